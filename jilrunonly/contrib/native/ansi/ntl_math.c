@@ -124,6 +124,82 @@ static int			MathCall(NTLInstance* pInst, int funcID);
 static JILFloat		MathWhiteNoise();
 static JILFloat		MathGaussianNoise();
 
+//------------------------------------------------------------------------------
+// directly callable functions
+//------------------------------------------------------------------------------
+// Small functions that the VM can call without going through MathProc. Since
+// JILFloat is not necessarily double, the ANSI functions are wrapped.
+
+#define MATH_FLOAT1(NAME, EXPR)	static JILFloat NAME(JILFloat f) { return EXPR; }
+#define MATH_FLOAT2(NAME, EXPR)	static JILFloat NAME(JILFloat f1, JILFloat f2) { return EXPR; }
+#define MATH_INT2(NAME, EXPR)	static JILLong NAME(JILLong l1, JILLong l2) { return EXPR; }
+
+static JILLong MathAbs(JILLong l) { return abs(l); }
+MATH_FLOAT1( MathAcos,	acos(f) )
+MATH_FLOAT1( MathAsin,	asin(f) )
+MATH_FLOAT1( MathAtan,	atan(f) )
+MATH_FLOAT2( MathAtan2,	atan2(f1, f2) )
+MATH_FLOAT1( MathCos,	cos(f) )
+MATH_FLOAT1( MathCosh,	cosh(f) )
+MATH_FLOAT1( MathExp,	exp(f) )
+MATH_FLOAT1( MathFabs,	fabs(f) )
+MATH_FLOAT1( MathLog,	log(f) )
+MATH_FLOAT1( MathLog10,	log10(f) )
+MATH_FLOAT2( MathPow,	pow(f1, f2) )
+MATH_FLOAT1( MathSin,	sin(f) )
+MATH_FLOAT1( MathSinh,	sinh(f) )
+MATH_FLOAT1( MathTan,	tan(f) )
+MATH_FLOAT1( MathTanh,	tanh(f) )
+MATH_FLOAT1( MathSqrt,	sqrt(f) )
+MATH_FLOAT1( MathCeil,	ceil(f) )
+MATH_FLOAT1( MathFloor,	floor(f) )
+MATH_FLOAT1( MathInt,	(f < 0.0) ? ceil(f) : floor(f) )
+MATH_FLOAT1( MathFrac,	f - ((f < 0.0) ? ceil(f) : floor(f)) )
+MATH_FLOAT1( MathSgn,	(f < 0.0) ? -1.0 : 1.0 )
+MATH_INT2( MathMin,		(l1 < l2) ? l1 : l2 )
+MATH_INT2( MathMax,		(l2 < l1) ? l1 : l2 )
+MATH_FLOAT2( MathFmin,	(f1 < f2) ? f1 : f2 )
+MATH_FLOAT2( MathFmax,	(f2 < f1) ? f1 : f2 )
+static JILLong MathRandomInt() { return MathRandom(); }
+static JILFloat MathLin(JILFloat n1, JILFloat n2, JILFloat f) { return n1 + (n2 - n1) * f; }
+
+// in the order of the function index numbers
+static const NTLDirectCall kDirectCalls[] =
+{
+	{ NTL_Sig_Int_Int,					(NTLDirectProc) MathAbs },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathAcos },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathAsin },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathAtan },
+	{ NTL_Sig_Float_FloatFloat,			(NTLDirectProc) MathAtan2 },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathCos },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathCosh },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathExp },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathFabs },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathLog },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathLog10 },
+	{ NTL_Sig_Float_FloatFloat,			(NTLDirectProc) MathPow },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathSin },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathSinh },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathTan },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathTanh },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathSqrt },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathCeil },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathFloor },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathInt },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathFrac },
+	{ NTL_Sig_Float_Float,				(NTLDirectProc) MathSgn },
+	{ NTL_Sig_Int_IntInt,				(NTLDirectProc) MathMin },
+	{ NTL_Sig_Int_IntInt,				(NTLDirectProc) MathMax },
+	{ NTL_Sig_Float_FloatFloat,			(NTLDirectProc) MathFmin },
+	{ NTL_Sig_Float_FloatFloat,			(NTLDirectProc) MathFmax },
+	{ NTL_Sig_None,						NULL },		// randomSeed() has no return value
+	{ NTL_Sig_Int_Void,					(NTLDirectProc) MathRandomInt },
+	{ NTL_Sig_Float_Void,				(NTLDirectProc) MathWhiteNoise },
+	{ NTL_Sig_Float_Void,				(NTLDirectProc) MathGaussianNoise },
+	{ NTL_Sig_Float_FloatFloatFloat,	(NTLDirectProc) MathLin },
+	{ NTL_Sig_End,						NULL }
+};
+
 //------------------------------------------------------------------------------
 // our main proc
 //------------------------------------------------------------------------------
@@ -156,6 +232,7 @@ int MathProc(NTLInstance* pInst, int msg, int param, void* pDataIn, void** ppDat
 		case NTL_GetBuildTimeStamp:		(*(const char**) ppDataOut) = kTimeStamp; break;
 		case NTL_GetAuthorName:			(*(const char**) ppDataOut) = kAuthorName; break;
 		case NTL_GetAuthorString:		(*(const char**) ppDataOut) = kAuthorString; break;
+		case NTL_GetDirectCalls:		(*(const NTLDirectCall**) ppDataOut) = kDirectCalls; break;
 
 		default:						result = JIL_ERR_Unsupported_Native_Call; break;
 	}
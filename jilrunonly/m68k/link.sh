@@ -1 +1 @@
-m68k-atari-mint-gcc bind_arraylist.o bind_runtime.o bind_runtime_exception.o bind_stringMatch.o jclarray.o jclclass.o jclclause.o jclerrors.o jclfile.o jclfunc.o jclgendoc.o jcllinker.o jclnative.o jcloption.o jclpair.o jclstate.o jclstring.o jclvar.o jilallocators.o jilarray.o jilarraylist.o jilchunk.o jilcodelist.o jilcompiler.o jilcstrsegment.o jildebug.o jilexception.o jilexecbytecode.o jilfixmem.o jilhandle.o jiliterator.o jillist.o jilmachine.o jilnativetype.o jiloptables.o jilprogramming.o jilruntime.o jilstdinc.o jilstring.o jilsymboltable.o jiltable.o jiltools.o jiltypeinfo.o jiltypelist.o ntl_file.o ntl_math.o ntl_stdlib.o ntl_time.o main.o -lc -lm -o jilrun.tos -Ofast
+m68k-atari-mint-gcc bind_arraylist.o bind_runtime.o bind_runtime_exception.o bind_stringMatch.o jclarray.o jclclass.o jclclause.o jclerrors.o jclfile.o jclfunc.o jclgendoc.o jcllinker.o jclnative.o jcloption.o jclpair.o jclstate.o jclstring.o jclvar.o jilallocators.o jilarray.o jilarraylist.o jilchunk.o jilcodelist.o jilcompiler.o jilcstrsegment.o jildebug.o jilexception.o jilexecbytecode.o jilfixmem.o jiljit.o jilaot.o jilhandle.o jiliterator.o jillist.o jilmachine.o jilnativetype.o jiloptables.o jilprogramming.o jilruntime.o jilstdinc.o jilstring.o jilsymboltable.o jiltable.o jilmap.o jiltools.o jiltypeinfo.o jiltypelist.o ntl_file.o ntl_math.o ntl_stdlib.o ntl_time.o main.o -lc -lm -o jilrun.tos -Ofast
@@ -28,6 +28,8 @@ m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../ji
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilexception.c -o ./jilexception.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilexecbytecode.c -o ./jilexecbytecode.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilfixmem.c -o ./jilfixmem.o -I ../../jilruntime/include -Ofast
+m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jiljit.c -o ./jiljit.o -I ../../jilruntime/include -Ofast
+m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilaot.c -o ./jilaot.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilhandle.c -o ./jilhandle.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jiliterator.c -o ./jiliterator.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jillist.c -o ./jillist.o -I ../../jilruntime/include -Ofast
@@ -40,6 +42,7 @@ m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../ji
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilstring.c -o ./jilstring.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilsymboltable.c -o ./jilsymboltable.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jiltable.c -o ./jiltable.o -I ../../jilruntime/include -Ofast
+m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jilmap.c -o ./jilmap.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jiltools.c -o ./jiltools.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jiltypeinfo.c -o ./jiltypeinfo.o -I ../../jilruntime/include -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../../jilruntime/src/jiltypelist.c -o ./jiltypelist.o -I ../../jilruntime/include -Ofast
@@ -50,4 +53,4 @@ m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../contr
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../contrib/native/ansi/ntl_time.c -o ./ntl_time.o -I ../../jilruntime/include -I ../../jilruntime/src -I ../contrib/native/ansi -Ofast
 m68k-atari-mint-gcc -D JIL_MACHINE_NO_64_BIT -D JIL_STRING_POOLING=0 -c ../src/main.c -o ./main.o -I ../../jilruntime/include -I ../../jilruntime/src -I ../contrib/native/ansi -Ofast
 # link
-m68k-atari-mint-gcc bind_arraylist.o bind_runtime.o bind_runtime_exception.o bind_stringMatch.o jclarray.o jclclass.o jclclause.o jclerrors.o jclfile.o jclfunc.o jclgendoc.o jcllinker.o jclnative.o jcloption.o jclpair.o jclstate.o jclstring.o jclvar.o jilallocators.o jilarray.o jilarraylist.o jilchunk.o jilcodelist.o jilcompiler.o jilcstrsegment.o jildebug.o jilexception.o jilexecbytecode.o jilfixmem.o jilhandle.o jiliterator.o jillist.o jilmachine.o jilnativetype.o jiloptables.o jilprogramming.o jilruntime.o jilstdinc.o jilstring.o jilsymboltable.o jiltable.o jiltools.o jiltypeinfo.o jiltypelist.o ntl_file.o ntl_math.o ntl_stdlib.o ntl_time.o main.o -lc -lm -o jilrun.tos -Ofast
+m68k-atari-mint-gcc bind_arraylist.o bind_runtime.o bind_runtime_exception.o bind_stringMatch.o jclarray.o jclclass.o jclclause.o jclerrors.o jclfile.o jclfunc.o jclgendoc.o jcllinker.o jclnative.o jcloption.o jclpair.o jclstate.o jclstring.o jclvar.o jilallocators.o jilarray.o jilarraylist.o jilchunk.o jilcodelist.o jilcompiler.o jilcstrsegment.o jildebug.o jilexception.o jilexecbytecode.o jilfixmem.o jiljit.o jilaot.o jilhandle.o jiliterator.o jillist.o jilmachine.o jilnativetype.o jiloptables.o jilprogramming.o jilruntime.o jilstdinc.o jilstring.o jilsymboltable.o jiltable.o jilmap.o jiltools.o jiltypeinfo.o jiltypelist.o ntl_file.o ntl_math.o ntl_stdlib.o ntl_time.o main.o -lc -lm -o jilrun.tos -Ofast
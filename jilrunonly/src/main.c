@@ -63,6 +63,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 
 //------------------------------------------------------------------------------
 // JIL includes
@@ -114,6 +115,9 @@ static void			CBOutputLogMessage		(JILState*, const char*);
 static void			CBMachineException		(JILState*);
 static void			CBBreakException		(JILState*);
 
+// garbage collector event handler
+static JILError		CBGarbageCollector		(JILState*, JILLong, JILUnknown*);
+
 //------------------------------------------------------------------------------
 // helper functions in this file
 //------------------------------------------------------------------------------
@@ -125,6 +129,19 @@ static void			GetAppPath				(const char* pFilespec);
 static void			WaitForEnter			();
 static int			LoadBinary				(JILState* pMachine, const char* pFileName);
 static int			SaveBinary				(JILState* pMachine, const char* pFileName);
+static int			SaveCSource				(JILState* pMachine, const char* pFileName);
+
+//------------------------------------------------------------------------------
+// compiled code
+//------------------------------------------------------------------------------
+// To run a program translated to C with option -wc, add the generated C file
+// to this project and define JILRUN_COMPILED_CODE to the name of its
+// registration function, e.g. JILRUN_COMPILED_CODE=app_Register for "app.c".
+// The code is registered after the binary has been loaded with option -rb.
+
+#ifdef JILRUN_COMPILED_CODE
+JILError			JILRUN_COMPILED_CODE	(JILState* pMachine);
+#endif
 
 //------------------------------------------------------------------------------
 // static variables and constants
@@ -135,6 +152,7 @@ static char gDefaultPath[MAX_PATH];
 static char gCompilerOptions[MAX_PATH];
 static char gExtension[MAX_PATH];
 static char gBinaryName[MAX_PATH];
+static char gCSourceName[MAX_PATH];
 static char gExportName[MAX_PATH];
 
 // The initial stack size the runtime is going to use (can be increased by script if neccessary)
@@ -156,6 +174,7 @@ const char* kUsageString =
 	"-v           output version info\n"
 	"-w           wait for enter\n"
 	"-wb <file>   write a compiled binary program using the given filename\n"
+	"-wc <file>   write the program as C source code using the given filename\n"
 	"-x           exit without running the script\n"
 	"-xml <file>  Export type information to the specified XML file\n"
 ;
@@ -189,6 +208,7 @@ int main(int nArgs, char* ppArgList[])
 	int bSetExt = 0;
 	int bReadBinary = 0;
 	int bWriteBinary = 0;
+	int bWriteCSource = 0;
 	int nFile = 1;
 	int nExportMode = export_nothing;
 	int err = 0;
@@ -224,6 +244,12 @@ int main(int nArgs, char* ppArgList[])
 			strcpy(gBinaryName, ppArgList[nFile]);
 			bWriteBinary = 1;
 		}
+		else if( strcmp(ppArgList[nFile], "-wc") == 0 )
+		{
+			if( ++nFile == nArgs ) break;
+			strcpy(gCSourceName, ppArgList[nFile]);
+			bWriteCSource = 1;
+		}
 		else if( strcmp(ppArgList[nFile], "-bind") == 0 )
 		{
 			if( ++nFile == nArgs ) break;
@@ -361,8 +387,13 @@ int main(int nArgs, char* ppArgList[])
 	}
 	else
 	{
-		err = LoadBinary(pMachine, ppArgList[0]);
+		err = LoadBinary(pMachine, ppArgList[nFile]);
 		THROW( err, err, "The specified binary file could not be loaded!" )
+
+	#ifdef JILRUN_COMPILED_CODE
+		err = JILRUN_COMPILED_CODE(pMachine);
+		THROW( err, err, "The compiled code does not match the specified binary file!" )
+	#endif
 	}
 
 	// save binary, if requested
@@ -372,6 +403,13 @@ int main(int nArgs, char* ppArgList[])
 		THROW( err, err, "The specified binary file could not be written!" )
 	}
 
+	// save C source code, if requested
+	if( bWriteCSource )
+	{
+		err = SaveCSource(pMachine, gCSourceName);
+		THROW( err, err, "The specified C source file could not be written!" )
+	}
+
 	// list code, if requested
 	if( bListCode )
 		JILListCode(pMachine, 0, 0, JILTrue);
@@ -396,6 +434,10 @@ int main(int nArgs, char* ppArgList[])
 	hFunctionMain = JILGetFunction(pMachine, NULL, NULL, "main");
 	THROW( !hFunctionMain, -1, "Script does not define the entry-point function 'main'!" )
 
+	// the garbage collector must know about the handle while 'main' is running
+	err = JILRegisterGCEvent(pMachine, CBGarbageCollector, &hFunctionMain);
+	THROW( err, err, NULL )
+
 	// create an array out of the command line parameters
 	hParameterArray = CreateParameterArray(pMachine, nArgs, ppArgList);
 	THROW( !hParameterArray, -1, "Could not create parameter array!" )
@@ -483,6 +525,21 @@ static void CBOutputLogMessage(JILState* pMachine, const char* pString)
 	fputs(pString, stdout);
 }
 
+//------------------------------------------------------------------------------
+// CBGarbageCollector
+//------------------------------------------------------------------------------
+// Callback function the garbage collector uses to let us mark the handles we
+// own. 'pUser' points to our handle to the function 'main'. A script can make
+// the runtime collect garbage while it is running, by setting the runtime
+// option "gc-growth", so the function being executed must not be collected.
+
+static JILError CBGarbageCollector(JILState* pMachine, JILLong event, JILUnknown* pUser)
+{
+	if( event == JIL_GCEvent_Mark )
+		return NTLMarkHandle(pMachine, *((JILHandle**) pUser));
+	return JIL_No_Exception;
+}
+
 //------------------------------------------------------------------------------
 // CBBreakException
 //------------------------------------------------------------------------------
@@ -732,3 +789,53 @@ error:
 	return err;
 }
 
+//------------------------------------------------------------------------------
+// SaveCSource
+//------------------------------------------------------------------------------
+// Save a JIL program as C source code. The name of the registration function
+// is derived from the file name, e.g. "path/my-app.c" -> my_app_Register().
+
+static int SaveCSource(JILState* pMachine, const char* pFileName)
+{
+	int err = JIL_ERR_Save_Chunk_Failed;
+	FILE* stream = NULL;
+	void* pData = NULL;
+	int size;
+	char name[MAX_PATH];
+	const char* pSrc;
+	char* pDst;
+
+	// derive the name from the file name
+	pSrc = pFileName + strlen(pFileName);
+	while( pSrc > pFileName && pSrc[-1] != '/' && pSrc[-1] != '\\' )
+		pSrc--;
+	pDst = name;
+	if( isdigit((unsigned char) *pSrc) )
+		*pDst++ = '_';
+	for( ; *pSrc && *pSrc != '.' && pDst < name + MAX_PATH - 2; pSrc++ )
+		*pDst++ = isalnum((unsigned char) *pSrc) ? *pSrc : '_';
+	*pDst = 0;
+
+	// get the source code from the virtual machine
+	err = JILSaveCSource(pMachine, name, &pData, &size);
+	if( err )
+		goto error;
+
+	// open the file
+	stream = fopen(pFileName, "wb");
+	if( stream == NULL )
+	{
+		err = JIL_ERR_Save_Chunk_Failed;
+		goto error;
+	}
+
+	// write it
+	if( fwrite(pData, size, 1, stream) != 1 )
+		err = JIL_ERR_Save_Chunk_Failed;
+
+error:
+	if( stream )
+		fclose( stream );
+	return err;
+}
+
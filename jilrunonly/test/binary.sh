@@ -0,0 +1,37 @@
+#!/bin/sh
+# binary.sh
+#
+# Compiles and runs binary.jc, saves it as a binary program with -wb, and runs
+# the saved binary with -rb. Then translates the program to C with -wc, builds
+# jilrun with the generated code, and runs the saved binary with it. All runs
+# must print the same output.
+#
+# usage: binary.sh <jilrun>
+#
+# The second jilrun is built with $CC (default: cc). $CFLAGS and $LIBS are
+# passed to the compiler.
+
+JILRUN=${1:-jilrun}
+DIR=`dirname "$0"`
+SRC="$DIR/../.."
+TMP=${TMPDIR:-/tmp}/jilbinary.$$
+
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+# run from source, save the binary and the C source
+"$JILRUN" -wb "$TMP/binary.jb" -wc "$TMP/binary.c" "$DIR/binary.jc" > "$TMP/source.txt" || { echo "FAIL: running from source"; exit 1; }
+
+# run the saved binary
+"$JILRUN" -rb "$TMP/binary.jb" > "$TMP/binary.txt" || { echo "FAIL: running the binary"; exit 1; }
+diff "$TMP/source.txt" "$TMP/binary.txt" || { echo "FAIL: the binary prints different output"; exit 1; }
+
+# build jilrun with the generated code and run the saved binary
+${CC:-cc} $CFLAGS -DJILRUN_COMPILED_CODE=binary_Register -o "$TMP/jilrun" \
+	-I "$SRC/jilruntime/include" -I "$SRC/jilruntime/src" -I "$SRC/jilrunonly/contrib/native/ansi" \
+	"$SRC"/jilruntime/src/*.c "$SRC"/jilrunonly/contrib/native/ansi/*.c "$SRC/jilrunonly/src/main.c" \
+	"$TMP/binary.c" $LIBS -lm || { echo "FAIL: building jilrun with the generated code"; exit 1; }
+"$TMP/jilrun" -rb "$TMP/binary.jb" > "$TMP/compiled.txt" || { echo "FAIL: running the compiled code"; exit 1; }
+diff "$TMP/source.txt" "$TMP/compiled.txt" || { echo "FAIL: the compiled code prints different output"; exit 1; }
+
+echo "OK"
@@ -77,22 +77,19 @@
 // JILInitialize
 //------------------------------------------------------------------------------
 /// Initializes the runtime and returns a JILState structure. The
-/// virtual machine's stack is fixed in size, it does not automatically grow.
+/// stack size is the maximum size of the stack of every context (the main
+/// program and each cofunction instance). Stacks start small and grow on
+/// demand, so a large maximum does not cost memory unless a script uses it.
 /// For small applets, macros or other functions, a size of 1024 should be
 /// sufficient. For larger applets or whole programs without recursive
 /// functions a size of 4096 is recommended.
 /// If your code is using excessively recursive functions (Ackerman, Fibonacci)
 /// the size should be 16384 or larger.
-/// <p>You can build the library with 'extended runtime checks' by setting the
-/// macro JIL_RUNTIME_CHECKS to 1 in file jilplatform.h, if you need the library
-/// to check for stack over/underruns. In this case the VM will generate an
-/// exception. Enabling runtime checks will significantly decrease
-/// performance.</p>
-/// <p>If you're not sure whether your stack size is sufficient, you can first
-/// test your JewelScript code with the debug build of the library, which will
-/// check the stack for over/underruns and generate an exception. Then, after
-/// you successfully ran your code with the debug build, you can safely switch
-/// to the release build.</p>
+/// <p>If a script exceeds the maximum stack size, the VM will generate a
+/// JIL_VM_Stack_Overflow exception. You can build the library with 'extended
+/// runtime checks' by setting the macro JIL_RUNTIME_CHECKS to 1 in file
+/// jilplatform.h, if you need the library to check for stack underruns as
+/// well. Enabling runtime checks will significantly decrease performance.</p>
 /// <p>You can pass additional options for the runtime and compiler if 'options'
 /// points to a character string that contains a comma seperated list of
 /// 'name=value' tags. You can pass NULL for this parameter if you don't need to
@@ -222,6 +219,43 @@ JILEXTERN JILError				JILLoadBinary			(JILState* pState, const JILUnknown* pData
 
 JILEXTERN JILError				JILSaveBinary			(JILState* pState, JILUnknown** ppData, JILLong* pDataSize);
 
+//------------------------------------------------------------------------------
+// JILSaveCSource
+//------------------------------------------------------------------------------
+/// Translates the bytecode of all script functions into C source code. If
+/// successful, the function writes the address of a buffer containing the
+/// zero-terminated source code to ppData and its length, in bytes, to
+/// pDataSize. The buffer is the same one JILSaveBinary() uses, so it remains
+/// valid until the runtime is terminated, re-initialized, or either function
+/// is called again.
+/// <p>The purpose of this function is to deploy a program that has been saved
+/// with JILSaveBinary() together with the generated code, so that most of its
+/// functions run as native code without a JIT compiler. The generated source
+/// file must be compiled with the "include" and "src" directories of the
+/// library in the include path, and linked into the application. It defines
+/// the function <code>JILError pName_Register(JILState* pState)</code>, which
+/// the application must call after loading the binary with JILLoadBinary().
+/// pName must be a valid C identifier.</p>
+/// Not every instruction is translated. Calls, allocations, exceptions and
+/// cofunctions are left to the virtual machine, which also continues
+/// wherever the operand types of an instruction differ from what the
+/// compiled code expects.
+
+JILEXTERN JILError				JILSaveCSource			(JILState* pState, const JILChar* pName, JILUnknown** ppData, JILLong* pDataSize);
+
+//------------------------------------------------------------------------------
+// JILRegisterCompiledCode
+//------------------------------------------------------------------------------
+/// Registers code that has been generated by JILSaveCSource() to the runtime.
+/// You do not need to call this function directly, it is called by the
+/// registration function in the generated source file. Returns
+/// JIL_ERR_Load_Chunk_Failed if the currently loaded bytecode is not the
+/// bytecode the code has been generated from, or JIL_VM_Allocation_Failed if
+/// the table of entry points could not be allocated. The registration is
+/// discarded when bytecode is changed or loaded.
+
+JILEXTERN JILError				JILRegisterCompiledCode	(JILState* pState, const JILCompiledCode* pCode);
+
 //------------------------------------------------------------------------------
 // JILRegisterNativeType
 //------------------------------------------------------------------------------
@@ -334,19 +368,19 @@ JILEXTERN JILUnknown*			JILGetObject			(JILState* pState, JILLong objectID);
 /// <p>Fixed memory management works by trading off memory efficiency for
 /// increased performance. That means, objects allocated through this manager
 /// may "waste" memory, because a larger block may be allocated than necessary.
-/// Therefore it may be better to use normal C-runtime malloc() and free() on
-/// machines with low memory resources.</p>
+/// Blocks are rounded up to the nearest size class: 8, 16, 24, 32, 48, 64, 96,
+/// 128, 192, 256, 384, 512, 768 or 1024 bytes. Blocks of the same size class
+/// are allocated from 16 KB slabs, which are returned to the C-runtime when
+/// they become empty, except for one per size class.</p>
 /// <p>Specify the maximum number of objects allowed for the given block sizes.
-/// When allocating a block, the library will choose the memory manager with the
-/// smallest block size capable of accommodating the block. If the requested
-/// block size is for example 24 bytes, the library will use the memory manager
-/// for 32 byte blocks.</p>
-/// <p>'max16' stands for maximum number of blocks less or equal 16 bytes in size,
-/// 'max32' for less or equal 32 bytes in size, and so forth.</p>
+/// 'max16' stands for maximum number of blocks less or equal 16 bytes in size,
+/// 'max32' for greater than 16 and less or equal 32 bytes in size, and so
+/// forth. The limit applies to each size class in that range.</p>
 /// <p>If you specify 0 (zero) for any of the 'max' parameters, this memory
 /// manager will be used in "dynamic growth" mode, meaning there is no limit to
-/// the number of blocks of that size (except available RAM of course).</p>
-/// <p>Suffice to say that blocks with sizes > 512 bytes will be allocated and
+/// the number of blocks of that size (except available RAM of course). Blocks
+/// greater than 512 bytes have no limit.</p>
+/// <p>Suffice to say that blocks with sizes > 1024 bytes will be allocated and
 /// freed using the normal C-runtime malloc() and free() functions.</p>
 /// <p>Calling this will override the JILState::vmMalloc and
 /// JILState::vmFree member variables. If you have set these callbacks to
@@ -403,6 +437,17 @@ JILEXTERN JILUnknown*			JILMalloc				(JILState* pState, JILLong size);
 
 JILEXTERN void					JILMfree				(JILState* pState, JILUnknown* ptr);
 
+//------------------------------------------------------------------------------
+// JILGetMemStats
+//------------------------------------------------------------------------------
+/// Returns statistics of the memory allocated through JILMalloc(), for example
+/// the number of bytes currently in use. The statistics are always collected,
+/// but most values are only available if fixed memory management has been
+/// enabled. The returned pointer is valid until the runtime is terminated.
+/// @see JILUseFixedMemory
+
+JILEXTERN const JILMemStats*	JILGetMemStats			(JILState* pState);
+
 //------------------------------------------------------------------------------
 // JILSetBlocked
 //------------------------------------------------------------------------------
@@ -525,10 +570,157 @@ JILEXTERN JILError				JILMarkFunctionTable	(JILState* pState, JILFunctionTable*
 /// the NTL_MarkHandles message in their type proc.</p>
 /// The function will return JIL_No_Exception unless a native function did not
 /// handle the marking message correctly or returned an error.
-/// @see JILRegisterGCEvent, JILUnregisterGCEvent
+/// <p>If an incremental collection started by JILCollectGarbageStep() is in
+/// progress, it is finished first.</p>
+/// @see JILRegisterGCEvent, JILUnregisterGCEvent, JILCollectGarbageStep
 
 JILEXTERN JILError				JILCollectGarbage		(JILState* pState);
 
+//------------------------------------------------------------------------------
+// JILCollectGarbageStep
+//------------------------------------------------------------------------------
+/// Performs one step of an incremental garbage collection. If no collection
+/// is in progress, a new one is started. Every step stops when the budget set
+/// by JILSetGCBudget() is used up, so the application can spread the work of
+/// a collection over many calls, for example one call per frame.
+/// <p>While a collection is in progress, the virtual machine also performs
+/// steps at calls and backward branches of the executed byte-code. If this
+/// function is called from a native function while byte-code is executing,
+/// it only requests the collection, which then starts at the next call or
+/// backward branch.</p>
+/// <p>The same rules regarding JILRegisterGCEvent() apply as for
+/// JILCollectGarbage(). The JIL_GCEvent_Mark message is sent when the
+/// collection starts, and again when marking is finished. After every step,
+/// the JIL_GCEvent_Pause message is sent.</p>
+/// If JIL_USE_INCREMENTAL_GC is disabled, this performs a full collection.
+/// @see JILCollectGarbage, JILSetGCBudget, JILGetGCPauseTime
+
+JILEXTERN JILError				JILCollectGarbageStep	(JILState* pState);
+
+//------------------------------------------------------------------------------
+// JILSetGCBudget
+//------------------------------------------------------------------------------
+/// Sets the budget of a single step of the incremental garbage collector.
+/// 'numHandles' is the maximum number of handles marked or swept per step,
+/// 'seconds' is the maximum time spent per step. Pass 0 for either value to
+/// remove the limit. By default, a step processes 4096 handles. The time
+/// limit can also be set by the runtime option "gc-budget-ms=milliseconds".
+/// @see JILCollectGarbageStep
+
+JILEXTERN void					JILSetGCBudget			(JILState* pState, JILLong numHandles, JILFloat seconds);
+
+//------------------------------------------------------------------------------
+// JILSetGCGrowth
+//------------------------------------------------------------------------------
+/// Sets how much the heap may grow before the runtime starts a garbage
+/// collection by itself. After every collection, the runtime multiplies the
+/// number of used handles, and the number of bytes allocated through the
+/// allocator set by JILUseFixedMemory(), by 'growth'. When either limit is
+/// reached, a collection is started at the next call or backward branch of the
+/// executed byte-code, and is performed in steps as if JILCollectGarbageStep()
+/// had been called. Since reference counting frees most objects right away,
+/// the heap only grows if objects are kept alive or leaked in reference
+/// cycles, so short bursts of allocations don't cause collections. A value
+/// of 2.0 is a good choice. Pass 0 to disable automatic collections, which is
+/// the default. Can also be set by the runtime option "gc-growth=factor".
+/// <p>Since a collection can start whenever byte-code is running, the
+/// application must mark all handles it holds while it calls script
+/// functions, including the handle of the function it calls, in response to
+/// the JIL_GCEvent_Mark message. See JILRegisterGCEvent().</p>
+/// @see JILSetGCBudget
+
+JILEXTERN void					JILSetGCGrowth			(JILState* pState, JILFloat growth);
+
+//------------------------------------------------------------------------------
+// JILGetGCPauseTime
+//------------------------------------------------------------------------------
+/// Returns the duration in seconds of the most recent garbage collection step
+/// or full collection. Call this in response to the JIL_GCEvent_Pause message
+/// to monitor the pause times of the garbage collector.
+/// @see JILRegisterGCEvent
+
+JILEXTERN JILFloat				JILGetGCPauseTime		(JILState* pState);
+
+//------------------------------------------------------------------------------
+// JILSetLazyFree
+//------------------------------------------------------------------------------
+/// Enables or disables lazy free mode. When the last reference to an object
+/// is released, the object is normally destroyed right away, together with
+/// every object that only it referenced. In lazy free mode, such objects are
+/// only added to a list of pending objects instead. Whenever a new handle is
+/// allocated, up to 'batchSize' of them are destroyed, so releasing a big data
+/// structure doesn't stall the application. Values without members, like ints
+/// and strings, are always destroyed right away. Pass 0 to disable lazy free
+/// mode; this destroys all pending objects. Can also be set by the runtime
+/// option "lazy-free=batchSize".
+/// @see JILFreePendingObjects
+
+JILEXTERN void					JILSetLazyFree			(JILState* pState, JILLong batchSize);
+
+//------------------------------------------------------------------------------
+// JILFreePendingObjects
+//------------------------------------------------------------------------------
+/// Destroys up to 'maxObjects' objects that are pending destruction in lazy
+/// free mode, or all of them if 'maxObjects' is 0. Returns the number of
+/// objects that are still pending. The application can call this once per
+/// frame, for example, to free memory when it has time to spare.
+/// @see JILSetLazyFree
+
+JILEXTERN JILLong				JILFreePendingObjects	(JILState* pState, JILLong maxObjects);
+
+//------------------------------------------------------------------------------
+// JILSetInstancePool
+//------------------------------------------------------------------------------
+/// Sets the maximum number of destroyed instances the runtime keeps per script
+/// class for reuse. When an instance of a class written in script code is
+/// destroyed, its member array is filled with null references and kept in a
+/// pool of that class, so the next instance can be allocated without calling
+/// the memory allocator and initializing its members. By default, up to 256
+/// instances are kept per class. Pass 0 to disable instance pooling; this
+/// frees all pooled instances. Can also be set by the runtime option
+/// "instance-pool=maxInstances". JILTrimHandles() also frees pooled instances.
+
+JILEXTERN void					JILSetInstancePool		(JILState* pState, JILLong maxInstances);
+
+//------------------------------------------------------------------------------
+// JILCollectCycles
+//------------------------------------------------------------------------------
+/// Frees reference cycles that are no longer referenced from outside the
+/// cycle. Unlike JILCollectGarbage(), this does not mark from the roots, but
+/// only examines the objects reachable from the candidates the runtime has
+/// buffered since the last call, which are the objects whose reference count
+/// has been decremented to a non-zero value. No JIL_GCEvent_Mark message is
+/// sent, handles held by the application keep their objects alive as long as
+/// the application holds a reference to them.
+/// <p>The children of every object are enumerated through the same
+/// NTL_MarkHandles message that is used by the garbage collector, so native
+/// types must only call NTLMarkHandle() for the handles they hold a reference
+/// to. If an incremental collection is in progress, it is finished first.
+/// While byte-code is executing, this function does nothing and returns
+/// JIL_ERR_Runtime_Locked; the virtual machine collects cycles itself at calls
+/// and backward branches, when enough candidates have been buffered.</p>
+/// If JIL_USE_CYCLE_COLLECTOR is disabled, this does nothing.
+/// @see JILCollectGarbage
+
+JILEXTERN JILError				JILCollectCycles		(JILState* pState);
+
+//------------------------------------------------------------------------------
+// JILTrimHandles
+//------------------------------------------------------------------------------
+/// Returns the memory of unused runtime handles to the system. Handles are
+/// allocated in buckets, so the handle table grows when the application
+/// creates many objects, and normally keeps that size until the runtime is
+/// terminated. This function releases every bucket that contains only unused
+/// handles. Returns the number of handles that have been released. The
+/// garbage collector also releases unused buckets after each cycle, but keeps
+/// as many unused handles as there are used handles, so that the table doesn't
+/// need to grow again right away.
+/// Does nothing and returns 0 if called during a garbage collection cycle.
+/// Also frees the instances kept for reuse, see JILSetInstancePool(), and
+/// returns empty slabs of the fixed memory manager to the C-runtime.
+
+JILEXTERN JILLong				JILTrimHandles			(JILState* pState);
+
 //------------------------------------------------------------------------------
 // JILRegisterGCEvent
 //------------------------------------------------------------------------------
@@ -44,6 +44,12 @@ typedef struct JILMemStats			JILMemStats;
 typedef struct JILFunctionTable		JILFunctionTable;
 typedef struct JILGCEventRecord		JILGCEventRecord;
 typedef struct JILFileHandle		JILFileHandle;
+typedef struct JILCallSite			JILCallSite;
+typedef struct JILInstancePool		JILInstancePool;
+typedef struct JILDirectCalls		JILDirectCalls;
+typedef struct JILJit				JILJit;
+typedef struct JILCompiledEntry	JILCompiledEntry;
+typedef struct JILCompiledCode		JILCompiledCode;
 
 typedef struct Seg_JILDataHandle	Seg_JILDataHandle;
 typedef struct Seg_JILLong			Seg_JILLong;
@@ -181,7 +187,8 @@ typedef enum
 enum
 {
 	JIL_GCEvent_Mark = 0,		//!< Sent to the event handler proc before the GC collects unused objects. Call NTLMarkHandle() for all your objects.
-	JIL_GCEvent_Shutdown		//!< Sent to the event handler proc when the VM is about to shut down. Call NTLFreeHandle() for all your objects.
+	JIL_GCEvent_Shutdown,		//!< Sent to the event handler proc when the VM is about to shut down. Call NTLFreeHandle() for all your objects.
+	JIL_GCEvent_Pause			//!< Sent to the event handler proc after every garbage collection step or full collection. Call JILGetGCPauseTime() to get its duration. Do not mark handles in response to this.
 };
 
 //------------------------------------------------------------------------------
@@ -293,6 +300,15 @@ typedef JILError (*JILFileInputProc) (JILState*, JILLong, JILChar*, JILLong, JIL
 
 typedef void (*JCLFatalErrorHandler) (JILState*, const JILChar*);
 
+//------------------------------------------------------------------------------
+// JILCompiledProc
+//------------------------------------------------------------------------------
+/// This is the prototype of a function generated by JILSaveCSource(). It runs
+/// the compiled code of a script function from the given code address on, and
+/// returns the code address at which the virtual machine has to continue.
+
+typedef JILLong (*JILCompiledProc) (JILState* pState, JILContext* pContext, JILLong address);
+
 //------------------------------------------------------------------------------
 // malloc / free hooks
 //------------------------------------------------------------------------------
@@ -318,16 +334,28 @@ struct JILVersionInfo
 // struct JILContext
 //------------------------------------------------------------------------------
 /// This struct contains the thread context during byte-code execution.
+/// <p>Both stacks grow downwards from JILState::vmDataStackSize and
+/// JILState::vmCallStackSize. They start small and are reallocated when
+/// a push would overflow them, see JILGrowStack(). Only the indices from
+/// the stack limit upwards are backed by memory. Element 0 of vmppDataStack
+/// and vmpCallStack holds the stack index given by the limit, so a stack
+/// index must be reduced by the limit before it is used.</p>
+/// <p>This is a breaking change of type interface version 4.4. Before, the
+/// stack buffers were indexed by the stack pointer directly. Hosts and native
+/// types should not read the stacks, but use NTLGetArgHandle() and the other
+/// NTLGetArg functions to access arguments.</p>
 
 struct JILContext
 {
 	JILLong				vmDataStackPointer;			//!< Current data stack pointer
 	JILLong				vmCallStackPointer;			//!< Current call stack pointer
 	JILLong				vmProgramCounter;			//!< Current program counter
-	JILHandle**			vmppRegister;				//!< The bank of virtual machine registers
-	JILHandle**			vmppDataStack;				//!< Points to the data stack, this stack consists out of JILHandle pointers
-	JILLong*			vmpCallStack;				//!< Points to the call stack, this stack consists out of offsets into the code segment
-	JILContext*			vmpYieldContext;			//!< The context that this context will yield to
+	JILHandle**			vmppRegister;				//!< The bank of virtual machine registers, allocated together with the context
+	JILHandle**			vmppDataStack;				//!< Points to the data stack buffer, this stack consists out of JILHandle pointers
+	JILLong*			vmpCallStack;				//!< Points to the call stack buffer, this stack consists out of offsets into the code segment
+	JILContext*			vmpYieldContext;			//!< The context that this context will yield to, links the contexts in JILState::vmpContextPool
+	JILLong				vmDataStackLimit;			//!< Lowest data stack index that is currently backed by memory
+	JILLong				vmCallStackLimit;			//!< Lowest call stack index that is currently backed by memory
 };
 
 //------------------------------------------------------------------------------
@@ -342,6 +370,97 @@ struct JILFunctionTable
 	JILHandle**			func;						//!< Pointer to array of handles
 };
 
+//------------------------------------------------------------------------------
+// struct JILCallSite
+//------------------------------------------------------------------------------
+/// Inline cache entry for a callm or calldg instruction. Only used if
+/// JIL_USE_INLINE_CACHING is enabled.
+
+struct JILCallSite
+{
+	JILLong				address;					//!< Code address of the call instruction, -1 if the entry is unused
+	JILLong				type;						//!< Type of the object the call was last made on
+	JILLong				index;						//!< Function index of the delegate (calldg only)
+	JILLong				codeAddr;					//!< Resolved code address of the called function
+};
+
+//------------------------------------------------------------------------------
+// struct JILInstancePool
+//------------------------------------------------------------------------------
+/// List of member arrays of destroyed instances of a script class, which are
+/// reused by the next instances of that class. The member arrays are filled
+/// with the null handle, except for the first entry, which links to the next
+/// member array in the list.
+
+struct JILInstancePool
+{
+	JILHandle**			ppFirst;					//!< The first member array in the list, or NULL
+	JILLong				count;						//!< Number of member arrays in the list
+};
+
+//------------------------------------------------------------------------------
+// struct JILDirectCalls
+//------------------------------------------------------------------------------
+/// The table of directly callable functions a native type has returned in
+/// response to NTL_GetDirectCalls, see struct NTLDirectCall.
+
+struct JILDirectCalls
+{
+	const struct NTLDirectCall*	pCalls;				//!< The table returned by the type proc, or NULL
+	JILLong				count;						//!< Number of entries in the table, not counting the terminating entry
+};
+
+//------------------------------------------------------------------------------
+// struct JILMemStats
+//------------------------------------------------------------------------------
+/// Statistics of the memory allocated by the runtime through JILMalloc(). The
+/// number of allocations and frees is always counted. The other values are
+/// only updated when fixed memory management is enabled. The fixed memory
+/// manager allocates small blocks from bigger chunks of memory, called slabs
+/// (or buckets), and returns slabs to the C-runtime when they become empty.
+/// Note that fixed memory is only used when memory is allocated during
+/// run-time, not when the compiler or other parts of the library allocate it.
+/// The built-in native type libraries use it too. But of course it is up to
+/// the implementor, whether or not a specific type library uses JILMalloc() or
+/// just new / malloc.
+/// @see JILUseFixedMemory, JILGetMemStats
+
+struct JILMemStats
+{
+	JILLong				numAlloc;					//!< The total number of memory allocations
+	JILLong				numFree;					//!< Total number of memory frees
+	JILLong				bytesUsed;					//!< Currently allocated number of bytes
+	JILLong				maxBytesUsed;				//!< Maximum number of allocated bytes at any time
+	JILLong				numBuckets;					//!< Number of slabs currently allocated
+	JILLong				bucketBytes;				//!< Number of bytes currently allocated for slabs
+	JILLong				numReleased;				//!< Total number of slabs returned to the C-runtime
+};
+
+//------------------------------------------------------------------------------
+// struct JILCompiledEntry
+//------------------------------------------------------------------------------
+/// An entry point into compiled code, generated by JILSaveCSource().
+
+struct JILCompiledEntry
+{
+	JILLong				address;					//!< Code address of the entry point
+	JILCompiledProc		proc;						//!< Compiled function that can be entered at this address
+};
+
+//------------------------------------------------------------------------------
+// struct JILCompiledCode
+//------------------------------------------------------------------------------
+/// Describes the compiled code generated by JILSaveCSource(), and the byte-code
+/// it has been generated from. @see JILRegisterCompiledCode
+
+struct JILCompiledCode
+{
+	JILLong					codeSize;				//!< Size of the code segment the code has been generated from
+	JILLong					checksum;				//!< Checksum of the code segment the code has been generated from
+	JILLong					numEntries;				//!< Number of entry points
+	const JILCompiledEntry*	pEntries;				//!< Array of entry points
+};
+
 //------------------------------------------------------------------------------
 // struct JILState
 //------------------------------------------------------------------------------
@@ -371,11 +490,12 @@ struct JILState
 	JILBool				vmBlocked;					//!< Can be set to JILTrue to block all further execution of script code
 	JILBool				vmStringPooling;			//!< Can be set to JILFalse to disable string pooling when compiling programs
 
-	JILLong				vmDataStackSize;			//!< The (fixed) size of the data stack, given in JILInitialize()
-	JILLong				vmCallStackSize;			//!< The (fixed) size of the call stack, given in JILInitialize()
+	JILLong				vmDataStackSize;			//!< The maximum size of the data stack of a context, given in JILInitialize()
+	JILLong				vmCallStackSize;			//!< The maximum size of the call stack of a context, given in JILInitialize()
 	JILLong				vmSegmentAllocGrain;		//!< The block size used when resizing the data or code segments
 	JILLong				vmCStrSegAllocGrain;		//!< The block size used when resizing the cstr segment
 	JILLong				vmInitDataIncr;				//!< Counter for incremental data handle initialization
+	JILLong				vmCheckedCodeSize;			//!< Size of the code segment when its opcodes were last checked, see JIL_USE_THREADED_DISPATCH
 	JILLong				vmInitTypeIncr;				//!< Counter for incremental native type initialization
 	JILLong				vmRunInitIncr;				//!< Code address for incremental init-code execution
 	JILLong				vmRunLevel;					//!< Counts the number of nested byte-code execution calls
@@ -383,6 +503,50 @@ struct JILState
 	JILLong				vmLogGarbageMode;			//!< Mode for the runtime option "log-garbage"
 	JILUInt64			vmInstructionCounter;		//!< Incremented for each executed instruction (only if JIL_USE_INSTRUCTION_COUNTER is enabled)
 	JILFloat			vmTimeLastGC;				//!< Time (ANSI clocks) when the GC was last executed
+	JILLong				vmGCPhase;					//!< Current phase of the incremental garbage collector (see enum in jilhandle.h)
+	JILLong				vmGCSweepIndex;				//!< Index of the next handle the incremental garbage collector will sweep
+	JILLong				vmGCCollected;				//!< Number of handles collected by the current garbage collection cycle
+	JILFloat			vmGCCycleStart;				//!< Time (ANSI clocks) when the current garbage collection cycle has been started
+	JILHandle**			vmppGCGrey;					//!< List of handles marked by the garbage collector, but not yet scanned
+	JILLong				vmGCGreyCount;				//!< Number of handles in the grey list
+	JILLong				vmGCGreySize;				//!< Allocated size of the grey list
+	JILLong				vmGCStepWork;				//!< Maximum number of handles to process per incremental GC step, 0 for no limit
+	JILFloat			vmGCStepTime;				//!< Maximum time in seconds per incremental GC step, 0 for no limit
+	JILFloat			vmGCLastPause;				//!< Duration in seconds of the most recent GC step or full collection
+	JILFloat			vmGCGrowth;					//!< Factor the heap may grow by before the next garbage collection is started automatically, 0 to disable (runtime option "gc-growth")
+	JILLong				vmGCHandleLimit;			//!< Number of used handles that starts the next garbage collection
+	JILUInt64			vmGCByteLimit;				//!< Number of bytes in use that starts the next garbage collection
+	JILUInt64			vmHeapBytes;				//!< Number of bytes currently allocated through the built-in allocator set by JILUseFixedMemory()
+	JILHandle**			vmppCCRoots;				//!< Candidate roots buffered for the cycle collector
+	JILLong				vmCCRootCount;				//!< Number of candidate roots in the buffer
+	JILLong				vmCCRootSize;				//!< Allocated size of the candidate root buffer
+	JILLong				vmCCThreshold;				//!< Minimum number of candidate roots that triggers the cycle collector, 0 to disable
+	JILLong				vmCCTrigger;				//!< Number of candidate roots that triggers the cycle collector at the next safe point, grows with the number of used handles
+	JILHandle**			vmppCCStack;				//!< Work list of the cycle collector
+	JILLong				vmCCStackCount;				//!< Number of entries on the work list
+	JILLong				vmCCStackSize;				//!< Allocated size of the work list
+	JILLong				vmCCMode;					//!< What the cycle collector does with the handles enumerated by JILMarkHandle(), 0 if not collecting
+	JILError			vmCCError;					//!< Error that abandons the current cycle collection, for example if the work list can't be grown
+	JILHandle**			vmppPendingFree;			//!< Handles whose reference count has reached 0, but whose objects have not been destroyed yet
+	JILLong				vmPendingCount;				//!< Number of handles in the pending list
+	JILLong				vmPendingSize;				//!< Allocated size of the pending list
+	JILBool				vmDestroying;				//!< Is JILTrue while objects from the pending list are destroyed
+	JILLong				vmLazyFree;					//!< Number of pending objects destroyed per allocation in lazy free mode, 0 if disabled (runtime option "lazy-free")
+	JILInstancePool*	vmpInstancePools;			//!< Recycled member arrays of script class instances, indexed by type
+	JILLong				vmNumInstancePools;			//!< Number of entries in vmpInstancePools
+	JILLong				vmInstancePoolCap;			//!< Maximum number of member arrays kept per type, 0 to disable (runtime option "instance-pool")
+	JILDirectCalls*		vmpDirectCalls;				//!< Tables of directly callable functions of native types, indexed by type
+	JILLong				vmNumDirectCalls;			//!< Number of entries in vmpDirectCalls
+	JILContext*			vmpContextPool;				//!< Freed contexts kept for reuse by JILAllocContext()
+	JILLong				vmNumContextPool;			//!< Number of contexts in vmpContextPool
+	JILLong				vmContextPoolCap;			//!< Maximum number of contexts kept for reuse, 0 to disable
+	JILLong				vmQuickInfoSize;			//!< The currently allocated size of the quickening info array
+	JILByte*			vmpQuickInfo;				//!< Quickening state for each word in the code segment (only if JIL_USE_QUICKENING is enabled)
+	JILUInt64*			vmpOpcodePairs;				//!< Execution counts of opcode pairs (only if JIL_USE_OPCODE_PROFILING is enabled)
+	JILCallSite*		vmpCallCache;				//!< Inline caches of call sites, indexed by code address (only if JIL_USE_INLINE_CACHING is enabled)
+	JILJit*				vmpJit;						//!< State of the just-in-time compiler (only if JIL_USE_JIT is enabled, NULL if disabled by runtime option "jit")
+	JILBool				vmJitDisabled;				//!< Is JILTrue if the just-in-time compiler has been disabled by runtime option "jit"
+	JILCompiledProc*	vmppCompiledCode;			//!< Entry points into compiled code for each code address, or NULL if no code has been registered by JILRegisterCompiledCode()
 
 	Seg_JILDataHandle*	vmpDataSegment;				//!< Pointer to the data segment
 	Seg_JILLong*		vmpCodeSegment;				//!< Pointer to the code segment
@@ -403,9 +567,13 @@ struct JILState
 	JILSymTabEntry*		vmpSymTabLast;				//!< Points to the last symbol entry in the symbol table
 
 	// handles
-	JILLong				vmMaxHandles;				//!< The number of currently allocated runtime handles
+	JILLong				vmMaxHandles;				//!< The number of currently used entries in vmppHandles, including released buckets
 	JILLong				vmUsedHandles;				//!< The number of currently used runtime handles
+	JILLong				vmNumHandles;				//!< The number of currently allocated runtime handles, which is the size of the free handle stack
+	JILLong				vmHandleCapacity;			//!< The currently allocated size of the handle pointer arrays
+	JILLong				vmReleasedBuckets;			//!< The number of released buckets, whose entries in vmppHandles are NULL
 	JILLong				vmHandleAllocGrain;			//!< The number of handles per bucket, runtime handles are allocated in buckets
+	JILLong				vmHandleBucketSize;			//!< The size of a bucket in bytes, buckets consist of aligned groups of handles
 	JILHandle**			vmppHandles;				//!< Pointer array of all existing (used or unused) runtime handles
 	JILHandle**			vmppFreeHandles;			//!< Pointer array (a stack) of unused runtime handles, for fast reuse of free handles
 
@@ -436,13 +604,8 @@ struct JILState
 	JILFreeProc			vmFree;						//!< Pointer to memory deallocator used during runtime. If you want to set this to your custom deallocator, you should do so directly after JILInitialize() to avoid inconsistencies.
 
 	// fixed memory support
-	JILFixMem*			vmFixMem16;					//!< Pointer to fixed memory manager object for blocks up to 16 byte, or NULL
-	JILFixMem*			vmFixMem32;					//!< Pointer to fixed memory manager object for blocks up to 32 byte, or NULL
-	JILFixMem*			vmFixMem64;					//!< Pointer to fixed memory manager object for blocks up to 64 byte, or NULL
-	JILFixMem*			vmFixMem128;				//!< Pointer to fixed memory manager object for blocks up to 128 byte, or NULL
-	JILFixMem*			vmFixMem256;				//!< Pointer to fixed memory manager object for blocks up to 256 byte, or NULL
-	JILFixMem*			vmFixMem512;				//!< Pointer to fixed memory manager object for blocks up to 512 byte, or NULL
-	JILMemStats*		vmpStats;					//!< Pointer to memory usage statistics (DEBUG only)
+	JILFixMem*			vmFixMem;					//!< Pointer to the fixed memory manager, or NULL
+	JILMemStats*		vmpStats;					//!< Pointer to memory usage statistics, see JILGetMemStats()
 
 	// version info
 	JILVersionInfo		vmVersion;					//!< Contains version information, see JILGetRuntimeVersion()
@@ -56,9 +56,66 @@ enum NTLMessage
 	NTL_GetAuthorName,			//!< Name of the author
 	NTL_GetAuthorString,		//!< Credits, copyright, etc, any length, any purpose allowed
 	NTL_GetDeclString,			//!< Return class declaration string
-	NTL_GetPackageString		//!< (Optional) Return comma seperated list of other classes to import before compiling the class declaration string
+	NTL_GetPackageString,		//!< (Optional) Return comma seperated list of other classes to import before compiling the class declaration string
+	NTL_GetDirectCalls			//!< (Optional) Return a table of functions the VM can call directly, see struct NTLDirectCall
 };
 
+//------------------------------------------------------------------------------
+// Signatures of directly callable functions
+//------------------------------------------------------------------------------
+/// Enumerates the signatures a function in a NTLDirectCall table can have.
+/// The name describes the return type, followed by the argument types. If
+/// NTL_Sig_Member is combined with a signature, the function is a member
+/// function and receives a pointer to the native object as first argument.
+/// For example, a member function declared as "method float scale(const
+/// float)" would be implemented as "JILFloat Scale(JILUnknown* pObj, JILFloat
+/// f)" and have the signature NTL_Sig_Float_Float | NTL_Sig_Member.
+
+enum NTLSignature
+{
+	NTL_Sig_End = -1,				//!< Marks the end of the table
+	NTL_Sig_None = 0,				//!< The function is called through the type proc
+	NTL_Sig_Int_Void,				//!< JILLong f()
+	NTL_Sig_Int_Int,				//!< JILLong f(JILLong)
+	NTL_Sig_Int_IntInt,				//!< JILLong f(JILLong, JILLong)
+	NTL_Sig_Float_Void,				//!< JILFloat f()
+	NTL_Sig_Float_Float,			//!< JILFloat f(JILFloat)
+	NTL_Sig_Float_FloatFloat,		//!< JILFloat f(JILFloat, JILFloat)
+	NTL_Sig_Float_FloatFloatFloat,	//!< JILFloat f(JILFloat, JILFloat, JILFloat)
+
+	NTL_Sig_Member = 0x100			//!< Flag for member functions
+};
+
+//------------------------------------------------------------------------------
+// NTLDirectProc
+//------------------------------------------------------------------------------
+/// Generic function pointer type for the functions in a NTLDirectCall table.
+/// Cast your function to this type when building the table.
+
+typedef void (*NTLDirectProc)(void);
+
+//------------------------------------------------------------------------------
+// struct NTLDirectCall
+//------------------------------------------------------------------------------
+/// Describes a function of a native type that the virtual machine can call
+/// directly, without sending NTL_CallStatic or NTL_CallMember to the type proc.
+/// This saves the message dispatch, and arguments and result are passed as C
+/// values instead of handles, which makes calling small functions much
+/// faster. It is only suitable for functions that cannot fail and that don't
+/// call back into the virtual machine.
+/// <p>In response to NTL_GetDirectCalls, a type proc can return a pointer to an
+/// array of these, where the index into the array is the function index, in
+/// the order of the class declaration. The array must be terminated by an
+/// entry with the signature NTL_Sig_End. Functions that have the signature
+/// NTL_Sig_None, or that are not in the array at all, are called through the
+/// type proc as usual, so the type proc must still handle all functions.</p>
+
+typedef struct NTLDirectCall
+{
+	JILLong			signature;		//!< The function's signature, see enum NTLSignature
+	NTLDirectProc	proc;			//!< Pointer to the function
+} NTLDirectCall;
+
 //------------------------------------------------------------------------------
 // NTLRevisionToLong
 //------------------------------------------------------------------------------
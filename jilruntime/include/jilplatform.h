@@ -165,6 +165,156 @@
 #endif
 #endif
 
+//------------------------------------------------------------------------------
+// JIL_USE_THREADED_DISPATCH
+//------------------------------------------------------------------------------
+/// @def JIL_USE_THREADED_DISPATCH
+/// Enable or disable threaded instruction dispatch in the virtual machine.
+/// By default, the VM dispatches every instruction through a single, big
+/// switch statement. If this is enabled, every instruction procedure jumps
+/// directly to the procedure of the following instruction, which gives the
+/// CPU's branch predictor a better chance. Opcodes are not checked while
+/// dispatching, all code is checked once before it runs instead. On x86-64
+/// with GCC, this makes the benchmark scripts about 2% to 7% faster.
+/// This requires the "labels as values" extension of GCC and Clang. For all
+/// other compilers this option is ignored and the VM falls back to the
+/// portable switch statement.
+
+#ifndef JIL_USE_THREADED_DISPATCH
+#define JIL_USE_THREADED_DISPATCH	0
+#endif
+
+#if JIL_USE_THREADED_DISPATCH && !defined(__GNUC__)
+#undef JIL_USE_THREADED_DISPATCH
+#define JIL_USE_THREADED_DISPATCH	0
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_USE_QUICKENING
+//------------------------------------------------------------------------------
+/// @def JIL_USE_QUICKENING
+/// Enable or disable runtime quickening of generic arithmetic instructions.
+/// The compiler emits generic add, sub, mul, div, mod, inc, dec, neg and
+/// compare instructions when the operand type is not known at compile-time,
+/// for example when using 'var'. If this is enabled, such an instruction
+/// replaces itself in the code segment by the corresponding int or float
+/// instruction once it has seen the same operand type a few times in a row.
+/// Should the operand type change later, the instruction is reverted to its
+/// generic form and will not be quickened again.
+
+#ifndef JIL_USE_QUICKENING
+#define JIL_USE_QUICKENING			1
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_USE_HANDLE_REUSE
+//------------------------------------------------------------------------------
+/// @def JIL_USE_HANDLE_REUSE
+/// Enable or disable reusing int and float handles for results. Registers,
+/// stack slots and object members always refer to handles, so every int or
+/// float result needs a handle. If this is enabled, an instruction that
+/// produces an int or float result writes it into the handle that the target
+/// variable already refers to, as long as no one else references that handle.
+/// Otherwise a new handle is taken for every result.
+
+#ifndef JIL_USE_HANDLE_REUSE
+#define JIL_USE_HANDLE_REUSE		1
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_USE_OPCODE_PROFILING
+//------------------------------------------------------------------------------
+/// @def JIL_USE_OPCODE_PROFILING
+/// Enable or disable opcode pair profiling. If this is enabled, the virtual
+/// machine counts how often each opcode is directly followed by each other
+/// opcode while executing byte-code. The most frequent pairs are written to
+/// the log output when the runtime is terminated, and can be listed at any
+/// time by calling JILListOpcodePairs().
+/// This is a diagnostic tool that helps deciding which instruction sequences
+/// are worth a fused "superinstruction". It slows down execution considerably
+/// and should not be enabled in production builds.
+
+#ifndef JIL_USE_OPCODE_PROFILING
+#define JIL_USE_OPCODE_PROFILING	0
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_USE_INLINE_CACHING
+//------------------------------------------------------------------------------
+/// @def JIL_USE_INLINE_CACHING
+/// Enable or disable inline caching of method and delegate calls. If this is
+/// enabled, the callm and calldg instructions remember the type of the object
+/// they were last called on, together with the resolved code address of the
+/// method. As long as a call site keeps seeing the same type, the v-table
+/// lookup is skipped. The cache is a small table indexed by the address of
+/// the call instruction, so the byte-code format is not affected.
+
+#ifndef JIL_USE_INLINE_CACHING
+#define JIL_USE_INLINE_CACHING		1
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_USE_JIT
+//------------------------------------------------------------------------------
+/// @def JIL_USE_JIT
+/// Enable or disable the just-in-time compiler. If this is enabled, functions
+/// that are called often, or that contain loops which are iterated often, are
+/// translated into x86-64 machine code. The compiler is a simple template JIT:
+/// It translates int and float arithmetic, compares, branches, moves and
+/// copies. All other instructions, as well as instructions whose operands
+/// don't have the expected type, leave the machine code and continue in the
+/// interpreter, which also takes care of calls, exceptions and cofunctions.
+/// The compiler can be disabled at runtime by the runtime option "jit=off".
+/// Compiled code increments the instruction counter just like the interpreter.
+/// It can't count opcode pairs, so the compiler is not available if
+/// JIL_USE_OPCODE_PROFILING is enabled.
+/// This is disabled by default. Only supported on x86-64 Linux with GCC or
+/// Clang, ignored otherwise.
+
+#ifndef JIL_USE_JIT
+#define JIL_USE_JIT					0
+#endif
+
+#if JIL_USE_JIT && (JIL_USE_OPCODE_PROFILING || !(defined(__x86_64__) && defined(__linux__) && defined(__GNUC__)))
+#undef JIL_USE_JIT
+#define JIL_USE_JIT					0
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_USE_INCREMENTAL_GC
+//------------------------------------------------------------------------------
+/// @def JIL_USE_INCREMENTAL_GC
+/// Enable or disable the incremental garbage collector. If this is enabled,
+/// JILCollectGarbageStep() can be used to spread a collection over many small
+/// steps, which are executed at calls and backward branches while byte-code
+/// is running. Every step stops when the budget set by JILSetGCBudget() is
+/// used up. While marking, every reference released by JILRelease() is
+/// shaded (write barrier), which costs a compare on every release.
+/// If this is disabled, JILCollectGarbageStep() performs a full collection.
+
+#ifndef JIL_USE_INCREMENTAL_GC
+#define JIL_USE_INCREMENTAL_GC		1
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_USE_CYCLE_COLLECTOR
+//------------------------------------------------------------------------------
+/// @def JIL_USE_CYCLE_COLLECTOR
+/// Enable or disable the cycle collector. If this is enabled, every object
+/// whose reference count is decremented to a non-zero value is buffered as a
+/// possible root of a reference cycle. JILCollectCycles() then only examines
+/// the objects reachable from these candidates, and frees all cycles among
+/// them that are no longer referenced from outside (trial deletion). When
+/// enough candidates have been buffered, this also happens automatically at
+/// calls and backward branches while byte-code is running. The mark-and-sweep
+/// collector, JILCollectGarbage(), is not affected by this option.
+/// Buffering the candidates makes programs that allocate many objects up to
+/// 30% slower, so this is disabled by default.
+
+#ifndef JIL_USE_CYCLE_COLLECTOR
+#define JIL_USE_CYCLE_COLLECTOR		0
+#endif
+
 //------------------------------------------------------------------------------
 // JIL_TRACE_RELEASE
 //------------------------------------------------------------------------------
@@ -39,7 +39,7 @@
 /// version numbers below is increased due to a change, this version should be
 /// increased as well, in order to reflect this change.
 
-#define JIL_LIBRARY_VERSION			JIL_PRODUCT_VERSION "4.27"
+#define JIL_LIBRARY_VERSION			JIL_PRODUCT_VERSION "4.28"
 
 //------------------------------------------------------------------------------
 // JIL_COMPILER_VERSION
@@ -61,7 +61,17 @@
 /// This is the version number of the native type interface. In your native type,
 /// upon receiving the NTL_GetInterfaceVersion message, convert this string into
 /// an integer value and return it. @see NTLRevisionToLong ()
+/// <p>Version 4.4 changed the layout of the stacks in JILContext, see there.
+/// Native types that return an older version are no longer registered.</p>
 
-#define JIL_TYPE_INTERFACE_VERSION	JIL_PRODUCT_VERSION "4.3"
+#define JIL_TYPE_INTERFACE_VERSION	JIL_PRODUCT_VERSION "4.4"
+
+//------------------------------------------------------------------------------
+// JIL_TYPE_INTERFACE_MIN_VERSION
+//------------------------------------------------------------------------------
+/// This is the oldest version of the native type interface that the runtime
+/// still accepts from a native type.
+
+#define JIL_TYPE_INTERFACE_MIN_VERSION	JIL_PRODUCT_VERSION "4.4"
 
 #endif // JILVERSION_H
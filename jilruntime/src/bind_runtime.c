@@ -17,6 +17,7 @@
 #include "jilcallntl.h"
 #include "jilarray.h"
 #include "jilcodelist.h"
+#include "jilhandle.h"
 
 //-----------------------------------------------------------------------------------
 // function enumeration - this must be kept in sync with the class declaration below.
@@ -48,7 +49,9 @@ enum {
 	fn_printLog,
 	fn_clone,
 	fn_printDebugInfo,
-	fn_disposeObject
+	fn_disposeObject,
+	fn_usedHandles,
+	fn_handleMemory
 };
 
 //--------------------------------------------------------------------------------------------
@@ -83,6 +86,8 @@ static const JILChar* kClassDeclaration =
 	"function var clone (const var o);" TAG("Creates a copy of the given object by calling it's copy constructor. Script objects that have no copy constructor will be copied by the runtime. If a native object has no copy constructor, this function returns null.<p>Special care should be taken if the specified object has references to delegates. While this function will also copy the source object's delegates, these may reference the source object. If that is unwanted, it is recommended to add a copy constructor to the class and initialize these delegates manually. This is especially true for hybrid classes.</p><p>Script objects that inherit base class should also define a copy constructor to ensure the object is initialized properly.</p>")
 	"function printDebugInfo (const var o);" TAG("Outputs information on the given object.")
 	"function int disposeObject (var o);" TAG("Frees all members of the given script object and sets them to null. This can be used to automatically set all member variables of any script object to null. This may help you fix memory leaks due to reference-cycles.<p>You should only call this for objects that aren't needed anymore. Your script should not access any members of the specified object after this function returns, or you'll risk a null-reference exception. Calling this multiple times for the same script object is harmless.</p>If the specified reference is not a script object, the function returns an error. If it was successful, it returns zero.")
+	"function int usedHandles ();" TAG("Returns the number of handles currently in use. Every value, object or other entity the virtual machine processes is represented by a handle.")
+	"function int handleMemory ();" TAG("Returns the number of bytes currently allocated for handles, including unused handles.")
 ;
 
 //------------------------------------------------------------------------------
@@ -368,6 +373,16 @@ static JILError bind_runtime_CallStatic(NTLInstance* pInst, JILLong funcID)
 			NTLFreeHandle(ps, hArg);
 			break;
 		}
+		case fn_usedHandles: // function int usedHandles ()
+		{
+			NTLReturnInt(ps, ps->vmUsedHandles);
+			break;
+		}
+		case fn_handleMemory: // function int handleMemory ()
+		{
+			NTLReturnInt(ps, JILGetHandleMemory(ps));
+			break;
+		}
 		default:
 		{
 			error = JIL_ERR_Invalid_Function_Index;
@@ -53,6 +53,9 @@ void create_JCLLiteral( JCLLiteral* _this )
 	_this->miMethod = JILFalse;
 	_this->mipFile = NULL;
 	_this->mipStack = NEW(Array_JCLVar);
+	_this->mipEnvSource = NEW(Array_JILLong);
+	_this->miEnvBase = 0;
+	_this->miEnvCode = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -64,6 +67,7 @@ void destroy_JCLLiteral( JCLLiteral* _this )
 {
 	DELETE( _this->miString );
 	DELETE( _this->mipStack );
+	DELETE( _this->mipEnvSource );
 }
 
 //------------------------------------------------------------------------------
@@ -83,6 +87,9 @@ void copy_JCLLiteral( JCLLiteral* _this, const JCLLiteral* src )
 	_this->miMethod = src->miMethod;
 	_this->mipFile = src->mipFile;
 	_this->mipStack->Copy(_this->mipStack, src->mipStack);
+	_this->mipEnvSource->Copy(_this->mipEnvSource, src->mipEnvSource);
+	_this->miEnvBase = src->miEnvBase;
+	_this->miEnvCode = src->miEnvCode;
 }
 
 /******************************************************************************/
@@ -274,6 +281,7 @@ void create_JCLFunc( JCLFunc* _this )
 	_this->miNaked = JILFalse;
 	_this->miOptLevel = 0;
 	_this->mipParentStack = NULL;
+	_this->miParentStackPos = 0;
 	_this->mipCode->grain = 1024;
 
 	for( i = 0; i < kNumRegisters; i++ )
@@ -336,6 +344,7 @@ void copy_JCLFunc(JCLFunc* _this, const JCLFunc* src)
 	_this->miLinked = src->miLinked;
 	_this->miNaked = src->miNaked;
 	_this->mipParentStack = src->mipParentStack;
+	_this->miParentStackPos = src->miParentStackPos;
 	for( i = 0; i < kNumRegisters; i++ )
 		_this->miRegUsage[i] = src->miRegUsage[i];
 }
@@ -43,6 +43,9 @@ DECL_CLASS(JCLLiteral)
 	JILBool				miMethod;	//!< anonymous delegate is method or closure
 	struct JCLFile*		mipFile;	//!< source file (for anonymous delegates)
 	Array_JCLVar*		mipStack;	//!< stack context in case of closure
+	Array_JILLong*		mipEnvSource;	//!< for each var in mipStack, its stack index at the literal, or -1 - index in the enclosing closure's parent stack
+	JILLong				miEnvBase;	//!< stack index of the enclosing closure's parent stack at the literal
+	JILLong				miEnvCode;	//!< offset in byte code of the code that pushes the closure's environment
 
 END_CLASS( JCLLiteral )
 
@@ -92,6 +95,7 @@ DECL_CLASS( JCLFunc )
 	Array_JILLong*		mipCode;		// buffer to compile code to
 	Array_JCLLiteral*	mipLiterals;	// literals
 	Array_JCLVar*		mipParentStack;	// parent stack in case of closure
+	JILLong				miParentStackPos;	// position of the parent stack on the simulated stack in case of closure
 	JILLong				miRegUsage[kNumRegisters];	// counts how often regs were allocated in function
 
 END_CLASS( JCLFunc )
@@ -657,6 +657,32 @@ static JILBool GetBranchAddr(CodeBlock* _this, JILLong addr, JILLong* outAddr)
 			offs = _this->array[addr + 3];
 			res = JILTrue;
 			break;
+		case op_cseqlb_rr:
+		case op_cseqlb_rs:
+		case op_cseqlb_sr:
+		case op_csnelb_rr:
+		case op_csnelb_rs:
+		case op_csnelb_sr:
+		case op_csgtlb_rr:
+		case op_csgtlb_rs:
+		case op_csgtlb_sr:
+		case op_csgelb_rr:
+		case op_csgelb_rs:
+		case op_csgelb_sr:
+		case op_csltlb_rr:
+		case op_csltlb_rs:
+		case op_csltlb_sr:
+		case op_cslelb_rr:
+		case op_cslelb_rs:
+		case op_cslelb_sr:
+			offs = _this->array[addr + 4];
+			res = JILTrue;
+			break;
+		case op_inclb_r:
+		case op_inclb_s:
+			offs = _this->array[addr + 2];
+			res = JILTrue;
+			break;
 		default:
 			offs = 0;
 			res = JILFalse;
@@ -694,6 +720,32 @@ static JILBool SetBranchAddr(CodeBlock* _this, JILLong addr, JILLong newAddr)
 			_this->array[addr + 3] = offs;
 			res = JILTrue;
 			break;
+		case op_cseqlb_rr:
+		case op_cseqlb_rs:
+		case op_cseqlb_sr:
+		case op_csnelb_rr:
+		case op_csnelb_rs:
+		case op_csnelb_sr:
+		case op_csgtlb_rr:
+		case op_csgtlb_rs:
+		case op_csgtlb_sr:
+		case op_csgelb_rr:
+		case op_csgelb_rs:
+		case op_csgelb_sr:
+		case op_csltlb_rr:
+		case op_csltlb_rs:
+		case op_csltlb_sr:
+		case op_cslelb_rr:
+		case op_cslelb_rs:
+		case op_cslelb_sr:
+			_this->array[addr + 4] = offs;
+			res = JILTrue;
+			break;
+		case op_inclb_r:
+		case op_inclb_s:
+			_this->array[addr + 2] = offs;
+			res = JILTrue;
+			break;
 		default:
 			res = JILFalse;
 			break;
@@ -1366,6 +1418,24 @@ static JILBool GetInstructionInitRegister(CodeBlock* _this, JILLong addr, JILLon
 		case op_strne_rs:
 		case op_cmpref_rr:
 		case op_dcvt:
+		case op_cseqlb_rr:
+		case op_cseqlb_rs:
+		case op_cseqlb_sr:
+		case op_csnelb_rr:
+		case op_csnelb_rs:
+		case op_csnelb_sr:
+		case op_csgtlb_rr:
+		case op_csgtlb_rs:
+		case op_csgtlb_sr:
+		case op_csgelb_rr:
+		case op_csgelb_rs:
+		case op_csgelb_sr:
+		case op_csltlb_rr:
+		case op_csltlb_rs:
+		case op_csltlb_sr:
+		case op_cslelb_rr:
+		case op_cslelb_rs:
+		case op_cslelb_sr:
 			*regNum = _this->array[addr + 3];
 			return JILTrue;
 		case op_cseq_rd:
@@ -1640,6 +1710,7 @@ static JILBool GetStackModifier(CodeBlock* _this, JILLong addr, JILLong* count)
 		case op_push_d:
 		case op_push_x:
 		case op_push_s:
+		case op_pushh:
 			*count = 1;
 			return JILTrue;
 		case op_pop:
@@ -1661,6 +1732,9 @@ static JILBool GetStackModifier(CodeBlock* _this, JILLong addr, JILLong* count)
 		case op_popr:
 			*count = - _this->array[addr + 2];
 			return JILTrue;
+		case op_tail:
+			*count = - _this->array[addr + 1];
+			return JILTrue;
 	}
 	return JILFalse;
 }
@@ -1831,6 +1905,32 @@ static JILBool IsBranchInstruction(CodeBlock* _this, JILLong addr, JILLong* offs
 			*isCond = JILTrue;
 			*offset = _this->array[addr + 3];
 			return JILTrue;
+		case op_cseqlb_rr:
+		case op_cseqlb_rs:
+		case op_cseqlb_sr:
+		case op_csnelb_rr:
+		case op_csnelb_rs:
+		case op_csnelb_sr:
+		case op_csgtlb_rr:
+		case op_csgtlb_rs:
+		case op_csgtlb_sr:
+		case op_csgelb_rr:
+		case op_csgelb_rs:
+		case op_csgelb_sr:
+		case op_csltlb_rr:
+		case op_csltlb_rs:
+		case op_csltlb_sr:
+		case op_cslelb_rr:
+		case op_cslelb_rs:
+		case op_cslelb_sr:
+			*isCond = JILTrue;
+			*offset = _this->array[addr + 4];
+			return JILTrue;
+		case op_inclb_r:
+		case op_inclb_s:
+			*isCond = JILFalse;
+			*offset = _this->array[addr + 2];
+			return JILTrue;
 	}
 	return JILFalse;
 }
@@ -1884,11 +1984,6 @@ static void FixStackOffsetsInBranch(CodeBlock* _this, JILLong addr, JILLong stop
 			}
 			subAddr += JILGetOperandSize(instrInfo->opType[i]);
 		}
-		// special case closure
-		if( opcode == op_newdgc )
-		{
-			_this->array[opaddr + 2] += fixup;
-		}
 		// take into account push/pop and branches
 		if( GetStackModifier(_this, opaddr, &modiAmount) )
 		{
@@ -2834,6 +2929,284 @@ static JILError createLiterals_JCLFunc(JCLFunc* _this, JCLState* pCompiler)
 	return err;
 }
 
+//------------------------------------------------------------------------------
+// IsSameResult
+//------------------------------------------------------------------------------
+// Checks if two functions return the same type, so that the result of one can
+// be returned by the other without copying or converting it.
+
+static JILBool IsSameResult(const JCLVar* pRes1, const JCLVar* pRes2)
+{
+	return (pRes1->miMode == pRes2->miMode &&
+		pRes1->miType == pRes2->miType &&
+		pRes1->miConst == pRes2->miConst &&
+		pRes1->miRef == pRes2->miRef &&
+		pRes1->miWeak == pRes2->miWeak &&
+		pRes1->miElemType == pRes2->miElemType &&
+		pRes1->miElemRef == pRes2->miElemRef);
+}
+
+//------------------------------------------------------------------------------
+// OptimizeTailCalls
+//------------------------------------------------------------------------------
+// Replaces a call in tail position by a jump into the called function, which
+// then reuses the stack frame of the current function instead of pushing a
+// return address. Both functions must take the same number of arguments.
+// Example:
+//		calls	ack						tail	2, 1
+//		popm	2						pop		r3
+//		copy	r1, r1				->	jmp		ack
+//		pop		r3
+//		ret
+// The 'tail' instruction replaces the arguments of the current function by
+// the arguments on top of the stack. The instructions following the call must
+// not be branch targets and may only pop the stack frame of the current
+// function. Copying the result is only omitted if both functions return the
+// same type.
+
+static JILError OptimizeTailCalls(JCLFunc* pFunc, JCLState* pCompiler, OptimizeReport* pReport)
+{
+	JILError err = JCL_No_Error;
+	JILLong opaddr;
+	JILLong opsize;
+	JILLong addr;
+	JILLong opcode;
+	JILLong numArgs;
+	JILLong numFrame;
+	JILLong numInstr;
+	JILLong toPop;
+	JILLong count;
+	JILLong n;
+	JILLong buffer[32];
+	JILBool bCopy;
+	JILBool bValid;
+	JILBool bSuccess = JILFalse;
+	JILFuncInfo* pFuncInfo;
+	JCLFunc* pCallee;
+	CodeBlock* _this = pFunc->mipCode;
+
+	pReport->totalPasses++;
+	if( pFunc->miCofunc || pFunc->miNaked )
+		return err;
+	numArgs = pFunc->mipArgs->Count(pFunc->mipArgs);
+	for( opaddr = 0; opaddr < _this->count; opaddr += opsize )
+	{
+		opsize = JILGetInstructionSize(_this->array[opaddr]);
+		if( _this->array[opaddr] != op_calls )
+			continue;
+		pFuncInfo = JILGetFunctionInfo(pCompiler->mipMachine, _this->array[opaddr + 1]);
+		if( pFuncInfo == NULL )
+			continue;
+		pCallee = GetFunc(pCompiler, pFuncInfo->type, pFuncInfo->memberIdx);
+		if( pCallee->miCofunc || pCallee->mipArgs->Count(pCallee->mipArgs) != numArgs )
+			continue;
+		// the new code starts with the 'tail' instruction, the stack frame size is filled in later
+		n = 0;
+		if( numArgs )
+		{
+			buffer[n++] = op_tail;
+			buffer[n++] = numArgs;
+			buffer[n++] = 0;
+		}
+		numFrame = 0;
+		numInstr = 1;
+		toPop = numArgs;
+		bCopy = JILFalse;
+		bValid = JILFalse;
+		for( addr = opaddr + opsize; addr < _this->count && n < 27; addr += JILGetInstructionSize(opcode) )
+		{
+			opcode = _this->array[addr];
+			if( IsAddrBranchTarget(_this, addr) )
+				break;
+			numInstr++;
+			if( opcode == op_ret )
+			{
+				bValid = (toPop == 0);
+				break;
+			}
+			else if( (opcode == op_move_rr || opcode == op_copy_rr) &&
+				_this->array[addr + 1] == kReturnRegister && _this->array[addr + 2] == kReturnRegister )
+			{
+				bCopy |= (opcode == op_copy_rr);
+			}
+			else if( IsPopAndForget(_this, addr, &count) )
+			{
+				// the first handles popped are the arguments of the call
+				if( toPop )
+				{
+					JILLong num = (count < toPop) ? count : toPop;
+					toPop -= num;
+					count -= num;
+				}
+				if( count == 1 )
+				{
+					buffer[n++] = op_pop;
+				}
+				else if( count > 1 )
+				{
+					buffer[n++] = op_popm;
+					buffer[n++] = count;
+				}
+				numFrame += count;
+			}
+			else if( (opcode == op_pop_r || opcode == op_popr) && !toPop && _this->array[addr + 1] > 2 )
+			{
+				// restoring a saved register, but r0 must remain untouched
+				count = (opcode == op_pop_r) ? 1 : _this->array[addr + 2];
+				memcpy(buffer + n, _this->array + addr, JILGetInstructionSize(opcode) * sizeof(JILLong));
+				n += JILGetInstructionSize(opcode);
+				numFrame += count;
+			}
+			else
+			{
+				break;
+			}
+		}
+		if( !bValid || (bCopy && !IsSameResult(pFunc->mipResult, pCallee->mipResult)) )
+			continue;
+		if( numArgs )
+			buffer[2] = numFrame;
+		buffer[n++] = op_jmp;
+		buffer[n++] = _this->array[opaddr + 1];
+		ReplaceCode(_this, opaddr, addr + 1 - opaddr, n);
+		memcpy(_this->array + opaddr, buffer, n * sizeof(JILLong));
+		opsize = n;
+		pReport->instr_removed += numInstr;
+		for( addr = opaddr; addr < opaddr + n; addr += JILGetInstructionSize(_this->array[addr]) )
+			pReport->instr_added++;
+		bSuccess = JILTrue;
+	}
+	if( bSuccess )
+		pReport->numPasses++;
+	return err;
+}
+
+//------------------------------------------------------------------------------
+// CompareToCompareAndBranch
+//------------------------------------------------------------------------------
+// Returns the compare-and-branch superinstruction for the given long compare
+// instruction, or 0 if there is none.
+
+static JILLong CompareToCompareAndBranch(JILLong opcode)
+{
+	switch( opcode )
+	{
+		case op_cseql_rr:  return op_cseqlb_rr;
+		case op_cseql_rs:  return op_cseqlb_rs;
+		case op_cseql_sr:  return op_cseqlb_sr;
+		case op_csnel_rr:  return op_csnelb_rr;
+		case op_csnel_rs:  return op_csnelb_rs;
+		case op_csnel_sr:  return op_csnelb_sr;
+		case op_csgtl_rr:  return op_csgtlb_rr;
+		case op_csgtl_rs:  return op_csgtlb_rs;
+		case op_csgtl_sr:  return op_csgtlb_sr;
+		case op_csgel_rr:  return op_csgelb_rr;
+		case op_csgel_rs:  return op_csgelb_rs;
+		case op_csgel_sr:  return op_csgelb_sr;
+		case op_csltl_rr:  return op_csltlb_rr;
+		case op_csltl_rs:  return op_csltlb_rs;
+		case op_csltl_sr:  return op_csltlb_sr;
+		case op_cslel_rr:  return op_cslelb_rr;
+		case op_cslel_rs:  return op_cslelb_rs;
+		case op_cslel_sr:  return op_cslelb_sr;
+	}
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+// OptimizeSuperInstructions
+//------------------------------------------------------------------------------
+// Replaces pairs of instructions that are frequently executed one after another
+// by a single instruction that does the work of both, saving one dispatch.
+// These are:
+//		csltl	r4, r3, r3				csltl.b	r4, r3, r3, label
+//		tsteq	r3, label			->
+//
+//		incl	(sp+2)					incl.b	(sp+2), label
+//		bra		label				->
+//
+//		push							pushh	72
+//		moveh	72, (sp+0)			->
+// The second instruction of a pair must not be a branch target. This should
+// be the last optimization, since the other optimizations don't know about
+// superinstructions.
+
+static JILError OptimizeSuperInstructions(JCLFunc* pFunc, OptimizeReport* pReport)
+{
+	JILError err = JCL_No_Error;
+	JILLong opaddr;
+	JILLong opsize;
+	JILLong opaddr2;
+	JILLong opsize2;
+	JILLong opcode;
+	JILLong opcode2;
+	JILLong newOpcode;
+	JILLong branchAddr;
+	JILLong buffer[8];
+	JILBool bSuccess = JILFalse;
+	CodeBlock* _this = pFunc->mipCode;
+
+	pReport->totalPasses++;
+	for( opaddr = 0; opaddr < _this->count; opaddr += opsize )
+	{
+		opcode = _this->array[opaddr];
+		opsize = JILGetInstructionSize(opcode);
+		opaddr2 = opaddr + opsize;
+		if( opaddr2 >= _this->count )
+			break;
+		opcode2 = _this->array[opaddr2];
+		opsize2 = JILGetInstructionSize(opcode2);
+		newOpcode = 0;
+		if( opcode2 == op_tsteq_r )
+		{
+			// the tested register must be the result of the compare
+			newOpcode = CompareToCompareAndBranch(opcode);
+			if( newOpcode && _this->array[opaddr2 + 1] != _this->array[opaddr + 3] )
+				newOpcode = 0;
+		}
+		else if( opcode2 == op_bra && (opcode == op_incl_r || opcode == op_incl_s) )
+		{
+			newOpcode = (opcode == op_incl_r) ? op_inclb_r : op_inclb_s;
+		}
+		else if( opcode == op_push && opcode2 == op_moveh_s && _this->array[opaddr2 + 2] == 0 )
+		{
+			newOpcode = op_pushh;
+		}
+		if( !newOpcode || IsAddrBranchTarget(_this, opaddr2) )
+			continue;
+		if( newOpcode == op_pushh )
+		{
+			buffer[0] = op_pushh;
+			buffer[1] = _this->array[opaddr2 + 1];
+			ReplaceCode(_this, opaddr, opsize + opsize2, 2);
+			memcpy(_this->array + opaddr, buffer, 2 * sizeof(JILLong));
+			opsize = 2;
+		}
+		else
+		{
+			// don't fuse a branch to itself
+			GetBranchAddr(_this, opaddr2, &branchAddr);
+			if( branchAddr > opaddr && branchAddr < opaddr2 + opsize2 )
+				continue;
+			// the branch offset becomes the last operand of the new instruction
+			memcpy(buffer, _this->array + opaddr, opsize * sizeof(JILLong));
+			buffer[0] = newOpcode;
+			ReplaceCode(_this, opaddr, opsize + opsize2, opsize + 1);
+			if( branchAddr > opaddr )
+				branchAddr -= opsize2 - 1;
+			buffer[opsize] = branchAddr - opaddr;
+			memcpy(_this->array + opaddr, buffer, (opsize + 1) * sizeof(JILLong));
+			opsize++;
+		}
+		pReport->instr_added++;
+		pReport->instr_removed += 2;
+		bSuccess = JILTrue;
+	}
+	if( bSuccess )
+		pReport->numPasses++;
+	return err;
+}
+
 //------------------------------------------------------------------------------
 // JCLFunc::OptimizeCode
 //------------------------------------------------------------------------------
@@ -2898,6 +3271,16 @@ static JILError optimizeCode_JCLFunc(JCLFunc* _this, JCLState* pCompiler)
 			}
 		}
 
+		// replace calls in tail position by jumps
+		err = OptimizeTailCalls(_this, pCompiler, &report);
+		if( err )
+			goto exit;
+
+		// combine frequent instruction pairs (MUST be last!)
+		err = OptimizeSuperInstructions(_this, &report);
+		if( err )
+			goto exit;
+
 		report.count_after = _this->mipCode->count;
 		if( (report.instr_removed - report.instr_added) ||
 			(report.count_before != report.count_after) )
@@ -196,6 +196,8 @@ static JCLVar*		SimRegisterGet		(JCLState*, JILLong);
 static JILError		MakeLocalVar		(JCLState*, Array_JCLVar*, JILLong, const JCLVar*);
 static void			FreeLocalVars		(JCLState*, Array_JCLVar*);
 static JCLVar*		FindLocalVar		(JCLState*, const JCLString*);
+static JCLVar*		BindParentVar		(JCLState*, const JCLString*);
+static JILLong		GetNumCapturedVars	(const Array_JCLVar*);
 static JCLVar*		FindFuncArg			(JCLState*, const JCLString*);
 static JILError		MakeTempVar			(JCLState*, JCLVar**, const JCLVar*);
 static JILError		MakeTempArrayVar	(JCLState*, JCLVar**, JCLVar*);
@@ -357,7 +359,8 @@ static JILError		cg_convert_to_type	(JCLState*, JCLVar*, JILLong);
 static JILError		cg_convert_compare	(JCLState*, JCLVar*, JCLVar*);
 static JILError		cg_convert_calc		(JCLState*, JCLVar*, JCLVar*);
 static JILError		cg_new_delegate		(JCLState*, JILLong, JCLVar*, JCLVar*);
-static JILError		cg_new_closure		(JCLState*, JILLong, JILLong, JCLVar*, JCLVar*);
+static JILError		cg_new_closure		(JCLState*, JILLong, JILLong, JCLVar*, JCLVar*, JILLong*, JILLong*);
+static void			cg_closure_env		(JCLState*, JCLFunc*, JCLLiteral*);
 static JILError		cg_call_delegate	(JCLState*, JCLVar*);
 
 //------------------------------------------------------------------------------
@@ -1694,6 +1697,42 @@ static JCLVar* FindLocalVar(JCLState* _this, const JCLString* pName)
 			return pVar;
 	}
 
+	// in case of closure, capture a variable of the parent function
+	return BindParentVar(_this, pName);
+}
+
+//------------------------------------------------------------------------------
+// BindParentVar
+//------------------------------------------------------------------------------
+// When compiling a closure, searches the variables of the parent function that
+// have not been captured yet. The first one found is captured: It gets the next
+// position in the closure's environment and is placed into the parent stack
+// area of the simulated stack. Returns NULL if there is no such variable.
+
+static JCLVar* BindParentVar(JCLState* _this, const JCLString* pName)
+{
+	int i;
+	JILLong pos;
+	JCLVar* pVar;
+	JCLFunc* pFunc = CurrentFunc(_this);
+	Array_JCLVar* pParent = pFunc->mipParentStack;
+
+	if( !pParent )
+		return NULL;
+	for( i = 0; i < pParent->Count(pParent); i++ )
+	{
+		pVar = pParent->Get(pParent, i);
+		if( pVar->miEnvIndex < 0 && !pVar->miHidden && JCLCompare(pVar->mipName, pName) )
+		{
+			pVar->miEnvIndex = GetNumCapturedVars(pParent);
+			pos = pFunc->miParentStackPos + pVar->miEnvIndex;
+			pVar->miIndex = pos - _this->miStackPos;
+			pVar->miMode = kModeStack;
+			pVar->miOnStack = JILTrue;
+			_this->mipStack[pos] = pVar;
+			return pVar;
+		}
+	}
 	return NULL;
 }
 
@@ -2051,6 +2090,24 @@ static JILLong GetParentStackSize(JCLState* _this)
 		return 0;
 }
 
+//------------------------------------------------------------------------------
+// GetNumCapturedVars
+//------------------------------------------------------------------------------
+// Returns the number of variables in the given parent stack of a closure that
+// have been captured so far, see BindParentVar().
+
+static JILLong GetNumCapturedVars(const Array_JCLVar* pParent)
+{
+	JILLong i;
+	JILLong n = 0;
+	for( i = 0; i < pParent->Count(pParent); i++ )
+	{
+		if( pParent->Get(pParent, i)->miEnvIndex >= 0 )
+			n++;
+	}
+	return n;
+}
+
 //------------------------------------------------------------------------------
 // IsFuncInGlobalScope
 //------------------------------------------------------------------------------
@@ -5822,13 +5879,9 @@ static JILError p_function_pass(JCLState* _this)
 	pFunc = CurrentFunc(_this);
 	pFunc->miRetFlag = JILFalse;
 	pFunc->miYieldFlag = JILFalse;
-	// in case of closure push parent stack onto simulated stack
-	if( pFunc->mipParentStack )
-	{
-		pArgs = pFunc->mipParentStack;
-		for( i = pArgs->Count(pArgs) - 1; i >= 0; i-- )
-			_this->mipStack[-- _this->miStackPos] = pArgs->Get(pArgs, i); // we cannot use SimStackPush() for this!
-	}
+	// in case of closure reserve space for the parent stack, variables are placed there when captured
+	_this->miStackPos -= GetParentStackSize(_this); // we cannot use SimStackPush() for this!
+	pFunc->miParentStackPos = _this->miStackPos;
 	// push arguments in reverse order onto simulated stack
 	pArgs = pFunc->mipArgs;
 	for( i = pArgs->Count(pArgs) - 1; i >= 0; i-- )
@@ -5973,7 +6026,8 @@ static JILError p_function_pass(JCLState* _this)
 		}
 	}
 	// pop parent stack from simulated stack (we cannot use SimStackPop() for this)
-	_this->miStackPos += GetParentStackSize(_this);
+	for( i = 0; i < GetParentStackSize(_this); i++ )
+		_this->mipStack[_this->miStackPos++] = NULL;
 
 exit:
 	DELETE( pToken2 );
@@ -5989,7 +6043,7 @@ exit:
 static JILError p_sub_functions(JCLState* _this)
 {
 	JILError err = JCL_No_Error;
-	JILLong i, j, n;
+	JILLong i, j;
 	JILLong funcIdx;
 	JILLong savePos;
 	JCLFunc* pCurrentFunc;
@@ -6003,8 +6057,6 @@ static JILError p_sub_functions(JCLState* _this)
 	Array_JCLLiteral* pLiterals;
 	JCLString* pToken;
 	JILLong tokenID;
-	JILLong numRegsToSave;
-	JILLong numParentArgs;
 
 	// if we don't have an init function yet, bail
 	if( _this->miPass == kPassPrecompile || NumFuncs(_this, type_global) == 0 )
@@ -6017,8 +6069,6 @@ static JILError p_sub_functions(JCLState* _this)
 	pCurrentFunc = CurrentOutFunc(_this);
 	pLiterals = pCurrentFunc->mipLiterals;
 	savePos = pOldFile->GetLocator(pOldFile);
-	numRegsToSave = GetNumRegsToSave(pCurrentFunc);
-	numParentArgs = pCurrentFunc->mipArgs->Count(pCurrentFunc->mipArgs);
 
 	for( i = 0; i < pLiterals->Count(pLiterals); i++ )
 	{
@@ -6080,13 +6130,10 @@ static JILError p_sub_functions(JCLState* _this)
 			{
 				pFile->SetLocator(pFile, pLit->miLocator);
 			}
-			// process parent stack variables
-			n = pLit->mipStack->Count(pLit->mipStack) - numParentArgs;
+			// parent stack variables are captured when the new function uses them
 			for( j = 0; j < pLit->mipStack->Count(pLit->mipStack); j++ )
 			{
 				JCLVar* pVar = pLit->mipStack->Get(pLit->mipStack, j);
-				if( j >= n )
-					pVar->miIndex += numRegsToSave;
 				pVar->miParentStack = JILTrue;
 			}
 			// now compile to the new function
@@ -6096,6 +6143,8 @@ static JILError p_sub_functions(JCLState* _this)
 			CurrentFunc(_this)->mipParentStack = NULL;
 			if( err )
 				goto exit;
+			// generate the code that passes the captured variables to the closure
+			cg_closure_env(_this, pCurrentFunc, pLit);
 		}
 	}
 
@@ -14053,16 +14102,22 @@ exit:
 //------------------------------------------------------------------------------
 // Load a function literal into a delegate variable. If pObj is NULL, creates a
 // function delegate, else creates a method delegate for pObj's type.
+// All variables the literal could refer to are stored with it. The closure
+// will only capture those its code actually uses, see cg_closure_env().
 
 static JILError cg_load_func_literal(JCLState* _this, JILLong codeLocator, JCLVar* pLVar, JCLVar** ppVarOut, JCLVar** ppTempVar, JCLVar* pObj)
 {
 	JILError err = JCL_No_Error;
 	JILLong codePos;
+	JILLong envPos;
 	JCLLiteral* pLit;
 	JCLVar* pWorkVar;
+	JCLVar* pSrc;
+	JCLVar* pDst;
 	JCLFunc* pFunc;
+	Array_JCLVar* pParent;
 	JILLong i;
-	JILLong sp;
+	JILLong numEnv = 0;
 
 	if( TypeFamily(_this, pLVar->miType) != tf_delegate )
 	{
@@ -14083,10 +14138,23 @@ static JILError cg_load_func_literal(JCLState* _this, JILLong codeLocator, JCLVa
 		pWorkVar = *ppTempVar;
 	}
 
+	// count the variables the literal could capture
+	pParent = CurrentFunc(_this)->mipParentStack;
+	for( i = 0; i < (kSimStackSize - _this->miStackPos); i++ )
+	{
+		pSrc = SimStackGet(_this, i);
+		if( pSrc && !pSrc->miHidden && JCLGetLength(pSrc->mipName) )
+			numEnv++;
+	}
+	for( i = 0; pParent && i < pParent->Count(pParent); i++ )
+	{
+		pSrc = pParent->Get(pParent, i);
+		if( pSrc->miEnvIndex < 0 && !pSrc->miHidden )
+			numEnv++;
+	}
+
 	// create function delegate
-	sp = kSimStackSize - _this->miStackPos;
-	codePos = GetCodeLocator(_this) + 3;
-	err = cg_new_closure(_this, sp, 0, pObj, pWorkVar);
+	err = cg_new_closure(_this, numEnv, 0, pObj, pWorkVar, &codePos, &envPos);
 	if( err )
 		goto exit;
 
@@ -14098,14 +14166,30 @@ static JILError cg_load_func_literal(JCLState* _this, JILLong codeLocator, JCLVa
 	pLit->miLocator = codeLocator;
 	pLit->miMethod = (pObj != NULL);
 	pLit->mipFile = _this->mipFile;
+	pLit->miEnvCode = envPos;
+	pLit->miEnvBase = CurrentFunc(_this)->miParentStackPos - _this->miStackPos;
 
-	for( i = 0; i < sp; i++ )
+	// variables on the stack, in the same search order as FindLocalVar()
+	for( i = 0; i < (kSimStackSize - _this->miStackPos); i++ )
 	{
-		JCLVar* pSrc = _this->mipStack[_this->miStackPos + i];
-		JCLVar* pDst = pLit->mipStack->New(pLit->mipStack);
-		if( pSrc == NULL )
-			pSrc = _this->mipNull;
-		pDst->Copy(pDst, pSrc);
+		pSrc = SimStackGet(_this, i);
+		if( pSrc && !pSrc->miHidden && JCLGetLength(pSrc->mipName) )
+		{
+			pDst = pLit->mipStack->New(pLit->mipStack);
+			pDst->Copy(pDst, pSrc);
+			pLit->mipEnvSource->Add(pLit->mipEnvSource, i);
+		}
+	}
+	// variables of the parent function, if we are in a closure ourselves
+	for( i = 0; pParent && i < pParent->Count(pParent); i++ )
+	{
+		pSrc = pParent->Get(pParent, i);
+		if( pSrc->miEnvIndex < 0 && !pSrc->miHidden )
+		{
+			pDst = pLit->mipStack->New(pLit->mipStack);
+			pDst->Copy(pDst, pSrc);
+			pLit->mipEnvSource->Add(pLit->mipEnvSource, -1 - i);
+		}
 	}
 
 exit:
@@ -17415,13 +17499,19 @@ exit:
 //------------------------------------------------------------------------------
 // cg_new_closure
 //------------------------------------------------------------------------------
+// Create a closure. Which variables it captures is not known until the closure
+// has been compiled, so this reserves space for pushing up to envSize variables
+// and creates a closure with an empty environment. Returns the code address of
+// the function handle operand in pHandlePos and the code address of the space
+// reserved in pEnvPos. See cg_closure_env().
 
-static JILError cg_new_closure(JCLState* _this, JILLong stackSize, JILLong hFunction, JCLVar* pObj, JCLVar* pDst)
+static JILError cg_new_closure(JCLState* _this, JILLong envSize, JILLong hFunction, JCLVar* pObj, JCLVar* pDst, JILLong* pHandlePos, JILLong* pEnvPos)
 {
 	JILError err = JCL_No_Error;
 	JCLVar* pTmpObj = NULL;
 	JCLVar* pTmpDst = NULL;
 	JCLVar* pNewDst = pDst;
+	JILLong i;
 
 	err = cg_dst_assign_rule(_this, pDst);
 	if( err )
@@ -17453,11 +17543,25 @@ static JILError cg_new_closure(JCLState* _this, JILLong stackSize, JILLong hFunc
 			goto exit;
 		pNewDst = pTmpDst;
 	}
+	*pEnvPos = GetCodeLocator(_this);
+	if( envSize )
+	{
+		cg_opcode(_this, op_bra);
+		cg_opcode(_this, 2 + envSize * 2);
+		for( i = 0; i < envSize * 2; i++ )
+			cg_opcode(_this, op_nop);
+	}
+	*pHandlePos = GetCodeLocator(_this) + 3;
 	cg_opcode(_this, op_newdgc);
 	cg_opcode(_this, pNewDst->miType);
-	cg_opcode(_this, stackSize);
+	cg_opcode(_this, 0);
 	cg_opcode(_this, hFunction);
 	cg_opcode(_this, pNewDst->miIndex);
+	if( envSize )
+	{
+		cg_opcode(_this, op_popm);
+		cg_opcode(_this, 0);
+	}
 	if( pNewDst != pDst )
 	{
 		err = cg_move_var(_this, pNewDst, pDst);
@@ -17472,6 +17576,60 @@ exit:
 	return err;
 }
 
+//------------------------------------------------------------------------------
+// cg_closure_env
+//------------------------------------------------------------------------------
+// Called after the closure of a function literal has been compiled. Fills the
+// space reserved by cg_new_closure() with code that pushes the variables the
+// closure has captured, in reverse order, so that the closure copies them into
+// its environment in the order captured. A variable captured from the parent
+// stack of pParent, if pParent is a closure itself, gets captured by pParent.
+
+static void cg_closure_env(JCLState* _this, JCLFunc* pParent, JCLLiteral* pLit)
+{
+	JILLong i, j;
+	JILLong pos;
+	JILLong src;
+	JCLVar* pVar;
+	Array_JILLong* pCode = pParent->mipCode;
+	Array_JCLVar* pStack = pLit->mipStack;
+	JILLong envSize = pStack->Count(pStack);
+	JILLong numCaptured = GetNumCapturedVars(pStack);
+	JILLong codePos = pLit->miEnvCode + 2 + (envSize - numCaptured) * 2;
+
+	if( envSize == 0 )
+		return;
+	// branch over the unused space
+	pCode->Set(pCode, pLit->miEnvCode + 1, 2 + (envSize - numCaptured) * 2);
+	// push captured variables, last one first
+	for( i = numCaptured - 1; i >= 0; i-- )
+	{
+		for( j = 0; j < envSize; j++ )
+		{
+			pVar = pStack->Get(pStack, j);
+			if( pVar->miEnvIndex == i )
+				break;
+		}
+		src = pLit->mipEnvSource->Get(pLit->mipEnvSource, j);
+		if( src >= 0 )
+		{
+			pos = src;
+		}
+		else
+		{
+			pVar = pParent->mipParentStack->Get(pParent->mipParentStack, -1 - src);
+			if( pVar->miEnvIndex < 0 )
+				pVar->miEnvIndex = GetNumCapturedVars(pParent->mipParentStack);
+			pos = pLit->miEnvBase + pVar->miEnvIndex;
+		}
+		pCode->Set(pCode, codePos++, op_push_s);
+		pCode->Set(pCode, codePos++, pos + (numCaptured - 1 - i));
+	}
+	// environment size of newdgc and number of handles to pop
+	pCode->Set(pCode, pLit->miOffset - 1, numCaptured);
+	pCode->Set(pCode, pLit->miOffset + 3, numCaptured);
+}
+
 //------------------------------------------------------------------------------
 // cg_call_delegate
 //------------------------------------------------------------------------------
@@ -65,6 +65,7 @@ void create_JCLVar( JCLVar* _this )
 	_this->miConstP = JILFalse;
 	_this->miOnStack = JILFalse;
 	_this->miParentStack = JILFalse;
+	_this->miEnvIndex = -1;
 	_this->miTypeCast = JILFalse;
 	_this->miHidden = JILFalse;
 	_this->miNonVT = JILFalse;
@@ -114,6 +115,7 @@ void copy_JCLVar(JCLVar* _this, const JCLVar* src)
 
 	_this->miOnStack = JILFalse;
 	_this->miParentStack = JILFalse;
+	_this->miEnvIndex = -1;
 	_this->mipArrIdx = NULL;
 }
 
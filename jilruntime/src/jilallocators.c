@@ -58,6 +58,141 @@ JILHandle** JILAllocObjectNoInit(JILState* pState, JILLong instSize)
 	return (JILHandle**) pState->vmMalloc( pState, instSize * sizeof(JILHandle*) );
 }
 
+//------------------------------------------------------------------------------
+// JILAllocInstance
+//------------------------------------------------------------------------------
+// Allocates the member array of an instance of a script class. Pooled member
+// arrays are already filled with null handles, except for the first entry.
+
+JILHandle** JILAllocInstance(JILState* pState, JILTypeInfo* pTypeInfo)
+{
+	JILHandle** ppHandles;
+	JILInstancePool* pPool;
+	JILLong type = pTypeInfo->type;
+
+	if( type < pState->vmNumInstancePools )
+	{
+		pPool = pState->vmpInstancePools + type;
+		ppHandles = pPool->ppFirst;
+		if( ppHandles )
+		{
+			pPool->ppFirst = (JILHandle**) ppHandles[0];
+			pPool->count--;
+			ppHandles[0] = JILGetNullHandle(pState);
+			return ppHandles;
+		}
+	}
+	return JILAllocObject(pState, pTypeInfo->instanceSize);
+}
+
+//------------------------------------------------------------------------------
+// JILAllocInstanceNoInit
+//------------------------------------------------------------------------------
+
+JILHandle** JILAllocInstanceNoInit(JILState* pState, JILTypeInfo* pTypeInfo)
+{
+	JILHandle** ppHandles;
+	JILInstancePool* pPool;
+	JILLong type = pTypeInfo->type;
+
+	if( type < pState->vmNumInstancePools )
+	{
+		pPool = pState->vmpInstancePools + type;
+		ppHandles = pPool->ppFirst;
+		if( ppHandles )
+		{
+			pPool->ppFirst = (JILHandle**) ppHandles[0];
+			pPool->count--;
+			// the caller overwrites the null handles
+			JILGetNullHandle(pState)->refCount -= pTypeInfo->instanceSize;
+			return ppHandles;
+		}
+	}
+	return JILAllocObjectNoInit(pState, pTypeInfo->instanceSize);
+}
+
+//------------------------------------------------------------------------------
+// JILFreeInstance
+//------------------------------------------------------------------------------
+
+void JILFreeInstance(JILState* pState, JILTypeInfo* pTypeInfo, JILHandle** ppHandles)
+{
+	JILInstancePool* pPool;
+	JILHandle* pNull;
+	JILLong type = pTypeInfo->type;
+	JILLong size = pTypeInfo->instanceSize;
+	JILLong i;
+
+	if( size > 0 && pState->vmInstancePoolCap > 0 )
+	{
+		if( type >= pState->vmNumInstancePools )
+		{
+			JILLong num = pState->vmUsedTypeInfoSegSize;
+			pState->vmpInstancePools = (JILInstancePool*) realloc(pState->vmpInstancePools, num * sizeof(JILInstancePool));
+			memset(pState->vmpInstancePools + pState->vmNumInstancePools, 0, (num - pState->vmNumInstancePools) * sizeof(JILInstancePool));
+			pState->vmNumInstancePools = num;
+		}
+		pPool = pState->vmpInstancePools + type;
+		if( pPool->count < pState->vmInstancePoolCap )
+		{
+			pNull = JILGetNullHandle(pState);
+			for( i = 1; i < size; i++ )
+				ppHandles[i] = pNull;
+			pNull->refCount += size;
+			ppHandles[0] = (JILHandle*) pPool->ppFirst;
+			pPool->ppFirst = ppHandles;
+			pPool->count++;
+			return;
+		}
+	}
+	pState->vmFree( pState, ppHandles );
+}
+
+//------------------------------------------------------------------------------
+// JILFlushInstancePool
+//------------------------------------------------------------------------------
+
+void JILFlushInstancePool(JILState* pState, JILLong type)
+{
+	JILInstancePool* pPool;
+	JILHandle** ppHandles;
+	JILLong size;
+
+	if( type < 0 )
+	{
+		for( type = 0; type < pState->vmNumInstancePools; type++ )
+			JILFlushInstancePool(pState, type);
+	}
+	else if( type < pState->vmNumInstancePools )
+	{
+		pPool = pState->vmpInstancePools + type;
+		size = JILTypeInfoFromType(pState, type)->instanceSize;
+		while( pPool->ppFirst )
+		{
+			ppHandles = pPool->ppFirst;
+			pPool->ppFirst = (JILHandle**) ppHandles[0];
+			JILGetNullHandle(pState)->refCount -= size;
+			pState->vmFree( pState, ppHandles );
+		}
+		pPool->count = 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILDestroyInstancePools
+//------------------------------------------------------------------------------
+
+void JILDestroyInstancePools(JILState* pState)
+{
+	JILFlushInstancePool(pState, -1);
+	if( pState->vmpInstancePools )
+	{
+		free( pState->vmpInstancePools );
+		pState->vmpInstancePools = NULL;
+	}
+	pState->vmNumInstancePools = 0;
+}
+
 //------------------------------------------------------------------------------
 // JILAllocArrayMulti
 //------------------------------------------------------------------------------
@@ -78,7 +213,7 @@ JILArray* JILAllocArrayMulti(JILState* pState, JILLong type, JILLong dim, JILLon
 	n++;
 
 	// get the size for this dimension from the stack and allocate an array object of that size
-	pHandle = pState->vmpContext->vmppDataStack[pState->vmpContext->vmDataStackPointer + dim - n];
+	pHandle = JILDataStack(pState->vmpContext, pState->vmpContext->vmDataStackPointer + dim - n);
 	size = JILGetIntHandle(pHandle)->l;
 
 	// if this is not the last dimension, recursively initialize sub-arrays
@@ -167,7 +302,7 @@ JILDelegate* JILAllocClosure(JILState* pState, JILLong stackSize, JILLong addr,
 	pDelegate->pObject = pObject;
 	JILAddRef(pObject);
 
-	src = pState->vmpContext->vmppDataStack + pState->vmpContext->vmDataStackPointer;
+	src = JILDataStackAt(pState->vmpContext, pState->vmpContext->vmDataStackPointer);
 	dst = pDelegate->pClosure->ppStack;
 	for( i = 0; i < stackSize; i++ )
 	{
@@ -38,6 +38,46 @@ JILHandle**			JILAllocObject			(JILState* pState, JILLong size);
 
 JILHandle**			JILAllocObjectNoInit	(JILState* pState, JILLong size);
 
+//------------------------------------------------------------------------------
+// JILAllocInstance
+//------------------------------------------------------------------------------
+/// Allocates the member array of an instance of the given script class. Reuses
+/// a member array from the instance pool of the class, if possible.
+
+JILHandle**			JILAllocInstance		(JILState* pState, JILTypeInfo* pTypeInfo);
+
+//------------------------------------------------------------------------------
+// JILAllocInstanceNoInit
+//------------------------------------------------------------------------------
+/// Same as JILAllocInstance(), but doesn't initialize the members with null
+/// handles, like JILAllocObjectNoInit().
+
+JILHandle**			JILAllocInstanceNoInit	(JILState* pState, JILTypeInfo* pTypeInfo);
+
+//------------------------------------------------------------------------------
+// JILFreeInstance
+//------------------------------------------------------------------------------
+/// Frees the member array of an instance of the given script class. The members
+/// must have been released already. If the instance pool of the class isn't
+/// full, the member array is filled with null handles and added to the pool.
+
+void				JILFreeInstance			(JILState* pState, JILTypeInfo* pTypeInfo, JILHandle** ppHandles);
+
+//------------------------------------------------------------------------------
+// JILFlushInstancePool
+//------------------------------------------------------------------------------
+/// Frees all member arrays in the instance pool of the given type. Pass -1 to
+/// flush the pools of all types.
+
+void				JILFlushInstancePool	(JILState* pState, JILLong type);
+
+//------------------------------------------------------------------------------
+// JILDestroyInstancePools
+//------------------------------------------------------------------------------
+/// Frees all instance pools. Called when the runtime is terminated.
+
+void				JILDestroyInstancePools	(JILState* pState);
+
 //------------------------------------------------------------------------------
 // JILAllocArrayMulti
 //------------------------------------------------------------------------------
@@ -0,0 +1,895 @@
+//------------------------------------------------------------------------------
+// File: JILAot.c                                              (c) 2026 jewe.org
+//------------------------------------------------------------------------------
+//
+// DISCLAIMER:
+// -----------
+//	THIS SOFTWARE IS SUBJECT TO THE LICENSE AGREEMENT FOUND IN "jilapi.h" AND
+//	"COPYING". BY USING THIS SOFTWARE YOU IMPLICITLY DECLARE YOUR AGREEMENT TO
+//	THE TERMS OF THIS LICENSE.
+//
+// Description:
+// ------------
+//	Translates the bytecode of script functions into C source code, that can
+//	be compiled and linked into the application. Like the JIT compiler, the
+//	translator works instruction by instruction, and every instruction that is
+//	not supported becomes a return to the VM, which executes it and continues.
+//	Supported instructions check their operands first, and return to the VM
+//	before changing anything if the types are not as expected, or if the
+//	instruction would throw an exception. The VM enters compiled code at the
+//	start of a function, and at the target of a backward branch. Compiled code
+//	counts the instructions it executes, so the instruction counter does not
+//	depend on whether code is compiled or interpreted.
+//------------------------------------------------------------------------------
+
+#include "jilstdinc.h"
+
+#include "jilaot.h"
+#include "jilcodelist.h"
+#include "jilopcodes.h"
+#include "jilmachine.h"
+
+#define kMaxStringLength 256
+
+//------------------------------------------------------------------------------
+// instruction classes
+//------------------------------------------------------------------------------
+// The translator does not care about addressing modes, it looks at the
+// mnemonic of an instruction and decodes the operands using the instruction
+// table.
+
+enum
+{
+	kAotNone = 0,
+	kAotNop,
+	kAotBra,
+	kAotTst,		// tsteq, tstne
+	kAotArith,		// add, sub, mul
+	kAotDiv,		// div, mod
+	kAotBits,		// and, or, xor
+	kAotIncDec,		// inc, dec
+	kAotNeg,		// neg
+	kAotNot,		// not, unot
+	kAotArithL,		// addl, subl, mull
+	kAotDivL,		// divl, modl
+	kAotIncDecL,	// incl, decl
+	kAotNegL,		// negl
+	kAotIncLB,		// incl.b
+	kAotArithF,		// addf, subf, mulf
+	kAotDivF,		// divf, modf
+	kAotIncDecF,	// incf, decf
+	kAotNegF,		// negf
+	kAotCmp,		// cseq ... csle
+	kAotCmpL,		// cseql ... cslel
+	kAotCmpLB,		// cseql.b ... cslel.b
+	kAotCmpF,		// cseqf ... cslef
+	kAotSnul,		// snul, snnul
+	kAotLdz,		// ldz
+	kAotMove,		// move, moveh
+	kAotCopy		// copy, copyh
+};
+
+typedef struct
+{
+	const JILChar*	name;		// mnemonic
+	JILLong			cls;		// instruction class
+	const JILChar*	op;			// C operator
+} JILAotOpInfo;
+
+static const JILAotOpInfo kAotOps[] =
+{
+	{ "nop",		kAotNop,		"" },
+	{ "bra",		kAotBra,		"" },
+	{ "tsteq",		kAotTst,		"==" },
+	{ "tstne",		kAotTst,		"!=" },
+	{ "add",		kAotArith,		"+=" },
+	{ "sub",		kAotArith,		"-=" },
+	{ "mul",		kAotArith,		"*=" },
+	{ "div",		kAotDiv,		"/" },
+	{ "mod",		kAotDiv,		"%" },
+	{ "and",		kAotBits,		"&=" },
+	{ "or",			kAotBits,		"|=" },
+	{ "xor",		kAotBits,		"^=" },
+	{ "inc",		kAotIncDec,		"+=" },
+	{ "dec",		kAotIncDec,		"-=" },
+	{ "neg",		kAotNeg,		"" },
+	{ "not",		kAotNot,		"~" },
+	{ "unot",		kAotNot,		"!" },
+	{ "addl",		kAotArithL,		"+=" },
+	{ "subl",		kAotArithL,		"-=" },
+	{ "mull",		kAotArithL,		"*=" },
+	{ "divl",		kAotDivL,		"/=" },
+	{ "modl",		kAotDivL,		"%=" },
+	{ "incl",		kAotIncDecL,	"+=" },
+	{ "decl",		kAotIncDecL,	"-=" },
+	{ "negl",		kAotNegL,		"" },
+	{ "incl.b",		kAotIncLB,		"" },
+	{ "addf",		kAotArithF,		"+=" },
+	{ "subf",		kAotArithF,		"-=" },
+	{ "mulf",		kAotArithF,		"*=" },
+	{ "divf",		kAotDivF,		"/" },
+	{ "modf",		kAotDivF,		"%" },
+	{ "incf",		kAotIncDecF,	"+=" },
+	{ "decf",		kAotIncDecF,	"-=" },
+	{ "negf",		kAotNegF,		"" },
+	{ "cseq",		kAotCmp,		"==" },
+	{ "csne",		kAotCmp,		"!=" },
+	{ "csgt",		kAotCmp,		">" },
+	{ "csge",		kAotCmp,		">=" },
+	{ "cslt",		kAotCmp,		"<" },
+	{ "csle",		kAotCmp,		"<=" },
+	{ "cseql",		kAotCmpL,		"==" },
+	{ "csnel",		kAotCmpL,		"!=" },
+	{ "csgtl",		kAotCmpL,		">" },
+	{ "csgel",		kAotCmpL,		">=" },
+	{ "csltl",		kAotCmpL,		"<" },
+	{ "cslel",		kAotCmpL,		"<=" },
+	{ "cseql.b",	kAotCmpLB,		"==" },
+	{ "csnel.b",	kAotCmpLB,		"!=" },
+	{ "csgtl.b",	kAotCmpLB,		">" },
+	{ "csgel.b",	kAotCmpLB,		">=" },
+	{ "csltl.b",	kAotCmpLB,		"<" },
+	{ "cslel.b",	kAotCmpLB,		"<=" },
+	{ "cseqf",		kAotCmpF,		"==" },
+	{ "csnef",		kAotCmpF,		"!=" },
+	{ "csgtf",		kAotCmpF,		">" },
+	{ "csgef",		kAotCmpF,		">=" },
+	{ "csltf",		kAotCmpF,		"<" },
+	{ "cslef",		kAotCmpF,		"<=" },
+	{ "snul",		kAotSnul,		"" },
+	{ "snnul",		kAotSnul,		"!" },
+	{ "ldz",		kAotLdz,		"" },
+	{ "move",		kAotMove,		"" },
+	{ "moveh",		kAotMove,		"" },
+	{ "copy",		kAotCopy,		"" },
+	{ "copyh",		kAotCopy,		"" },
+	{ NULL,			kAotNone,		NULL }
+};
+
+//------------------------------------------------------------------------------
+// flags
+//------------------------------------------------------------------------------
+
+enum
+{
+	// code address flags
+	kAotInstr		= 1 << 0,	// an instruction starts here
+	kAotSupported	= 1 << 1,	// the instruction can be translated
+	kAotEntry		= 1 << 2,	// the VM can enter compiled code here
+	kAotReached		= 1 << 3,	// an entry point, or reached by a branch from compiled code
+
+	// local variables used by a function
+	kAotUsePP1		= 1 << 0,
+	kAotUsePP2		= 1 << 1,
+	kAotUsePP3		= 1 << 2,
+	kAotUseObject	= 1 << 3,
+	kAotUseValue	= 1 << 4,
+	kAotUseHandle	= 1 << 5,
+	kAotUseInt		= 1 << 6
+};
+
+//------------------------------------------------------------------------------
+// JILAotText
+//------------------------------------------------------------------------------
+// A growing text buffer.
+
+typedef struct
+{
+	JILChar*		pBuf;
+	JILLong			length;
+	JILLong			maxLength;
+	JILBool			failed;
+} JILAotText;
+
+//------------------------------------------------------------------------------
+// JILAotOperand
+//------------------------------------------------------------------------------
+// A decoded operand of an instruction.
+
+typedef struct
+{
+	JILLong			type;		// operand type, see JILInstrInfo::opType
+	const JILLong*	pData;		// operand data in the code segment
+} JILAotOperand;
+
+//------------------------------------------------------------------------------
+// JILAotFunc
+//------------------------------------------------------------------------------
+// Working data while translating a function.
+
+typedef struct
+{
+	JILState*		pState;
+	const JILLong*	pCode;
+	JILByte*		pFlags;		// code address flags of the entire code segment
+	JILLong			codeAddr;
+	JILLong			codeSize;
+	JILLong			address;	// address of the current instruction
+	JILLong			uses;		// local variables used
+	JILAotText		body;
+} JILAotFunc;
+
+//------------------------------------------------------------------------------
+// text output
+//------------------------------------------------------------------------------
+
+static void Out(JILAotText* t, const JILChar* pFormat, ...)
+{
+	va_list arguments;
+	JILLong len;
+	JILLong newMax;
+	JILChar* pNew;
+
+	while( !t->failed )
+	{
+		if( t->pBuf )
+		{
+			va_start( arguments, pFormat );
+			len = JIL_VSNPRINTF( t->pBuf + t->length, t->maxLength - t->length, pFormat, arguments );
+			va_end( arguments );
+			if( len >= 0 && len < t->maxLength - t->length )
+			{
+				t->length += len;
+				return;
+			}
+		}
+		// grow the buffer and try again
+		newMax = t->maxLength ? t->maxLength * 2 : 4096;
+		pNew = (JILChar*) realloc(t->pBuf, newMax);
+		if( pNew == NULL )
+		{
+			t->failed = JILTrue;
+			break;
+		}
+		t->pBuf = pNew;
+		t->maxLength = newMax;
+	}
+}
+
+static void OutText(JILAotText* t, const JILAotText* pSrc)
+{
+	if( pSrc->failed )
+		t->failed = JILTrue;
+	else if( pSrc->length )
+		Out(t, "%s", pSrc->pBuf);
+}
+
+//------------------------------------------------------------------------------
+// JILAotFindOp
+//------------------------------------------------------------------------------
+// Find the instruction class of an instruction by its mnemonic.
+
+static const JILAotOpInfo* JILAotFindOp(const JILInstrInfo* pInstr)
+{
+	const JILAotOpInfo* pInfo;
+	JILLong i;
+	for( pInfo = kAotOps; pInfo->name; pInfo++ )
+	{
+		if( strcmp(pInfo->name, pInstr->name) == 0 )
+		{
+			// the indexed addressing mode is not supported
+			for( i = 0; i < pInstr->numOperands; i++ )
+			{
+				if( pInstr->opType[i] == ot_eax )
+					return NULL;
+			}
+			return pInfo;
+		}
+	}
+	return NULL;
+}
+
+//------------------------------------------------------------------------------
+// JILAotDecode
+//------------------------------------------------------------------------------
+// Decodes the operands of the instruction at the given address. Returns the
+// instruction class info, or NULL if the instruction is not supported.
+
+static const JILAotOpInfo* JILAotDecode(JILAotFunc* f, JILLong address, JILAotOperand* pOp)
+{
+	const JILInstrInfo* pInstr = JILGetInfoFromOpcode(f->pCode[address]);
+	JILLong i, pos;
+	for( pos = 1, i = 0; i < pInstr->numOperands; i++ )
+	{
+		pOp[i].type = pInstr->opType[i];
+		pOp[i].pData = f->pCode + address + pos;
+		pos += JILGetOperandSize(pInstr->opType[i]);
+	}
+	return JILAotFindOp(pInstr);
+}
+
+//------------------------------------------------------------------------------
+// JILAotBranchTarget
+//------------------------------------------------------------------------------
+// Returns the target address of a branch instruction, or -1 if the
+// instruction does not branch.
+
+static JILLong JILAotBranchTarget(JILAotFunc* f, const JILAotOpInfo* pInfo, const JILAotOperand* pOp)
+{
+	switch( pInfo->cls )
+	{
+		case kAotBra:	return f->address + pOp[0].pData[0];
+		case kAotTst:	return f->address + pOp[1].pData[0];
+		case kAotIncLB:	return f->address + pOp[1].pData[0];
+		case kAotCmpLB:	return f->address + pOp[3].pData[0];
+	}
+	return -1;
+}
+
+//------------------------------------------------------------------------------
+// operand output
+//------------------------------------------------------------------------------
+
+// Loads the address of the handle operand 'n' refers to into 'ppn'.
+static void OutOperand(JILAotFunc* f, JILLong n, const JILAotOperand* pOp)
+{
+	switch( pOp->type )
+	{
+		case ot_ear:
+			Out(&f->body, "\tJIL_AOT_R(pp%d, %d)\n", n, pOp->pData[0]);
+			break;
+		case ot_eas:
+			Out(&f->body, "\tJIL_AOT_S(pp%d, %d)\n", n, pOp->pData[0]);
+			break;
+		case ot_ead:
+			Out(&f->body, "\tJIL_AOT_D(pp%d, %d, %d, %d)\n", n, pOp->pData[0], pOp->pData[1], f->address);
+			f->uses |= kAotUseObject;
+			break;
+		case ot_handle:
+			Out(&f->body, "\tJIL_AOT_H(pp%d, %d)\n", n, pOp->pData[0]);
+			break;
+	}
+	f->uses |= kAotUsePP1 << (n - 1);
+}
+
+// Leaves compiled code if the operand is not of the given type.
+static void OutGuard(JILAotFunc* f, JILLong n, const JILChar* pType)
+{
+	Out(&f->body, "\tJIL_AOT_EXIT_IF(!JIL_AOT_IS(pp%d, %s), %d)\n", n, pType, f->address);
+}
+
+//------------------------------------------------------------------------------
+// JILAotTranslateInstr
+//------------------------------------------------------------------------------
+// Translates a single instruction. See the macros in jilopmacros.h for what
+// the VM does.
+
+static void JILAotTranslateInstr(JILAotFunc* f, const JILAotOpInfo* pInfo, const JILAotOperand* pOp)
+{
+	JILAotText* t = &f->body;
+	JILLong a = f->address;
+	JILLong target = JILAotBranchTarget(f, pInfo, pOp);
+	const JILChar* op = pInfo->op;
+
+	switch( pInfo->cls )
+	{
+		case kAotNop:
+			break;
+		case kAotBra:
+			Out(t, "\tgoto L%d;\n", target);
+			break;
+		case kAotTst:
+			OutOperand(f, 1, pOp + 0);
+			OutGuard(f, 1, "type_int");
+			Out(t, "\tif( JIL_AOT_INT(pp1) %s 0 ) goto L%d;\n", op, target);
+			break;
+		case kAotArith:
+		case kAotDiv:
+			OutOperand(f, 1, pOp + 0);
+			OutOperand(f, 2, pOp + 1);
+			if( pInfo->cls == kAotArith )
+			{
+				Out(t, "\tif( JIL_AOT_IS(pp1, type_int) && JIL_AOT_IS(pp2, type_int) )\n");
+				Out(t, "\t\tJIL_AOT_INT(pp2) %s JIL_AOT_INT(pp1);\n", op);
+				Out(t, "\telse if( JIL_AOT_IS(pp1, type_float) && JIL_AOT_IS(pp2, type_float) )\n");
+				Out(t, "\t\tJIL_AOT_FLOAT(pp2) %s JIL_AOT_FLOAT(pp1);\n", op);
+			}
+			else
+			{
+				// division by zero is thrown by the VM
+				Out(t, "\tif( JIL_AOT_IS(pp1, type_int) && JIL_AOT_IS(pp2, type_int) && JIL_AOT_INT(pp1) != 0 )\n");
+				Out(t, "\t\tJIL_AOT_INT(pp2) %s= JIL_AOT_INT(pp1);\n", op);
+				Out(t, "\telse if( JIL_AOT_IS(pp1, type_float) && JIL_AOT_IS(pp2, type_float) && JIL_AOT_FLOAT(pp1) != 0 )\n");
+				if( *op == '%' )
+					Out(t, "\t\tJIL_AOT_FLOAT(pp2) = fmod(JIL_AOT_FLOAT(pp2), JIL_AOT_FLOAT(pp1));\n");
+				else
+					Out(t, "\t\tJIL_AOT_FLOAT(pp2) /= JIL_AOT_FLOAT(pp1);\n");
+			}
+			Out(t, "\telse\n\t\tJIL_AOT_EXIT(%d)\n", a);
+			break;
+		case kAotBits:
+		case kAotArithL:
+		case kAotDivL:
+			OutOperand(f, 1, pOp + 0);
+			OutOperand(f, 2, pOp + 1);
+			OutGuard(f, 1, "type_int");
+			OutGuard(f, 2, "type_int");
+			if( pInfo->cls == kAotDivL )
+				Out(t, "\tJIL_AOT_EXIT_IF(JIL_AOT_INT(pp1) == 0, %d)\n", a);
+			Out(t, "\tJIL_AOT_INT(pp2) %s JIL_AOT_INT(pp1);\n", op);
+			break;
+		case kAotIncDec:
+		case kAotNeg:
+			OutOperand(f, 1, pOp + 0);
+			if( pInfo->cls == kAotIncDec )
+			{
+				Out(t, "\tif( JIL_AOT_IS(pp1, type_int) )\n\t\tJIL_AOT_INT(pp1) %s 1;\n", op);
+				Out(t, "\telse if( JIL_AOT_IS(pp1, type_float) )\n\t\tJIL_AOT_FLOAT(pp1) %s 1.0;\n", op);
+			}
+			else
+			{
+				Out(t, "\tif( JIL_AOT_IS(pp1, type_int) )\n\t\tJIL_AOT_INT(pp1) = -JIL_AOT_INT(pp1);\n");
+				Out(t, "\telse if( JIL_AOT_IS(pp1, type_float) )\n\t\tJIL_AOT_FLOAT(pp1) = -JIL_AOT_FLOAT(pp1);\n");
+			}
+			Out(t, "\telse\n\t\tJIL_AOT_EXIT(%d)\n", a);
+			break;
+		case kAotNot:
+		case kAotNegL:
+			OutOperand(f, 1, pOp + 0);
+			OutGuard(f, 1, "type_int");
+			Out(t, "\tJIL_AOT_INT(pp1) = %s JIL_AOT_INT(pp1);\n", (pInfo->cls == kAotNot) ? op : "-");
+			break;
+		case kAotIncDecL:
+		case kAotIncLB:
+			OutOperand(f, 1, pOp + 0);
+			OutGuard(f, 1, "type_int");
+			Out(t, "\tJIL_AOT_INT(pp1) %s 1;\n", (pInfo->cls == kAotIncLB) ? "+=" : op);
+			if( pInfo->cls == kAotIncLB )
+				Out(t, "\tgoto L%d;\n", target);
+			break;
+		case kAotArithF:
+		case kAotDivF:
+			OutOperand(f, 1, pOp + 0);
+			OutOperand(f, 2, pOp + 1);
+			OutGuard(f, 1, "type_float");
+			OutGuard(f, 2, "type_float");
+			if( pInfo->cls == kAotArithF )
+			{
+				Out(t, "\tJIL_AOT_FLOAT(pp2) %s JIL_AOT_FLOAT(pp1);\n", op);
+				break;
+			}
+			Out(t, "\tJIL_AOT_EXIT_IF(JIL_AOT_FLOAT(pp1) == 0, %d)\n", a);
+			if( *op == '%' )
+				Out(t, "\tJIL_AOT_FLOAT(pp2) = fmod(JIL_AOT_FLOAT(pp2), JIL_AOT_FLOAT(pp1));\n");
+			else
+				Out(t, "\tJIL_AOT_FLOAT(pp2) /= JIL_AOT_FLOAT(pp1);\n");
+			break;
+		case kAotIncDecF:
+		case kAotNegF:
+			OutOperand(f, 1, pOp + 0);
+			OutGuard(f, 1, "type_float");
+			if( pInfo->cls == kAotIncDecF )
+				Out(t, "\tJIL_AOT_FLOAT(pp1) %s 1.0;\n", op);
+			else
+				Out(t, "\tJIL_AOT_FLOAT(pp1) = -JIL_AOT_FLOAT(pp1);\n");
+			break;
+		case kAotCmp:
+		case kAotCmpL:
+		case kAotCmpLB:
+		case kAotCmpF:
+			OutOperand(f, 1, pOp + 0);
+			OutOperand(f, 2, pOp + 1);
+			OutOperand(f, 3, pOp + 2);
+			if( pInfo->cls == kAotCmp )
+			{
+				Out(t, "\tif( JIL_AOT_IS(pp1, type_int) && JIL_AOT_IS(pp2, type_int) )\n");
+				Out(t, "\t\ti = (JIL_AOT_INT(pp2) %s JIL_AOT_INT(pp1));\n", op);
+				Out(t, "\telse if( JIL_AOT_IS(pp1, type_float) && JIL_AOT_IS(pp2, type_float) )\n");
+				Out(t, "\t\ti = (JIL_AOT_FLOAT(pp2) %s JIL_AOT_FLOAT(pp1));\n", op);
+				Out(t, "\telse\n\t\tJIL_AOT_EXIT(%d)\n", a);
+			}
+			else if( pInfo->cls == kAotCmpF )
+			{
+				OutGuard(f, 1, "type_float");
+				OutGuard(f, 2, "type_float");
+				Out(t, "\ti = (JIL_AOT_FLOAT(pp2) %s JIL_AOT_FLOAT(pp1));\n", op);
+			}
+			else
+			{
+				OutGuard(f, 1, "type_int");
+				OutGuard(f, 2, "type_int");
+				Out(t, "\ti = (JIL_AOT_INT(pp2) %s JIL_AOT_INT(pp1));\n", op);
+			}
+			Out(t, "\tJIL_STORE_INT(pState, pp3, i)\n");
+			if( pInfo->cls == kAotCmpLB )
+				Out(t, "\tif( i == 0 ) goto L%d;\n", target);
+			f->uses |= kAotUseInt | kAotUseValue;
+			break;
+		case kAotSnul:
+			OutOperand(f, 1, pOp + 0);
+			OutOperand(f, 2, pOp + 1);
+			Out(t, "\tJIL_STORE_INT(pState, pp2, %sJIL_AOT_IS(pp1, type_null))\n", op);
+			f->uses |= kAotUseValue;
+			break;
+		case kAotLdz:
+			OutOperand(f, 1, pOp + 0);
+			Out(t, "\tJIL_STORE_INT(pState, pp1, 0)\n");
+			f->uses |= kAotUseValue;
+			break;
+		case kAotMove:
+			OutOperand(f, 1, pOp + 0);
+			OutOperand(f, 2, pOp + 1);
+			Out(t, "\th = *pp1;\n");
+			Out(t, "\tJIL_STORE_HANDLE(pState, pp2, h)\n");
+			f->uses |= kAotUseHandle;
+			break;
+		case kAotCopy:
+			// only int and float values are copied here, see JIL_COPY
+			OutOperand(f, 1, pOp + 0);
+			OutOperand(f, 2, pOp + 1);
+			Out(t, "\tif( JIL_AOT_IS(pp1, type_int) ) {\n\t\tJIL_STORE_INT(pState, pp2, JIL_AOT_INT(pp1))\n");
+			Out(t, "\t} else if( JIL_AOT_IS(pp1, type_float) ) {\n\t\tJIL_STORE_FLOAT(pState, pp2, JIL_AOT_FLOAT(pp1))\n");
+			Out(t, "\t} else\n\t\tJIL_AOT_EXIT(%d)\n", a);
+			f->uses |= kAotUseValue;
+			break;
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILAotMarkReached
+//------------------------------------------------------------------------------
+// Marks the entry points, and the branch targets that can be reached from them
+// in compiled code. Code after an unsupported instruction or an unconditional
+// branch can only be reached through one of these.
+
+static void JILAotMarkReached(JILAotFunc* f)
+{
+	const JILInstrInfo* pInstr;
+	const JILAotOpInfo* pInfo;
+	JILAotOperand operand[4];
+	JILByte* pFlags = f->pFlags;
+	JILLong addr, target;
+	JILLong end = f->codeAddr + f->codeSize;
+	JILBool reachable;
+	JILBool changed = JILTrue;
+
+	for( addr = f->codeAddr; addr < end; addr++ )
+	{
+		if( pFlags[addr] & kAotEntry )
+			pFlags[addr] |= kAotReached;
+	}
+	while( changed )
+	{
+		changed = JILFalse;
+		reachable = JILFalse;
+		for( addr = f->codeAddr; addr < end; addr += pInstr->instrSize )
+		{
+			pInstr = JILGetInfoFromOpcode(f->pCode[addr]);
+			if( pFlags[addr] & kAotReached )
+				reachable = JILTrue;
+			if( !reachable )
+				continue;
+			if( !(pFlags[addr] & kAotSupported) )
+			{
+				reachable = JILFalse;
+				continue;
+			}
+			f->address = addr;
+			pInfo = JILAotDecode(f, addr, operand);
+			target = JILAotBranchTarget(f, pInfo, operand);
+			if( target >= 0 && !(pFlags[target] & kAotReached) )
+			{
+				pFlags[target] |= kAotReached;
+				changed = JILTrue;
+			}
+			if( pInfo->cls == kAotBra || pInfo->cls == kAotIncLB )
+				reachable = JILFalse;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILAotTranslateFunc
+//------------------------------------------------------------------------------
+// Translates a function into a JILCompiledProc named "fn_<address>". Marks
+// all addresses at which the function can be entered. Returns JILFalse if
+// the function has not been translated.
+
+static JILBool JILAotTranslateFunc(JILAotText* pOut, JILAotFunc* f)
+{
+	const JILInstrInfo* pInstr;
+	const JILAotOpInfo* pInfo;
+	JILAotOperand operand[4];
+	JILChar buf[kMaxStringLength];
+	JILChar* pSrc;
+	JILChar* pDst;
+	JILByte* pFlags = f->pFlags;
+	JILLong addr, end, target, opcode;
+	JILBool hasEntry = JILFalse;
+	JILBool reachable = JILFalse;
+
+	end = f->codeAddr + f->codeSize;
+	if( f->codeAddr < 0 || end > f->pState->vmpCodeSegment->usedSize || (pFlags[f->codeAddr] & kAotInstr) )
+		return JILFalse;
+
+	// mark all instructions, so that branches can be checked
+	for( addr = f->codeAddr; addr < end; addr += pInstr->instrSize )
+	{
+		opcode = f->pCode[addr];
+		pInstr = (opcode >= 0 && opcode < JILNumOpcodes) ? JILGetInfoFromOpcode(opcode) : NULL;
+		if( pInstr == NULL || pInstr->instrSize <= 0 || addr + pInstr->instrSize > end )
+			return JILFalse;
+		pFlags[addr] |= kAotInstr;
+	}
+
+	// find supported instructions, branch targets and entry points
+	for( addr = f->codeAddr; addr < end; addr += pInstr->instrSize )
+	{
+		pInstr = JILGetInfoFromOpcode(f->pCode[addr]);
+		f->address = addr;
+		pInfo = JILAotDecode(f, addr, operand);
+		if( pInfo == NULL )
+			continue;
+		target = JILAotBranchTarget(f, pInfo, operand);
+		if( target >= 0 )
+		{
+			// the VM takes care of branches leaving the function
+			if( target < f->codeAddr || target >= end || !(pFlags[target] & kAotInstr) )
+				continue;
+			// the VM only enters compiled code at backward branches
+			if( target <= addr && (pInfo->cls == kAotBra || pInfo->cls == kAotIncLB) )
+				pFlags[target] |= kAotEntry;
+		}
+		pFlags[addr] |= kAotSupported;
+	}
+	pFlags[f->codeAddr] |= kAotEntry;
+	for( addr = f->codeAddr; addr < end; addr++ )
+	{
+		if( (pFlags[addr] & kAotEntry) && !(pFlags[addr] & kAotSupported) )
+			pFlags[addr] &= ~kAotEntry;
+		if( pFlags[addr] & kAotEntry )
+			hasEntry = JILTrue;
+	}
+	if( !hasEntry )
+		return JILFalse;
+	JILAotMarkReached(f);
+
+	// translate all instructions, code after a return or goto can only be
+	// reached through a label
+	for( addr = f->codeAddr; addr < end; addr += pInstr->instrSize )
+	{
+		pInstr = JILGetInfoFromOpcode(f->pCode[addr]);
+		f->address = addr;
+		if( pFlags[addr] & kAotReached )
+		{
+			Out(&f->body, "L%d:\n", addr);
+			reachable = JILTrue;
+		}
+		// list the instruction as a comment, without the function header and
+		// the extra spaces
+		JILListInstruction(f->pState, addr, buf, kMaxStringLength, JILFalse);
+		pSrc = strrchr(buf, '\n');
+		pSrc = pSrc ? pSrc + 1 : buf;
+		for( pDst = buf; *pSrc; pSrc++ )
+		{
+			if( *pSrc == '\t' )
+				*pSrc = ' ';
+			if( *pSrc != ' ' || (pDst > buf && pDst[-1] != ' ') )
+				*pDst++ = *pSrc;
+		}
+		while( pDst > buf && pDst[-1] == ' ' )
+			pDst--;
+		*pDst = 0;
+		Out(&f->body, "\t// %s\n", buf);
+		if( !reachable )
+			continue;
+		if( pFlags[addr] & kAotSupported )
+		{
+			pInfo = JILAotDecode(f, addr, operand);
+			Out(&f->body, "\tJIL_AOT_COUNT\n");
+			JILAotTranslateInstr(f, pInfo, operand);
+			if( pInfo->cls == kAotBra || pInfo->cls == kAotIncLB )
+				reachable = JILFalse;
+		}
+		else
+		{
+			Out(&f->body, "\treturn %d;\n", addr);
+			reachable = JILFalse;
+		}
+	}
+
+	// write the function
+	JILGetFunctionName(f->pState, buf, kMaxStringLength, f->codeAddr);
+	Out(pOut, "//------------------------------------------------------------------------------\n");
+	Out(pOut, "// %s\n", buf);
+	Out(pOut, "//------------------------------------------------------------------------------\n\n");
+	Out(pOut, "static JILLong fn_%d(JILState* pState, JILContext* pContext, JILLong address)\n{\n", f->codeAddr);
+	if( f->uses & kAotUsePP1 )		Out(pOut, "\tJILHandle** pp1;\n");
+	if( f->uses & kAotUsePP2 )		Out(pOut, "\tJILHandle** pp2;\n");
+	if( f->uses & kAotUsePP3 )		Out(pOut, "\tJILHandle** pp3;\n");
+	if( f->uses & kAotUseHandle )	Out(pOut, "\tJILHandle* h;\n");
+	if( f->uses & kAotUseValue )	Out(pOut, "\tJILHandle* pValue;\n");
+	if( f->uses & kAotUseObject )	Out(pOut, "\tJILHandleObject* pHObject;\n");
+	if( f->uses & kAotUseInt )		Out(pOut, "\tJILLong i;\n");
+	Out(pOut, "\tswitch( address )\n\t{\n");
+	for( addr = f->codeAddr; addr < end; addr++ )
+	{
+		if( pFlags[addr] & kAotEntry )
+			Out(pOut, "\t\tcase %d: goto L%d;\n", addr, addr);
+	}
+	Out(pOut, "\t}\n\treturn address;\n");
+	OutText(pOut, &f->body);
+	if( reachable )
+		Out(pOut, "\treturn %d;\n", end);
+	Out(pOut, "}\n\n");
+	return JILTrue;
+}
+
+//------------------------------------------------------------------------------
+// JILIsIdentifier
+//------------------------------------------------------------------------------
+
+static JILBool JILIsIdentifier(const JILChar* pName)
+{
+	const JILChar* p;
+	if( pName == NULL || *pName == 0 || isdigit((unsigned char) *pName) )
+		return JILFalse;
+	for( p = pName; *p; p++ )
+	{
+		if( !isalnum((unsigned char) *p) && *p != '_' )
+			return JILFalse;
+	}
+	return JILTrue;
+}
+
+//------------------------------------------------------------------------------
+// JILSaveCSource
+//------------------------------------------------------------------------------
+
+JILError JILSaveCSource(JILState* pState, const JILChar* pName, JILUnknown** ppData, JILLong* pDataSize)
+{
+	JILAotText out;
+	JILAotFunc f;
+	JILFuncInfo* pFunc;
+	JILByte* pFlags;
+	JILLong i, addr, numEntries;
+	JILLong codeSize = pState->vmpCodeSegment->usedSize;
+
+	// clear given variables
+	*ppData = NULL;
+	*pDataSize = 0;
+	if( !JILIsIdentifier(pName) )
+		return JIL_ERR_Illegal_Argument;
+
+	// make sure we don't translate quickened instructions
+	JILDequickenCode(pState);
+
+	pFlags = (JILByte*) malloc(codeSize + 1);
+	if( pFlags == NULL )
+		return JIL_ERR_Save_Chunk_Failed;
+	memset(pFlags, 0, codeSize + 1);
+	memset(&out, 0, sizeof(out));
+
+	Out(&out, "//------------------------------------------------------------------------------\n");
+	Out(&out, "// File: %s.c\n", pName);
+	Out(&out, "//------------------------------------------------------------------------------\n");
+	Out(&out, "// Generated by JILSaveCSource(), do not edit. Compile this file with the\n");
+	Out(&out, "// \"include\" and \"src\" directories of the library in the include path, and\n");
+	Out(&out, "// call %s_Register() after loading the binary with JILLoadBinary().\n", pName);
+	Out(&out, "//------------------------------------------------------------------------------\n\n");
+	Out(&out, "#include \"jilstdinc.h\"\n");
+	Out(&out, "#include \"jilaot.h\"\n\n");
+
+	// translate all functions
+	for( i = 0; i < pState->vmpFuncSegment->usedSize; i++ )
+	{
+		pFunc = pState->vmpFuncSegment->pData + i;
+		if( pFunc->codeSize <= 0 )
+			continue;
+		memset(&f, 0, sizeof(f));
+		f.pState = pState;
+		f.pCode = pState->vmpCodeSegment->pData;
+		f.pFlags = pFlags;
+		f.codeAddr = pFunc->codeAddr;
+		f.codeSize = pFunc->codeSize;
+		JILAotTranslateFunc(&out, &f);
+		free(f.body.pBuf);
+	}
+
+	// write the entry point table
+	Out(&out, "//------------------------------------------------------------------------------\n");
+	Out(&out, "// entry points\n");
+	Out(&out, "//------------------------------------------------------------------------------\n\n");
+	Out(&out, "static const JILCompiledEntry kEntries[] =\n{\n");
+	numEntries = 0;
+	for( i = 0; i < pState->vmpFuncSegment->usedSize; i++ )
+	{
+		pFunc = pState->vmpFuncSegment->pData + i;
+		if( pFunc->codeSize <= 0 || pFunc->codeAddr < 0 || pFunc->codeAddr + pFunc->codeSize > codeSize )
+			continue;
+		for( addr = pFunc->codeAddr; addr < pFunc->codeAddr + pFunc->codeSize; addr++ )
+		{
+			if( pFlags[addr] & kAotEntry )
+			{
+				Out(&out, "\t{ %d, fn_%d },\n", addr, pFunc->codeAddr);
+				pFlags[addr] &= ~kAotEntry;
+				numEntries++;
+			}
+		}
+	}
+	Out(&out, "\t{ -1, NULL }\n};\n\n");
+	Out(&out, "static const JILCompiledCode kCompiledCode =\n{\n");
+	Out(&out, "\t%d,\t// code size\n", codeSize);
+	Out(&out, "\t%d,\t// checksum\n", JILCodeChecksum(pState));
+	Out(&out, "\t%d,\t// number of entry points\n", numEntries);
+	Out(&out, "\tkEntries\n};\n\n");
+
+	// write the registration function
+	Out(&out, "//------------------------------------------------------------------------------\n");
+	Out(&out, "// %s_Register\n", pName);
+	Out(&out, "//------------------------------------------------------------------------------\n\n");
+	Out(&out, "JILError %s_Register(JILState* pState)\n{\n", pName);
+	Out(&out, "\treturn JILRegisterCompiledCode(pState, &kCompiledCode);\n}\n");
+	free(pFlags);
+
+	if( out.failed )
+	{
+		free(out.pBuf);
+		return JIL_ERR_Save_Chunk_Failed;
+	}
+	// hand the text over to the chunk buffer
+	if( pState->vmpChunkBuffer )
+		free( pState->vmpChunkBuffer );
+	pState->vmpChunkBuffer = out.pBuf;
+	*ppData = out.pBuf;
+	*pDataSize = out.length;
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILRegisterCompiledCode
+//------------------------------------------------------------------------------
+
+JILError JILRegisterCompiledCode(JILState* pState, const JILCompiledCode* pCode)
+{
+	JILLong i;
+	JILLong address;
+	JILLong codeSize = pState->vmpCodeSegment->usedSize;
+
+	JILResetCompiledCode(pState);
+	JILDequickenCode(pState);
+	if( pCode->codeSize != codeSize || pCode->checksum != JILCodeChecksum(pState) )
+		return JIL_ERR_Load_Chunk_Failed;
+	pState->vmppCompiledCode = (JILCompiledProc*) malloc(codeSize * sizeof(JILCompiledProc));
+	if( pState->vmppCompiledCode == NULL )
+		return JIL_VM_Allocation_Failed;
+	for( i = 0; i < codeSize; i++ )
+		pState->vmppCompiledCode[i] = NULL;
+	for( i = 0; i < pCode->numEntries; i++ )
+	{
+		address = pCode->pEntries[i].address;
+		if( address >= 0 && address < codeSize )
+			pState->vmppCompiledCode[address] = pCode->pEntries[i].proc;
+	}
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILResetCompiledCode
+//------------------------------------------------------------------------------
+
+void JILResetCompiledCode(JILState* pState)
+{
+	if( pState->vmppCompiledCode )
+	{
+		free( pState->vmppCompiledCode );
+		pState->vmppCompiledCode = NULL;
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILCodeChecksum
+//------------------------------------------------------------------------------
+// FNV-1a over all code words.
+
+JILLong JILCodeChecksum(JILState* pState)
+{
+	JILUInt32 hash = 2166136261u;
+	JILLong i;
+	for( i = 0; i < pState->vmpCodeSegment->usedSize; i++ )
+	{
+		hash ^= (JILUInt32) pState->vmpCodeSegment->pData[i];
+		hash *= 16777619u;
+	}
+	return (JILLong) hash;
+}
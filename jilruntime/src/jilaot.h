@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// File: JILAot.h                                              (c) 2026 jewe.org
+//------------------------------------------------------------------------------
+//
+// DISCLAIMER:
+// -----------
+//	THIS SOFTWARE IS SUBJECT TO THE LICENSE AGREEMENT FOUND IN "jilapi.h" AND
+//	"COPYING". BY USING THIS SOFTWARE YOU IMPLICITLY DECLARE YOUR AGREEMENT TO
+//	THE TERMS OF THIS LICENSE.
+//
+// Description:
+// ------------
+/// @file jilaot.h
+/// Support for ahead-of-time compiled code, see JILSaveCSource(). This file is
+/// included by the C source files generated by JILSaveCSource() and defines
+/// the macros they use.
+//------------------------------------------------------------------------------
+
+#ifndef JILAOT_H
+#define JILAOT_H
+
+#include "jiltypes.h"
+#include "jilapi.h"
+#include "jilsegment.h"
+#include "jilhandle.h"
+#include "jilopmacros.h"
+
+//------------------------------------------------------------------------------
+// JIL_AOT_R
+//------------------------------------------------------------------------------
+// Load effective address of a handle. Addressing mode 'rn'.
+
+#define JIL_AOT_R(PP,N)			PP = pContext->vmppRegister + (N);
+
+//------------------------------------------------------------------------------
+// JIL_AOT_S
+//------------------------------------------------------------------------------
+// Load effective address of a handle. Addressing mode 'd(sp)'.
+
+#define JIL_AOT_S(PP,N)			PP = pContext->vmppDataStack + (pContext->vmDataStackPointer + (N) - pContext->vmDataStackLimit);
+
+//------------------------------------------------------------------------------
+// JIL_AOT_D
+//------------------------------------------------------------------------------
+// Load effective address of a handle. Addressing mode 'd(rn)'. Leaves the
+// compiled code if the object is null, the VM will throw the exception.
+
+#define JIL_AOT_D(PP,R,N,ADDR) \
+	pHObject = (JILHandleObject*) pContext->vmppRegister[R];\
+	JIL_AOT_EXIT_IF(pHObject->type == type_null, ADDR)\
+	PP = pHObject->ppHandles + (N);
+
+//------------------------------------------------------------------------------
+// JIL_AOT_H
+//------------------------------------------------------------------------------
+// Load the address of a handle from the data segment.
+
+#define JIL_AOT_H(PP,N)			PP = pState->vmppHandles + pState->vmpDataSegment->pData[N].index;
+
+//------------------------------------------------------------------------------
+// JIL_AOT_COUNT
+//------------------------------------------------------------------------------
+// Counts an instruction executed by compiled code, or takes the count back if
+// the instruction leaves compiled code, because the VM executes and counts it
+// again. See JIL_USE_INSTRUCTION_COUNTER.
+
+#if JIL_USE_INSTRUCTION_COUNTER
+#define JIL_AOT_COUNT			pState->vmInstructionCounter++;
+#define JIL_AOT_UNCOUNT			pState->vmInstructionCounter--;
+#else
+#define JIL_AOT_COUNT
+#define JIL_AOT_UNCOUNT
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_AOT_EXIT, JIL_AOT_EXIT_IF
+//------------------------------------------------------------------------------
+// Leaves the compiled code at the current instruction and lets the VM execute
+// it, because its operands are not as expected.
+
+#define JIL_AOT_EXIT(ADDR)			{ JIL_AOT_UNCOUNT return (ADDR); }
+#define JIL_AOT_EXIT_IF(COND,ADDR)	if( COND ) JIL_AOT_EXIT(ADDR)
+
+//------------------------------------------------------------------------------
+// JIL_AOT_IS, JIL_AOT_INT, JIL_AOT_FLOAT
+//------------------------------------------------------------------------------
+// Access the type and value of the handle an effective address points to.
+
+#define JIL_AOT_IS(PP,T)		((*(PP))->type == (T))
+#define JIL_AOT_INT(PP)			(JILGetIntHandle(*(PP))->l)
+#define JIL_AOT_FLOAT(PP)		(JILGetFloatHandle(*(PP))->f)
+
+//------------------------------------------------------------------------------
+// JILCodeChecksum
+//------------------------------------------------------------------------------
+// Calculates a checksum over the code segment, used to make sure compiled
+// code is only used with the bytecode it has been generated from. The code
+// must not contain quickened instructions.
+
+JILLong					JILCodeChecksum			(JILState* pState);
+
+//------------------------------------------------------------------------------
+// JILResetCompiledCode
+//------------------------------------------------------------------------------
+// Discards the entry points registered by JILRegisterCompiledCode(). Called
+// when code is written into the code segment, or the runtime is terminated.
+
+void					JILResetCompiledCode	(JILState* pState);
+
+#endif	// #ifndef JILAOT_H
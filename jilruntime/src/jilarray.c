@@ -57,7 +57,9 @@ enum
 	kPushItem,
 	kPopItem,
 	kSort,
-	kIndexOf
+	kIndexOf,
+	kSortAscending,
+	kSortDescending
 };
 
 //------------------------------------------------------------------------------
@@ -86,8 +88,10 @@ static const JILChar* kClassDeclaration =
 	"method				enumerate(enumerator fn, var args);" TAG("Calls a delegate function for every element in this array. The delegate can read or modify each element that is passed to it. If the given array is multi-dimensional, this function recursively processes all elements. The delegate is not called for elements that contain null-references.")
 	"method				push(var item);" TAG("Adds the specified item to the end of this array. This actually modifies the array and allows to use it like a stack.")
 	"method	var			pop();" TAG("Removes the top level element from this array and returns it. If the array is currently empty, null is returned. This actually modifies the array and allows to use it like a stack.")
-	"method	array		sort(comparator fn);" TAG("Sorts this array's elements according to the specified comparator delegate.")
+	"method	array		sort(comparator fn);" TAG("Sorts this array's elements according to the specified comparator delegate. The sort is stable, elements the delegate considers equal keep their order.")
 	"method int			indexOf(var item, const int index);" TAG("Searches 'item' in a one-dimensional array and returns the index of the first occurrence. The search starts at the given 'index' position. Integers, floats and strings will be compared by value, all other types will be compared by reference. If no element is found, -1 is returned.")
+	"method	array		sortAscending();" TAG("Sorts this array's elements in ascending order and returns the result as a new array. Integers, floats and strings are compared by value, without calling a delegate. Elements of different types are ordered by type, all other elements are considered equal. The sort is stable.")
+	"method	array		sortDescending();" TAG("Sorts this array's elements in descending order and returns the result as a new array. Integers, floats and strings are compared by value, without calling a delegate. Elements of different types are ordered by type, all other elements are considered equal. The sort is stable.")
 ;
 
 //------------------------------------------------------------------------------
@@ -352,6 +356,13 @@ static int ArrayCallMember(NTLInstance* pInst, int funcID, JILArray* _this)
 			NTLFreeHandle(ps, hItem);
 			break;
 		}
+		case kSortAscending:
+		case kSortDescending:
+			pArr = JILArray_SortValues(_this, funcID == kSortDescending);
+			hArr = NTLNewHandleForObject(ps, type_array, pArr);
+			NTLReturnHandle(ps, hArr);
+			NTLFreeHandle(ps, hArr);
+			break;
 		default:
 			result = JIL_ERR_Invalid_Function_Index;
 			break;
@@ -392,6 +403,22 @@ void JILArrayHandleToStringF(JILState*, JILString*, const JILString*, JILHandle*
 static JILArray* JILArrayPreAlloc(JILState*, JILLong);
 static void JILArrayReAlloc(JILArray*, JILLong, JILLong);
 static void JILArrayDeAlloc(JILArray*);
+static JILError ArrayCompareDelegate(JILUnknown*, JILUnknown*, JILUnknown*, JILLong*);
+static JILError ArrayCompareAscending(JILUnknown*, JILUnknown*, JILUnknown*, JILLong*);
+static JILError ArrayCompareDescending(JILUnknown*, JILUnknown*, JILUnknown*, JILLong*);
+
+//------------------------------------------------------------------------------
+// struct ArraySortDelegate
+//------------------------------------------------------------------------------
+// Passed to ArrayCompareDelegate() when sorting with a comparator delegate.
+
+typedef struct
+{
+	JILState*		pState;
+	JILHandle*		pDelegate;
+	JILStackFrame	frame;
+
+} ArraySortDelegate;
 
 //------------------------------------------------------------------------------
 // JILArray_New
@@ -1013,47 +1040,53 @@ JILError JILArray_Enumerate(JILArray* _this, JILHandle* pDelegate, JILHandle* pA
 //------------------------------------------------------------------------------
 // JILArray_Sort
 //------------------------------------------------------------------------------
-/// Calls a comparator delegate and sorts this array. This will fail if the
-/// array is multi-dimensional.
+/// Calls a comparator delegate and sorts a copy of this array, using a stable
+/// merge sort. All calls to the delegate share one stack frame. Fails with
+/// JIL_ERR_Runtime_Blocked if script code can't be called.
 
 JILError JILArray_Sort(JILArray* _this, JILHandle* pDelegate, JILArray** ppNew)
 {
-	JILLong i, j, res;
-	JILError err;
-	JILHandle* pResult;
+	JILError err = JIL_No_Exception;
 	JILArray* pNew;
+	ArraySortDelegate sd;
 	JILState* ps = _this->pState;
 
 	*ppNew = pNew = JILArray_Copy(_this);
-	for( i = 1; i < pNew->size; i++ )
-    {
-        for( j = i; j >= 1; j-- )
-        {
-			// call our delegate to compare both elements
-			pResult = JILCallFunction(ps, pDelegate, 2, kArgHandle, pNew->ppHandles[j - 1], kArgHandle, pNew->ppHandles[j]);
-			res = NTLHandleToInt(ps, pResult);
-			err = NTLHandleToError(ps, pResult);
-			NTLFreeHandle(ps, pResult);
-			if( err )
-				goto exit;
-            if( res > 0 )
-            {
-				JILArray_Swap(pNew, j - 1, j);
-            }
-            else
-            {
-                break;
-            }
-        }
-    }
-	return JIL_No_Exception;
-
-exit:
-	JILArray_Delete(pNew);
-	*ppNew = NULL;
+	if( pNew->size < 2 )
+		return JIL_No_Exception;
+	if( !ps->vmInitialized || ps->vmBlocked )
+		err = JIL_ERR_Runtime_Blocked;
+	// room for the stack frame and the comparator's arguments
+	else if( (err = JILGrowStack(ps, ps->vmpContext, 4, 0, JILTrue)) == JIL_No_Exception )
+	{
+		sd.pState = ps;
+		sd.pDelegate = pDelegate;
+		JILPushStackFrame(ps, &sd.frame);
+		err = JILSort((JILUnknown**) pNew->ppHandles, pNew->size, ArrayCompareDelegate, &sd);
+		JILPopStackFrame(ps, &sd.frame);
+	}
+	if( err )
+	{
+		JILArray_Delete(pNew);
+		*ppNew = NULL;
+	}
 	return err;
 }
 
+//------------------------------------------------------------------------------
+// JILArray_SortValues
+//------------------------------------------------------------------------------
+/// Sorts a copy of this array by the values of its elements, without calling
+/// any script code. Integers, floats and strings are compared by value, other
+/// elements of the same type are considered equal.
+
+JILArray* JILArray_SortValues(JILArray* _this, JILBool descending)
+{
+	JILArray* pNew = JILArray_Copy(_this);
+	JILSort((JILUnknown**) pNew->ppHandles, pNew->size, descending ? ArrayCompareDescending : ArrayCompareAscending, NULL);
+	return pNew;
+}
+
 //------------------------------------------------------------------------------
 // JILArray_IndexOf
 //------------------------------------------------------------------------------
@@ -1308,3 +1341,56 @@ static void JILArrayDeAlloc(JILArray* _this)
 	_this->size = 0;
 	_this->maxSize = 0;
 }
+
+//------------------------------------------------------------------------------
+// ArrayCompareDelegate
+//------------------------------------------------------------------------------
+// Compare callback for JILSort(), calls the comparator delegate.
+
+static JILError ArrayCompareDelegate(JILUnknown* pUser, JILUnknown* pItem1, JILUnknown* pItem2, JILLong* pResult)
+{
+	ArraySortDelegate* sd = (ArraySortDelegate*) pUser;
+	return JILCallComparator(sd->pState, &sd->frame, sd->pDelegate, (JILHandle*) pItem1, (JILHandle*) pItem2, pResult);
+}
+
+//------------------------------------------------------------------------------
+// ArrayCompareValues
+//------------------------------------------------------------------------------
+// Compares two elements by type first, then integers, floats and strings by
+// value.
+
+static JILLong ArrayCompareValues(JILHandle* h1, JILHandle* h2)
+{
+	if( h1->type != h2->type )
+		return (h1->type > h2->type) ? 1 : -1;
+	switch( h1->type )
+	{
+		case type_int:
+			return (JILGetIntHandle(h1)->l > JILGetIntHandle(h2)->l) - (JILGetIntHandle(h1)->l < JILGetIntHandle(h2)->l);
+		case type_float:
+			return (JILGetFloatHandle(h1)->f > JILGetFloatHandle(h2)->f) - (JILGetFloatHandle(h1)->f < JILGetFloatHandle(h2)->f);
+		case type_string:
+			return JILString_Compare(JILGetStringHandle(h1)->str, JILGetStringHandle(h2)->str);
+	}
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+// ArrayCompareAscending
+//------------------------------------------------------------------------------
+
+static JILError ArrayCompareAscending(JILUnknown* pUser, JILUnknown* pItem1, JILUnknown* pItem2, JILLong* pResult)
+{
+	*pResult = ArrayCompareValues((JILHandle*) pItem1, (JILHandle*) pItem2);
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// ArrayCompareDescending
+//------------------------------------------------------------------------------
+
+static JILError ArrayCompareDescending(JILUnknown* pUser, JILUnknown* pItem1, JILUnknown* pItem2, JILLong* pResult)
+{
+	*pResult = ArrayCompareValues((JILHandle*) pItem2, (JILHandle*) pItem1);
+	return JIL_No_Exception;
+}
@@ -64,6 +64,7 @@ JILArray*		JILArray_Remove(JILArray* _this, JILLong index, JILLong length);
 JILArray*		JILArray_SubArray(JILArray* _this, JILLong index, JILLong length);
 void			JILArray_Swap(JILArray* _this, JILLong index1, JILLong index2);
 JILError		JILArray_Sort(JILArray* _this, JILHandle* pDelegate, JILArray** ppNew);
+JILArray*		JILArray_SortValues(JILArray* _this, JILBool descending);
 JILLong			JILArray_IndexOf(JILArray* _this, JILHandle* hItem, JILLong index);
 
 JILString*		JILArray_Format(JILArray* _this, JILString* pFormat);
@@ -134,4 +134,13 @@ JILINLINE JILError CallNTLGetPackageString(JILTypeProc proc, const JILChar** ppO
 	return proc(NULL, NTL_GetPackageString, 0, NULL, (void**) ppOut);
 }
 
+//------------------------------------------------------------------------------
+// direct calls
+//------------------------------------------------------------------------------
+// Calls a function from the NTLDirectCall table of a native type, passing the
+// arguments from the stack and setting the return register. pObj is only used
+// for member functions.
+
+void CallNTLDirect(JILState* pState, const NTLDirectCall* pCall, JILUnknown* pObj);
+
 #endif	// #ifdef JILCALLNTL_H
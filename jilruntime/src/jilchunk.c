@@ -157,6 +157,9 @@ JILError JILSaveBinary(JILState* pState, JILUnknown** ppData, JILLong* pDataSize
 	*ppData = NULL;
 	*pDataSize = 0;
 
+	// make sure we don't save quickened instructions
+	JILDequickenCode(pState);
+
 	// prepare chunk header
 	memset( &header, 0, sizeof(JILChunkHeader) );
 	CreateChunkID(header.cnkMagic, sizeof(header.cnkMagic));
@@ -60,6 +60,7 @@ static void		JILGetCalln			(JILState* pState, JILChar* pDst, JILLong maxLen, JIL
 static void		JILGetJsr			(JILState* pState, JILChar* pDst, JILLong maxLen, JILLong addr);
 static void		JILGetNewctx		(JILState* pState, JILChar* pDst, JILLong maxLen, JILLong addr);
 static void		JILGetNewdg			(JILState* pState, JILChar* pDst, JILLong maxLen, JILLong addr);
+static void		JILGetOpcodeName	(JILChar* pDst, JILLong maxLen, JILLong opcode);
 
 //------------------------------------------------------------------------------
 // JILGetInstructionSize
@@ -423,7 +424,7 @@ void JILListCallStack(JILState* pState, JILLong maxTraceback)
 	numStack = (numStack < maxTraceback) ? numStack : maxTraceback;
 	for( i = 0; i < numStack; i++ )
 	{
-		addr = pContext->vmpCallStack[pContext->vmCallStackPointer + i];
+		addr = JILCallStack(pContext, pContext->vmCallStackPointer + i);
 		if( addr == kReturnToNative )
 		{
 			JILMessageLog(pState, "%4d: native_entry_point()\n", i+1, addr);
@@ -441,6 +442,54 @@ error:
 	return;
 }
 
+//------------------------------------------------------------------------------
+// JILListOpcodePairs
+//------------------------------------------------------------------------------
+// Outputs the most frequently executed opcode pairs to the log output callback.
+
+void JILListOpcodePairs(JILState* pState, JILLong maxPairs)
+{
+	JILLong i, j;
+	JILLong numPairs = 0;
+	JILLong pairs[64];
+	JILUInt64* pCounts = pState->vmpOpcodePairs;
+	JILFloat total = 0.0;
+
+	if( !pCounts )
+		return;
+	if( maxPairs > 64 )
+		maxPairs = 64;
+
+	// keep the indexes of the highest counts, in descending order
+	for( i = 0; i < JILNumOpcodes * JILNumOpcodes; i++ )
+	{
+		if( !pCounts[i] )
+			continue;
+		total += (JILFloat) pCounts[i];
+		if( numPairs == maxPairs && pCounts[i] <= pCounts[pairs[numPairs - 1]] )
+			continue;
+		if( numPairs < maxPairs )
+			numPairs++;
+		for( j = numPairs - 1; j > 0 && pCounts[pairs[j - 1]] < pCounts[i]; j-- )
+			pairs[j] = pairs[j - 1];
+		pairs[j] = i;
+	}
+
+	JILMessageLog(pState, "Most frequently executed opcode pairs:\n");
+	for( i = 0; i < numPairs; i++ )
+	{
+		JILChar name1[32];
+		JILChar name2[32];
+		JILGetOpcodeName(name1, sizeof(name1), pairs[i] / JILNumOpcodes);
+		JILGetOpcodeName(name2, sizeof(name2), pairs[i] % JILNumOpcodes);
+		JILMessageLog(pState, "%12.0f %6.2f%%  %-12s %s\n",
+			(JILFloat) pCounts[pairs[i]],
+			(JILFloat) pCounts[pairs[i]] * 100.0 / total,
+			name1,
+			name2);
+	}
+}
+
 //------------------------------------------------------------------------------
 // JILOutputCrashLog
 //------------------------------------------------------------------------------
@@ -478,7 +527,7 @@ void JILOutputCrashLog(JILState* ps)
 
 	JILMessageLog(ps, "\n*** LISTING STACK CONTENTS ***\n\n");
 	pContext = ps->vmpContext;
-	numStack = ps->vmDataStackSize - pContext->vmDataStackPointer - kNumRegisters;
+	numStack = ps->vmDataStackSize - pContext->vmDataStackPointer;
 	if( numStack < 0 )
 	{
 		JILMessageLog(ps, "DATA STACK OVERFLOW: %d\n", numStack);
@@ -488,7 +537,7 @@ void JILOutputCrashLog(JILState* ps)
 		numStack = numStack < 100 ? numStack : 100;
 		for( r = 0; r < numStack; r++ )
 		{
-			JILListHandle(ps, pContext->vmppDataStack[pContext->vmDataStackPointer + r], str, kMaxStringLength);
+			JILListHandle(ps, JILDataStack(pContext, pContext->vmDataStackPointer + r), str, kMaxStringLength);
 			JILMessageLog(ps, "%5d: %s\n", r, str);
 		}
 	}
@@ -876,3 +925,33 @@ void JILCheckInstructionTables(JILState* ps)
 	}
 	JILMessageLog(ps, "%d error(s) in instruction table\n", e);
 }
+
+//------------------------------------------------------------------------------
+// JILGetOpcodeName
+//------------------------------------------------------------------------------
+// Returns the mnemonic of an opcode, followed by the addressing modes of its
+// operands, for example "move_sr". Used to tell apart instructions with the
+// same mnemonic in the opcode pair profile.
+
+static void JILGetOpcodeName(JILChar* pDst, JILLong maxLen, JILLong opcode)
+{
+	const JILInstrInfo* pInfo = JILGetInfoFromOpcode(opcode);
+	JILChar modes[5];
+	JILLong i;
+	JILLong n = 0;
+	for( i = 0; i < pInfo->numOperands; i++ )
+	{
+		switch( pInfo->opType[i] )
+		{
+			case ot_ear: modes[n++] = 'r'; break;
+			case ot_ead: modes[n++] = 'd'; break;
+			case ot_eax: modes[n++] = 'x'; break;
+			case ot_eas: modes[n++] = 's'; break;
+		}
+	}
+	modes[n] = 0;
+	if( n )
+		JILSnprintf(pDst, maxLen, "%s_%s", pInfo->name, modes);
+	else
+		JILSnprintf(pDst, maxLen, "%s", pInfo->name);
+}
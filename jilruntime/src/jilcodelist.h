@@ -82,6 +82,16 @@ JILEXTERN void					JILListCode				(JILState* pState, JILLong from, JILLong to, J
 
 JILEXTERN void					JILListCallStack		(JILState* pState, JILLong maxTraceback);
 
+//------------------------------------------------------------------------------
+// JILListOpcodePairs
+//------------------------------------------------------------------------------
+/// Outputs the most frequently executed opcode pairs to the log output
+/// callback. 'maxPairs' specifies the maximum number of pairs to print out.
+/// This only produces output if the library has been built with
+/// JIL_USE_OPCODE_PROFILING enabled. @see JILSetLogCallback ()
+
+JILEXTERN void					JILListOpcodePairs		(JILState* pState, JILLong maxPairs);
+
 //------------------------------------------------------------------------------
 // JILOutputCrashLog
 //------------------------------------------------------------------------------
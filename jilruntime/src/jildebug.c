@@ -87,7 +87,7 @@ JILError JILGetRuntimeHandle(JILState* pState, JILLong hObject, JILHandle* pOutD
 	if( hObject >= 0 && hObject < pState->vmMaxHandles )
 	{
 		// if the refCount is zero, don't return the handle, it's dead.
-		if( pState->vmppHandles[hObject]->refCount > 0 )
+		if( pState->vmppHandles[hObject] && pState->vmppHandles[hObject]->refCount > 0 )
 		{
 			*pOutData = *pState->vmppHandles[hObject];
 			result = JIL_No_Exception;
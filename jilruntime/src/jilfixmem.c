@@ -10,8 +10,15 @@
 //
 // Description:
 // ------------
-//	A memory manager class for allocating and freeing fixed-size blocks of
-//  memory.
+//	A slab allocator for allocating and freeing small blocks of memory.
+//	Blocks are grouped into size classes. Each size class allocates its blocks
+//	from slabs, which are bigger chunks of memory holding blocks of the same
+//	size. Every block is preceded by a pointer to its slab, so a block can be
+//	freed without searching. Slabs that become empty are returned to the
+//	C-runtime, except for one per size class, which is kept for fast reuse.
+//	Blocks bigger than the biggest size class are allocated using malloc().
+//	All slabs and large blocks are linked into lists, so they can be released
+//	when the memory manager is deleted, even if blocks have been leaked.
 //------------------------------------------------------------------------------
 
 #include "jilstdinc.h"
@@ -22,184 +29,248 @@
 // private structs
 //------------------------------------------------------------------------------
 
-typedef struct JILFixMemBucket	JILFixMemBucket;
+typedef struct JILFixMemSlab	JILFixMemSlab;
+typedef struct JILFixMemClass	JILFixMemClass;
+typedef struct JILFixMemLarge	JILFixMemLarge;
 
-typedef struct JILFixMemBlock	JILFixMemBlock;
-struct JILFixMemBlock
+struct JILFixMemSlab
 {
-	JILFixMemBucket*	bucket;			// ptr back to owner bucket
-	JILLong				size;			// must keep track of size (large block support)
+	JILFixMemSlab*		pPrev;			// previous slab in the list of slabs with free blocks
+	JILFixMemSlab*		pNext;			// next slab in the list of slabs with free blocks
+	JILFixMemSlab*		pPrevAll;		// previous slab in the list of all slabs
+	JILFixMemSlab*		pNextAll;		// next slab in the list of all slabs
+	JILFixMemClass*		pClass;			// size class the slab belongs to
+	JILChar*			pFree;			// first freed block, the next one is stored in the block
+	JILChar*			pBump;			// next block that has never been used
+	JILLong				numUsed;		// number of allocated blocks
 };
 
-struct JILFixMemBucket
+struct JILFixMemClass
 {
-	JILChar*			pMemory;
-	JILFixMemBucket*	pPrev;
-	JILFixMemBucket*	pNext;
-	JILFixMemBlock**	ppFreeBlocks;
-	JILLong				numFreeBlocks;
+	JILFixMemSlab*		pFirst;			// list of slabs with free blocks
+	JILFixMemSlab*		pAll;			// list of all slabs, including full ones
+	JILLong				blockSize;		// size of the blocks, without the slab pointer
+	JILLong				slotSize;		// size of the blocks, including the slab pointer
+	JILLong				slabBlocks;		// number of blocks per slab
+	JILLong				maxBlocks;		// maximum number of allocated blocks, or 0 for no limit
+	JILLong				numBlocks;		// number of allocated blocks
+	JILLong				numEmpty;		// number of empty slabs that are kept
 };
 
-struct JILFixMem
+struct JILFixMemLarge
 {
-	JILFixMemBucket*	pFirst;
-	JILMemStats*		pStats;
-	JILLong				blockSize;
-	JILLong				bucketSize;
-	JILLong				currentBucket;
-	JILLong				maxBuckets;
-	JILLong				realBlockSize;
-	JILLong				dynamicGrowth;
+	JILFixMemLarge*		pPrev;			// previous large block
+	JILFixMemLarge*		pNext;			// next large block
+	JILLong				size;			// size of the block, without the header
 };
 
 //------------------------------------------------------------------------------
 // static constants
 //------------------------------------------------------------------------------
 
-const long kDynamicGrowthSize = 32;
-const long kDefaultBucketSize = 32;
+#define kNumClasses		14
+
+static const JILLong kClassSizes[kNumClasses] =
+{
+	8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+static const JILLong kMaxClassSize	= 1024;		// biggest size class
+static const JILLong kSlabSize		= 16384;	// bytes per slab
+static const JILLong kSlabHeader	= (sizeof(JILFixMemSlab) + 15) & ~15;
+static const JILLong kBlockHeader	= sizeof(JILFixMemSlab*);
+static const JILLong kLargeHeader	= (sizeof(JILFixMemLarge) + sizeof(JILFixMemSlab*) + 15) & ~15;
+static const JILLong kKeepEmpty		= 1;		// empty slabs kept per size class
+
+struct JILFixMem
+{
+	JILFixMemClass		classes[kNumClasses];
+	JILByte				sizeToClass[(1024 >> 3) + 1];	// size class of each size in steps of 8 bytes
+	JILFixMemLarge*		pLarge;							// list of allocated large blocks
+	JILMemStats*		pStats;
+};
 
 //------------------------------------------------------------------------------
 // static functions
 //------------------------------------------------------------------------------
 
-static JILFixMemBucket* JILNewBucket(JILFixMem* _this);
-static void JILLinkBucket(JILFixMem* _this, JILFixMemBucket* pBucket);
-static void JILUnlinkBucket(JILFixMem* _this, JILFixMemBucket* pBucket);
+static JILFixMemSlab* JILNewSlab(JILFixMem* _this, JILFixMemClass* pClass);
+static void JILFreeSlab(JILFixMem* _this, JILFixMemSlab* pSlab);
+static void JILLinkSlab(JILFixMemClass* pClass, JILFixMemSlab* pSlab);
+static void JILUnlinkSlab(JILFixMemClass* pClass, JILFixMemSlab* pSlab);
+static JILChar* JILAllocLargeBlock(JILFixMem* _this, JILLong size);
+static void JILFreeLargeBlock(JILFixMem* _this, JILFixMemLarge* pLarge);
+
+//------------------------------------------------------------------------------
+// JILSlabOf
+//------------------------------------------------------------------------------
+// Returns the slab of the given block, or NULL for a large block.
+
+JILINLINE JILFixMemSlab* JILSlabOf(JILChar* pBuffer)
+{
+	return *((JILFixMemSlab**) (pBuffer - kBlockHeader));
+}
+
+//------------------------------------------------------------------------------
+// JILLargeOf
+//------------------------------------------------------------------------------
+// Returns the header of the given large block.
+
+JILINLINE JILFixMemLarge* JILLargeOf(JILChar* pBuffer)
+{
+	return (JILFixMemLarge*) (pBuffer - kLargeHeader);
+}
 
 //------------------------------------------------------------------------------
 // New_FixMem
 //------------------------------------------------------------------------------
-// Allocates and initializes the fixed memory manager
-//
-// blockSize:  The size (bytes) of the memory blocks returned by FixMem_Alloc()
-// maxBlocks:  The total number of memory blocks the manager should handle
-//             Set this to 0 to use dynamic growth
-// bucketSize: How many blocks are pre-allocated at once
-//             Set this to 0 to use default (32)
+// Allocates and initializes the slab allocator. All size classes have no limit
+// for the number of blocks, use FixMem_SetMaxBlocks() to limit them.
 
-JILFixMem* New_FixMem(JILLong blockSize, JILLong maxBlocks, JILLong bucketSize, JILMemStats* pStats)
+JILFixMem* New_FixMem(JILMemStats* pStats)
 {
-	JILLong freeBuckets;
+	JILLong i, size;
+	JILFixMemClass* pClass;
 
 	JILFixMem* _this = malloc(sizeof(JILFixMem));
 	memset(_this, 0, sizeof(JILFixMem));
+	_this->pStats = pStats;
 
-	if( bucketSize <= 0 )
-		bucketSize = kDefaultBucketSize;
-	if( maxBlocks <= 0 )
+	for( i = 0; i < kNumClasses; i++ )
 	{
-		maxBlocks = kDynamicGrowthSize * bucketSize;
-		_this->dynamicGrowth = JILTrue;
+		pClass = _this->classes + i;
+		pClass->blockSize = kClassSizes[i];
+		pClass->slotSize = kClassSizes[i] + kBlockHeader;
+		pClass->slabBlocks = (kSlabSize - kSlabHeader) / pClass->slotSize;
+	}
+	for( i = 0, size = 0; size <= kMaxClassSize; size += 8 )
+	{
+		if( size > kClassSizes[i] )
+			i++;
+		_this->sizeToClass[size >> 3] = (JILByte) i;
 	}
-	if( maxBlocks < bucketSize )
-		maxBlocks = bucketSize;
-
-	freeBuckets = maxBlocks / bucketSize;
-
-	_this->blockSize = blockSize;
-	_this->bucketSize = bucketSize;
-	_this->maxBuckets = freeBuckets;
-	_this->realBlockSize = blockSize + sizeof(JILFixMemBlock);
-	_this->pStats = pStats;
-
 	return _this;
 }
 
 //------------------------------------------------------------------------------
 // Delete_FixMem
 //------------------------------------------------------------------------------
-// Frees up all memory allocated by this memory manager.
+// Frees up all memory allocated by this memory manager, including slabs and
+// large blocks that still hold leaked blocks.
 
 void Delete_FixMem(JILFixMem* _this)
 {
 	if( _this )
 	{
-		JILLong missingBlocks = 0;
-		JILFixMemBucket* bucket;
-		JILFixMemBucket* next;
-		for( bucket = _this->pFirst; bucket != NULL; bucket = next )
+		JILLong i;
+		JILFixMemClass* pClass;
+		for( i = 0; i < kNumClasses; i++ )
 		{
-			missingBlocks += (_this->bucketSize - bucket->numFreeBlocks);
-			next = bucket->pNext;
-			free( bucket );
-			_this->currentBucket--;
+			pClass = _this->classes + i;
+			#if !JIL_NO_FPRINTF
+			JIL_INSERT_DEBUG_CODE(
+				if( pClass->numBlocks )
+				{
+					fprintf(stderr,
+						"MEMORY LEAK DETECTED IN BLOCK MANAGER:\n"
+						"Block size:          %d\n"
+						"Blocks leaked:       %d\n"
+						"Bytes leaked:        %d\n"
+						"---------------------\n",
+						pClass->blockSize, pClass->numBlocks, pClass->numBlocks * pClass->blockSize
+						);
+				}
+			);
+			#endif
+			while( pClass->pAll )
+				JILFreeSlab(_this, pClass->pAll);
 		}
-		#if !JIL_NO_FPRINTF
-		JIL_INSERT_DEBUG_CODE(
-			if( _this->currentBucket || missingBlocks )
-			{
-				JILLong bytesLeaked = (_this->currentBucket * _this->bucketSize + missingBlocks) * _this->realBlockSize;
-				fprintf(stderr,
-					"MEMORY LEAK DETECTED IN BLOCK MANAGER:\n"
-					"Block size:          %d\n"
-					"Bucket size:         %d\n"
-					"Max buckets:         %d\n"
-					"Dynamic growth:      %s\n"
-					"Buckets leaked:      %d\n"
-					"Blocks leaked:       %d\n"
-					"Bytes leaked:        %d\n"
-					"---------------------\n",
-					_this->blockSize, _this->bucketSize, _this->maxBuckets, _this->dynamicGrowth ? "YES" : "NO",
-					_this->currentBucket, missingBlocks, bytesLeaked
-					);
-			}
-		);
-		#endif
+		while( _this->pLarge )
+			JILFreeLargeBlock(_this, _this->pLarge);
 		free( _this );
 	}
 }
 
+//------------------------------------------------------------------------------
+// FixMem_SetMaxBlocks
+//------------------------------------------------------------------------------
+// Limits the number of blocks of the size classes with a block size greater
+// than 'minSize' and less or equal 'maxSize'. Pass 0 for 'maxBlocks' to
+// remove the limit.
+
+void FixMem_SetMaxBlocks(JILFixMem* _this, JILLong minSize, JILLong maxSize, JILLong maxBlocks)
+{
+	JILLong i;
+	for( i = 0; i < kNumClasses; i++ )
+	{
+		if( kClassSizes[i] > minSize && kClassSizes[i] <= maxSize )
+			_this->classes[i].maxBlocks = (maxBlocks > 0) ? maxBlocks : 0;
+	}
+}
+
 //------------------------------------------------------------------------------
 // FixMem_Alloc
 //------------------------------------------------------------------------------
-// Allocate a memory buffer of the given JILFixMem memory manager's size. Make
-// sure you never step over the buffer's size when writing into it, this will
-// severely mess up the whole memory manager!
+// Allocates a memory buffer of at least the given size. Returns NULL if the
+// limit of blocks of the size class has been reached. Make sure you never step
+// over the buffer's size when writing into it, this will severely mess up the
+// whole memory manager!
 
-JILChar* FixMem_Alloc(JILFixMem* _this)
+JILChar* FixMem_Alloc(JILFixMem* _this, JILLong size)
 {
 	JILChar* pBlock;
-	JILFixMemBucket* pCurrentBucket;
+	JILFixMemSlab* pSlab;
+	JILFixMemClass* pClass;
+	JILMemStats* pStats;
+
+	if( size > kMaxClassSize )
+		return JILAllocLargeBlock(_this, size);
 
-	// get current bucket
-	pCurrentBucket = _this->pFirst;
+	pClass = _this->classes + _this->sizeToClass[(size + 7) >> 3];
+	pSlab = pClass->pFirst;
 
-	// no more free buckets?
-	if( pCurrentBucket == NULL )
+	// no slab with free blocks?
+	if( pSlab == NULL )
 	{
-		// bucket limit reached?
-		if( _this->currentBucket == (_this->maxBuckets - 1) )
-		{
-			if( !_this->dynamicGrowth )
-				return NULL;
-			_this->maxBuckets++;
-		}
-		// allocate a new bucket
-		pCurrentBucket = JILNewBucket(_this);
-		JILLinkBucket(_this, pCurrentBucket);
-		_this->currentBucket++;
+		// block limit reached?
+		if( pClass->maxBlocks && pClass->numBlocks >= pClass->maxBlocks )
+			return NULL;
+		pSlab = JILNewSlab(_this, pClass);
+		if( pSlab == NULL )
+			return NULL;
+		JILLinkSlab(pClass, pSlab);
 	}
 
-	// pop a block from the free block stack
-	pBlock = (JILChar*) pCurrentBucket->ppFreeBlocks[--pCurrentBucket->numFreeBlocks];
-	pBlock += sizeof(JILFixMemBlock);
-
-	// no more blocks in this bucket?
-	if( pCurrentBucket->numFreeBlocks == 0 )
+	// take a freed block, or the next unused block
+	pBlock = pSlab->pFree;
+	if( pBlock )
+	{
+		pSlab->pFree = *((JILChar**) pBlock);
+	}
+	else
 	{
-		// unlink the bucket
-		JILUnlinkBucket(_this, pCurrentBucket);
+		pBlock = pSlab->pBump + kBlockHeader;
+		*((JILFixMemSlab**) pSlab->pBump) = pSlab;
+		pSlab->pBump += pClass->slotSize;
 	}
 
+	if( pSlab->numUsed++ == 0 )
+		pClass->numEmpty--;
+	// no more blocks in this slab?
+	if( pSlab->numUsed == pClass->slabBlocks )
+		JILUnlinkSlab(pClass, pSlab);
+	pClass->numBlocks++;
+
+	// do the statistics
+	pStats = _this->pStats;
+	pStats->numAlloc++;
+	pStats->bytesUsed += pClass->blockSize;
+	if( pStats->bytesUsed > pStats->maxBytesUsed )
+		pStats->maxBytesUsed = pStats->bytesUsed;
+
 	JIL_INSERT_DEBUG_CODE(
 		/* pad memory with 0xCC to show it's created */
-		memset(pBlock, 0xCC, _this->blockSize);
-		/* do the statistics */
-		_this->pStats->numAlloc++;
-		_this->pStats->bytesUsed += _this->blockSize;
-		if( _this->pStats->bytesUsed > _this->pStats->maxBytesUsed )
-			_this->pStats->maxBytesUsed = _this->pStats->bytesUsed;
+		memset(pBlock, 0xCC, pClass->blockSize);
 	)
 
 	return pBlock;
@@ -211,46 +282,79 @@ JILChar* FixMem_Alloc(JILFixMem* _this)
 // Free a memory buffer allocated by FixMem_Alloc(). NEVER try to free a block
 // with this function that has not been allocted by FixMem_Alloc(), but by any
 // other method (f.ex. malloc). The function ASSUMES the given buffer is
-// prepended by a valid JILFixMemBlock descriptor. If it isn't, an application
-// crash is guaranteed!
+// prepended by a pointer to its slab. If it isn't, an application crash is
+// guaranteed!
 
 void FixMem_Free(JILFixMem* _this, JILChar* pBuffer)
 {
-	JILFixMemBucket* pBucket;
-	JILFixMemBlock* pBlock;
-	
-	// convert buffer pointer to a JILFixMemBlock pointer
-	pBlock = (JILFixMemBlock*) (pBuffer - sizeof(JILFixMemBlock));
-
-	// verify block size in block header
-	if( pBlock->size == _this->blockSize )
+	JILFixMemSlab* pSlab;
+	JILFixMemClass* pClass;
+	JILMemStats* pStats = _this->pStats;
+
+	pSlab = JILSlabOf(pBuffer);
+	if( pSlab == NULL )
 	{
-		// store block in free blocks list
-		pBucket = pBlock->bucket;
-		pBucket->ppFreeBlocks[pBucket->numFreeBlocks++] = pBlock;
-		// relink the bucket
-		if( pBucket->pNext == NULL &&
-			pBucket->pPrev == NULL &&
-			_this->pFirst != pBucket )
-		{
-			JILLinkBucket(_this, pBucket);
-		}
+		// large block
+		pStats->numFree++;
+		pStats->bytesUsed -= JILLargeOf(pBuffer)->size;
+		JILFreeLargeBlock(_this, JILLargeOf(pBuffer));
+		return;
+	}
+
+	pClass = pSlab->pClass;
+	pStats->numFree++;
+	pStats->bytesUsed -= pClass->blockSize;
+	JIL_INSERT_DEBUG_CODE(
+		/* pad memory with 0xDD to show it's deleted */
+		memset(pBuffer, 0xDD, pClass->blockSize);
+	)
 
-		JIL_INSERT_DEBUG_CODE(
-			/* pad memory with 0xDD to show it's deleted */
-			memset(pBuffer, 0xDD, pBlock->size);
-			/* do the statistics */
-			_this->pStats->numFree++;
-			_this->pStats->bytesUsed -= _this->blockSize;
-		)
+	// push block onto the free list of the slab
+	*((JILChar**) pBuffer) = pSlab->pFree;
+	pSlab->pFree = pBuffer;
+	pClass->numBlocks--;
+	// relink the slab if it was full
+	if( pSlab->numUsed-- == pClass->slabBlocks )
+		JILLinkSlab(pClass, pSlab);
+	// release the slab if it is empty, but keep some for reuse
+	if( pSlab->numUsed == 0 )
+	{
+		if( pClass->numEmpty < kKeepEmpty )
+			pClass->numEmpty++;
+		else
+			JILFreeSlab(_this, pSlab);
 	}
-	else
+}
+
+//------------------------------------------------------------------------------
+// FixMem_Purge
+//------------------------------------------------------------------------------
+// Returns all empty slabs to the C-runtime, including the ones kept for reuse.
+// Returns the number of bytes released.
+
+JILLong FixMem_Purge(JILFixMem* _this)
+{
+	JILLong i;
+	JILLong bytes = 0;
+	JILFixMemSlab* pSlab;
+	JILFixMemSlab* pNext;
+	JILFixMemClass* pClass;
+
+	for( i = 0; i < kNumClasses; i++ )
 	{
-		// this doesn't seem to be a valid buffer pointer
-		#if !JIL_NO_FPRINTF
-		fprintf(stderr, "ERROR: FixMem_Free() called with invalid buffer pointer\n");
-		#endif
+		pClass = _this->classes + i;
+		for( pSlab = pClass->pFirst; pSlab != NULL; pSlab = pNext )
+		{
+			pNext = pSlab->pNext;
+			if( pSlab->numUsed == 0 )
+			{
+				pClass->numEmpty--;
+				JILFreeSlab(_this, pSlab);
+				bytes += kSlabSize;
+			}
+		}
 	}
+	return bytes;
 }
 
 //------------------------------------------------------------------------------
@@ -263,133 +367,143 @@ void FixMem_Free(JILFixMem* _this, JILChar* pBuffer)
 
 JILLong FixMem_GetBlockLength(JILChar* pBuffer)
 {
-	JILFixMemBlock* pBlock = (JILFixMemBlock*) (pBuffer - sizeof(JILFixMemBlock));
-	return pBlock->size;
+	JILFixMemSlab* pSlab = JILSlabOf(pBuffer);
+	if( pSlab == NULL )
+		return JILLargeOf(pBuffer)->size;
+	return pSlab->pClass->blockSize;
 }
 
 //------------------------------------------------------------------------------
-// FixMem_AllocLargeBlock
+// JILAllocLargeBlock
 //------------------------------------------------------------------------------
 // This will redirect the allocation to the C-Runtime 'malloc' function, but
-// prepends the block with a valid JILFixMemBlock descriptor, so the block can
-// be properly detected as a large block when trying to free it.
+// prepends the block with a header and a NULL slab pointer, so the block can
+// be properly detected as a large block when trying to free it. The header
+// links the block into the list of large blocks.
 
-JILChar* FixMem_AllocLargeBlock(JILLong size, JILMemStats* pStats)
+static JILChar* JILAllocLargeBlock(JILFixMem* _this, JILLong size)
 {
-	JILChar* pBuffer = (JILChar*) malloc(size + sizeof(JILFixMemBlock));
-	JILFixMemBlock* pBlock = (JILFixMemBlock*) pBuffer;
-	pBuffer += sizeof(JILFixMemBlock);
-	pBlock->bucket = NULL;
-	pBlock->size = size;
+	JILMemStats* pStats = _this->pStats;
+	JILFixMemLarge* pLarge = (JILFixMemLarge*) malloc(size + kLargeHeader);
+	JILChar* pBuffer;
+	if( pLarge == NULL )
+		return NULL;
+	pLarge->pPrev = NULL;
+	pLarge->pNext = _this->pLarge;
+	pLarge->size = size;
+	if( _this->pLarge )
+		_this->pLarge->pPrev = pLarge;
+	_this->pLarge = pLarge;
+	pBuffer = (JILChar*) pLarge + kLargeHeader;
+	*((JILFixMemSlab**) (pBuffer - kBlockHeader)) = NULL;
 
 	// do the statistics
-	JIL_INSERT_DEBUG_CODE(
-		pStats->numAlloc++;
-		pStats->bytesUsed += size;
-		if( pStats->bytesUsed > pStats->maxBytesUsed )
-			pStats->maxBytesUsed = pStats->bytesUsed;
-	)
+	pStats->numAlloc++;
+	pStats->bytesUsed += size;
+	if( pStats->bytesUsed > pStats->maxBytesUsed )
+		pStats->maxBytesUsed = pStats->bytesUsed;
 	return pBuffer;
 }
 
 //------------------------------------------------------------------------------
-// FixMem_FreeLargeBlock
+// JILFreeLargeBlock
 //------------------------------------------------------------------------------
-// Free a large memory block by calling the C-Runtime 'free' function. This
-// function ASSUMES that the given buffer pointer is prepended by a
-// JILFixMemBlock descriptor!
+// Unlinks a large block from the list of large blocks and frees it. Does not
+// update the statistics, so leaked blocks freed on teardown are still reported.
 
-void FixMem_FreeLargeBlock(JILChar* pBuffer, JILMemStats* pStats)
+static void JILFreeLargeBlock(JILFixMem* _this, JILFixMemLarge* pLarge)
 {
-	// do the statistics
-	JIL_INSERT_DEBUG_CODE(
-		pStats->numFree++;
-		pStats->bytesUsed -= ((JILFixMemBlock*)(pBuffer - sizeof(JILFixMemBlock)))->size;
-	)
+	if( pLarge->pPrev )
+		pLarge->pPrev->pNext = pLarge->pNext;
+	else
+		_this->pLarge = pLarge->pNext;
+	if( pLarge->pNext )
+		pLarge->pNext->pPrev = pLarge->pPrev;
+	free( pLarge );
+}
+
+//------------------------------------------------------------------------------
+// JILNewSlab
+//------------------------------------------------------------------------------
+// Allocate a new slab for the given size class. The blocks of the slab are
+// handed out in order when the slab has no freed blocks, so the memory of a
+// slab is not touched before it is needed.
 
-	free( pBuffer - sizeof(JILFixMemBlock) );
+static JILFixMemSlab* JILNewSlab(JILFixMem* _this, JILFixMemClass* pClass)
+{
+	JILFixMemSlab* pSlab = (JILFixMemSlab*) malloc(kSlabSize);
+	if( pSlab == NULL )
+		return NULL;
+	pSlab->pPrev = NULL;
+	pSlab->pNext = NULL;
+	pSlab->pPrevAll = NULL;
+	pSlab->pNextAll = pClass->pAll;
+	if( pClass->pAll )
+		pClass->pAll->pPrevAll = pSlab;
+	pClass->pAll = pSlab;
+	pSlab->pClass = pClass;
+	pSlab->pFree = NULL;
+	pSlab->pBump = (JILChar*) pSlab + kSlabHeader;
+	pSlab->numUsed = 0;
+	pClass->numEmpty++;
+	// do the statistics
+	_this->pStats->numBuckets++;
+	_this->pStats->bucketBytes += kSlabSize;
+	return pSlab;
 }
 
 //------------------------------------------------------------------------------
-// JILNewBucket
+// JILFreeSlab
 //------------------------------------------------------------------------------
-// Allocate a new bucket. A bucket is a fixed-sized set of pre-allocated
-// memory blocks.
+// Unlinks a slab from both lists and frees it.
 
-static JILFixMemBucket* JILNewBucket(JILFixMem* _this)
+static void JILFreeSlab(JILFixMem* _this, JILFixMemSlab* pSlab)
 {
-	int i;
-	JILLong size;
-	JILChar* pBlock;
-	JILFixMemBucket* pBucket;
-	// allocate memory in one big chunk
-	size = sizeof(JILFixMemBucket) + _this->bucketSize * _this->realBlockSize + _this->bucketSize * sizeof(JILFixMemBlock*);
-	pBlock = (JILChar*) malloc(size);
-	pBucket = (JILFixMemBucket*) pBlock;
-	pBucket->numFreeBlocks = _this->bucketSize;
-	pBucket->pNext = NULL;
-	pBucket->pPrev = NULL;
-	pBlock += sizeof(JILFixMemBucket);
-	// allocate block memory as one big chunk
-	pBucket->pMemory = pBlock;
-	pBlock += _this->bucketSize * _this->realBlockSize;
-	// allocate stack for pointers to free blocks
-	pBucket->ppFreeBlocks = (JILFixMemBlock**) pBlock;
-	pBlock = pBucket->pMemory;
-	// fill free block stack
-	for( i = 0; i < _this->bucketSize; i++ )
-	{
-		pBucket->ppFreeBlocks[i] = (JILFixMemBlock*) pBlock;
-		pBucket->ppFreeBlocks[i]->bucket = pBucket;
-		pBucket->ppFreeBlocks[i]->size = _this->blockSize;
-		pBlock += _this->realBlockSize;
-	}
+	JILFixMemClass* pClass = pSlab->pClass;
+	JILUnlinkSlab(pClass, pSlab);
+	if( pSlab->pPrevAll )
+		pSlab->pPrevAll->pNextAll = pSlab->pNextAll;
+	else
+		pClass->pAll = pSlab->pNextAll;
+	if( pSlab->pNextAll )
+		pSlab->pNextAll->pPrevAll = pSlab->pPrevAll;
+	free( pSlab );
 	// do the statistics
-	JIL_INSERT_DEBUG_CODE(
-		_this->pStats->bucketBytes += size;
-		_this->pStats->numBuckets++;
-	)
-	return pBucket;
+	_this->pStats->numBuckets--;
+	_this->pStats->bucketBytes -= kSlabSize;
+	_this->pStats->numReleased++;
 }
 
 //------------------------------------------------------------------------------
-// JILLinkBucket
+// JILLinkSlab
 //------------------------------------------------------------------------------
-// Add a bucket to the link list
+// Add a slab to the list of slabs with free blocks
 
-static void JILLinkBucket(JILFixMem* _this, JILFixMemBucket* pBucket)
+static void JILLinkSlab(JILFixMemClass* pClass, JILFixMemSlab* pSlab)
 {
-	JILFixMemBucket* oldFirst = _this->pFirst;
+	JILFixMemSlab* oldFirst = pClass->pFirst;
+	pSlab->pPrev = NULL;
+	pSlab->pNext = oldFirst;
 	if( oldFirst )
-	{
-		_this->pFirst = pBucket;
-		oldFirst->pPrev = pBucket;
-		pBucket->pPrev = NULL;
-		pBucket->pNext = oldFirst;
-	}
-	else
-	{
-		_this->pFirst = pBucket;
-		pBucket->pPrev = NULL;
-		pBucket->pNext = NULL;
-	}
+		oldFirst->pPrev = pSlab;
+	pClass->pFirst = pSlab;
 }
 
 //------------------------------------------------------------------------------
-// JILUnlinkBucket
+// JILUnlinkSlab
 //------------------------------------------------------------------------------
-// JCLRemove a bucket from the link list
+// Remove a slab from the list of slabs with free blocks
 
-static void JILUnlinkBucket(JILFixMem* _this, JILFixMemBucket* pBucket)
+static void JILUnlinkSlab(JILFixMemClass* pClass, JILFixMemSlab* pSlab)
 {
-	JILFixMemBucket* pPrev = pBucket->pPrev;
-	JILFixMemBucket* pNext = pBucket->pNext;
+	JILFixMemSlab* pPrev = pSlab->pPrev;
+	JILFixMemSlab* pNext = pSlab->pNext;
 	if( pPrev )
 		pPrev->pNext = pNext;
 	if( pNext )
 		pNext->pPrev = pPrev;
-	if( _this->pFirst == pBucket )
-		_this->pFirst = pNext;
-	pBucket->pPrev = NULL;
-	pBucket->pNext = NULL;
+	if( pClass->pFirst == pSlab )
+		pClass->pFirst = pNext;
+	pSlab->pPrev = NULL;
+	pSlab->pNext = NULL;
 }
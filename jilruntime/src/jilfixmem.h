@@ -10,8 +10,7 @@
 //
 // Description:
 // ------------
-// A memory manager class for fast allocating and freeing fix-sized blocks of
-// memory.
+// A slab allocator for fast allocating and freeing small blocks of memory.
 //------------------------------------------------------------------------------
 
 #ifndef JILFIXMEM_H
@@ -23,14 +22,14 @@
 // functions
 //------------------------------------------------------------------------------
 
-JILFixMem*				New_FixMem				(JILLong maxBlocks, JILLong blockSize, JILLong bucketSize, JILMemStats* pStats);
+JILFixMem*				New_FixMem				(JILMemStats* pStats);
 void					Delete_FixMem			(JILFixMem* _this);
-JILChar*				FixMem_Alloc			(JILFixMem* _this);
+void					FixMem_SetMaxBlocks		(JILFixMem* _this, JILLong minSize, JILLong maxSize, JILLong maxBlocks);
+JILChar*				FixMem_Alloc			(JILFixMem* _this, JILLong size);
 void					FixMem_Free				(JILFixMem* _this, JILChar* pBuffer);
+JILLong					FixMem_Purge			(JILFixMem* _this);
 
 // Global tool functions
 JILLong					FixMem_GetBlockLength	(JILChar* pBuffer);
-JILChar*				FixMem_AllocLargeBlock	(JILLong size, JILMemStats*);
-void					FixMem_FreeLargeBlock	(JILChar* pBuffer, JILMemStats*);
 
 #endif
@@ -27,6 +27,11 @@
 #include "jilmachine.h"
 #include "jilcallntl.h"
 #include "jilcodelist.h"
+#include "jilfixmem.h"
+
+#ifdef WIN32
+#include <malloc.h>
+#endif
 
 //------------------------------------------------------------------------------
 // externals
@@ -34,35 +39,192 @@
 
 const JILChar* JILGetExceptionString(JILState*, JILError);
 
+//------------------------------------------------------------------------------
+// other constants or variables
+//------------------------------------------------------------------------------
+
+static const JILLong kGCGreyAllocGrain		= 1024;		// grey list entries
+#if JIL_USE_CYCLE_COLLECTOR
+static const JILLong kCCAllocGrain			= 1024;		// candidate buffer and work list entries
+#endif
+static const JILLong kPendingAllocGrain		= 1024;		// pending list entries
+static const JILLong kGCMinHandles			= 65536;	// used handles before the first automatic GC
+static const JILUInt64 kGCMinBytes			= 16 << 20;	// allocated bytes before the first automatic GC
+static const JILLong kHandleGroupSize		= 1024;		// bytes per group of handles, must be a power of two
+
+//------------------------------------------------------------------------------
+// cycle collector modes
+//------------------------------------------------------------------------------
+// Values of JILState::vmCCMode, determine what JILMarkHandle() does with the
+// handles enumerated by JILScanHandle() while the cycle collector is running.
+
+enum
+{
+	kCCNone = 0,		// not collecting cycles
+	kCCMarkGrey,		// trial-delete the reference and make the handle grey
+	kCCScan,			// scan grey handles
+	kCCScanBlack,		// restore the reference and make the handle black
+	kCCCollectWhite,	// collect white handles
+	kCCRestore			// restore the reference
+};
+
+//------------------------------------------------------------------------------
+// internal functions
+//------------------------------------------------------------------------------
+
+#if JIL_USE_CYCLE_COLLECTOR
+static void JILCCVisit(JILState* ps, JILHandle* h);
+static JILError JILCCScanChildren(JILState* ps, JILHandle* h);
+static void JILCCScanGrey(JILState* ps, JILHandle* h);
+static JILError JILCCCollect(JILState* ps);
+#endif
+
+//------------------------------------------------------------------------------
+// JILAllocBucket
+//------------------------------------------------------------------------------
+// Allocates memory for a bucket, aligned to the size of a group of handles.
+
+static JILByte* JILAllocBucket(JILLong size)
+{
+#ifdef WIN32
+	return (JILByte*) _aligned_malloc(size, kHandleGroupSize);
+#else
+	JILUnknown* p;
+	return posix_memalign(&p, kHandleGroupSize, size) ? NULL : (JILByte*) p;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILFreeBucket
+//------------------------------------------------------------------------------
+// Frees the bucket that starts with the given handle.
+
+static void JILFreeBucket(JILHandle* pFirst)
+{
+	JILByte* p = (JILByte*) pFirst - sizeof(JILHandle);
+#ifdef WIN32
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILInitBucket
+//------------------------------------------------------------------------------
+// Allocates a bucket of handles and adds them to the handle array, starting
+// at the given index, and to the end of the free handle stack. A bucket
+// consists of aligned groups of handles. The first handle sized slot of each
+// group holds the index of the first handle in the group.
+
+static void JILInitBucket(JILState* pState, JILLong index)
+{
+	JILLong i;
+	JILLong grain = pState->vmHandleAllocGrain;
+	JILLong perGroup = kHandleGroupSize / sizeof(JILHandle) - 1;
+	JILHandle** ppAll = pState->vmppHandles + index;
+	JILHandle** ppFree = pState->vmppFreeHandles + pState->vmNumHandles;
+	JILByte* pMem;
+	JILHandle* pBucket = NULL;
+
+	pMem = JILAllocBucket( pState->vmHandleBucketSize );
+	memset(pMem, 0, pState->vmHandleBucketSize);
+	for( i = 0; i < grain; i++ )
+	{
+		if( i % perGroup == 0 )
+		{
+			*((JILLong*) pMem) = index + i;
+			pBucket = (JILHandle*) (pMem + sizeof(JILHandle));
+			pMem += kHandleGroupSize;
+		}
+		*ppAll++ = *ppFree++ = pBucket++;
+	}
+	pState->vmppHandles[index]->flags = HF_NEWBUCKET;
+	pState->vmNumHandles += grain;
+}
+
+//------------------------------------------------------------------------------
+// JILResizeHandleArrays
+//------------------------------------------------------------------------------
+// Resizes the handle pointer arrays to the given number of entries.
+
+static void JILResizeHandleArrays(JILState* pState, JILLong capacity)
+{
+	pState->vmppHandles = (JILHandle**) realloc( pState->vmppHandles, capacity * sizeof(JILHandle*) );
+	pState->vmppFreeHandles = (JILHandle**) realloc( pState->vmppFreeHandles, capacity * sizeof(JILHandle*) );
+	pState->vmHandleCapacity = capacity;
+}
+
+//------------------------------------------------------------------------------
+// JILAddBuckets
+//------------------------------------------------------------------------------
+// Allocates the given number of new buckets. Buckets that have been released
+// are reused first, then the handle arrays are grown. The arrays at least
+// double in size, so that the total cost of copying them stays linear.
+
+static void JILAddBuckets(JILState* pState, JILLong numBuckets)
+{
+	JILLong i;
+	JILLong grain = pState->vmHandleAllocGrain;
+	JILLong newMax;
+	JILLong capacity;
+
+	// fill the holes left by released buckets
+	for( i = 0; numBuckets && pState->vmReleasedBuckets && i < pState->vmMaxHandles; i += grain )
+	{
+		if( !pState->vmppHandles[i] )
+		{
+			JILInitBucket(pState, i);
+			pState->vmReleasedBuckets--;
+			numBuckets--;
+		}
+	}
+	if( !numBuckets )
+		return;
+
+	// grow the arrays geometrically
+	newMax = pState->vmMaxHandles + grain * numBuckets;
+	if( newMax > pState->vmHandleCapacity )
+	{
+		capacity = pState->vmHandleCapacity * 2;
+		JILResizeHandleArrays(pState, (capacity < newMax) ? newMax : capacity);
+	}
+
+	// allocate new handle memory buckets
+	for( i = pState->vmMaxHandles; i < newMax; i += grain )
+		JILInitBucket(pState, i);
+	pState->vmMaxHandles = newMax;
+}
+
 //------------------------------------------------------------------------------
 // JILInitHandles
 //------------------------------------------------------------------------------
 
 JILError JILInitHandles(JILState* pState, JILLong allocGrain)
 {
-	JILLong i;
-	JILHandle* pBucket;
 	JILError result = JIL_No_Exception;
+	JILLong perGroup = kHandleGroupSize / sizeof(JILHandle) - 1;
+	JILLong numGroups = (allocGrain + perGroup - 1) / perGroup;
+
+	// round up to whole groups, one slot per group is used for the index
+	if( numGroups < 1 )
+		numGroups = 1;
+	allocGrain = numGroups * perGroup;
 
 	pState->vmHandleAllocGrain = allocGrain;
+	pState->vmHandleBucketSize = numGroups * kHandleGroupSize;
 	pState->vmMaxHandles = allocGrain;
 	pState->vmUsedHandles = 0;
+	pState->vmNumHandles = 0;
+	pState->vmReleasedBuckets = 0;
 
 	// allocate handle pointer arrays
-	pState->vmppHandles = (JILHandle**) malloc( allocGrain * sizeof(JILHandle*) );
-	pState->vmppFreeHandles = (JILHandle**) malloc( allocGrain * sizeof(JILHandle*) );
+	pState->vmppHandles = NULL;
+	pState->vmppFreeHandles = NULL;
+	JILResizeHandleArrays(pState, allocGrain);
 
 	// allocate a handle memory bucket
-	pBucket = (JILHandle*) malloc( allocGrain * sizeof(JILHandle) );
-	memset(pBucket, 0, allocGrain * sizeof(JILHandle));
-
-	// init handle pointer arrays
-	for( i = 0; i < allocGrain; i++ )
-	{
-		pState->vmppHandles[i] = pBucket;
-		pState->vmppFreeHandles[i] = pBucket++;
-	}
-	pState->vmppHandles[0]->flags = HF_NEWBUCKET;
+	JILInitBucket(pState, 0);
 	return result;
 }
 
@@ -74,46 +236,21 @@ JILHandle* JILGetNewHandle(JILState* pState)
 {
 	JILHandle* pHandle;
 
-	if( pState->vmUsedHandles >= pState->vmMaxHandles )
-	{
-		// must resize pointer arrays!
-		JILLong i;
-		JILLong grain = pState->vmHandleAllocGrain;
-		JILLong oldMax = pState->vmMaxHandles;
-		JILLong newMax = oldMax + grain;
-		JILHandle** ppOldHandles = pState->vmppHandles;
-		JILHandle** ppOldFreeHandles = pState->vmppFreeHandles;
-		JILHandle** ppAll;
-		JILHandle** ppFree;
-		JILHandle* pBucket;
-
-		// allocate new buffers
-		pState->vmppHandles = (JILHandle**) malloc( newMax * sizeof(JILHandle*) );
-		pState->vmMaxHandles = newMax;
-		memcpy( pState->vmppHandles, ppOldHandles, oldMax * sizeof(JILHandle*) );
-		pState->vmppFreeHandles = (JILHandle**) malloc( newMax * sizeof(JILHandle*) );
-		memcpy( pState->vmppFreeHandles, ppOldFreeHandles, oldMax * sizeof(JILHandle*) );
-
-		// allocate new handle memory bucket
-		pBucket = (JILHandle*) malloc( grain * sizeof(JILHandle) );
-		memset(pBucket, 0, grain * sizeof(JILHandle));
-
-		// init handle arrays
-		ppAll = pState->vmppHandles + oldMax;
-		ppFree = pState->vmppFreeHandles + oldMax;
-		for( i = oldMax; i < newMax; i++ )
-			*ppAll++ = *ppFree++ = pBucket++;
-		pState->vmppHandles[oldMax]->flags = HF_NEWBUCKET;
-
-		// free old buffers
-		free( ppOldHandles );
-		free( ppOldFreeHandles );
-	}
+	// in lazy free mode, destroy a batch of pending objects first
+	if( pState->vmPendingCount && !pState->vmDestroying )
+		JILDestroyPending(pState, pState->vmLazyFree);
+	// must allocate a new bucket?
+	if( pState->vmUsedHandles >= pState->vmNumHandles )
+		JILAddBuckets(pState, 1);
 	// get a new handle and initialize it
 	pHandle = pState->vmppFreeHandles[pState->vmUsedHandles++];
+	JIL_GC_CHECK_LIMIT(pState, pState->vmUsedHandles, pState->vmGCHandleLimit)
 	pHandle->type = type_null;
 	pHandle->flags &= HF_NEWBUCKET;
 	pHandle->refCount = 1;
+	// handles allocated during a GC cycle must survive it
+	if( pState->vmGCPhase == kGCMark || (pState->vmGCPhase == kGCSweep && JILFindHandleIndex(pState, pHandle) >= pState->vmGCSweepIndex) )
+		pHandle->flags |= HF_MARKED;
 	return pHandle;
 }
 
@@ -122,14 +259,123 @@ JILHandle* JILGetNewHandle(JILState* pState)
 //------------------------------------------------------------------------------
 
 JILLong JILFindHandleIndex(JILState* pState, JILHandle* pHandle)
+{
+	JILByte* pMem = (JILByte*) ((size_t) pHandle & ~((size_t) kHandleGroupSize - 1));
+	return *((JILLong*) pMem) + (JILLong) (pHandle - (JILHandle*) (pMem + sizeof(JILHandle)));
+}
+
+//------------------------------------------------------------------------------
+// JILReserveHandles
+//------------------------------------------------------------------------------
+
+void JILReserveHandles(JILState* pState, JILLong count)
+{
+	JILLong grain = pState->vmHandleAllocGrain;
+	JILLong missing = count - (pState->vmNumHandles - pState->vmUsedHandles);
+	if( missing > 0 )
+		JILAddBuckets(pState, (missing + grain - 1) / grain);
+}
+
+//------------------------------------------------------------------------------
+// JILTrimBuckets
+//------------------------------------------------------------------------------
+
+JILLong JILTrimBuckets(JILState* pState, JILLong keep)
 {
 	JILLong i;
-	for( i = 0; i < pState->vmMaxHandles; i++ )
+	JILLong n;
+	JILLong grain = pState->vmHandleAllocGrain;
+	JILLong numBuckets = pState->vmMaxHandles / grain;
+	JILLong numFree = pState->vmNumHandles - pState->vmUsedHandles;
+	JILLong released = 0;
+	JILLong* pCount;
+	JILHandle* h;
+
+	// the collectors keep pointers to handles while they are running
+	if( pState->vmGCPhase != kGCIdle || pState->vmDestroying || numFree - grain < keep )
+		return 0;
+
+	// count the unused handles in every bucket
+	pCount = (JILLong*) malloc( numBuckets * sizeof(JILLong) );
+	memset(pCount, 0, numBuckets * sizeof(JILLong));
+	for( i = pState->vmUsedHandles; i < pState->vmNumHandles; i++ )
+		pCount[JILFindHandleIndex(pState, pState->vmppFreeHandles[i]) / grain]++;
+
+	// select buckets from the end, so that the handle array can shrink; the
+	// first bucket always stays, because it contains the null handle
+	for( i = numBuckets - 1; i > 0 && numFree - released - grain >= keep; i-- )
+	{
+		if( pCount[i] == grain )
+		{
+			pCount[i] = -1;
+			released += grain;
+		}
+	}
+	if( released )
 	{
-		if( pState->vmppHandles[i] == pHandle )
-			return i;
+		// remove the handles from the free handle stack
+		n = pState->vmUsedHandles;
+		for( i = pState->vmUsedHandles; i < pState->vmNumHandles; i++ )
+		{
+			h = pState->vmppFreeHandles[i];
+			if( pCount[JILFindHandleIndex(pState, h) / grain] >= 0 )
+				pState->vmppFreeHandles[n++] = h;
+		}
+		pState->vmNumHandles = n;
+#if JIL_USE_CYCLE_COLLECTOR
+		// the candidate buffer can still refer to handles that have been freed
+		n = 0;
+		for( i = 0; i < pState->vmCCRootCount; i++ )
+		{
+			h = pState->vmppCCRoots[i];
+			if( pCount[JILFindHandleIndex(pState, h) / grain] >= 0 )
+				pState->vmppCCRoots[n++] = h;
+		}
+		pState->vmCCRootCount = n;
+#endif
+		// free the buckets
+		for( i = 1; i < numBuckets; i++ )
+		{
+			if( pCount[i] < 0 )
+			{
+				JILFreeBucket( pState->vmppHandles[i * grain] );
+				memset(pState->vmppHandles + i * grain, 0, grain * sizeof(JILHandle*));
+				pState->vmReleasedBuckets++;
+			}
+		}
+		// shrink the handle arrays if released buckets are at the end
+		while( !pState->vmppHandles[pState->vmMaxHandles - grain] )
+		{
+			pState->vmMaxHandles -= grain;
+			pState->vmReleasedBuckets--;
+		}
+		if( pState->vmMaxHandles * 4 <= pState->vmHandleCapacity )
+			JILResizeHandleArrays(pState, pState->vmHandleCapacity / 2);
 	}
-	return 0;
+	free( pCount );
+	return released;
+}
+
+//------------------------------------------------------------------------------
+// JILGetHandleMemory
+//------------------------------------------------------------------------------
+
+JILLong JILGetHandleMemory(JILState* pState)
+{
+	JILLong numBuckets = pState->vmMaxHandles / pState->vmHandleAllocGrain - pState->vmReleasedBuckets;
+	return numBuckets * pState->vmHandleBucketSize;
+}
+
+//------------------------------------------------------------------------------
+// JILTrimHandles
+//------------------------------------------------------------------------------
+
+JILLong JILTrimHandles(JILState* pState)
+{
+	JILFlushInstancePool(pState, -1);
+	if( pState->vmFixMem )
+		FixMem_Purge(pState->vmFixMem);
+	return JILTrimBuckets(pState, 0);
 }
 
 //------------------------------------------------------------------------------
@@ -149,13 +395,28 @@ JILError JILDestroyHandles(JILState* pState)
 	for( pRecord = pState->vmpFirstEventRecord; pRecord; pRecord = pRecord->pNext )
 		pRecord->eventProc(pState, JIL_GCEvent_Shutdown, pRecord->pUserPtr);
 
+	// cancel a garbage collection cycle in progress
+	pState->vmGCPhase = kGCIdle;
+
+	// destroy everything that is still pending
+	pState->vmLazyFree = 0;
+	JILDestroyPending(pState, 0);
+
+	// free recycled instances, they hold references to the null handle
+	pState->vmInstancePoolCap = 0;
+	JILDestroyInstancePools(pState);
+
+	// free recycled contexts
+	pState->vmContextPoolCap = 0;
+	JILDestroyContextPool(pState);
+
 	// STEP 1: List every handle that still exists at this point
 	if( pState->vmLogGarbageMode == kLogGarbageAll )
 	{
 		for( i = 0; i < pState->vmMaxHandles; i++ )
 		{
 			pHandle = pState->vmppHandles[i];
-			if( pHandle->refCount > 0 )
+			if( pHandle && pHandle->refCount > 0 )
 				JILMessageLog(pState, "Leaked handle %d, refCount = %d, type = %s\n", i, pHandle->refCount, JILGetHandleTypeName(pState, pHandle->type));
 		}
 	}
@@ -163,7 +424,7 @@ JILError JILDestroyHandles(JILState* pState)
 	for( i = 0; i < pState->vmMaxHandles; i++ )
 	{
 		pHandle = pState->vmppHandles[i];
-		if( pHandle->refCount > 0 )
+		if( pHandle && pHandle->refCount > 0 )
 		{
 			if( pState->vmLogGarbageMode == kLogGarbageBrief )
 				JILMessageLog(pState, "Collecting handle %d, refCount = %d, type = %s\n", i, pHandle->refCount, JILGetHandleTypeName(pState, pHandle->type));
@@ -179,7 +440,7 @@ JILError JILDestroyHandles(JILState* pState)
 		for( i = 0; i < pState->vmMaxHandles; i++ )
 		{
 			pHandle = pState->vmppHandles[i];
-			if( pHandle->refCount > 0 )
+			if( pHandle && pHandle->refCount > 0 )
 				leakedHandlesLeft++;
 		}
 		JILMessageLog(pState, "--- GC collected %d handles, %d left ---\n", handlesLeaked, leakedHandlesLeft);
@@ -188,10 +449,15 @@ JILError JILDestroyHandles(JILState* pState)
 	for( i = 0; i < pState->vmMaxHandles; i++ )
 	{
 		pHandle = pState->vmppHandles[i];
-		if( pHandle->flags & HF_NEWBUCKET )
+		if( !pHandle )
 		{
+			// bucket has been released
 			i += pState->vmHandleAllocGrain - 1;
-			free( pHandle );
+		}
+		else if( pHandle->flags & HF_NEWBUCKET )
+		{
+			i += pState->vmHandleAllocGrain - 1;
+			JILFreeBucket( pHandle );
 		}
 		else
 		{
@@ -210,8 +476,42 @@ JILError JILDestroyHandles(JILState* pState)
 		free( pState->vmppFreeHandles );
 		pState->vmppFreeHandles = NULL;
 	}
+	// destroy grey list
+	if( pState->vmppGCGrey )
+	{
+		free( pState->vmppGCGrey );
+		pState->vmppGCGrey = NULL;
+	}
+	pState->vmGCGreyCount = 0;
+	pState->vmGCGreySize = 0;
+	// destroy cycle collector buffers
+	if( pState->vmppCCRoots )
+	{
+		free( pState->vmppCCRoots );
+		pState->vmppCCRoots = NULL;
+	}
+	if( pState->vmppCCStack )
+	{
+		free( pState->vmppCCStack );
+		pState->vmppCCStack = NULL;
+	}
+	pState->vmCCRootCount = 0;
+	pState->vmCCRootSize = 0;
+	pState->vmCCStackCount = 0;
+	pState->vmCCStackSize = 0;
+	// destroy pending list
+	if( pState->vmppPendingFree )
+	{
+		free( pState->vmppPendingFree );
+		pState->vmppPendingFree = NULL;
+	}
+	pState->vmPendingCount = 0;
+	pState->vmPendingSize = 0;
 	pState->vmMaxHandles = 0;
 	pState->vmUsedHandles = 0;
+	pState->vmNumHandles = 0;
+	pState->vmHandleCapacity = 0;
+	pState->vmReleasedBuckets = 0;
 
 	return result;
 }
@@ -221,14 +521,46 @@ JILError JILDestroyHandles(JILState* pState)
 //------------------------------------------------------------------------------
 
 JILError JILMarkHandle(JILState* pState, JILHandle* pSource)
+{
+#if JIL_USE_CYCLE_COLLECTOR
+	// the cycle collector enumerates references through the same protocol
+	if( pState->vmCCMode )
+	{
+		if( pSource )
+			JILCCVisit(pState, pSource);
+		return JIL_No_Exception;
+	}
+#endif
+	// only shade the handle, it's members are marked when it gets scanned
+	if( pState->vmGCPhase == kGCMark && pSource && pSource->refCount && !(pSource->flags & HF_MARKED) )
+		JILShadeHandle(pState, pSource);
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILShadeHandle
+//------------------------------------------------------------------------------
+
+void JILShadeHandle(JILState* pState, JILHandle* pHandle)
+{
+	pHandle->flags |= HF_MARKED;
+	if( pState->vmGCGreyCount == pState->vmGCGreySize )
+	{
+		pState->vmGCGreySize += pState->vmGCGreySize ? pState->vmGCGreySize : kGCGreyAllocGrain;
+		pState->vmppGCGrey = (JILHandle**) realloc(pState->vmppGCGrey, pState->vmGCGreySize * sizeof(JILHandle*));
+	}
+	pState->vmppGCGrey[pState->vmGCGreyCount++] = pHandle;
+}
+
+//------------------------------------------------------------------------------
+// JILScanHandle
+//------------------------------------------------------------------------------
+// Marks all handles referenced by the object of the given handle.
+
+static JILError JILScanHandle(JILState* pState, JILHandle* pSource)
 {
 	JILError result = JIL_No_Exception;
-	JILTypeInfo* pTypeInfo;
-	// don't do it if it's already marked
-	if( !pSource || (pSource->flags & HF_MARKED) || !pSource->refCount )
-		return result;
-	pSource->flags |= HF_MARKED;
-	pTypeInfo = JILTypeInfoFromType(pState, pSource->type);
+	JILTypeInfo* pTypeInfo = JILTypeInfoFromType(pState, pSource->type);
 	// first check if the class is a native type
 	if( pTypeInfo->isNative )
 	{
@@ -244,11 +576,7 @@ JILError JILMarkHandle(JILState* pState, JILHandle* pSource)
 				JILHandle** ppS = JILGetObjectHandle(pSource)->ppHandles;
 				JILLong size = pTypeInfo->instanceSize;
 				for( i = 0; i < size; i++ )
-				{
-					result = JILMarkHandle(pState, *ppS++);
-					if( result )
-						break;
-				}
+					JILMarkHandle(pState, *ppS++);
 				break;
 			}
 			case tf_delegate:
@@ -313,12 +641,13 @@ JILError JILCopyHandle(JILState* pState, JILHandle* pSource, JILHandle** ppOut)
 					if( result )
 						goto _exit;
 					// push source onto stack
-					pState->vmpContext->vmppDataStack[--pState->vmpContext->vmDataStackPointer] = pSource;
+					JILGrowStack(pState, pState->vmpContext, 1, 0, JILFalse);
+					JILDataStack(pState->vmpContext, --pState->vmpContext->vmDataStackPointer) = pSource;
 					JILAddRef(pSource);
 					// call copy ctor
 					result = CallNTLCallMember(pTypeInfo, pTypeInfo->methodInfo.cctor, newPtr);
 					// pop source from stack
-					JILRelease(pState, pState->vmpContext->vmppDataStack[pState->vmpContext->vmDataStackPointer++]);
+					JILRelease(pState, JILDataStack(pState->vmpContext, pState->vmpContext->vmDataStackPointer++));
 					if( result )
 						goto _exit;
 					pDObj->ptr = newPtr;
@@ -345,7 +674,7 @@ JILError JILCopyHandle(JILState* pState, JILHandle* pSource, JILHandle** ppOut)
 							JILHandleObject* pSObj = JILGetObjectHandle(pSource);
 							JILLong size = pTypeInfo->instanceSize;
 							// allocate a new object
-							pDObj->ppHandles = JILAllocObjectNoInit(pState, size);
+							pDObj->ppHandles = JILAllocInstanceNoInit(pState, pTypeInfo);
 							// copy references to source object's members
 							ppS = pSObj->ppHandles;
 							ppD = pDObj->ppHandles;
@@ -359,7 +688,7 @@ JILError JILCopyHandle(JILState* pState, JILHandle* pSource, JILHandle** ppOut)
 						else	// call copy-constructor
 						{
 							// allocate a new object
-							JILGetObjectHandle(pDest)->ppHandles = JILAllocObject(pState, pTypeInfo->instanceSize);
+							JILGetObjectHandle(pDest)->ppHandles = JILAllocInstance(pState, pTypeInfo);
 							// call copy-constructor
 							pDest->type = pSource->type;
 							result = JILCallCopyConstructor(pState, pDest, pSource);
@@ -484,7 +813,7 @@ void JILDestroyObject(JILState* pState, JILHandle* pHandle)
 								JILRelease(pState, ppObj[i]);
 							}
 							// free the object
-							pState->vmFree( pState, ppObj );
+							JILFreeInstance( pState, pTypeInfo, ppObj );
 							break;
 						}
 						case tf_delegate:
@@ -506,89 +835,719 @@ void JILDestroyObject(JILState* pState, JILHandle* pHandle)
 }
 
 //------------------------------------------------------------------------------
-// JILCollectGarbage
+// JILFreeHandle
 //------------------------------------------------------------------------------
 
-JILError JILCollectGarbage(JILState* ps)
+void JILFreeHandle(JILState* pState, JILHandle* pHandle)
+{
+	// values without members can't release other objects
+	if( pHandle->type <= type_string )
+	{
+		JILDestroyObject(pState, pHandle);
+		pState->vmppFreeHandles[--pState->vmUsedHandles] = pHandle;
+		return;
+	}
+	if( pState->vmPendingCount == pState->vmPendingSize )
+	{
+		pState->vmPendingSize += pState->vmPendingSize ? pState->vmPendingSize : kPendingAllocGrain;
+		pState->vmppPendingFree = (JILHandle**) realloc(pState->vmppPendingFree, pState->vmPendingSize * sizeof(JILHandle*));
+	}
+	pState->vmppPendingFree[pState->vmPendingCount++] = pHandle;
+	// objects released while destroying are picked up by the loop in JILDestroyPending()
+	if( !pState->vmLazyFree )
+		JILDestroyPending(pState, 0);
+}
+
+//------------------------------------------------------------------------------
+// JILDestroyPending
+//------------------------------------------------------------------------------
+
+JILLong JILDestroyPending(JILState* pState, JILLong maxObjects)
+{
+	JILLong n = 0;
+	JILHandle* pHandle;
+	if( pState->vmDestroying )
+		return pState->vmPendingCount;
+	pState->vmDestroying = JILTrue;
+	while( pState->vmPendingCount && (maxObjects == 0 || n < maxObjects) )
+	{
+		pHandle = pState->vmppPendingFree[--pState->vmPendingCount];
+		JILDestroyObject(pState, pHandle);
+		pState->vmppFreeHandles[--pState->vmUsedHandles] = pHandle;
+		n++;
+	}
+	pState->vmDestroying = JILFalse;
+	return pState->vmPendingCount;
+}
+
+//------------------------------------------------------------------------------
+// JILGCMarkRoots
+//------------------------------------------------------------------------------
+// Marks the data handles, the throw handle, the members of objects pending
+// destruction and the root and current context, and sends mark events to
+// everyone in the GC event list.
+
+static JILError JILGCMarkRoots(JILState* ps)
 {
-	JILLong numColl = 0;
 	JILError err;
 	JILLong i;
-	JILLong num;
-	JILHandle* h;
 	JILGCEventRecord* pRecord;
-	JILFloat time = (JILFloat) clock();
-
-	// for safety reasons, do nothing if currently executing byte-code
-	if( ps->vmRunning )
-		return JIL_ERR_Runtime_Locked;
 
 	// mark data handles
 	err = JILMarkDataHandles(ps);
 	if( err )
-		goto exit;
+		return err;
 
 	// mark throw handle
 	err = NTLMarkHandle(ps, ps->vmpThrowHandle);
 	if( err )
-		goto exit;
+		return err;
 
-	// mark everything in the root context
+	// mark the members of objects that are pending destruction
+	for( i = 0; i < ps->vmPendingCount; i++ )
+	{
+		err = JILScanHandle(ps, ps->vmppPendingFree[i]);
+		if( err )
+			return err;
+	}
+
+	// mark everything in the root context and the current context
 	err = JILMarkContext(ps, ps->vmpRootContext);
 	if( err )
-		goto exit;
+		return err;
+	if( ps->vmpContext && ps->vmpContext != ps->vmpRootContext )
+	{
+		err = JILMarkContext(ps, ps->vmpContext);
+		if( err )
+			return err;
+	}
 
 	// send mark events to everyone in the GC event list
 	for( pRecord = ps->vmpFirstEventRecord; pRecord; pRecord = pRecord->pNext )
 	{
 		err = pRecord->eventProc(ps, JIL_GCEvent_Mark, pRecord->pUserPtr);
+		if( err )
+			return err;
+	}
+	return err;
+}
+
+//------------------------------------------------------------------------------
+// JILGCBudgetUsed
+//------------------------------------------------------------------------------
+// Checks if a step of the incremental garbage collector has used up it's budget
+// after processing 'n' handles. The clock is only read every 64 handles.
+
+static JILBool JILGCBudgetUsed(JILLong n, JILLong work, JILFloat deadline)
+{
+	if( work > 0 && n >= work )
+		return JILTrue;
+	if( deadline > 0.0 && (n & 63) == 63 && (JILFloat) clock() >= deadline )
+		return JILTrue;
+	return JILFalse;
+}
+
+//------------------------------------------------------------------------------
+// JILGCAbort
+//------------------------------------------------------------------------------
+// Cancels the current garbage collection cycle and removes all marks.
+
+static void JILGCAbort(JILState* ps)
+{
+	JILLong i;
+	for( i = 0; i < ps->vmMaxHandles; i++ )
+	{
+		if( ps->vmppHandles[i] )
+			ps->vmppHandles[i]->flags &= ~HF_MARKED;
+	}
+	ps->vmGCGreyCount = 0;
+	ps->vmGCPhase = kGCIdle;
+}
+
+//------------------------------------------------------------------------------
+// JILGCStep
+//------------------------------------------------------------------------------
+
+JILError JILGCStep(JILState* ps, JILBool complete)
+{
+	JILError err;
+	JILLong i;
+	JILLong n = 0;
+	JILLong work = complete ? 0 : ps->vmGCStepWork;
+	JILHandle* h;
+	JILGCEventRecord* pRecord;
+	JILFloat time = (JILFloat) clock();
+	JILFloat deadline = 0.0;
+
+	if( !complete && ps->vmGCStepTime > 0.0 )
+		deadline = time + ps->vmGCStepTime * ((JILFloat)CLOCKS_PER_SEC);
+
+	// start a new cycle: mark all roots grey
+	if( ps->vmGCPhase == kGCIdle || ps->vmGCPhase == kGCStart )
+	{
+		ps->vmGCPhase = kGCMark;
+		ps->vmGCCollected = 0;
+		ps->vmGCCycleStart = time;
+		err = JILGCMarkRoots(ps);
 		if( err )
 			goto exit;
 	}
 
-	// now run through all handles and free everything that's not marked
-	num = ps->vmMaxHandles;
-	if( ps->vmLogGarbageMode == kLogGarbageAll )
+	if( ps->vmGCPhase == kGCMark )
 	{
-		for( i = 0; i < num; i++ )
+		// scan grey handles until the budget is used up
+		while( ps->vmGCGreyCount )
 		{
-			h = ps->vmppHandles[i];
-			if( (h->refCount > 0) && !(h->flags & HF_MARKED) )
-				JILMessageLog(ps, "Leaked handle %d, refCount = %d, type = %s\n", i, h->refCount, JILGetHandleTypeName(ps, h->type));
+			if( JILGCBudgetUsed(n++, work, deadline) )
+				goto pause;
+			h = ps->vmppGCGrey[--ps->vmGCGreyCount];
+			if( h->refCount > 0 )
+			{
+				err = JILScanHandle(ps, h);
+				if( err )
+					goto exit;
+			}
 		}
-	}
-	for( i = 0; i < num; i++ )
-	{
-		h = ps->vmppHandles[i];
-		if( (h->refCount > 0) && !(h->flags & HF_MARKED) )
+		// finish marking atomically, in case references have been moved
+		// without passing the write barrier
+		err = JILGCMarkRoots(ps);
+		if( err )
+			goto exit;
+		while( ps->vmGCGreyCount )
 		{
-			if( ps->vmLogGarbageMode == kLogGarbageBrief )
-				JILMessageLog(ps, "Collecting handle %d, refCount = %d, type = %s\n", i, h->refCount, JILGetHandleTypeName(ps, h->type));
-			h->refCount = 1;
-			JILRelease(ps, h);
-			numColl++;
+			h = ps->vmppGCGrey[--ps->vmGCGreyCount];
+			if( h->refCount > 0 )
+			{
+				err = JILScanHandle(ps, h);
+				if( err )
+					goto exit;
+			}
 		}
-		else
+		if( ps->vmLogGarbageMode == kLogGarbageAll )
 		{
-			// unmark
-			h->flags &= ~HF_MARKED;
+			for( i = 0; i < ps->vmMaxHandles; i++ )
+			{
+				h = ps->vmppHandles[i];
+				if( h && (h->refCount > 0) && !(h->flags & HF_MARKED) )
+					JILMessageLog(ps, "Leaked handle %d, refCount = %d, type = %s\n", i, h->refCount, JILGetHandleTypeName(ps, h->type));
+			}
 		}
+		ps->vmGCPhase = kGCSweep;
+		ps->vmGCSweepIndex = 0;
 	}
 
-	ps->vmTimeLastGC = (JILFloat) clock();
-	if( numColl )
+	if( ps->vmGCPhase == kGCSweep )
 	{
-		time = (ps->vmTimeLastGC - time) / ((JILFloat)CLOCKS_PER_SEC);
-		ps->errHandlesLeaked += numColl;
-		JILMessageLog(ps, "--- GC collected %d handles in %g seconds ---\n", numColl, time);
+		// now run through all handles and free everything that's not marked
+		while( ps->vmGCSweepIndex < ps->vmMaxHandles )
+		{
+			if( JILGCBudgetUsed(n++, work, deadline) )
+				goto pause;
+			i = ps->vmGCSweepIndex++;
+			h = ps->vmppHandles[i];
+			if( !h )
+			{
+				// skip released bucket
+				ps->vmGCSweepIndex = i + ps->vmHandleAllocGrain;
+			}
+			else if( (h->refCount > 0) && !(h->flags & HF_MARKED) )
+			{
+				if( ps->vmLogGarbageMode == kLogGarbageBrief )
+					JILMessageLog(ps, "Collecting handle %d, refCount = %d, type = %s\n", i, h->refCount, JILGetHandleTypeName(ps, h->type));
+				// the mutator runs between steps, so other garbage that still
+				// refers to this handle must be able to release it later
+				JILAddRef(h);
+				JILDestroyObject(ps, h);
+				h->type = type_null;
+				JILRelease(ps, h);
+				ps->vmGCCollected++;
+			}
+			else
+			{
+				// unmark
+				h->flags &= ~HF_MARKED;
+			}
+		}
+		ps->vmGCPhase = kGCIdle;
+		ps->vmTimeLastGC = (JILFloat) clock();
+		// release unused buckets, but keep room for as many handles as are in use
+		JILTrimBuckets(ps, ps->vmUsedHandles);
+		JILGCSetLimits(ps);
+		if( ps->vmGCCollected )
+		{
+			ps->errHandlesLeaked += ps->vmGCCollected;
+			JILMessageLog(ps, "--- GC collected %d handles in %g seconds ---\n", ps->vmGCCollected, (ps->vmTimeLastGC - ps->vmGCCycleStart) / ((JILFloat)CLOCKS_PER_SEC));
+		}
 	}
+
+pause:
+	// report the pause to everyone in the GC event list
+	ps->vmGCLastPause = ((JILFloat) clock() - time) / ((JILFloat)CLOCKS_PER_SEC);
+	for( pRecord = ps->vmpFirstEventRecord; pRecord; pRecord = pRecord->pNext )
+		pRecord->eventProc(ps, JIL_GCEvent_Pause, pRecord->pUserPtr);
 	return JIL_No_Exception;
 
 exit:
+	JILGCAbort(ps);
 	JILMessageLog(ps, "GC MARK ERROR: %d (%s)\n", err, JILGetExceptionString(ps, err));
 	return JIL_ERR_Mark_Handle_Error;
 }
 
+//------------------------------------------------------------------------------
+// JILGCSetLimits
+//------------------------------------------------------------------------------
+
+void JILGCSetLimits(JILState* ps)
+{
+	JILFloat handles = (JILFloat) ps->vmUsedHandles * ps->vmGCGrowth;
+	JILFloat bytes = (JILFloat) ps->vmHeapBytes * ps->vmGCGrowth;
+	if( ps->vmGCGrowth <= 0.0 )
+	{
+		// automatic collection disabled
+		ps->vmGCHandleLimit = 0x7fffffff;
+		ps->vmGCByteLimit = ~((JILUInt64) 0);
+		return;
+	}
+	ps->vmGCHandleLimit = (handles < (JILFloat) kGCMinHandles) ? kGCMinHandles : (handles < 2147483647.0) ? (JILLong) handles : 0x7fffffff;
+	ps->vmGCByteLimit = (bytes < (JILFloat) kGCMinBytes) ? kGCMinBytes : (JILUInt64) bytes;
+}
+
+//------------------------------------------------------------------------------
+// JILCollectGarbage
+//------------------------------------------------------------------------------
+
+JILError JILCollectGarbage(JILState* ps)
+{
+	JILError err;
+
+	// for safety reasons, do nothing if currently executing byte-code
+	if( ps->vmRunning )
+		return JIL_ERR_Runtime_Locked;
+
+	// finish a cycle that is in progress, then run a complete one
+	if( ps->vmGCPhase == kGCMark || ps->vmGCPhase == kGCSweep )
+	{
+		err = JILGCStep(ps, JILTrue);
+		if( err )
+			return err;
+	}
+	return JILGCStep(ps, JILTrue);
+}
+
+//------------------------------------------------------------------------------
+// JILCollectGarbageStep
+//------------------------------------------------------------------------------
+
+JILError JILCollectGarbageStep(JILState* ps)
+{
+#if JIL_USE_INCREMENTAL_GC
+	// while executing byte-code, the cycle starts at the next safe point
+	if( ps->vmRunning )
+	{
+		if( ps->vmGCPhase == kGCIdle )
+			ps->vmGCPhase = kGCStart;
+		return JIL_No_Exception;
+	}
+	return JILGCStep(ps, JILFalse);
+#else
+	return JILCollectGarbage(ps);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILGCSafePoint
+//------------------------------------------------------------------------------
+
+void JILGCSafePoint(JILState* ps)
+{
+	// without the write barrier, a collection can't be spread over many steps
+	if( ps->vmGCPhase != kGCIdle )
+		JILGCStep(ps, !JIL_USE_INCREMENTAL_GC);
+#if JIL_USE_CYCLE_COLLECTOR
+	else if( ps->vmCCTrigger && ps->vmCCRootCount >= ps->vmCCTrigger )
+		JILCCCollect(ps);
+#endif
+}
+
+#if JIL_USE_CYCLE_COLLECTOR
+
+//------------------------------------------------------------------------------
+// JILBufferCandidate
+//------------------------------------------------------------------------------
+
+void JILBufferCandidate(JILState* ps, JILHandle* pHandle)
+{
+	JILLong i;
+	JILLong n = 0;
+	JILLong size;
+	JILHandle* h;
+	JILHandle** ppRoots;
+	if( ps->vmCCRootCount == ps->vmCCRootSize )
+	{
+		// drop handles that have been freed or reused since they were buffered,
+		// and grow the buffer only if that didn't free enough space
+		for( i = 0; i < ps->vmCCRootCount; i++ )
+		{
+			h = ps->vmppCCRoots[i];
+			if( (h->flags & HF_CCBUFFERED) && h->refCount > 0 )
+			{
+				h->flags &= ~HF_CCBUFFERED;
+				ps->vmppCCRoots[n++] = h;
+			}
+		}
+		for( i = 0; i < n; i++ )
+			ps->vmppCCRoots[i]->flags |= HF_CCBUFFERED;
+		ps->vmCCRootCount = n;
+		if( n >= ps->vmCCRootSize / 2 )
+		{
+			size = ps->vmCCRootSize + (ps->vmCCRootSize ? ps->vmCCRootSize : kCCAllocGrain);
+			ppRoots = (JILHandle**) realloc(ps->vmppCCRoots, size * sizeof(JILHandle*));
+			if( ppRoots )
+			{
+				ps->vmppCCRoots = ppRoots;
+				ps->vmCCRootSize = size;
+			}
+		}
+		// if the buffer is still full, the handle is not a candidate; a cycle
+		// through it is still found by the mark and sweep collector
+		if( n == ps->vmCCRootSize )
+			return;
+	}
+	pHandle->flags |= HF_CCBUFFERED;
+	ps->vmppCCRoots[ps->vmCCRootCount++] = pHandle;
+}
+
+//------------------------------------------------------------------------------
+// JILCCPush
+//------------------------------------------------------------------------------
+// Pushes a handle onto the work list of the cycle collector. Returns JILFalse
+// if the work list is full and can't be grown.
+
+static JILBool JILCCPush(JILState* ps, JILHandle* h)
+{
+	JILLong size;
+	JILHandle** ppStack;
+	if( ps->vmCCStackCount == ps->vmCCStackSize )
+	{
+		size = ps->vmCCStackSize + (ps->vmCCStackSize ? ps->vmCCStackSize : kCCAllocGrain);
+		ppStack = (JILHandle**) realloc(ps->vmppCCStack, size * sizeof(JILHandle*));
+		if( ppStack == NULL )
+			return JILFalse;
+		ps->vmppCCStack = ppStack;
+		ps->vmCCStackSize = size;
+	}
+	ps->vmppCCStack[ps->vmCCStackCount++] = h;
+	return JILTrue;
+}
+
+//------------------------------------------------------------------------------
+// JILCCPushScan
+//------------------------------------------------------------------------------
+// Pushes a handle whose references are visited later in the current mode. If
+// the work list can't be grown, they are visited right away instead.
+
+static void JILCCPushScan(JILState* ps, JILHandle* h)
+{
+	JILError err;
+	if( JILCCPush(ps, h) )
+		return;
+	err = JILCCScanChildren(ps, h);
+	if( err )
+		ps->vmCCError = err;
+}
+
+//------------------------------------------------------------------------------
+// JILCCPushWhite
+//------------------------------------------------------------------------------
+// Moves a white handle to the list of garbage. If the list can't be grown, the
+// handle stays white and the collection is abandoned.
+
+static void JILCCPushWhite(JILState* ps, JILHandle* h)
+{
+	if( JILCCPush(ps, h) )
+		h->flags &= ~HF_CCWHITE;
+	else
+		ps->vmCCError = JIL_VM_Allocation_Failed;
+}
+
+//------------------------------------------------------------------------------
+// JILCCVisit
+//------------------------------------------------------------------------------
+// Called by JILMarkHandle() for every handle referenced by the object that is
+// currently scanned by the cycle collector.
+
+static void JILCCVisit(JILState* ps, JILHandle* h)
+{
+	// objects without members can't be part of a cycle
+	if( h->type <= type_string )
+		return;
+	switch( ps->vmCCMode )
+	{
+		case kCCMarkGrey:
+			h->refCount--;
+			if( !(h->flags & HF_CCGREY) )
+			{
+				h->flags |= HF_CCGREY;
+				JILCCPushScan(ps, h);
+			}
+			break;
+		case kCCScan:
+			if( (h->flags & HF_CCGREY) && !JILCCPush(ps, h) )
+				JILCCScanGrey(ps, h);
+			break;
+		case kCCScanBlack:
+			h->refCount++;
+			if( h->flags & (HF_CCGREY | HF_CCWHITE) )
+			{
+				h->flags &= ~(HF_CCGREY | HF_CCWHITE);
+				JILCCPushScan(ps, h);
+			}
+			break;
+		case kCCCollectWhite:
+			if( h->flags & HF_CCWHITE )
+				JILCCPushWhite(ps, h);
+			break;
+		case kCCRestore:
+			h->refCount++;
+			break;
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILCCScanChildren
+//------------------------------------------------------------------------------
+// Enumerates the handles referenced by the object of the given handle. Weak
+// references don't own the object they refer to. Iterators share list items
+// with their list and other iterators, so their references are not counted
+// and they are treated like objects without members.
+
+static JILError JILCCScanChildren(JILState* ps, JILHandle* h)
+{
+	if( (h->flags & HF_PERSIST) || h->type == type_iterator )
+		return JIL_No_Exception;
+	return JILScanHandle(ps, h);
+}
+
+//------------------------------------------------------------------------------
+// JILCCDrain
+//------------------------------------------------------------------------------
+// Scans handles from the work list until it is back at the given size.
+
+static JILError JILCCDrain(JILState* ps, JILLong base)
+{
+	JILError err = JIL_No_Exception;
+	JILError e;
+	while( ps->vmCCStackCount > base )
+	{
+		e = JILCCScanChildren(ps, ps->vmppCCStack[--ps->vmCCStackCount]);
+		if( e )
+			err = e;
+	}
+	return err;
+}
+
+//------------------------------------------------------------------------------
+// JILCCScanBlack
+//------------------------------------------------------------------------------
+// Restores the references of a grey or white handle and of everything that
+// can be reached from it, because it is referenced from outside.
+
+static void JILCCScanBlack(JILState* ps, JILHandle* h)
+{
+	JILLong mode = ps->vmCCMode;
+	JILLong base = ps->vmCCStackCount;
+	ps->vmCCMode = kCCScanBlack;
+	h->flags &= ~(HF_CCGREY | HF_CCWHITE);
+	JILCCPushScan(ps, h);
+	JILCCDrain(ps, base);
+	ps->vmCCMode = mode;
+}
+
+//------------------------------------------------------------------------------
+// JILCCScanGrey
+//------------------------------------------------------------------------------
+// Decides whether a grey handle is garbage. If it is still referenced from
+// outside, it and everything reachable from it is black, otherwise it is white
+// and its references are scanned.
+
+static void JILCCScanGrey(JILState* ps, JILHandle* h)
+{
+	if( !(h->flags & HF_CCGREY) )
+		return;
+	if( h->refCount > 0 )
+	{
+		JILCCScanBlack(ps, h);
+	}
+	else
+	{
+		h->flags = (h->flags & ~HF_CCGREY) | HF_CCWHITE;
+		JILCCScanChildren(ps, h);
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILCCCollect
+//------------------------------------------------------------------------------
+// Collects the cycles that can be reached from the buffered candidate roots.
+// The references between the objects reachable from a root are subtracted
+// from their reference counts. Objects whose count then is zero are only
+// referenced from within the subgraph and are garbage, unless they can be
+// reached from an object that is referenced from outside.
+
+static JILError JILCCCollect(JILState* ps)
+{
+	JILError err = JIL_No_Exception;
+	JILError e;
+	JILLong i;
+	JILLong n = 0;
+	JILHandle* h;
+	JILHandle** ppRoots = ps->vmppCCRoots;
+	JILHandle** ppWhite;
+	JILFloat time = (JILFloat) clock();
+
+	// mark grey: subtract the references of everything reachable from a root
+	ps->vmCCError = JIL_No_Exception;
+	ps->vmCCMode = kCCMarkGrey;
+	for( i = 0; i < ps->vmCCRootCount; i++ )
+	{
+		h = ppRoots[i];
+		// skip duplicates and handles that have been freed or reused
+		if( !(h->flags & HF_CCBUFFERED) )
+			continue;
+		h->flags &= ~HF_CCBUFFERED;
+		if( h->refCount == 0 )
+			continue;
+		ppRoots[n++] = h;
+		if( !(h->flags & HF_CCGREY) )
+		{
+			h->flags |= HF_CCGREY;
+			JILCCPushScan(ps, h);
+			e = JILCCDrain(ps, 0);
+			if( e )
+				err = e;
+		}
+	}
+	ps->vmCCRootCount = 0;
+	if( ps->vmCCError )
+		err = ps->vmCCError;
+
+	// if a native type failed to enumerate it's references, restore everything
+	if( err )
+	{
+		for( i = 0; i < n; i++ )
+		{
+			if( ppRoots[i]->flags & (HF_CCGREY | HF_CCWHITE) )
+				JILCCScanBlack(ps, ppRoots[i]);
+		}
+		ps->vmCCMode = kCCNone;
+		JILMessageLog(ps, "CC MARK ERROR: %d (%s)\n", err, JILGetExceptionString(ps, err));
+		return JIL_ERR_Mark_Handle_Error;
+	}
+
+	// scan: grey handles that are still referenced are black, all others white
+	ps->vmCCMode = kCCScan;
+	for( i = 0; i < n; i++ )
+	{
+		JILCCScanGrey(ps, ppRoots[i]);
+		while( ps->vmCCStackCount )
+			JILCCScanGrey(ps, ps->vmppCCStack[--ps->vmCCStackCount]);
+	}
+
+	// collect white: the work list becomes the list of garbage handles
+	ps->vmCCMode = kCCCollectWhite;
+	for( i = 0; i < n; i++ )
+	{
+		if( ppRoots[i]->flags & HF_CCWHITE )
+			JILCCPushWhite(ps, ppRoots[i]);
+	}
+	for( i = 0; i < ps->vmCCStackCount; i++ )
+		JILCCScanChildren(ps, ps->vmppCCStack[i]);
+
+	// if the list of garbage could not be grown, keep everything
+	if( ps->vmCCError )
+	{
+		ps->vmCCMode = kCCScanBlack;
+		while( ps->vmCCStackCount )
+		{
+			i = --ps->vmCCStackCount;
+			JILCCScanChildren(ps, ps->vmppCCStack[i]);
+			JILCCDrain(ps, i);
+		}
+		for( i = 0; i < n; i++ )
+		{
+			if( ppRoots[i]->flags & HF_CCWHITE )
+				JILCCScanBlack(ps, ppRoots[i]);
+		}
+		ps->vmCCMode = kCCNone;
+		JILMessageLog(ps, "CC ERROR: %d (%s)\n", ps->vmCCError, JILGetExceptionString(ps, ps->vmCCError));
+		return ps->vmCCError;
+	}
+	n = ps->vmCCStackCount;
+	ps->vmCCStackCount = 0;
+
+	if( n )
+	{
+		// restore the references held by the garbage, so destroying it
+		// releases everything correctly
+		ps->vmCCMode = kCCRestore;
+		ppWhite = ps->vmppCCStack;
+		for( i = 0; i < n; i++ )
+			JILCCScanChildren(ps, ppWhite[i]);
+		ps->vmCCMode = kCCNone;
+		// free the garbage; the handles are kept alive until all objects
+		// have been destroyed, because they still refer to each other
+		for( i = 0; i < n; i++ )
+			JILAddRef(ppWhite[i]);
+		for( i = 0; i < n; i++ )
+		{
+			h = ppWhite[i];
+			if( ps->vmLogGarbageMode == kLogGarbageBrief )
+				JILMessageLog(ps, "Collecting handle %d, refCount = %d, type = %s\n", JILFindHandleIndex(ps, h), h->refCount - 1, JILGetHandleTypeName(ps, h->type));
+			JILDestroyObject(ps, h);
+			h->type = type_null;
+		}
+		for( i = 0; i < n; i++ )
+			JILRelease(ps, ppWhite[i]);
+		if( ps->vmLogGarbageMode != kLogGarbageNone )
+			JILMessageLog(ps, "--- CC collected %d handles in %g seconds ---\n", n, ((JILFloat) clock() - time) / ((JILFloat)CLOCKS_PER_SEC));
+	}
+	ps->vmCCMode = kCCNone;
+	// the work of a collection grows with the size of the heap, so wait for
+	// more candidates if the heap is large
+	ps->vmCCTrigger = ps->vmCCThreshold;
+	if( ps->vmCCTrigger && ps->vmCCTrigger < ps->vmUsedHandles )
+		ps->vmCCTrigger = ps->vmUsedHandles;
+	return JIL_No_Exception;
+}
+
+#endif	// JIL_USE_CYCLE_COLLECTOR
+
+//------------------------------------------------------------------------------
+// JILCollectCycles
+//------------------------------------------------------------------------------
+
+JILError JILCollectCycles(JILState* ps)
+{
+#if JIL_USE_CYCLE_COLLECTOR
+	JILError err;
+
+	// for safety reasons, do nothing if currently executing byte-code
+	if( ps->vmRunning )
+		return JIL_ERR_Runtime_Locked;
+
+	// the collectors can't both use the handle flags at the same time
+	if( ps->vmGCPhase == kGCMark || ps->vmGCPhase == kGCSweep )
+	{
+		err = JILGCStep(ps, JILTrue);
+		if( err )
+			return err;
+	}
+	return JILCCCollect(ps);
+#else
+	return JIL_No_Exception;
+#endif
+}
+
 //------------------------------------------------------------------------------
 // JILCreateException
 //------------------------------------------------------------------------------
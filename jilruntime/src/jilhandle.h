@@ -39,6 +39,21 @@ typedef struct JILHandleNObject		JILHandleNObject;
 typedef struct JILHandleContext		JILHandleContext;
 typedef struct JILHandleDelegate	JILHandleDelegate;
 
+//------------------------------------------------------------------------------
+// garbage collector phases
+//------------------------------------------------------------------------------
+/// Values of JILState::vmGCPhase. While the phase is kGCMark, handles are
+/// marked by shading them and adding them to the grey list, and every
+/// reference released by JILRelease() is shaded (write barrier).
+
+enum
+{
+	kGCIdle = 0,		//!< No garbage collection cycle in progress
+	kGCStart,			//!< A cycle has been requested and starts at the next safe point
+	kGCMark,			//!< Marking handles incrementally
+	kGCSweep			//!< Sweeping handles incrementally
+};
+
 //------------------------------------------------------------------------------
 // struct JILHandleInt
 //------------------------------------------------------------------------------
@@ -46,10 +61,9 @@ typedef struct JILHandleDelegate	JILHandleDelegate;
 
 struct JILHandleInt
 {
-	JILLong		type;
-	JILLong		flags;
+	JILUInt16	type;
+	JILUInt16	flags;
 	JILLong		refCount;
-	JILLong		reserved;
 	JILLong		l;
 };
 
@@ -60,10 +74,9 @@ struct JILHandleInt
 
 struct JILHandleFloat
 {
-	JILLong		type;
-	JILLong		flags;
+	JILUInt16	type;
+	JILUInt16	flags;
 	JILLong		refCount;
-	JILLong		reserved;
 	JILFloat	f;
 };
 
@@ -75,10 +88,9 @@ struct JILHandleFloat
 
 struct JILHandleString
 {
-	JILLong		type;
-	JILLong		flags;
+	JILUInt16	type;
+	JILUInt16	flags;
 	JILLong		refCount;
-	JILLong		reserved;
 	JILString*	str;		// pointer to string, keep opaque with JILHandleNObject::ptr
 };
 
@@ -90,10 +102,9 @@ struct JILHandleString
 
 struct JILHandleArray
 {
-	JILLong		type;
-	JILLong		flags;
+	JILUInt16	type;
+	JILUInt16	flags;
 	JILLong		refCount;
-	JILLong		reserved;
 	JILArray*	arr;		// pointer to array, keep opaque with JILHandleNObject::ptr
 };
 
@@ -105,10 +116,9 @@ struct JILHandleArray
 
 struct JILHandleObject
 {
-	JILLong		type;
-	JILLong		flags;
+	JILUInt16	type;
+	JILUInt16	flags;
 	JILLong		refCount;
-	JILLong		reserved;
 	JILHandle**	ppHandles;	// pointer to object (which is an array of pointers to JILHandle objects)
 };
 
@@ -119,10 +129,9 @@ struct JILHandleObject
 
 struct JILHandleNObject
 {
-	JILLong		type;
-	JILLong		flags;
+	JILUInt16	type;
+	JILUInt16	flags;
 	JILLong		refCount;
-	JILLong		reserved;
 	JILUnknown*	ptr;		// pointer to native object
 };
 
@@ -133,10 +142,9 @@ struct JILHandleNObject
 
 struct JILHandleContext
 {
-	JILLong		type;
-	JILLong		flags;
+	JILUInt16	type;
+	JILUInt16	flags;
 	JILLong		refCount;
-	JILLong		reserved;
 	JILContext*	pContext;	// pointer to context
 };
 
@@ -147,10 +155,9 @@ struct JILHandleContext
 
 struct JILHandleDelegate
 {
-	JILLong			type;
-	JILLong			flags;
+	JILUInt16		type;
+	JILUInt16		flags;
 	JILLong			refCount;
-	JILLong			reserved;
 	JILDelegate*	pDelegate;	// pointer to delegate struct
 };
 
@@ -176,11 +183,38 @@ JILHandle*			JILGetNewHandle		(JILState* pState);
 //------------------------------------------------------------------------------
 // JILFindHandleIndex
 //------------------------------------------------------------------------------
-/// Searches through all allocated runtime handles for the given handle
-/// address and returns it's index number.
+/// Returns the index number of the given handle in JILState::vmppHandles.
+/// Handles are allocated in aligned groups that store the index of their
+/// first handle in front of it, so this takes constant time.
 
 JILLong				JILFindHandleIndex	(JILState* pState, JILHandle* pHandle);
 
+//------------------------------------------------------------------------------
+// JILReserveHandles
+//------------------------------------------------------------------------------
+/// Makes sure that at least the given number of handles can be allocated
+/// without growing the handle arrays. The arrays are resized at most once,
+/// which is much faster than allocating one bucket after another when lots
+/// of handles are needed at once, for example for the data segment.
+
+void				JILReserveHandles	(JILState* pState, JILLong count);
+
+//------------------------------------------------------------------------------
+// JILTrimBuckets
+//------------------------------------------------------------------------------
+/// Releases buckets that contain only unused handles, but keeps at least
+/// 'keep' unused handles. Returns the number of handles released.
+
+JILLong				JILTrimBuckets		(JILState* pState, JILLong keep);
+
+//------------------------------------------------------------------------------
+// JILGetHandleMemory
+//------------------------------------------------------------------------------
+/// Returns the number of bytes allocated for handle buckets. The handle
+/// pointer arrays are not included.
+
+JILLong				JILGetHandleMemory	(JILState* pState);
+
 //------------------------------------------------------------------------------
 // JILDestroyHandles
 //------------------------------------------------------------------------------
@@ -226,6 +260,51 @@ JILHandle*			JILCreateWeakRef	(JILState* pState, JILHandle* srcHandle);
 
 JILError			JILMarkHandle		(JILState* pState, JILHandle* pHandle);
 
+//------------------------------------------------------------------------------
+// JILShadeHandle
+//------------------------------------------------------------------------------
+/// Marks the given handle and adds it to the grey list, so it's members get
+/// marked by the next step of the garbage collector. Only call this while
+/// JILState::vmGCPhase is kGCMark.
+
+void				JILShadeHandle		(JILState* pState, JILHandle* pHandle);
+
+//------------------------------------------------------------------------------
+// JILGCStep
+//------------------------------------------------------------------------------
+/// Performs one step of the incremental garbage collector, starting a new
+/// cycle if none is in progress. If 'complete' is JILTrue, the current cycle
+/// is run to the end, otherwise the step stops when the budget set by
+/// JILSetGCBudget() is used up. Sends the JIL_GCEvent_Pause event.
+
+JILError			JILGCStep			(JILState* pState, JILBool complete);
+
+//------------------------------------------------------------------------------
+// JILGCSetLimits
+//------------------------------------------------------------------------------
+/// Calculates the number of used handles and allocated bytes at which the
+/// next garbage collection is started, from the current size of the heap and
+/// JILState::vmGCGrowth. Called whenever a collection has finished.
+
+void				JILGCSetLimits		(JILState* pState);
+
+//------------------------------------------------------------------------------
+// JILBufferCandidate
+//------------------------------------------------------------------------------
+/// Adds the given handle to the candidate roots of the cycle collector. Called
+/// by JILRelease() when a reference count is decremented to a non-zero value.
+
+void				JILBufferCandidate	(JILState* pState, JILHandle* pHandle);
+
+//------------------------------------------------------------------------------
+// JILGCSafePoint
+//------------------------------------------------------------------------------
+/// Called by the virtual machine at calls and backward branches. Takes a step
+/// of the incremental garbage collector, if a collection is in progress, or
+/// collects cycles, if enough candidate roots have been buffered.
+
+void				JILGCSafePoint		(JILState* pState);
+
 //------------------------------------------------------------------------------
 // JILDestroyObject
 //------------------------------------------------------------------------------
@@ -233,6 +312,27 @@ JILError			JILMarkHandle		(JILState* pState, JILHandle* pHandle);
 
 void				JILDestroyObject	(JILState* pState, JILHandle* pHandle);
 
+//------------------------------------------------------------------------------
+// JILFreeHandle
+//------------------------------------------------------------------------------
+/// Called by JILRelease() when the reference count of a handle has reached 0.
+/// Values without members are destroyed and returned to the handle pool right
+/// away. All other objects are added to the list of pending objects, which is
+/// processed iteratively, so releasing a long chain of objects doesn't recurse.
+/// In lazy free mode, the list is only processed in batches, see
+/// JILSetLazyFree().
+
+void				JILFreeHandle		(JILState* pState, JILHandle* pHandle);
+
+//------------------------------------------------------------------------------
+// JILDestroyPending
+//------------------------------------------------------------------------------
+/// Destroys up to 'maxObjects' objects from the list of pending objects, or
+/// all of them if 'maxObjects' is 0, and returns the number of objects that
+/// are still pending. Does nothing if called while objects are destroyed.
+
+JILLong				JILDestroyPending	(JILState* pState, JILLong maxObjects);
+
 //------------------------------------------------------------------------------
 // JILCreateException
 //------------------------------------------------------------------------------
@@ -258,11 +358,54 @@ JILINLINE JILHandle* JILGetNullHandle(JILState* pState)
 
 #define JILAddRef(HANDLE)	(HANDLE)->refCount++;
 
+//------------------------------------------------------------------------------
+// JIL_GC_BARRIER
+//------------------------------------------------------------------------------
+/// Write barrier of the incremental garbage collector, executed by JILRelease()
+/// and therefore by every store through JIL_STORE_HANDLE. While marking, a
+/// reference that is removed from a variable is shaded, so an object can't
+/// escape the collector by being moved from a not yet scanned object into one
+/// that has already been scanned.
+
+#if JIL_USE_INCREMENTAL_GC
+#define JIL_GC_BARRIER(STATE, HANDLE) \
+	if( (STATE)->vmGCPhase == kGCMark && !((HANDLE)->flags & HF_MARKED) )\
+		JILShadeHandle( (STATE), (HANDLE) );
+#else
+#define JIL_GC_BARRIER(STATE, HANDLE)
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_GC_CHECK_LIMIT
+//------------------------------------------------------------------------------
+/// Requests a garbage collection if the given value has reached the given
+/// limit, see JILGCSetLimits(). The collection starts at the next safe point.
+
+#define JIL_GC_CHECK_LIMIT(STATE, VALUE, LIMIT) \
+	if( (VALUE) >= (LIMIT) && (STATE)->vmGCPhase == kGCIdle )\
+		(STATE)->vmGCPhase = kGCStart;
+
+//------------------------------------------------------------------------------
+// JIL_CC_CANDIDATE
+//------------------------------------------------------------------------------
+/// Executed by JILRelease() if the reference count of a handle has been
+/// decremented to a non-zero value. Objects that have no members, like ints,
+/// floats and strings, can't be part of a cycle and are not buffered.
+
+#if JIL_USE_CYCLE_COLLECTOR
+#define JIL_CC_CANDIDATE(STATE, HANDLE) \
+	if( (HANDLE)->type > type_string && !((HANDLE)->flags & HF_CCBUFFERED) )\
+		JILBufferCandidate( (STATE), (HANDLE) );
+#else
+#define JIL_CC_CANDIDATE(STATE, HANDLE)
+#endif
+
 //------------------------------------------------------------------------------
 // JILRelease
 //------------------------------------------------------------------------------
 /// Release a reference to a handle. If the reference count reaches 0, the handle
-/// will be freed and the encapsulated object will be destroyed.
+/// will be freed and the encapsulated object will be destroyed, see
+/// JILFreeHandle().
 
 #define JILRelease(STATE, HANDLE) \
 {\
@@ -270,8 +413,12 @@ JILINLINE JILHandle* JILGetNullHandle(JILState* pState)
 	JILHandle* _H = (HANDLE);\
 	if( --_H->refCount == 0 )\
 	{\
-		JILDestroyObject( _S, _H );\
-		_S->vmppFreeHandles[--_S->vmUsedHandles] = _H;\
+		JILFreeHandle( _S, _H );\
+	}\
+	else\
+	{\
+		JIL_GC_BARRIER( _S, _H )\
+		JIL_CC_CANDIDATE( _S, _H )\
 	}\
 }
 
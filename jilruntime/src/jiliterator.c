@@ -11,12 +11,13 @@
 // Description:
 // ------------
 /// @file jiliterator.c
-/// The built-in iterator object for iterating over the built-in list object.
+/// The built-in iterator object for iterating over the built-in list and table objects.
 //------------------------------------------------------------------------------
 
 #include "jilstdinc.h"
 
 #include "jillist.h"
+#include "jiltable.h"
 #include "jiltools.h"
 #include "jilhandle.h"
 #include "jilstring.h"
@@ -49,7 +50,7 @@ enum
 //------------------------------------------------------------------------------
 
 static const char* kClassDeclaration =
-	TAG("This is the built-in iterator class. Iterators are used to sequentially navigate over lists and examine their items. To create an iterator for a list, you can just initialize an iterator variable with a list object: <pre>list myList = new list();\\nmyList.add(\\\"hello\\\", \\\"Hello World!\\\");\\nfor( iterator it = myList; it.valid; it.next() )\\n{\\n    println(it.value);\\n}</pre>")
+	TAG("This is the built-in iterator class. Iterators are used to sequentially navigate over lists and examine their items. To create an iterator for a list, you can just initialize an iterator variable with a list object: <pre>list myList = new list();\\nmyList.add(\\\"hello\\\", \\\"Hello World!\\\");\\nfor( iterator it = myList; it.valid; it.next() )\\n{\\n    println(it.value);\\n}</pre> Iterators can also visit the keys and values of a table in the order of their keys, see table::iterate(). When the table is modified during iteration, the iterator continues with the next key in order. Inserting into a table stores the value under the given key, regardless of the iterator's position.")
 	"method					iterator(list);" TAG("Constructs a new iterator for the specified list.")
 	"method					iterator(const iterator);" TAG("Copy-constructs a new iterator from an existing one. The new iterator will reference the same item from the same list as the specified iterator.")
 	"method					first();" TAG("Moves the iterator to the beginning of the list.")
@@ -83,6 +84,7 @@ static int IteratorNew			(NTLInstance* pInst, JILIterator** ppObject);
 static int IteratorDelete		(NTLInstance* pInst, JILIterator* _this);
 static int IteratorMark			(NTLInstance* pInst, JILIterator* _this);
 static int IteratorCallMember	(NTLInstance* pInst, int funcID, JILIterator* _this);
+static int IteratorCallTable	(JILState* ps, int funcID, JILIterator* _this);
 
 static JILIterator*	JILIterator_New		(JILState* pState);
 static void			JILIterator_Delete	(JILIterator* _this);
@@ -168,6 +170,8 @@ static int IteratorCallMember(NTLInstance* pInst, int funcID, JILIterator* _this
 	JILHandle* key = NULL;
 	JILHandle* val = NULL;
 	JILBool flag;
+	if( _this->pCursor )
+		return IteratorCallTable(ps, funcID, _this);
 	switch( funcID )
 	{
 		case kCtor:
@@ -183,6 +187,8 @@ static int IteratorCallMember(NTLInstance* pInst, int funcID, JILIterator* _this
 			_this->pList = pSrc->pList;
 			_this->pItem = pSrc->pItem;
 			_this->deleted = pSrc->deleted;
+			if( pSrc->pCursor )
+				_this->pCursor = JILTable_CopyCursor(pSrc->pCursor);
 			NTLReferHandle(ps, _this->pList);
 			JILList_AddRef(_this->pState, _this->pItem);
 			NTLFreeHandle(ps, hSrc);
@@ -290,6 +296,103 @@ invalid_key:
 	return JIL_VM_Unsupported_Type;
 }
 
+//------------------------------------------------------------------------------
+// IteratorCallTable
+//------------------------------------------------------------------------------
+// Member functions of an iterator that references a table. The cursor keeps a
+// copy of the current key, the value is looked up when it is accessed.
+
+static int IteratorCallTable(JILState* ps, int funcID, JILIterator* _this)
+{
+	int result = JIL_No_Exception;
+	JILTable* table = (JILTable*) NTLHandleToObject(ps, type_table, _this->pList);
+	const JILChar* pKey = JILTable_CursorKey(_this->pCursor);
+	JILHandle* key;
+	JILHandle* val;
+	switch( funcID )
+	{
+		case kFirst:
+			JILTable_CursorFirst(_this->pCursor);
+			break;
+		case kLast:
+			JILTable_CursorLast(_this->pCursor);
+			break;
+		case kPrev:
+			JILTable_CursorPrev(_this->pCursor);
+			break;
+		case kNext:
+			JILTable_CursorNext(_this->pCursor);
+			break;
+		case kInsert:
+			key = NTLGetArgHandle(ps, 0);
+			val = NTLGetArgHandle(ps, 1);
+			if( NTLHandleToTypeID(ps, key) == type_string )
+				JILTable_SetItem(table, NTLHandleToString(ps, key), val);
+			else
+				result = JIL_VM_Unsupported_Type;
+			NTLFreeHandle(ps, val);
+			NTLFreeHandle(ps, key);
+			break;
+		case kDelete:
+			if( pKey )
+				JILTable_SetItem(table, pKey, JILGetNullHandle(ps));
+			break;
+		case kKey:
+			if( pKey )
+			{
+				JILString* pStr = JILString_New(ps);
+				JILString_Assign(pStr, pKey);
+				key = NTLNewHandleForObject(ps, type_string, pStr);
+				NTLReturnHandle(ps, key);
+				NTLFreeHandle(ps, key);
+			}
+			else
+			{
+				NTLReturnHandle(ps, NULL);
+			}
+			break;
+		case kValueGet:
+			NTLReturnHandle(ps, pKey ? (JILHandle*) JILTable_GetItem(table, pKey) : NULL);
+			break;
+		case kValueSet:
+			if( pKey )
+			{
+				val = NTLGetArgHandle(ps, 0);
+				JILTable_SetItem(table, pKey, val);
+				NTLFreeHandle(ps, val);
+			}
+			break;
+		case kValid:
+			NTLReturnInt(ps, pKey != NULL);
+			break;
+		case kIsFirst:
+			NTLReturnInt(ps, JILTable_CursorIsFirst(_this->pCursor));
+			break;
+		case kIsLast:
+			NTLReturnInt(ps, JILTable_CursorIsLast(_this->pCursor));
+			break;
+		default:
+			result = JIL_ERR_Invalid_Function_Index;
+			break;
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// JILIterator_NewForTable
+//------------------------------------------------------------------------------
+/// Creates an iterator that visits the keys and values of a table in the order
+/// of their keys, and returns a new handle for it.
+
+JILHandle* JILIterator_NewForTable(JILState* pState, JILHandle* hTable)
+{
+	JILIterator* _this = JILIterator_New(pState);
+	_this->pList = hTable;
+	_this->pCursor = JILTable_NewCursor((JILTable*) NTLHandleToObject(pState, type_table, hTable));
+	NTLReferHandle(pState, hTable);
+	return NTLNewHandleForObject(pState, type_iterator, _this);
+}
+
 //------------------------------------------------------------------------------
 // JILIterator_New
 //------------------------------------------------------------------------------
@@ -309,6 +412,8 @@ static JILIterator* JILIterator_New (JILState* pState)
 static void JILIterator_Delete (JILIterator* _this)
 {
 	JILList_Release(_this->pState, _this->pItem);
+	if( _this->pCursor )
+		JILTable_DeleteCursor(_this->pCursor);
 	if( _this->pList )
 		JILRelease(_this->pState, _this->pList);
 	_this->pState->vmFree( _this->pState, _this );
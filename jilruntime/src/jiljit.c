@@ -0,0 +1,1082 @@
+//------------------------------------------------------------------------------
+// File: JILJit.c                                              (c) 2026 jewe.org
+//------------------------------------------------------------------------------
+//
+// DISCLAIMER:
+// -----------
+//	THIS SOFTWARE IS SUBJECT TO THE LICENSE AGREEMENT FOUND IN "jilapi.h" AND
+//	"COPYING". BY USING THIS SOFTWARE YOU IMPLICITLY DECLARE YOUR AGREEMENT TO
+//	THE TERMS OF THIS LICENSE.
+//
+// Description:
+// ------------
+//	A simple template JIT compiler for x86-64. When a function has been called
+//	often, or a backward branch inside a function has been taken often, the
+//	whole function is translated into machine code, instruction by instruction.
+//	Every instruction the compiler does not support is translated into an exit,
+//	that returns the address of the instruction to the interpreter, which then
+//	executes it and continues. Every supported instruction first checks its
+//	operands, and exits in the same way before changing anything if the types
+//	are not as expected, or if the instruction would throw an exception. So the
+//	interpreter always continues in a consistent state, and remains responsible
+//	for calls, allocations, exceptions and cofunctions. If the checks of an
+//	instruction keep failing, for example because the interpreter has reverted
+//	a quickened instruction, the function is discarded and compiled again
+//	with that instruction translated into an exit.
+//	While compiled code runs, these registers hold the state of the VM:
+//	rbx = JILContext*, r12 = registers, r13 = stack frame, r14 = JILState*.
+//------------------------------------------------------------------------------
+
+#include "jilstdinc.h"
+
+#include "jiljit.h"
+#include "jilsegment.h"
+#include "jilhandle.h"
+#include "jilcodelist.h"
+#include "jilopcodes.h"
+
+#if JIL_USE_JIT
+#include <sys/mman.h>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+// x86-64 registers and condition codes
+//------------------------------------------------------------------------------
+
+enum
+{
+	kRAX = 0, kRCX, kRDX, kRBX, kRSP, kRBP, kRSI, kRDI,
+	kR8, kR9, kR10, kR11, kR12, kR13, kR14, kR15
+};
+
+enum
+{
+	kRegContext	= kRBX,		// JILContext*
+	kRegBank	= kR12,		// JILContext::vmppRegister
+	kRegFrame	= kR13,		// JILContext::vmppDataStack + vmDataStackPointer
+	kRegState	= kR14		// JILState*
+};
+
+enum
+{
+	kCondAlways	= -1,
+	kCondE		= 0x4,
+	kCondNE		= 0x5,
+	kCondBE		= 0x6,
+	kCondA		= 0x7,
+	kCondP		= 0xA,
+	kCondL		= 0xC,
+	kCondGE		= 0xD,
+	kCondLE		= 0xE,
+	kCondG		= 0xF
+};
+
+//------------------------------------------------------------------------------
+// handle and context offsets
+//------------------------------------------------------------------------------
+
+#define kOffType		((JILLong) offsetof(JILHandle, type))
+#define kOffRefCount	((JILLong) offsetof(JILHandle, refCount))
+#define kOffData		((JILLong) offsetof(JILHandle, data))
+#define kOffHandles		((JILLong) offsetof(JILHandleObject, ppHandles))
+#define kOffRegister	((JILLong) offsetof(JILContext, vmppRegister))
+#define kOffDataStack	((JILLong) offsetof(JILContext, vmppDataStack))
+#define kOffStackPtr	((JILLong) offsetof(JILContext, vmDataStackPointer))
+#define kOffStackLimit	((JILLong) offsetof(JILContext, vmDataStackLimit))
+#define kOffInstrCount	((JILLong) offsetof(JILState, vmInstructionCounter))
+
+//------------------------------------------------------------------------------
+// instruction classes
+//------------------------------------------------------------------------------
+// The compiler does not care about addressing modes, it looks at the mnemonic
+// of an instruction and decodes the operands using the instruction table.
+
+enum
+{
+	kJitNone = 0,
+	kJitNop,
+	kJitBra,
+	kJitTst,		// tsteq, tstne
+	kJitArithL,		// addl, subl, mull
+	kJitDivL,		// divl, modl
+	kJitUnaryL,		// incl, decl
+	kJitCmpL,		// cseql ... cslel
+	kJitCmpLB,		// cseql.b ... cslel.b
+	kJitIncLB,		// incl.b
+	kJitArithF,		// addf, subf, mulf, divf
+	kJitUnaryF,		// incf, decf
+	kJitMove,		// move, moveh
+	kJitCopy		// copy, copyh
+};
+
+typedef struct
+{
+	const JILChar*	name;		// mnemonic
+	JILLong			cls;		// instruction class
+	JILLong			op;			// x86 opcode or condition code
+} JILJitOpInfo;
+
+static const JILJitOpInfo kJitOps[] =
+{
+	{ "nop",		kJitNop,	0 },
+	{ "bra",		kJitBra,	0 },
+	{ "tsteq",		kJitTst,	kCondE },
+	{ "tstne",		kJitTst,	kCondNE },
+	{ "addl",		kJitArithL,	0x03 },		// add r32, m32
+	{ "subl",		kJitArithL,	0x2B },		// sub r32, m32
+	{ "mull",		kJitArithL,	0x0FAF },	// imul r32, m32
+	{ "divl",		kJitDivL,	kRAX },		// quotient
+	{ "modl",		kJitDivL,	kRDX },		// remainder
+	{ "incl",		kJitUnaryL,	0 },		// inc m32
+	{ "decl",		kJitUnaryL,	1 },		// dec m32
+	{ "cseql",		kJitCmpL,	kCondE },
+	{ "csnel",		kJitCmpL,	kCondNE },
+	{ "csgtl",		kJitCmpL,	kCondG },
+	{ "csgel",		kJitCmpL,	kCondGE },
+	{ "csltl",		kJitCmpL,	kCondL },
+	{ "cslel",		kJitCmpL,	kCondLE },
+	{ "cseql.b",	kJitCmpLB,	kCondE },
+	{ "csnel.b",	kJitCmpLB,	kCondNE },
+	{ "csgtl.b",	kJitCmpLB,	kCondG },
+	{ "csgel.b",	kJitCmpLB,	kCondGE },
+	{ "csltl.b",	kJitCmpLB,	kCondL },
+	{ "cslel.b",	kJitCmpLB,	kCondLE },
+	{ "incl.b",		kJitIncLB,	0 },
+#if !JIL_MACHINE_NO_64_BIT
+	{ "addf",		kJitArithF,	0x58 },		// addsd
+	{ "subf",		kJitArithF,	0x5C },		// subsd
+	{ "mulf",		kJitArithF,	0x59 },		// mulsd
+	{ "divf",		kJitArithF,	0x5E },		// divsd
+	{ "incf",		kJitUnaryF,	0x58 },
+	{ "decf",		kJitUnaryF,	0x5C },
+#endif
+	{ "move",		kJitMove,	0 },
+	{ "moveh",		kJitMove,	0 },
+	{ "copy",		kJitCopy,	0 },
+	{ "copyh",		kJitCopy,	0 },
+	{ NULL,			kJitNone,	0 }
+};
+
+//------------------------------------------------------------------------------
+// struct JILJitBlock
+//------------------------------------------------------------------------------
+// A block of executable memory holding the code of a compiled function.
+
+struct JILJitBlock
+{
+	JILJitBlock*	pNext;
+	void*			pMem;
+	size_t			size;
+	JILLong			codeAddr;		// code address of the compiled function
+	JILLong			codeSize;		// size of the compiled function in code words
+};
+
+//------------------------------------------------------------------------------
+// JILJitFixup
+//------------------------------------------------------------------------------
+// A rel32 jump that must be patched after all code has been emitted.
+
+typedef struct
+{
+	JILLong		pos;			// position of the rel32 in the code buffer
+	JILLong		address;		// code address of the target instruction
+	JILBool		isExit;			// jump to the exit of the instruction, not the instruction
+} JILJitFixup;
+
+//------------------------------------------------------------------------------
+// JILJitCompiler
+//------------------------------------------------------------------------------
+// Working data while compiling a function.
+
+typedef struct
+{
+	JILState*		pState;
+	const JILLong*	pCode;			// the code segment
+	JILLong			codeAddr;		// code address of the function
+	JILLong			codeSize;		// size of the function in code words
+	JILLong*		pLabel;			// native offset for every code word, or -1
+	JILLong*		pExit;			// native offset of the exit for every code word, or -1
+	JILLong			address;		// code address of the instruction being compiled
+	JILLong			epilogue;		// native offset of the epilogue
+	JILByte*		pBuf;
+	JILLong			size;
+	JILLong			maxSize;
+	JILJitFixup*	pFixup;
+	JILLong			numFixup;
+	JILLong			maxFixup;
+	JILBool			failed;
+} JILJitCompiler;
+
+//------------------------------------------------------------------------------
+// JILJitOperand
+//------------------------------------------------------------------------------
+// A decoded operand of an instruction.
+
+typedef struct
+{
+	JILLong			type;			// operand type, see enum JILOperandType
+	const JILLong*	pData;			// operand data in the code segment
+} JILJitOperand;
+
+//------------------------------------------------------------------------------
+// static functions
+//------------------------------------------------------------------------------
+
+static void		JILJitStoreHandle	(JILState* ps, JILHandle** ppVar, JILHandle* pObj);
+static JILBool	JILJitCompile		(JILState* ps, JILLong address);
+static JILJitBlock*	JILJitNewBlock	(const JILByte* pCode, JILLong size);
+static void		JILJitFreeBlocks	(JILJitBlock** ppList);
+
+//------------------------------------------------------------------------------
+// code emitters
+//------------------------------------------------------------------------------
+
+static void Emit8(JILJitCompiler* c, JILLong b)
+{
+	if( c->size == c->maxSize )
+	{
+		c->maxSize *= 2;
+		c->pBuf = (JILByte*) realloc(c->pBuf, c->maxSize);
+	}
+	c->pBuf[c->size++] = (JILByte) b;
+}
+
+static void Emit16(JILJitCompiler* c, JILLong v)
+{
+	Emit8(c, v);
+	Emit8(c, v >> 8);
+}
+
+static void Emit32(JILJitCompiler* c, JILLong v)
+{
+	Emit8(c, v);
+	Emit8(c, v >> 8);
+	Emit8(c, v >> 16);
+	Emit8(c, v >> 24);
+}
+
+static void Emit64(JILJitCompiler* c, JILUInt64 v)
+{
+	Emit32(c, (JILLong) v);
+	Emit32(c, (JILLong) (v >> 32));
+}
+
+static void Patch32(JILJitCompiler* c, JILLong pos, JILLong v)
+{
+	c->pBuf[pos] = (JILByte) v;
+	c->pBuf[pos + 1] = (JILByte) (v >> 8);
+	c->pBuf[pos + 2] = (JILByte) (v >> 16);
+	c->pBuf[pos + 3] = (JILByte) (v >> 24);
+}
+
+// prefix, REX and opcode bytes
+static void EmitOp(JILJitCompiler* c, JILLong prefix, JILBool w, JILLong op, JILLong reg, JILLong rm)
+{
+	JILLong rex = 0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0);
+	if( prefix )
+		Emit8(c, prefix);
+	if( rex != 0x40 )
+		Emit8(c, rex);
+	if( op > 0xFF )
+		Emit8(c, op >> 8);
+	Emit8(c, op);
+}
+
+// op reg, [base + disp32]
+static void EmitMem(JILJitCompiler* c, JILLong prefix, JILBool w, JILLong op, JILLong reg, JILLong base, JILLong disp)
+{
+	EmitOp(c, prefix, w, op, reg, base);
+	Emit8(c, 0x80 | ((reg & 7) << 3) | (base & 7));
+	if( (base & 7) == kRSP )
+		Emit8(c, 0x24);
+	Emit32(c, disp);
+}
+
+// op reg, rm
+static void EmitReg(JILJitCompiler* c, JILLong prefix, JILBool w, JILLong op, JILLong reg, JILLong rm)
+{
+	EmitOp(c, prefix, w, op, reg, rm);
+	Emit8(c, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+static void EmitPush(JILJitCompiler* c, JILLong reg)
+{
+	if( reg & 8 )
+		Emit8(c, 0x41);
+	Emit8(c, 0x50 | (reg & 7));
+}
+
+static void EmitPop(JILJitCompiler* c, JILLong reg)
+{
+	if( reg & 8 )
+		Emit8(c, 0x41);
+	Emit8(c, 0x58 | (reg & 7));
+}
+
+// mov r32, imm32
+static void EmitMovImm(JILJitCompiler* c, JILLong reg, JILLong imm)
+{
+	if( reg & 8 )
+		Emit8(c, 0x41);
+	Emit8(c, 0xB8 | (reg & 7));
+	Emit32(c, imm);
+}
+
+// mov r64, imm64
+static void EmitMovImm64(JILJitCompiler* c, JILLong reg, JILUInt64 imm)
+{
+	Emit8(c, (reg & 8) ? 0x49 : 0x48);
+	Emit8(c, 0xB8 | (reg & 7));
+	Emit64(c, imm);
+}
+
+// cmp dword [base + disp], imm32
+static void EmitCmpImm(JILJitCompiler* c, JILLong base, JILLong disp, JILLong imm)
+{
+	EmitMem(c, 0, JILFalse, 0x81, 7, base, disp);
+	Emit32(c, imm);
+}
+
+// cmp word [base + type], imm16
+static void EmitCmpType(JILJitCompiler* c, JILLong base, JILLong type)
+{
+	EmitMem(c, 0x66, JILFalse, 0x81, 7, base, kOffType);
+	Emit16(c, type);
+}
+
+// jcc / jmp rel32 to a position that is patched later, returns the position of the rel32
+static JILLong EmitJump(JILJitCompiler* c, JILLong cond)
+{
+	if( cond == kCondAlways )
+	{
+		Emit8(c, 0xE9);
+	}
+	else
+	{
+		Emit8(c, 0x0F);
+		Emit8(c, 0x80 | cond);
+	}
+	Emit32(c, 0);
+	return c->size - 4;
+}
+
+// patches a jump emitted by EmitJump() to continue at the current position
+static void EmitLabel(JILJitCompiler* c, JILLong pos)
+{
+	Patch32(c, pos, c->size - (pos + 4));
+}
+
+static void AddFixup(JILJitCompiler* c, JILLong pos, JILLong address, JILBool isExit)
+{
+	if( c->numFixup == c->maxFixup )
+	{
+		c->maxFixup *= 2;
+		c->pFixup = (JILJitFixup*) realloc(c->pFixup, c->maxFixup * sizeof(JILJitFixup));
+	}
+	c->pFixup[c->numFixup].pos = pos;
+	c->pFixup[c->numFixup].address = address;
+	c->pFixup[c->numFixup].isExit = isExit;
+	c->numFixup++;
+}
+
+// jump to the exit of the current instruction, if the condition is true
+static void EmitExitIf(JILJitCompiler* c, JILLong cond)
+{
+	AddFixup(c, EmitJump(c, cond), c->address, JILTrue);
+}
+
+// jump to the instruction at the given code address, if the condition is true
+static void EmitBranch(JILJitCompiler* c, JILLong cond, JILLong address)
+{
+	if( address < c->codeAddr || address >= c->codeAddr + c->codeSize || c->pLabel[address - c->codeAddr] < 0 )
+		c->failed = JILTrue;
+	AddFixup(c, EmitJump(c, cond), address, JILFalse);
+}
+
+// count the instruction, see JIL_USE_INSTRUCTION_COUNTER
+static void EmitCount(JILJitCompiler* c, JILLong delta)
+{
+#if JIL_USE_INSTRUCTION_COUNTER
+	EmitMem(c, 0, JILTrue, 0x83, (delta < 0) ? 5 : 0, kRegState, kOffInstrCount);	// add / sub qword [r14 + vmInstructionCounter], 1
+	Emit8(c, 1);
+#endif
+}
+
+// leave compiled code and continue in the interpreter at the given address
+static void EmitExit(JILJitCompiler* c, JILLong address)
+{
+	EmitMovImm(c, kRAX, address);
+	Emit8(c, 0xE9);
+	Emit32(c, c->epilogue - (c->size + 4));
+}
+
+// load registers and stack frame from the context
+static void EmitLoadContext(JILJitCompiler* c)
+{
+	EmitMem(c, 0, JILTrue, 0x8B, kRegBank, kRegContext, kOffRegister);		// mov r12, [rbx + vmppRegister]
+	EmitMem(c, 0, JILTrue, 0x8B, kRegFrame, kRegContext, kOffDataStack);	// mov r13, [rbx + vmppDataStack]
+	EmitMem(c, 0, JILFalse, 0x8B, kRAX, kRegContext, kOffStackPtr);			// mov eax, [rbx + vmDataStackPointer]
+	EmitMem(c, 0, JILFalse, 0x2B, kRAX, kRegContext, kOffStackLimit);		// sub eax, [rbx + vmDataStackLimit]
+	EmitReg(c, 0, JILTrue, 0xC1, 4, kRAX);									// shl rax, 3
+	Emit8(c, 3);
+	EmitReg(c, 0, JILTrue, 0x01, kRAX, kRegFrame);							// add r13, rax
+}
+
+//------------------------------------------------------------------------------
+// operand emitters
+//------------------------------------------------------------------------------
+
+// Loads the address of the handle pointer an operand refers to into 'reg'. If
+// lea is false, loads the handle pointer itself.
+static void EmitOperand(JILJitCompiler* c, JILLong reg, const JILJitOperand* pOp, JILBool lea)
+{
+	JILLong op = lea ? 0x8D : 0x8B;
+	switch( pOp->type )
+	{
+		case ot_ear:
+			EmitMem(c, 0, JILTrue, op, reg, kRegBank, pOp->pData[0] * sizeof(JILHandle*));
+			break;
+		case ot_eas:
+			EmitMem(c, 0, JILTrue, op, reg, kRegFrame, pOp->pData[0] * sizeof(JILHandle*));
+			break;
+		case ot_ead:
+			EmitMem(c, 0, JILTrue, 0x8B, reg, kRegBank, pOp->pData[0] * sizeof(JILHandle*));
+			EmitCmpType(c, reg, type_null);
+			EmitExitIf(c, kCondE);
+			EmitMem(c, 0, JILTrue, 0x8B, reg, reg, kOffHandles);
+			EmitMem(c, 0, JILTrue, op, reg, reg, pOp->pData[1] * sizeof(JILHandle*));
+			break;
+		default:
+			c->failed = JILTrue;
+			break;
+	}
+}
+
+// exit if the handle in 'reg' is not of the given type
+static void EmitGuardType(JILJitCompiler* c, JILLong reg, JILLong type)
+{
+	EmitCmpType(c, reg, type);
+	EmitExitIf(c, kCondNE);
+}
+
+// exit if the handle in 'reg' is neither int nor float
+static void EmitGuardNumber(JILJitCompiler* c, JILLong reg)
+{
+	JILLong pos;
+	EmitCmpType(c, reg, type_int);
+	pos = EmitJump(c, kCondE);
+	EmitGuardType(c, reg, type_float);
+	EmitLabel(c, pos);
+}
+
+// exit if a value can not be written directly into the handle in 'reg', see JIL_STORE_INT
+static void EmitGuardOwned(JILJitCompiler* c, JILLong reg)
+{
+#if JIL_USE_HANDLE_REUSE
+	EmitCmpImm(c, reg, kOffRefCount, 1);
+	EmitExitIf(c, kCondNE);
+	EmitGuardNumber(c, reg);
+#else
+	// the interpreter takes a new handle for every result
+	EmitExitIf(c, kCondAlways);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILJitCompileInstr
+//------------------------------------------------------------------------------
+// Translates a single instruction. The handle of the source operand is loaded
+// into rcx, the handle of the destination operand into rsi. All checks are
+// done before anything is written.
+
+static void JILJitCompileInstr(JILJitCompiler* c, const JILJitOpInfo* pInfo, const JILJitOperand* pOp)
+{
+	JILLong pos, pos2, pos3, pos4;
+	switch( pInfo->cls )
+	{
+		case kJitNop:
+			break;
+		case kJitBra:
+			EmitBranch(c, kCondAlways, c->address + pOp[0].pData[0]);
+			break;
+		case kJitTst:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitGuardType(c, kRCX, type_int);
+			EmitCmpImm(c, kRCX, kOffData, 0);
+			EmitBranch(c, pInfo->op, c->address + pOp[1].pData[0]);
+			break;
+		case kJitArithL:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitOperand(c, kRSI, pOp + 1, JILFalse);
+			EmitGuardType(c, kRCX, type_int);
+			EmitGuardType(c, kRSI, type_int);
+			EmitMem(c, 0, JILFalse, 0x8B, kRAX, kRSI, kOffData);			// mov eax, [rsi + l]
+			EmitMem(c, 0, JILFalse, pInfo->op, kRAX, kRCX, kOffData);		// op eax, [rcx + l]
+			EmitMem(c, 0, JILFalse, 0x89, kRAX, kRSI, kOffData);			// mov [rsi + l], eax
+			break;
+		case kJitDivL:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitOperand(c, kRSI, pOp + 1, JILFalse);
+			EmitGuardType(c, kRCX, type_int);
+			EmitGuardType(c, kRSI, type_int);
+			EmitCmpImm(c, kRCX, kOffData, 0);								// division by zero is thrown by the interpreter
+			EmitExitIf(c, kCondE);
+			EmitMem(c, 0, JILFalse, 0x8B, kRAX, kRSI, kOffData);			// mov eax, [rsi + l]
+			Emit8(c, 0x99);													// cdq
+			EmitMem(c, 0, JILFalse, 0xF7, 7, kRCX, kOffData);				// idiv dword [rcx + l]
+			EmitMem(c, 0, JILFalse, 0x89, pInfo->op, kRSI, kOffData);		// mov [rsi + l], eax / edx
+			break;
+		case kJitUnaryL:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitGuardType(c, kRCX, type_int);
+			EmitMem(c, 0, JILFalse, 0xFF, pInfo->op, kRCX, kOffData);		// inc / dec dword [rcx + l]
+			break;
+		case kJitIncLB:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitGuardType(c, kRCX, type_int);
+			EmitMem(c, 0, JILFalse, 0xFF, 0, kRCX, kOffData);				// inc dword [rcx + l]
+			EmitBranch(c, kCondAlways, c->address + pOp[1].pData[0]);
+			break;
+		case kJitCmpL:
+		case kJitCmpLB:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitOperand(c, kRSI, pOp + 1, JILFalse);
+			EmitOperand(c, kRDI, pOp + 2, JILFalse);
+			EmitGuardType(c, kRCX, type_int);
+			EmitGuardType(c, kRSI, type_int);
+			EmitGuardOwned(c, kRDI);
+			EmitMem(c, 0, JILFalse, 0x8B, kRAX, kRSI, kOffData);			// mov eax, [rsi + l]
+			EmitMem(c, 0, JILFalse, 0x3B, kRAX, kRCX, kOffData);			// cmp eax, [rcx + l]
+			EmitReg(c, 0, JILFalse, 0x0F90 | pInfo->op, 0, kRAX);			// setcc al
+			EmitReg(c, 0, JILFalse, 0x0FB6, kRAX, kRAX);					// movzx eax, al
+			EmitMem(c, 0x66, JILFalse, 0xC7, 0, kRDI, kOffType);			// mov word [rdi + type], type_int
+			Emit16(c, type_int);
+			EmitMem(c, 0, JILFalse, 0x89, kRAX, kRDI, kOffData);			// mov [rdi + l], eax
+			if( pInfo->cls == kJitCmpLB )
+			{
+				EmitReg(c, 0, JILFalse, 0x85, kRAX, kRAX);					// test eax, eax
+				EmitBranch(c, kCondE, c->address + pOp[3].pData[0]);
+			}
+			break;
+		case kJitArithF:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitOperand(c, kRSI, pOp + 1, JILFalse);
+			EmitGuardType(c, kRCX, type_float);
+			EmitGuardType(c, kRSI, type_float);
+			if( pInfo->op == 0x5E )
+			{
+				// division by zero is thrown by the interpreter
+				EmitReg(c, 0x66, JILFalse, 0x0F57, 1, 1);					// xorpd xmm1, xmm1
+				EmitMem(c, 0x66, JILFalse, 0x0F2E, 1, kRCX, kOffData);		// ucomisd xmm1, [rcx + f]
+				pos = EmitJump(c, kCondP);
+				EmitExitIf(c, kCondE);
+				EmitLabel(c, pos);
+			}
+			EmitMem(c, 0xF2, JILFalse, 0x0F10, 0, kRSI, kOffData);			// movsd xmm0, [rsi + f]
+			EmitMem(c, 0xF2, JILFalse, 0x0F00 | pInfo->op, 0, kRCX, kOffData);	// op xmm0, [rcx + f]
+			EmitMem(c, 0xF2, JILFalse, 0x0F11, 0, kRSI, kOffData);			// movsd [rsi + f], xmm0
+			break;
+		case kJitUnaryF:
+			EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			EmitGuardType(c, kRCX, type_float);
+			{
+				JILFloat one = 1.0;
+				JILUInt64 bits;
+				memcpy(&bits, &one, sizeof(bits));
+				EmitMovImm64(c, kRAX, bits);								// mov rax, 1.0
+			}
+			EmitReg(c, 0x66, JILTrue, 0x0F6E, 1, kRAX);						// movq xmm1, rax
+			EmitMem(c, 0xF2, JILFalse, 0x0F10, 0, kRCX, kOffData);			// movsd xmm0, [rcx + f]
+			EmitReg(c, 0xF2, JILFalse, 0x0F00 | pInfo->op, 0, 1);			// op xmm0, xmm1
+			EmitMem(c, 0xF2, JILFalse, 0x0F11, 0, kRCX, kOffData);			// movsd [rcx + f], xmm0
+			break;
+		case kJitMove:
+			if( pOp[0].type == ot_handle )
+			{
+				EmitMem(c, 0, JILTrue, 0x8B, kRCX, kRegState, (JILLong) offsetof(JILState, vmppHandles));
+				EmitMem(c, 0, JILTrue, 0x8B, kRCX, kRCX, c->pState->vmpDataSegment->pData[pOp[0].pData[0]].index * sizeof(JILHandle*));
+			}
+			else
+			{
+				EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			}
+			EmitOperand(c, kRDI, pOp + 1, JILTrue);
+			// see JIL_STORE_HANDLE, only call JILRelease() if the old value will be destroyed,
+			// or if it must be buffered as a candidate root of the cycle collector
+			EmitMem(c, 0, JILTrue, 0x8B, kRAX, kRDI, 0);					// mov rax, [rdi]
+			EmitReg(c, 0, JILTrue, 0x39, kRCX, kRAX);						// cmp rax, rcx
+			pos = EmitJump(c, kCondE);
+			EmitCmpImm(c, kRAX, kOffRefCount, 1);
+			pos2 = EmitJump(c, kCondE);
+#if JIL_USE_CYCLE_COLLECTOR
+			EmitCmpType(c, kRAX, type_string);
+			pos4 = EmitJump(c, kCondA);
+#endif
+			EmitMem(c, 0, JILFalse, 0xFF, 0, kRCX, kOffRefCount);			// inc dword [rcx + refCount]
+			EmitMem(c, 0, JILFalse, 0xFF, 1, kRAX, kOffRefCount);			// dec dword [rax + refCount]
+			EmitMem(c, 0, JILTrue, 0x89, kRCX, kRDI, 0);					// mov [rdi], rcx
+			pos3 = EmitJump(c, kCondAlways);
+			EmitLabel(c, pos2);
+#if JIL_USE_CYCLE_COLLECTOR
+			EmitLabel(c, pos4);
+#endif
+			EmitReg(c, 0, JILTrue, 0x89, kRCX, kRDX);						// mov rdx, rcx
+			EmitReg(c, 0, JILTrue, 0x89, kRDI, kRSI);						// mov rsi, rdi
+			EmitReg(c, 0, JILTrue, 0x89, kRegState, kRDI);					// mov rdi, r14
+			EmitMovImm64(c, kRAX, (JILUInt64) (size_t) JILJitStoreHandle);
+			EmitReg(c, 0, JILFalse, 0xFF, 2, kRAX);							// call rax
+			EmitLoadContext(c);
+			EmitLabel(c, pos);
+			EmitLabel(c, pos3);
+			break;
+		case kJitCopy:
+			if( pOp[0].type == ot_handle )
+			{
+				EmitMem(c, 0, JILTrue, 0x8B, kRCX, kRegState, (JILLong) offsetof(JILState, vmppHandles));
+				EmitMem(c, 0, JILTrue, 0x8B, kRCX, kRCX, c->pState->vmpDataSegment->pData[pOp[0].pData[0]].index * sizeof(JILHandle*));
+			}
+			else
+			{
+				EmitOperand(c, kRCX, pOp + 0, JILFalse);
+			}
+			EmitOperand(c, kRSI, pOp + 1, JILFalse);
+			EmitGuardNumber(c, kRCX);
+			EmitGuardOwned(c, kRSI);
+			EmitMem(c, 0x66, JILFalse, 0x8B, kRAX, kRCX, kOffType);			// mov ax, [rcx + type]
+			EmitMem(c, 0x66, JILFalse, 0x89, kRAX, kRSI, kOffType);			// mov [rsi + type], ax
+			EmitMem(c, 0, JILTrue, 0x8B, kRAX, kRCX, kOffData);				// mov rax, [rcx + data]
+			EmitMem(c, 0, JILTrue, 0x89, kRAX, kRSI, kOffData);				// mov [rsi + data], rax
+			break;
+		default:
+			c->failed = JILTrue;
+			break;
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILJitStoreHandle
+//------------------------------------------------------------------------------
+// Called from compiled code if a move instruction is going to release the last
+// reference to a value.
+
+static void JILJitStoreHandle(JILState* ps, JILHandle** ppVar, JILHandle* pObj)
+{
+	JILAddRef(pObj);
+	JILRelease(ps, *ppVar);
+	*ppVar = pObj;
+}
+
+//------------------------------------------------------------------------------
+// JILJitFindOp
+//------------------------------------------------------------------------------
+// Find the instruction class of an instruction by its mnemonic.
+
+static const JILJitOpInfo* JILJitFindOp(const JILInstrInfo* pInstr)
+{
+	const JILJitOpInfo* pInfo;
+	JILLong i;
+	for( pInfo = kJitOps; pInfo->name; pInfo++ )
+	{
+		if( strcmp(pInfo->name, pInstr->name) == 0 )
+		{
+			// the JIT does not support the indexed addressing mode
+			for( i = 0; i < pInstr->numOperands; i++ )
+			{
+				if( pInstr->opType[i] == ot_eax )
+					return NULL;
+			}
+			return pInfo;
+		}
+	}
+	return NULL;
+}
+
+//------------------------------------------------------------------------------
+// JILJitCompile
+//------------------------------------------------------------------------------
+// Compiles the function containing the given code address. Returns JILTrue if
+// there is an entry point for the address afterwards.
+
+static JILBool JILJitCompile(JILState* ps, JILLong address)
+{
+	JILJit* pJit = ps->vmpJit;
+	JILFuncInfo* pFunc = NULL;
+	const JILInstrInfo* pInstr;
+	const JILJitOpInfo* pInfo;
+	JILJitOperand operand[4];
+	JILJitCompiler c;
+	JILJitBlock* pBlock = NULL;
+	JILByte* pMem = NULL;
+	JILLong i, j, pos, addr, opcode;
+
+	// find the function the address belongs to
+	for( i = 0; i < ps->vmpFuncSegment->usedSize; i++ )
+	{
+		JILFuncInfo* pFi = ps->vmpFuncSegment->pData + i;
+		if( pFi->codeSize > 0 && address >= pFi->codeAddr && address < pFi->codeAddr + pFi->codeSize )
+		{
+			pFunc = pFi;
+			break;
+		}
+	}
+	if( pFunc == NULL || pFunc->codeAddr + pFunc->codeSize > pJit->tableSize )
+	{
+		pJit->pCounter[address] = kJitNever;
+		return JILFalse;
+	}
+
+	memset(&c, 0, sizeof(c));
+	c.pState = ps;
+	c.pCode = ps->vmpCodeSegment->pData;
+	c.codeAddr = pFunc->codeAddr;
+	c.codeSize = pFunc->codeSize;
+	c.pLabel = (JILLong*) malloc(c.codeSize * sizeof(JILLong));
+	c.pExit = (JILLong*) malloc(c.codeSize * sizeof(JILLong));
+	c.maxSize = 1024;
+	c.pBuf = (JILByte*) malloc(c.maxSize);
+	c.maxFixup = 64;
+	c.pFixup = (JILJitFixup*) malloc(c.maxFixup * sizeof(JILJitFixup));
+	for( i = 0; i < c.codeSize; i++ )
+	{
+		c.pLabel[i] = -1;
+		c.pExit[i] = -1;
+	}
+
+	// mark all instructions, so that branches can be checked
+	for( addr = c.codeAddr; addr < c.codeAddr + c.codeSize; addr += pInstr->instrSize )
+	{
+		opcode = c.pCode[addr];
+		pInstr = (opcode >= 0 && opcode < JILNumOpcodes) ? JILGetInfoFromOpcode(opcode) : NULL;
+		if( pInstr == NULL || pInstr->instrSize <= 0 )
+		{
+			c.failed = JILTrue;
+			break;
+		}
+		c.pLabel[addr - c.codeAddr] = 0;
+	}
+
+	// the epilogue comes first, exits jump back to it
+	c.epilogue = c.size;
+	EmitPop(&c, kR15);
+	EmitPop(&c, kRegState);
+	EmitPop(&c, kRegFrame);
+	EmitPop(&c, kRegBank);
+	EmitPop(&c, kRegContext);
+	Emit8(&c, 0xC3);	// ret
+
+	// translate all instructions
+	for( addr = c.codeAddr; !c.failed && addr < c.codeAddr + c.codeSize; addr += pInstr->instrSize )
+	{
+		opcode = c.pCode[addr];
+		pInstr = JILGetInfoFromOpcode(opcode);
+		c.address = addr;
+		c.pLabel[addr - c.codeAddr] = c.size;
+		pInfo = JILJitFindOp(pInstr);
+		if( pInfo == NULL || pJit->pCounter[addr] == kJitExitOnly )
+		{
+			EmitExit(&c, addr);
+			continue;
+		}
+		EmitCount(&c, 1);
+		// decode operands
+		for( pos = 1, i = 0; i < pInstr->numOperands; i++ )
+		{
+			operand[i].type = pInstr->opType[i];
+			operand[i].pData = c.pCode + addr + pos;
+			pos += JILGetOperandSize(pInstr->opType[i]);
+		}
+		JILJitCompileInstr(&c, pInfo, operand);
+	}
+	// falling off the end of the function
+	EmitExit(&c, c.codeAddr + c.codeSize);
+
+	// resolve jumps and emit the exits of instructions
+	for( i = 0; !c.failed && i < c.numFixup; i++ )
+	{
+		j = c.pFixup[i].address - c.codeAddr;
+		if( c.pFixup[i].isExit )
+		{
+			if( c.pExit[j] < 0 )
+			{
+				// the interpreter executes and counts the instruction again
+				c.pExit[j] = c.size;
+				EmitCount(&c, -1);
+				EmitExit(&c, c.pFixup[i].address);
+			}
+			Patch32(&c, c.pFixup[i].pos, c.pExit[j] - (c.pFixup[i].pos + 4));
+		}
+		else
+		{
+			Patch32(&c, c.pFixup[i].pos, c.pLabel[j] - (c.pFixup[i].pos + 4));
+		}
+	}
+
+	if( !c.failed )
+		pBlock = JILJitNewBlock(c.pBuf, c.size);
+	if( pBlock )
+	{
+		pBlock->codeAddr = c.codeAddr;
+		pBlock->codeSize = c.codeSize;
+		pBlock->pNext = pJit->pBlocks;
+		pJit->pBlocks = pBlock;
+		pMem = (JILByte*) pBlock->pMem;
+	}
+
+	// install entry points, the counters now count failed checks
+	for( i = 0; i < c.codeSize; i++ )
+	{
+		addr = c.codeAddr + i;
+		pJit->ppEntry[addr] = NULL;
+		if( pJit->pCounter[addr] == kJitExitOnly )
+			continue;
+		pJit->pCounter[addr] = kJitNever;
+		if( pMem && c.pLabel[i] >= 0 && JILJitFindOp(JILGetInfoFromOpcode(c.pCode[addr])) )
+		{
+			pJit->ppEntry[addr] = pMem + c.pLabel[i];
+			pJit->pCounter[addr] = 0;
+		}
+	}
+
+	free(c.pLabel);
+	free(c.pExit);
+	free(c.pBuf);
+	free(c.pFixup);
+	return (pJit->ppEntry[address] != NULL);
+}
+
+//------------------------------------------------------------------------------
+// JILJitNewBlock
+//------------------------------------------------------------------------------
+// Copies machine code into a new block of executable memory.
+
+static JILJitBlock* JILJitNewBlock(const JILByte* pCode, JILLong size)
+{
+	JILJitBlock* pBlock;
+	void* pMem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if( pMem == MAP_FAILED )
+		return NULL;
+	memcpy(pMem, pCode, size);
+	if( mprotect(pMem, size, PROT_READ | PROT_EXEC) != 0 )
+	{
+		munmap(pMem, size);
+		return NULL;
+	}
+	pBlock = (JILJitBlock*) malloc(sizeof(JILJitBlock));
+	pBlock->pNext = NULL;
+	pBlock->pMem = pMem;
+	pBlock->size = size;
+	pBlock->codeAddr = 0;
+	pBlock->codeSize = 0;
+	return pBlock;
+}
+
+//------------------------------------------------------------------------------
+// JILJitFreeBlocks
+//------------------------------------------------------------------------------
+// Frees a list of blocks of compiled code.
+
+static void JILJitFreeBlocks(JILJitBlock** ppList)
+{
+	JILJitBlock* pBlock;
+	while( *ppList )
+	{
+		pBlock = *ppList;
+		*ppList = pBlock->pNext;
+		munmap(pBlock->pMem, pBlock->size);
+		free(pBlock);
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILJitCreateTrampoline
+//------------------------------------------------------------------------------
+// Creates the code that enters compiled code, see JILJitEnterProc. It saves
+// the registers the compiled code uses, which are restored by the epilogue of
+// every compiled function.
+
+static JILBool JILJitCreateTrampoline(JILJit* pJit)
+{
+	JILJitCompiler c;
+	memset(&c, 0, sizeof(c));
+	c.maxSize = 64;
+	c.pBuf = (JILByte*) malloc(c.maxSize);
+	EmitPush(&c, kRegContext);
+	EmitPush(&c, kRegBank);
+	EmitPush(&c, kRegFrame);
+	EmitPush(&c, kRegState);
+	EmitPush(&c, kR15);									// keeps the stack 16-byte aligned
+	EmitReg(&c, 0, JILTrue, 0x89, kRDI, kRegContext);	// mov rbx, rdi
+	EmitReg(&c, 0, JILTrue, 0x89, kRSI, kRegState);		// mov r14, rsi
+	EmitLoadContext(&c);
+	EmitReg(&c, 0, JILFalse, 0xFF, 4, kRDX);			// jmp rdx
+	pJit->pTrampoline = JILJitNewBlock(c.pBuf, c.size);
+	free(c.pBuf);
+	if( pJit->pTrampoline == NULL )
+		return JILFalse;
+	pJit->pEnter = (JILJitEnterProc) pJit->pTrampoline->pMem;
+	return JILTrue;
+}
+
+#endif	// JIL_USE_JIT
+
+//------------------------------------------------------------------------------
+// JILInitJit
+//------------------------------------------------------------------------------
+
+JILError JILInitJit(JILState* ps)
+{
+#if JIL_USE_JIT
+	JILJit* pJit = ps->vmpJit;
+	JILLong newSize = ps->vmpCodeSegment->maxSize;
+	JILLong oldSize;
+
+	if( ps->vmJitDisabled )
+		return JIL_No_Exception;
+	if( pJit == NULL )
+	{
+		pJit = (JILJit*) malloc(sizeof(JILJit));
+		memset(pJit, 0, sizeof(JILJit));
+		ps->vmpJit = pJit;
+		if( !JILJitCreateTrampoline(pJit) )
+		{
+			// no executable memory, run without JIT
+			JILDestroyJit(ps);
+			ps->vmJitDisabled = JILTrue;
+			return JIL_No_Exception;
+		}
+	}
+	oldSize = pJit->tableSize;
+	if( newSize > oldSize )
+	{
+		pJit->pCounter = (JILLong*) realloc(pJit->pCounter, newSize * sizeof(JILLong));
+		pJit->ppEntry = (void**) realloc(pJit->ppEntry, newSize * sizeof(void*));
+		memset(pJit->pCounter + oldSize, 0, (newSize - oldSize) * sizeof(JILLong));
+		memset(pJit->ppEntry + oldSize, 0, (newSize - oldSize) * sizeof(void*));
+		pJit->tableSize = newSize;
+	}
+#endif
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILDestroyJit
+//------------------------------------------------------------------------------
+
+void JILDestroyJit(JILState* ps)
+{
+#if JIL_USE_JIT
+	JILJit* pJit = ps->vmpJit;
+	if( pJit )
+	{
+		JILJitFreeBlocks(&pJit->pBlocks);
+		JILJitFreeBlocks(&pJit->pTrampoline);
+		free(pJit->pCounter);
+		free(pJit->ppEntry);
+		free(pJit);
+		ps->vmpJit = NULL;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILResetJit
+//------------------------------------------------------------------------------
+
+void JILResetJit(JILState* ps, JILLong address, JILLong size)
+{
+#if JIL_USE_JIT
+	JILJit* pJit = ps->vmpJit;
+	if( pJit == NULL )
+		return;
+	if( pJit->pBlocks != NULL )
+	{
+		// compiled code may depend on the changed code, discard all of it
+		JILJitFreeBlocks(&pJit->pBlocks);
+		memset(pJit->pCounter, 0, pJit->tableSize * sizeof(JILLong));
+		memset(pJit->ppEntry, 0, pJit->tableSize * sizeof(void*));
+	}
+	if( address + size > pJit->tableSize )
+	{
+		JILInitJit(ps);
+	}
+	else
+	{
+		memset(pJit->pCounter + address, 0, size * sizeof(JILLong));
+		memset(pJit->ppEntry + address, 0, size * sizeof(void*));
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILJitCount
+//------------------------------------------------------------------------------
+
+JILBool JILJitCount(JILState* ps, JILLong address)
+{
+#if JIL_USE_JIT
+	JILJit* pJit = ps->vmpJit;
+	if( ++pJit->pCounter[address] < kJitThreshold )
+		return JILFalse;
+	return JILJitCompile(ps, address);
+#else
+	return JILFalse;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILJitRun
+//------------------------------------------------------------------------------
+
+JILLong JILJitRun(JILState* ps, JILContext* pContext, JILLong address)
+{
+#if JIL_USE_JIT
+	JILJit* pJit = ps->vmpJit;
+	JILLong result = pJit->pEnter(pContext, ps, pJit->ppEntry[address]);
+
+	// compiled code only exits at compiled instructions if their checks fail
+	if( result < pJit->tableSize && pJit->ppEntry[result] && ++pJit->pCounter[result] >= kJitMaxBailouts )
+	{
+		// the instruction keeps failing, compile it into an exit next time
+		JILJitDiscard(ps, result);
+		pJit->pCounter[result] = kJitExitOnly;
+	}
+	return result;
+#else
+	return address;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// JILJitDiscard
+//------------------------------------------------------------------------------
+
+void JILJitDiscard(JILState* ps, JILLong address)
+{
+#if JIL_USE_JIT
+	JILJit* pJit = ps->vmpJit;
+	JILJitBlock** ppLink;
+	JILJitBlock* pBlock;
+	JILLong i;
+
+	if( pJit == NULL )
+		return;
+	for( ppLink = &pJit->pBlocks; *ppLink; ppLink = &(*ppLink)->pNext )
+	{
+		pBlock = *ppLink;
+		if( address >= pBlock->codeAddr && address < pBlock->codeAddr + pBlock->codeSize )
+		{
+			// compiled code never stays on the stack when it exits, so the block can be freed right away
+			for( i = pBlock->codeAddr; i < pBlock->codeAddr + pBlock->codeSize; i++ )
+			{
+				pJit->ppEntry[i] = NULL;
+				if( pJit->pCounter[i] != kJitExitOnly )
+					pJit->pCounter[i] = 0;
+			}
+			*ppLink = pBlock->pNext;
+			pBlock->pNext = NULL;
+			JILJitFreeBlocks(&pBlock);
+			break;
+		}
+	}
+#endif
+}
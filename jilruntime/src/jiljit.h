@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// File: JILJit.h                                              (c) 2026 jewe.org
+//------------------------------------------------------------------------------
+//
+// DISCLAIMER:
+// -----------
+//	THIS SOFTWARE IS SUBJECT TO THE LICENSE AGREEMENT FOUND IN "jilapi.h" AND
+//	"COPYING". BY USING THIS SOFTWARE YOU IMPLICITLY DECLARE YOUR AGREEMENT TO
+//	THE TERMS OF THIS LICENSE.
+//
+// Description:
+// ------------
+/// @file jiljit.h
+/// A simple template JIT compiler, that translates hot byte-code functions into
+/// x86-64 machine code. See JIL_USE_JIT in jilplatform.h.
+//------------------------------------------------------------------------------
+
+#ifndef JILJIT_H
+#define JILJIT_H
+
+#include "jiltypes.h"
+
+typedef struct JILJitBlock			JILJitBlock;
+
+//------------------------------------------------------------------------------
+// JILJitEnterProc
+//------------------------------------------------------------------------------
+// Enters compiled code at the given entry point. Returns the code address at
+// which the interpreter has to continue.
+
+typedef JILLong (*JILJitEnterProc)(JILContext* pContext, JILState* pState, void* pEntry);
+
+//------------------------------------------------------------------------------
+// JIT thresholds
+//------------------------------------------------------------------------------
+
+enum
+{
+	kJitThreshold		= 1000,		//!< number of calls or loop iterations until a function gets compiled
+	kJitMaxBailouts		= 100,		//!< number of times a compiled instruction may fail its checks before the function is discarded
+	kJitNever			= -1,		//!< counter value of code addresses that will not be compiled (anymore)
+	kJitExitOnly		= -2		//!< counter value of instructions that are compiled into an exit, because their checks kept failing
+};
+
+//------------------------------------------------------------------------------
+// struct JILJit
+//------------------------------------------------------------------------------
+// State of the JIT compiler, see JILState::vmpJit.
+
+struct JILJit
+{
+	JILLong				tableSize;		//!< Number of code words covered by pCounter and ppEntry
+	JILLong*			pCounter;		//!< Number of calls or backward branches to each code address, or failed checks if compiled
+	void**				ppEntry;		//!< Entry point into compiled code for each code address, or NULL
+	JILJitEnterProc		pEnter;			//!< Trampoline that sets up registers and jumps to an entry point
+	JILJitBlock*		pBlocks;		//!< List of memory blocks holding compiled functions
+	JILJitBlock*		pTrampoline;	//!< Memory block holding the trampoline
+};
+
+//------------------------------------------------------------------------------
+// JILInitJit
+//------------------------------------------------------------------------------
+// Creates the JIT compiler state and makes sure it covers the entire code
+// segment. Called by JILInitVM(). Does nothing if the JIT compiler is disabled
+// by JIL_USE_JIT or the runtime option "jit".
+
+JILError				JILInitJit				(JILState* ps);
+
+//------------------------------------------------------------------------------
+// JILDestroyJit
+//------------------------------------------------------------------------------
+// Frees all compiled code and the JIT compiler state.
+
+void					JILDestroyJit			(JILState* ps);
+
+//------------------------------------------------------------------------------
+// JILResetJit
+//------------------------------------------------------------------------------
+// Discards compiled code after code has been written into the given range of
+// code words. Called when code is written into the code segment.
+
+void					JILResetJit				(JILState* ps, JILLong address, JILLong size);
+
+//------------------------------------------------------------------------------
+// JILJitCount
+//------------------------------------------------------------------------------
+// Called by the interpreter for every backward branch or call to an address
+// that has no entry point yet. Counts the branch and compiles the function
+// containing the address once it gets hot. Returns JILTrue if there is an
+// entry point for the address now.
+
+JILBool					JILJitCount				(JILState* ps, JILLong address);
+
+//------------------------------------------------------------------------------
+// JILJitRun
+//------------------------------------------------------------------------------
+// Runs compiled code from the entry point at the given code address. Returns
+// the code address at which the interpreter has to continue.
+
+JILLong					JILJitRun				(JILState* ps, JILContext* pContext, JILLong address);
+
+//------------------------------------------------------------------------------
+// JILJitDiscard
+//------------------------------------------------------------------------------
+// Discards the compiled code of the function containing the given code
+// address, if there is any. The function is compiled again once it is hot.
+// Called when the interpreter reverts a quickened instruction, and when the
+// checks of a compiled instruction keep failing.
+
+void					JILJitDiscard			(JILState* ps, JILLong address);
+
+#endif	// #ifndef JILJIT_H
@@ -65,7 +65,7 @@ enum
 //------------------------------------------------------------------------------
 
 static const char* kClassDeclaration =
-	TAG("This is the built-in list class. It is a double-chained, associative list implementation. Items can be stored and retrieved by an associative 'key'. The key can be an integer, a floating-point number, or a string. The list does not enforce that an item's key is unique.<p>All methods that access items by their key will actually search the list for the first occurrence of a matching key. This will only work reliably, if you use unique values for the keys. It also means that performance of these methods gets worse the larger the list gets.  The arraylist class allows quick random access to list items. However, it will also use more memory. For very large collections, consider using the table class.</p>")
+	TAG("This is the built-in list class. It is a double-chained, associative list implementation. Items can be stored and retrieved by an associative 'key'. The key can be an integer, a floating-point number, or a string. The list does not enforce that an item's key is unique.<p>All methods that access items by their key will find the first occurrence of a matching key in the list. This will only work reliably, if you use unique values for the keys. Once the list has grown beyond a few dozen items, it builds a hash index of its keys, so that these methods do not get slower the larger the list gets. Accessing items by their index is logarithmic for large lists. The arraylist class allows quick random access to list items. However, it will also use more memory.</p>")
 	"delegate			enumerator(const var key, var value, var args);" TAG("Delegate type for the list::enumerate() method.")
 	"delegate int		comparator(const var value1, const var value2);" TAG("Delegate type for the list::sort() and array::sort() methods. The delegate should handle null-references and unmatching types gracefully. It should return -1 if value1 is less than value2, 1 if it is greater, and 0 if they are equal.")
 	"method				list();" TAG("Constructs a new, empty list.")
@@ -81,7 +81,7 @@ static const char* kClassDeclaration =
 	"method				moveToLast(const var key);" TAG("Moves the specified item to the end of the list. If the specified item does not exist, the call has no effect.")
 	"method				remove(const var key);" TAG("Removes the specified item from the list. If the specified item does not exist, the call has no effect.")
 	"method				clear();" TAG("Removes all items from the list.")
-	"method				sort(const int mode, comparator fn);" TAG("Sorts the list according to the specified mode and comparator delegate. 'mode' is defined as follows: <ol start='0'><li>sort by key first, ascending</li><li>sort by key first, descending</li><li>sort by value first, ascending</li><li>sort by value first, descending</li></ol>")
+	"method				sort(const int mode, comparator fn);" TAG("Sorts the list according to the specified mode and comparator delegate. 'mode' is defined as follows: <ol start='0'><li>sort by key first, ascending</li><li>sort by key first, descending</li><li>sort by value first, ascending</li><li>sort by value first, descending</li></ol> Integers, floats and strings are compared by value, the delegate is only called for other types. The sort is stable.")
 	"method var			value(const var key);" TAG("Returns the value from the list that is associated with the specified key. If the key is not found, null is returned.")
 	"method var			valueFromIndex(const int index);" TAG("Returns the value from the list that is associated with the specified zero based index. If the index is out of range, null is returned.")
 	"method const var	keyFromIndex(const int index);" TAG("Returns the key from the list that is associated with the specified zero based index. If the index is out of range, null is returned.")
@@ -101,6 +101,13 @@ static const char*	kAuthorName		=	"www.jewe.org";
 static const char*	kAuthorString	=	"A list class for JewelScript.";
 static const char*	kTimeStamp		=	"01/28/2006";
 
+//------------------------------------------------------------------------------
+// index constants
+//------------------------------------------------------------------------------
+
+static const JILLong kListIndexThreshold	=	32;		// length at which a list builds an index when it is searched
+static const JILLong kListMinBuckets		=	64;		// initial number of buckets of the key index
+
 //------------------------------------------------------------------------------
 // forward declare static functions
 //------------------------------------------------------------------------------
@@ -362,81 +369,110 @@ invalid_key:
 // NewListItem
 //------------------------------------------------------------------------------
 
+// Keys are copied, because the key index would get out of sync if a script
+// modified a key handle it still refers to.
+
 static JILListItem* NewListItem(JILState* pState, JILHandle* key, JILHandle* value)
 {
 	JILListItem* item = (JILListItem*) pState->vmMalloc(pState, sizeof(JILListItem));
-	NTLReferHandle(pState, key);
-	item->pKey = key;
+	if( JILList_InvalidKey(key) )
+	{
+		NTLReferHandle(pState, key);
+		item->pKey = key;
+	}
+	else
+	{
+		item->pKey = NTLCopyHandle(pState, key);
+	}
 	NTLReferHandle(pState, value);
 	item->pValue = value;
 	item->pNext = NULL;
 	item->pPrev = NULL;
 	item->pList = NULL;
 	item->numRef = 1;
+	item->hash = 0;
+	item->pHashNext = NULL;
+	item->pParent = NULL;
+	item->pLeft = NULL;
+	item->pRight = NULL;
+	item->weight = 1;
 	return item;
 }
 
+//------------------------------------------------------------------------------
+// struct ListSortInfo
+//------------------------------------------------------------------------------
+// Passed to ListIsPredessor() by JILList_Sort(). If there is a delegate, all
+// calls to it share the same stack frame.
+
+typedef struct
+{
+	JILState*		pState;
+	JILHandle*		pDelegate;
+	JILLong			mode;
+	JILStackFrame	frame;
+
+} ListSortInfo;
+
 //------------------------------------------------------------------------------
 // ListCompareHandle
 //------------------------------------------------------------------------------
 
-static JILLong ListCompareHandle(JILHandle* h1, JILHandle* h2, JILState* ps, JILHandle* pDelegate, JILError* pErr)
+static JILError ListCompareHandle(JILHandle* h1, JILHandle* h2, ListSortInfo* pInfo, JILLong* pResult)
 {
-	*pErr = JIL_No_Exception;
+	*pResult = 0;
 	if( h1->type > h2->type )
-		return 1;
+		*pResult = 1;
 	else if( h1->type < h2->type )
-		return -1;
-	switch( h1->type )
+		*pResult = -1;
+	else switch( h1->type )
 	{
 		case type_int:
 			if( JILGetIntHandle(h1)->l > JILGetIntHandle(h2)->l )
-				return 1;
+				*pResult = 1;
 			else if( JILGetIntHandle(h1)->l < JILGetIntHandle(h2)->l )
-				return -1;
-			else
-				return 0;
+				*pResult = -1;
+			break;
 		case type_float:
 			if( JILGetFloatHandle(h1)->f > JILGetFloatHandle(h2)->f )
-				return 1;
+				*pResult = 1;
 			else if( JILGetFloatHandle(h1)->f < JILGetFloatHandle(h2)->f )
-				return -1;
-			else
-				return 0;
+				*pResult = -1;
+			break;
 		case type_string:
-			return JILString_Compare(JILGetStringHandle(h1)->str, JILGetStringHandle(h2)->str);
+			*pResult = JILString_Compare(JILGetStringHandle(h1)->str, JILGetStringHandle(h2)->str);
+			break;
 		default:
-			if( pDelegate )
-			{
-				JILHandle* pResult = JILCallFunction(ps, pDelegate, 2, kArgHandle, h1, kArgHandle, h2);
-				JILLong res = NTLHandleToInt(ps, pResult);
-				*pErr = NTLHandleToError(ps, pResult);
-				NTLFreeHandle(ps, pResult);
-				return res;
-			}
+			if( pInfo->pDelegate )
+				return JILCallComparator(pInfo->pState, &pInfo->frame, pInfo->pDelegate, h1, h2, pResult);
 			break;
 	}
-	return 0;
+	return JIL_No_Exception;
 }
 
 //------------------------------------------------------------------------------
 // ListIsPredessor
 //------------------------------------------------------------------------------
+// Compare callback for JILSort(), compares two list items according to the
+// sort mode.
 
-static JILLong ListIsPredessor(JILListItem* item1, JILListItem* item2, JILLong mode, JILState* ps, JILHandle* pDelegate, JILError* pErr)
+static JILError ListIsPredessor(JILUnknown* pUser, JILUnknown* pItem1, JILUnknown* pItem2, JILLong* pResult)
 {
-	JILLong result;
+	JILError err;
 	JILHandle* first1;
 	JILHandle* first2;
 	JILHandle* second1;
 	JILHandle* second2;
-	if( mode & 1 )
+	ListSortInfo* pInfo = (ListSortInfo*) pUser;
+	JILListItem* item1 = (JILListItem*) pItem1;
+	JILListItem* item2 = (JILListItem*) pItem2;
+	if( pInfo->mode & 1 )
 	{
 		JILListItem* i = item1;
 		item1 = item2;
 		item2 = i;
 	}
-	if( mode & 2 )
+	if( pInfo->mode & 2 )
 	{
 		first1 = item1->pValue;
 		first2 = item2->pValue;
@@ -450,46 +486,359 @@ static JILLong ListIsPredessor(JILListItem* item1, JILListItem* item2, JILLong m
 		second1 = item1->pValue;
 		second2 = item2->pValue;
 	}
-	result = ListCompareHandle(first1, first2, ps, pDelegate, pErr);
-	if( *pErr )
-		return 0;
-	if( result == 0 )
-		result = ListCompareHandle(second1, second2, ps, pDelegate, pErr);
-	if( *pErr )
-		return 0;
-	return result;
+	err = ListCompareHandle(first1, first2, pInfo, pResult);
+	if( err == JIL_No_Exception && *pResult == 0 )
+		err = ListCompareHandle(second1, second2, pInfo, pResult);
+	return err;
+}
+
+//------------------------------------------------------------------------------
+// KeyEquals
+//------------------------------------------------------------------------------
+
+static JILBool KeyEquals(JILHandle* pKey1, JILHandle* pKey2)
+{
+	if( pKey1->type != pKey2->type )
+		return JILFalse;
+	switch( pKey1->type )
+	{
+		case type_int:
+			return JILGetIntHandle(pKey1)->l == JILGetIntHandle(pKey2)->l;
+		case type_float:
+			return JILGetFloatHandle(pKey1)->f == JILGetFloatHandle(pKey2)->f;
+		case type_string:
+			return JILString_Equal(JILGetStringHandle(pKey1)->str, JILGetStringHandle(pKey2)->str);
+	}
+	return JILFalse;
+}
+
+//------------------------------------------------------------------------------
+// KeyHash
+//------------------------------------------------------------------------------
+// Computes the hash value of a key. Keys that are equal according to
+// KeyEquals() must produce the same hash value.
+
+static JILUInt32 KeyHash(JILHandle* pKey)
+{
+	JILUInt32 h = 2166136261u;
+	const JILByte* p;
+	JILFloat f;
+	JILLong i;
+	switch( pKey->type )
+	{
+		case type_int:
+			h = (JILUInt32) JILGetIntHandle(pKey)->l;
+			break;
+		case type_float:
+			f = JILGetFloatHandle(pKey)->f;
+			if( f == 0 )
+				f = 0;	// -0.0 equals 0.0
+			p = (const JILByte*) &f;
+			for( i = 0; i < (JILLong) sizeof(JILFloat); i++ )
+				h = (h ^ p[i]) * 16777619u;
+			break;
+		case type_string:
+			p = (const JILByte*) JILString_String(JILGetStringHandle(pKey)->str);
+			while( *p )
+				h = (h ^ *p++) * 16777619u;
+			break;
+	}
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+//------------------------------------------------------------------------------
+// HashInsert
+//------------------------------------------------------------------------------
+// Adds an item to the key index. The item must already be in the list.
+
+static void HashInsert(JILList* _this, JILListItem* pItem)
+{
+	JILListItem** ppBucket;
+	if( _this->length > _this->numBuckets )
+	{
+		// double the number of buckets and redistribute the items
+		JILState* ps = _this->pState;
+		JILLong numBuckets = _this->numBuckets * 2;
+		JILListItem** ppBuckets = (JILListItem**) ps->vmMalloc(ps, numBuckets * sizeof(JILListItem*));
+		JILListItem* p;
+		memset(ppBuckets, 0, numBuckets * sizeof(JILListItem*));
+		for( p = _this->pFirst; p != NULL; p = p->pNext )
+		{
+			if( p != pItem )
+			{
+				ppBucket = ppBuckets + (p->hash & (numBuckets - 1));
+				p->pHashNext = *ppBucket;
+				*ppBucket = p;
+			}
+		}
+		ps->vmFree(ps, _this->ppBuckets);
+		_this->ppBuckets = ppBuckets;
+		_this->numBuckets = numBuckets;
+	}
+	pItem->hash = KeyHash(pItem->pKey);
+	ppBucket = _this->ppBuckets + (pItem->hash & (_this->numBuckets - 1));
+	pItem->pHashNext = *ppBucket;
+	*ppBucket = pItem;
+}
+
+//------------------------------------------------------------------------------
+// HashRemove
+//------------------------------------------------------------------------------
+// Removes an item from the key index.
+
+static void HashRemove(JILList* _this, JILListItem* pItem)
+{
+	JILListItem** pp = _this->ppBuckets + (pItem->hash & (_this->numBuckets - 1));
+	while( *pp != pItem )
+		pp = &((*pp)->pHashNext);
+	*pp = pItem->pHashNext;
+	pItem->pHashNext = NULL;
+}
+
+//------------------------------------------------------------------------------
+// HashBuild
+//------------------------------------------------------------------------------
+// Builds the key index from all items in the list.
+
+static void HashBuild(JILList* _this)
+{
+	JILState* ps = _this->pState;
+	JILListItem* pItem;
+	JILListItem** ppBucket;
+	JILLong numBuckets = kListMinBuckets;
+	while( numBuckets < _this->length )
+		numBuckets *= 2;
+	_this->ppBuckets = (JILListItem**) ps->vmMalloc(ps, numBuckets * sizeof(JILListItem*));
+	_this->numBuckets = numBuckets;
+	memset(_this->ppBuckets, 0, numBuckets * sizeof(JILListItem*));
+	for( pItem = _this->pFirst; pItem != NULL; pItem = pItem->pNext )
+	{
+		pItem->hash = KeyHash(pItem->pKey);
+		ppBucket = _this->ppBuckets + (pItem->hash & (numBuckets - 1));
+		pItem->pHashNext = *ppBucket;
+		*ppBucket = pItem;
+	}
+}
+
+//------------------------------------------------------------------------------
+// HashDestroy
+//------------------------------------------------------------------------------
+// Frees the key index. It will be rebuilt when the list is searched again.
+
+static void HashDestroy(JILList* _this)
+{
+	if( _this->ppBuckets )
+	{
+		_this->pState->vmFree(_this->pState, _this->ppBuckets);
+		_this->ppBuckets = NULL;
+		_this->numBuckets = 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+// TreePriority
+//------------------------------------------------------------------------------
+// The position index is a treap: A binary tree whose in-order sequence is the
+// order of items in the list, and whose nodes are heap-ordered by a pseudo
+// random priority, which keeps it balanced on average. The priority is derived
+// from the item's address.
+
+static JILUInt32 TreePriority(const JILListItem* pItem)
+{
+	JILUInt32 h = (JILUInt32) ((size_t) pItem / sizeof(JILListItem*));
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+//------------------------------------------------------------------------------
+// TreeWeight
+//------------------------------------------------------------------------------
+
+static JILLong TreeWeight(const JILListItem* pItem)
+{
+	return pItem ? pItem->weight : 0;
+}
+
+//------------------------------------------------------------------------------
+// TreeRotateUp
+//------------------------------------------------------------------------------
+// Rotates an item above its parent node.
+
+static void TreeRotateUp(JILList* _this, JILListItem* pItem)
+{
+	JILListItem* pParent = pItem->pParent;
+	JILListItem* pGrand = pParent->pParent;
+	if( pParent->pLeft == pItem )
+	{
+		pParent->pLeft = pItem->pRight;
+		if( pItem->pRight )
+			pItem->pRight->pParent = pParent;
+		pItem->pRight = pParent;
+	}
+	else
+	{
+		pParent->pRight = pItem->pLeft;
+		if( pItem->pLeft )
+			pItem->pLeft->pParent = pParent;
+		pItem->pLeft = pParent;
+	}
+	pParent->pParent = pItem;
+	pItem->pParent = pGrand;
+	if( !pGrand )
+		_this->pRoot = pItem;
+	else if( pGrand->pLeft == pParent )
+		pGrand->pLeft = pItem;
+	else
+		pGrand->pRight = pItem;
+	pParent->weight = 1 + TreeWeight(pParent->pLeft) + TreeWeight(pParent->pRight);
+	pItem->weight = 1 + TreeWeight(pItem->pLeft) + TreeWeight(pItem->pRight);
+}
+
+//------------------------------------------------------------------------------
+// TreeInsert
+//------------------------------------------------------------------------------
+// Adds an item to the position index. The item must already be linked into
+// the list, and must not be followed by any item but pNext.
+
+static void TreeInsert(JILList* _this, JILListItem* pItem, JILListItem* pNext)
+{
+	JILListItem* pParent;
+	pItem->pLeft = NULL;
+	pItem->pRight = NULL;
+	pItem->weight = 1;
+	if( pNext && !pNext->pLeft )
+	{
+		pParent = pNext;
+		pParent->pLeft = pItem;
+	}
+	else if( pItem->pPrev )
+	{
+		// the previous item has no right sub-tree, since it directly precedes pNext
+		pParent = pItem->pPrev;
+		pParent->pRight = pItem;
+	}
+	else
+	{
+		pItem->pParent = NULL;
+		_this->pRoot = pItem;
+		return;
+	}
+	pItem->pParent = pParent;
+	for( ; pParent != NULL; pParent = pParent->pParent )
+		pParent->weight++;
+	while( pItem->pParent && TreePriority(pItem) > TreePriority(pItem->pParent) )
+		TreeRotateUp(_this, pItem);
+}
+
+//------------------------------------------------------------------------------
+// TreeRemove
+//------------------------------------------------------------------------------
+// Removes an item from the position index.
+
+static void TreeRemove(JILList* _this, JILListItem* pItem)
+{
+	JILListItem* pParent;
+	// rotate the item down until it is a leaf
+	while( pItem->pLeft || pItem->pRight )
+	{
+		if( !pItem->pRight || (pItem->pLeft && TreePriority(pItem->pLeft) > TreePriority(pItem->pRight)) )
+			TreeRotateUp(_this, pItem->pLeft);
+		else
+			TreeRotateUp(_this, pItem->pRight);
+	}
+	pParent = pItem->pParent;
+	if( !pParent )
+		_this->pRoot = NULL;
+	else if( pParent->pLeft == pItem )
+		pParent->pLeft = NULL;
+	else
+		pParent->pRight = NULL;
+	for( ; pParent != NULL; pParent = pParent->pParent )
+		pParent->weight--;
+	pItem->pParent = NULL;
+}
+
+//------------------------------------------------------------------------------
+// TreeBuild
+//------------------------------------------------------------------------------
+// Builds the position index from all items in the list.
+
+static void TreeBuild(JILList* _this)
+{
+	JILListItem* pItem;
+	_this->pRoot = NULL;
+	for( pItem = _this->pFirst; pItem != NULL; pItem = pItem->pNext )
+		TreeInsert(_this, pItem, NULL);
+}
+
+//------------------------------------------------------------------------------
+// TreeIndex
+//------------------------------------------------------------------------------
+// Returns the zero based position of an item in the list.
+
+static JILLong TreeIndex(const JILListItem* pItem)
+{
+	JILLong index = TreeWeight(pItem->pLeft);
+	for( ; pItem->pParent != NULL; pItem = pItem->pParent )
+	{
+		if( pItem->pParent->pRight == pItem )
+			index += TreeWeight(pItem->pParent->pLeft) + 1;
+	}
+	return index;
 }
 
 //------------------------------------------------------------------------------
 // ItemFromKey
 //------------------------------------------------------------------------------
+// Returns the first item in the list that has the given key.
 
 static JILListItem* ItemFromKey(JILList* _this, JILHandle* pKey)
 {
 	JILListItem* item = NULL;
-	switch( pKey->type )
+	JILListItem* p;
+	JILUInt32 hash;
+	if( JILList_InvalidKey(pKey) )
+		return NULL;
+	if( !_this->ppBuckets )
 	{
-		case type_int:
-			for(item = _this->pFirst; item != NULL; item = item->pNext)
+		if( _this->length < kListIndexThreshold )
+		{
+			for( item = _this->pFirst; item != NULL; item = item->pNext )
 			{
-				if( item->pKey->type == type_int && JILGetIntHandle(item->pKey)->l == JILGetIntHandle(pKey)->l  )
+				if( KeyEquals(item->pKey, pKey) )
 					break;
 			}
-			break;
-		case type_float:
-			for(item = _this->pFirst; item != NULL; item = item->pNext)
+			return item;
+		}
+		HashBuild(_this);
+	}
+	hash = KeyHash(pKey);
+	for( p = _this->ppBuckets[hash & (_this->numBuckets - 1)]; p != NULL; p = p->pHashNext )
+	{
+		if( p->hash == hash && KeyEquals(p->pKey, pKey) )
+		{
+			if( !item )
 			{
-				if( item->pKey->type == type_float && JILGetFloatHandle(item->pKey)->f == JILGetFloatHandle(pKey)->f  )
-					break;
+				item = p;
 			}
-			break;
-		case type_string:
-			for(item = _this->pFirst; item != NULL; item = item->pNext)
+			else
 			{
-				if( item->pKey->type == type_string && JILString_Equal(JILGetStringHandle(item->pKey)->str, JILGetStringHandle(pKey)->str)  )
-					break;
+				// the key is not unique, find the first one in the list
+				if( !_this->pRoot )
+					TreeBuild(_this);
+				if( TreeIndex(p) < TreeIndex(item) )
+					item = p;
 			}
-			break;
+		}
 	}
 	return item;
 }
@@ -501,15 +850,36 @@ static JILListItem* ItemFromKey(JILList* _this, JILHandle* pKey)
 static JILListItem* ItemFromIndex(JILList* _this, JILLong index)
 {
 	JILListItem* item;
-	if( index < 0 )
+	if( index < 0 || index >= _this->length )
 		return NULL;
-	for(item = _this->pFirst; item != NULL; item = item->pNext)
+	if( !_this->pRoot )
 	{
-		if( !index )
-			break;
-		index--;
+		if( _this->length < kListIndexThreshold )
+		{
+			for( item = _this->pFirst; index; index-- )
+				item = item->pNext;
+			return item;
+		}
+		TreeBuild(_this);
+	}
+	item = _this->pRoot;
+	for(;;)
+	{
+		JILLong left = TreeWeight(item->pLeft);
+		if( index < left )
+		{
+			item = item->pLeft;
+		}
+		else if( index > left )
+		{
+			index -= left + 1;
+			item = item->pRight;
+		}
+		else
+		{
+			return item;
+		}
 	}
-	return item;
 }
 
 //------------------------------------------------------------------------------
@@ -532,6 +902,10 @@ static void ItemInsert(JILListItem* pItem, JILListItem* pNew)
 		else
 			list->pFirst = pNew;
 		list->length++;
+		if( list->ppBuckets )
+			HashInsert(list, pNew);
+		if( list->pRoot )
+			TreeInsert(list, pNew, pNext);
 	}
 }
 
@@ -546,6 +920,10 @@ static void ItemRemove(JILListItem* pItem)
 	{
 		JILListItem* pPrev = pItem->pPrev;
 		JILListItem* pNext = pItem->pNext;
+		if( list->ppBuckets )
+			HashRemove(list, pItem);
+		if( list->pRoot )
+			TreeRemove(list, pItem);
 		if( pPrev )
 			pPrev->pNext = pNext;
 		if( pNext )
@@ -579,6 +957,10 @@ static void ItemAdd(JILList* _this, JILListItem* pItem)
 	}
 	pItem->pList = _this;
 	_this->length++;
+	if( _this->ppBuckets )
+		HashInsert(_this, pItem);
+	if( _this->pRoot )
+		TreeInsert(_this, pItem, NULL);
 }
 
 //------------------------------------------------------------------------------
@@ -614,14 +996,11 @@ void JILList_Copy (JILList* _this, const JILList* pSource)
 {
 	JILState* pState = pSource->pState;
 	JILListItem* pItem;
-	JILHandle* newKey;
 	JILHandle* newValue;
 	for( pItem = pSource->pFirst; pItem != NULL; pItem = pItem->pNext )
 	{
-		newKey = NTLCopyValueType(pState, pItem->pKey);
 		newValue = NTLCopyValueType(pState, pItem->pValue);
-		JILList_Add(_this, newKey, newValue);
-		NTLFreeHandle(pState, newKey);
+		JILList_Add(_this, pItem->pKey, newValue);
 		NTLFreeHandle(pState, newValue);
 	}
 }
@@ -635,15 +1014,12 @@ JILList* JILList_DeepCopy (const JILList* _this)
 {
 	JILState* pState = _this->pState;
 	JILListItem* pItem;
-	JILHandle* newKey;
 	JILHandle* newValue;
 	JILList* pNew = JILList_New(pState);
 	for( pItem = _this->pFirst; pItem != NULL; pItem = pItem->pNext )
 	{
-		newKey = NTLCopyHandle(pState, pItem->pKey);
 		newValue = NTLCopyHandle(pState, pItem->pValue);
-		JILList_Add(pNew, newKey, newValue);
-		NTLFreeHandle(pState, newKey);
+		JILList_Add(pNew, pItem->pKey, newValue);
 		NTLFreeHandle(pState, newValue);
 	}
 	return pNew;
@@ -759,10 +1135,23 @@ void JILList_Swap (JILList* _this, JILHandle* pKey1, JILHandle* pKey2)
 	{
 		JILHandle* key = pItemA->pKey;
 		JILHandle* val = pItemA->pValue;
+		JILUInt32 hash = pItemA->hash;
+		if( _this->ppBuckets )
+		{
+			HashRemove(_this, pItemA);
+			HashRemove(_this, pItemB);
+		}
 		pItemA->pKey = pItemB->pKey;
 		pItemA->pValue = pItemB->pValue;
+		pItemA->hash = pItemB->hash;
 		pItemB->pKey = key;
 		pItemB->pValue = val;
+		pItemB->hash = hash;
+		if( _this->ppBuckets )
+		{
+			HashInsert(_this, pItemA);
+			HashInsert(_this, pItemB);
+		}
 	}
 }
 
@@ -825,11 +1214,14 @@ void JILList_Clear (JILList* _this)
 		pNext = pItem->pNext;
 		pItem->pList = NULL;
 		pItem->pNext = pItem->pPrev = NULL;
+		pItem->pHashNext = pItem->pParent = pItem->pLeft = pItem->pRight = NULL;
 		JILList_Release(_this->pState, pItem);
 	}
 	_this->length = 0;
 	_this->pFirst = NULL;
 	_this->pLast = NULL;
+	_this->pRoot = NULL;
+	HashDestroy(_this);
 }
 
 //------------------------------------------------------------------------------
@@ -842,40 +1234,59 @@ void JILList_Clear (JILList* _this)
 /// 2 = sort by value first, ascending<br>
 /// 3 = sort by value first, descending<br>
 /// </p>
+/// The items are sorted with a stable merge sort and then relinked, so
+/// iterators stay on their items. If the delegate fails, the list is left
+/// unchanged. Fails with JIL_ERR_Runtime_Blocked if there is a delegate and
+/// script code can't be called.
 
 JILError JILList_Sort (JILList* _this, JILLong mode, JILHandle* pDelegate)
 {
-	JILError result = JIL_No_Exception;
-	if( _this->pFirst )
+	JILError result;
+	JILLong i;
+	JILListItem* pItem;
+	JILListItem** ppItems;
+	ListSortInfo info;
+	JILState* ps = _this->pState;
+
+	if( _this->length < 2 )
+		return JIL_No_Exception;
+	// a null delegate compares all items equal
+	if( pDelegate && pDelegate->type == type_null )
+		pDelegate = NULL;
+	if( pDelegate )
 	{
-		JILListItem* pIter = _this->pFirst;
-		pIter = pIter->pNext;
-		while( pIter )
+		if( !ps->vmInitialized || ps->vmBlocked )
+			return JIL_ERR_Runtime_Blocked;
+		// room for the stack frame and the comparator's arguments
+		result = JILGrowStack(ps, ps->vmpContext, 4, 0, JILTrue);
+		if( result )
+			return result;
+	}
+	info.pState = ps;
+	info.pDelegate = pDelegate;
+	info.mode = mode;
+	ppItems = (JILListItem**) ps->vmMalloc(ps, _this->length * sizeof(JILListItem*));
+	for( i = 0, pItem = _this->pFirst; pItem != NULL; pItem = pItem->pNext )
+		ppItems[i++] = pItem;
+	if( pDelegate )
+		JILPushStackFrame(ps, &info.frame);
+	result = JILSort((JILUnknown**) ppItems, _this->length, ListIsPredessor, &info);
+	if( pDelegate )
+		JILPopStackFrame(ps, &info.frame);
+	if( result == JIL_No_Exception )
+	{
+		// relink items in sorted order, keys stay with their items
+		for( i = 0; i < _this->length; i++ )
 		{
-			JILListItem* pIter2 = pIter;
-			while( pIter2->pPrev )
-			{
-				JILListItem* pPrev = pIter2->pPrev;
-				JILLong eq = ListIsPredessor(pIter2, pPrev, mode, _this->pState, pDelegate, &result);
-				if( result )
-					return result;
-				if( eq < 0 )
-				{
-					// swap item data
-					JILHandle* key = pIter2->pKey;
-					JILHandle* val = pIter2->pValue;
-					pIter2->pKey = pPrev->pKey;
-					pIter2->pValue = pPrev->pValue;
-					pPrev->pKey = key;
-					pPrev->pValue = val;
-				}
-				else
-					break;
-				pIter2 = pPrev;
-			}
-			pIter = pIter->pNext;
+			ppItems[i]->pPrev = i ? ppItems[i - 1] : NULL;
+			ppItems[i]->pNext = (i + 1 < _this->length) ? ppItems[i + 1] : NULL;
 		}
+		_this->pFirst = ppItems[0];
+		_this->pLast = ppItems[_this->length - 1];
+		// positions have changed, the position index is rebuilt when needed
+		_this->pRoot = NULL;
 	}
+	ps->vmFree(ps, ppItems);
 	return result;
 }
 
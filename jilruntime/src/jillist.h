@@ -35,6 +35,12 @@ struct JILListItem
 	JILHandle*		pKey;		//!< Pointer to 'key' associated with list item
 	JILHandle*		pValue;		//!< Pointer to actual data of the list item
 	JILLong			numRef;		//!< Number of iterator references to this item
+	JILUInt32		hash;		//!< Hash value of the key, only valid while the list has a key index
+	JILListItem*	pHashNext;	//!< Next item in the same bucket of the key index or NULL
+	JILListItem*	pParent;	//!< Parent node in the position index or NULL
+	JILListItem*	pLeft;		//!< Sub-tree of preceding items in the position index or NULL
+	JILListItem*	pRight;		//!< Sub-tree of following items in the position index or NULL
+	JILLong			weight;		//!< Number of items in the sub-tree of the position index rooted at this item
 };
 
 //------------------------------------------------------------------------------
@@ -47,6 +53,9 @@ struct JILList
 	JILListItem*	pFirst;		//!< Pointer to the first item in the list, or NULL
 	JILListItem*	pLast;		//!< Pointer to the last item in the list, or NULL
 	JILState*		pState;		//!< The virtual machine object this list 'belongs' to
+	JILListItem**	ppBuckets;	//!< Hash index of the keys, or NULL if not yet built
+	JILLong			numBuckets;	//!< Number of buckets in the key index, a power of two
+	JILListItem*	pRoot;		//!< Root of the position index, a tree in list order, or NULL if not yet built
 };
 
 //------------------------------------------------------------------------------
@@ -59,6 +68,7 @@ struct JILIterator
 	JILHandle*		pList;		//!< Handle to the list this iterator references
 	JILState*		pState;		//!< The virtual machine object this list 'belongs' to
 	JILLong			deleted;	//!< Current item is marked deleted
+	JILTableCursor*	pCursor;	//!< Position in the table if pList references a table, otherwise NULL
 };
 
 //------------------------------------------------------------------------------
@@ -106,5 +116,6 @@ JILEXTERN JILError JILListProc(NTLInstance* pInst, JILLong msg, JILLong param, J
 //------------------------------------------------------------------------------
 
 JILEXTERN JILError JILIteratorProc(NTLInstance* pInst, JILLong msg, JILLong param, JILUnknown* pDataIn, JILUnknown** ppDataOut);
+JILEXTERN JILHandle* JILIterator_NewForTable(JILState* pState, JILHandle* hTable);
 
 #endif	// #ifndef JILLIST_H
@@ -18,9 +18,12 @@
 #include "jilmachine.h"
 #include "jilhandle.h"
 #include "jiltypelist.h"
+#include "jilcodelist.h"
 #include "jilallocators.h"
 #include "jilcallntl.h"
 #include "jilprogramming.h"
+#include "jilopcodes.h"
+#include "jiljit.h"
 
 //------------------------------------------------------------------------------
 // static functions
@@ -28,9 +31,48 @@
 
 static JILLong JILExecuteByteCode	(JILState*, JILContext*, JILLong, JILHandle*);
 static JILLong JILInitNativeType	(JILState*, JILTypeInfo*, JILLong);
+static JILError JILGetDirectCalls	(JILState* pState, JILTypeProc proc, JILLong type);
 static JILError JILCallFunc			(JILState* pState, JILLong hFunction);
 static JILError JILCallMethod		(JILState* pState, JILHandle* object, JILLong nIndex);
 static JILError JILCallClosure		(JILState* pState, JILDelegate* pDelegate);
+static JILLong JILQuickOpcode		(JILLong opcode, JILLong type);
+static JILLong JILGenericOpcode		(JILLong opcode);
+#if JIL_USE_THREADED_DISPATCH
+static JILError JILCheckOpcodes		(JILState* pState);
+#endif
+
+//------------------------------------------------------------------------------
+// quickening
+//------------------------------------------------------------------------------
+// Maps blocks of generic instructions to their int variants. The float
+// variants are laid out exactly like the int variants, kQuickFloatOffset
+// instructions further down in the opcode list.
+
+static const JILLong kQuickMap[][3] =
+{
+	// generic		int				count
+	{ op_add_rr,	op_addl_rr,		7 },
+	{ op_sub_rr,	op_subl_rr,		7 },
+	{ op_mul_rr,	op_mull_rr,		7 },
+	{ op_div_rr,	op_divl_rr,		7 },
+	{ op_mod_rr,	op_modl_rr,		7 },
+	{ op_dec_r,		op_decl_r,		8 },
+	{ op_neg_r,		op_negl_r,		4 },
+	{ op_cseq_rr,	op_cseql_rr,	42 }
+};
+static const JILLong kQuickMapSize = sizeof(kQuickMap) / sizeof(kQuickMap[0]);
+static const JILLong kQuickFloatOffset = op_addf_rr - op_addl_rr;
+static const JILLong kQuickThreshold = 8;
+
+//------------------------------------------------------------------------------
+// context stacks
+//------------------------------------------------------------------------------
+// Initial sizes of the stacks of a new context. Stacks grow on demand up to
+// JILState::vmDataStackSize and JILState::vmCallStackSize, so cofunctions that
+// only use a few local variables stay small.
+
+static const JILLong kContextDataStack = 128;
+static const JILLong kContextCallStack = 32;
 
 //------------------------------------------------------------------------------
 // External references
@@ -49,6 +91,7 @@ void JILCheckInstructionTables(JILState* ps);
 JILError JILInitVM(JILState* pState)
 {
 	JILLong i;
+	JILLong n;
 	JILLong err;
 	JILHandle* pDest;
 	JILHandle* pNull;
@@ -59,8 +102,11 @@ JILError JILInitVM(JILState* pState)
 	if( !pState->vmInitialized )
 	{
 		// re-order free handles stack, so handle order remains consistent with the code!
-		for( i = 0; i < pState->vmMaxHandles; i++ )
-			pState->vmppFreeHandles[i] = pState->vmppHandles[i];
+		for( i = n = 0; i < pState->vmMaxHandles; i++ )
+		{
+			if( pState->vmppHandles[i] )
+				pState->vmppFreeHandles[n++] = pState->vmppHandles[i];
+		}
 
 		// allocate null handle, we need it for initializing the registers!
 		pNull = JILGetNewHandle(pState);
@@ -73,6 +119,7 @@ JILError JILInitVM(JILState* pState)
 	}
 
 	// incrementally create handles from data segment
+	JILReserveHandles(pState, pDataSegment->usedSize - pState->vmInitDataIncr);
 	for( i = pState->vmInitDataIncr; i < pDataSegment->usedSize; i++ )
 	{
 		pSource = pDataSegment->pData + i;
@@ -109,13 +156,71 @@ JILError JILInitVM(JILState* pState)
 		pTypeInfo->typeNamePtr = JILCStrGetString(pState, pTypeInfo->offsetName);
 	}
 
+	// make sure all code can be quickened
+	err = JILInitQuickInfo(pState);
+	if( err )
+		return err;
+
+	// make sure all code can be compiled
+	err = JILInitJit(pState);
+	if( err )
+		return err;
+
+#if JIL_USE_THREADED_DISPATCH
+	// threaded dispatch doesn't check opcodes, so check new or changed code here
+	if( pState->vmpCodeSegment->usedSize != pState->vmCheckedCodeSize )
+	{
+		err = JILCheckOpcodes(pState);
+		if( err )
+			return err;
+	}
+#endif
+
 	// we are initialized
+	pState->vmCheckedCodeSize = pState->vmpCodeSegment->usedSize;
 	pState->vmInitDataIncr = pDataSegment->usedSize;
 	pState->vmInitTypeIncr = pState->vmUsedTypeInfoSegSize;
 	pState->vmInitialized = JILTrue;
 	return JIL_No_Exception;
 }
 
+#if JIL_USE_THREADED_DISPATCH
+
+//------------------------------------------------------------------------------
+// JILCheckOpcodes
+//------------------------------------------------------------------------------
+// Makes sure that every instruction of every function has a valid opcode and
+// ends within its function. Threaded dispatch uses opcodes as indexes into the
+// jump table without checking them, see JIL_NEXT.
+
+static JILError JILCheckOpcodes(JILState* pState)
+{
+	JILLong i, addr, end, size;
+	JILFuncInfo* pFunc;
+	JILLong* pCode = pState->vmpCodeSegment->pData;
+
+	for( i = 0; i < pState->vmpFuncSegment->usedSize; i++ )
+	{
+		pFunc = pState->vmpFuncSegment->pData + i;
+		if( pFunc->codeSize <= 0 )
+			continue;
+		end = pFunc->codeAddr + pFunc->codeSize;
+		if( pFunc->codeAddr < 0 || end > pState->vmpCodeSegment->usedSize )
+			return JIL_VM_Invalid_Code_Address;
+		for( addr = pFunc->codeAddr; addr < end; addr += size )
+		{
+			if( pCode[addr] < 0 || pCode[addr] >= JILNumOpcodes )
+				return JIL_VM_Illegal_Instruction;
+			size = JILGetInstructionSize(pCode[addr]);
+			if( size <= 0 || addr + size > end )
+				return JIL_VM_Illegal_Instruction;
+		}
+	}
+	return JIL_No_Exception;
+}
+
+#endif
+
 //------------------------------------------------------------------------------
 // JILRunInitCode
 //------------------------------------------------------------------------------
@@ -253,6 +358,57 @@ JILError JILCallDelegate(JILState* pState, JILHandle* pDelegate)
 	return result;
 }
 
+//------------------------------------------------------------------------------
+// JILCallDelegateCached
+//------------------------------------------------------------------------------
+
+JILError JILCallDelegateCached(JILState* pState, JILHandle* pDelegate, JILLong address)
+{
+	JILTypeInfo* pTypeInfo;
+	JILFuncInfo* pFuncInfo;
+	JILCallSite* pSite;
+	JILDelegate* pdg;
+	JILLong* pVt;
+	JILLong type;
+
+	// closures need their stack pushed, null and bad references need error handling
+	if( pState->vmBlocked || pDelegate->type == type_null )
+		return JILCallDelegate(pState, pDelegate);
+	pTypeInfo = JILTypeInfoFromType(pState, pDelegate->type);
+	if( pTypeInfo->family != tf_delegate )
+		return JILCallDelegate(pState, pDelegate);
+	pdg = JILGetDelegateHandle(pDelegate)->pDelegate;
+	if( pdg->pClosure )
+		return JILCallDelegate(pState, pDelegate);
+	type = pdg->pObject ? pdg->pObject->type : type_null;
+	pSite = pState->vmpCallCache + (address & (kCallCacheSize - 1));
+	if( pSite->address != address || pSite->type != type || pSite->index != pdg->index )
+	{
+		// resolve the function
+		if( pdg->pObject )
+		{
+			pTypeInfo = JILTypeInfoFromType(pState, type);
+			if( pTypeInfo->family != tf_class || pTypeInfo->isNative )
+				return JILCallDelegate(pState, pDelegate);
+			pVt = JILCStrGetVTable(pState, pTypeInfo->offsetVtab);
+			pFuncInfo = JILGetFunctionInfo(pState, pVt[pdg->index]);
+		}
+		else
+		{
+			pFuncInfo = JILGetFunctionInfo(pState, pdg->index);
+			if( pFuncInfo && JILTypeInfoFromType(pState, pFuncInfo->type)->isNative )
+				return JILCallDelegate(pState, pDelegate);
+		}
+		if( pFuncInfo == NULL )
+			return JILCallDelegate(pState, pDelegate);
+		pSite->address = address;
+		pSite->type = type;
+		pSite->index = pdg->index;
+		pSite->codeAddr = pFuncInfo->codeAddr;
+	}
+	return JILExecuteByteCode(pState, pState->vmpContext, pSite->codeAddr, pdg->pObject);
+}
+
 //------------------------------------------------------------------------------
 // JILCallClosure
 //------------------------------------------------------------------------------
@@ -261,7 +417,6 @@ static JILError JILCallClosure(JILState* pState, JILDelegate* pDelegate)
 {
 	JILError result;
 	JILFuncInfo* pFuncInfo;
-	JILHandle** saveSP = pState->vmpContext->vmppDataStack + pState->vmpContext->vmDataStackPointer;
 	JILHandle** psp;
 	JILHandle** pcl;
 	JILLong oldSP = pState->vmpContext->vmDataStackPointer;
@@ -271,31 +426,31 @@ static JILError JILCallClosure(JILState* pState, JILDelegate* pDelegate)
 	pFuncInfo = JILGetFunctionInfo(pState, pDelegate->index);
 	if( pFuncInfo == NULL )
 		return JIL_ERR_Invalid_Function_Index;
-	// push parent stack onto stack
+	// make room for parent stack and function arguments
 	n = pDelegate->pClosure->stackSize;
+	result = JILGrowStack(pState, pState->vmpContext, n + pFuncInfo->args, 0, JILTrue);
+	if( result )
+		return result;
+	// push parent stack onto stack
 	pcl = pDelegate->pClosure->ppStack + n - 1;
 	for( i = 0; i < n; i++ )
 	{
 		JILAddRef(*pcl);
-		pState->vmpContext->vmppDataStack[--pState->vmpContext->vmDataStackPointer] = *pcl--;
-		if( pState->vmpContext->vmDataStackPointer < 0 )
-			return JIL_VM_Stack_Overflow;
+		JILDataStack(pState->vmpContext, --pState->vmpContext->vmDataStackPointer) = *pcl--;
 	}
 	// shuffle function arguments back to top of stack
 	n = pFuncInfo->args;
-	psp = saveSP + n - 1;
+	psp = JILDataStackAt(pState->vmpContext, oldSP + n - 1);
 	for( i = 0; i < n; i++ )
 	{
 		JILAddRef(*psp);
-		pState->vmpContext->vmppDataStack[--pState->vmpContext->vmDataStackPointer] = *psp--;
-		if( pState->vmpContext->vmDataStackPointer < 0 )
-			return JIL_VM_Stack_Overflow;
+		JILDataStack(pState->vmpContext, --pState->vmpContext->vmDataStackPointer) = *psp--;
 	}
 	// execute the bytecode
 	result = JILExecuteByteCode(pState, pState->vmpContext, pFuncInfo->codeAddr, pDelegate->pObject);
-	// move stack back to closure
+	// move stack back to closure, the stack may have moved during execution
 	n = pDelegate->pClosure->stackSize;
-	psp = saveSP - n;
+	psp = JILDataStackAt(pState->vmpContext, oldSP - n);
 	pcl = pDelegate->pClosure->ppStack;
 	for( i = 0; i < n; i++ )
 	{
@@ -305,7 +460,7 @@ static JILError JILCallClosure(JILState* pState, JILDelegate* pDelegate)
 	}
 	// pop everything from stack
 	n = oldSP - pState->vmpContext->vmDataStackPointer;
-	psp = pState->vmpContext->vmppDataStack + pState->vmpContext->vmDataStackPointer;
+	psp = JILDataStackAt(pState->vmpContext, pState->vmpContext->vmDataStackPointer);
 	for( i = 0; i < n; i++ )
 	{
 		JILRelease(pState, *psp++);
@@ -336,7 +491,8 @@ JILError JILCallCopyConstructor(JILState* pState, JILHandle* object, JILHandle*
 	// save current context
 	JILPushStackFrame(pState, &stackFrame);
 	// push source onto stack
-	pState->vmpContext->vmppDataStack[--pState->vmpContext->vmDataStackPointer] = src;
+	JILGrowStack(pState, pState->vmpContext, 1, 0, JILFalse);
+	JILDataStack(pState->vmpContext, --pState->vmpContext->vmDataStackPointer) = src;
 	JILAddRef(src);
 	// call copy constructor
 	result = JILCallMethod(pState, object, pTypeInfo1->methodInfo.cctor);
@@ -466,14 +622,16 @@ JILStackFrame* JILPushStackFrame(JILState* pState, JILStackFrame* pStackFrame)
 	pStackFrame->pc = c->vmProgramCounter;
 	// save call stack pointer
 	pStackFrame->cstp = c->vmCallStackPointer;
+	// make room for r0 and r1
+	JILGrowStack(pState, c, 2, 0, JILFalse);
 	// push r0 onto the stack
 	h = c->vmppRegister[0];
 	JILAddRef(h);
-	c->vmppDataStack[--c->vmDataStackPointer] = h;
+	JILDataStack(c, --c->vmDataStackPointer) = h;
 	// push r1 onto the stack
 	h = c->vmppRegister[1];
 	JILAddRef(h);
-	c->vmppDataStack[--c->vmDataStackPointer] = h;
+	JILDataStack(c, --c->vmDataStackPointer) = h;
 	// save data stack pointer
 	pStackFrame->dstp = c->vmDataStackPointer;
 	return pStackFrame;
@@ -491,15 +649,15 @@ JILStackFrame* JILPopStackFrame(JILState* pState, JILStackFrame* pStackFrame)
 	// unroll data stack
 	while( c->vmDataStackPointer < pStackFrame->dstp )
 	{
-		h = c->vmppDataStack[c->vmDataStackPointer++];
+		h = JILDataStack(c, c->vmDataStackPointer++);
 		JILRelease(pState, h);
 	}
 	// pop r1 from the stack
-	h = c->vmppDataStack[c->vmDataStackPointer++];
+	h = JILDataStack(c, c->vmDataStackPointer++);
 	JILRelease(pState, c->vmppRegister[1]);
 	c->vmppRegister[1] = h;
 	// pop r0 from the stack
-	h = c->vmppDataStack[c->vmDataStackPointer++];
+	h = JILDataStack(c, c->vmDataStackPointer++);
 	JILRelease(pState, c->vmppRegister[0]);
 	c->vmppRegister[0] = h;
 	// restore call stack pointer
@@ -511,6 +669,127 @@ JILStackFrame* JILPopStackFrame(JILState* pState, JILStackFrame* pStackFrame)
 	return pStackFrame;
 }
 
+//------------------------------------------------------------------------------
+// JILCallComparator
+//------------------------------------------------------------------------------
+
+JILError JILCallComparator(JILState* pState, JILStackFrame* pFrame, JILHandle* pDelegate, JILHandle* pArg1, JILHandle* pArg2, JILLong* pResult)
+{
+	JILError err;
+	JILHandle* h;
+	JILContext* c = pFrame->ctx;
+
+	*pResult = 0;
+	if( pState->vmBlocked )
+		return JIL_ERR_Runtime_Blocked;
+	// free any throw handle from a previous call
+	if( pState->vmpThrowHandle )
+	{
+		JILRelease(pState, pState->vmpThrowHandle);
+		pState->vmpThrowHandle = NULL;
+	}
+	// push arguments onto the stack
+	JILGrowStack(pState, c, 2, 0, JILFalse);
+	JILAddRef(pArg2);
+	JILDataStack(c, --c->vmDataStackPointer) = pArg2;
+	JILAddRef(pArg1);
+	JILDataStack(c, --c->vmDataStackPointer) = pArg1;
+	// call comparator
+	err = JILCallDelegate(pState, pDelegate);
+	if( err == JIL_No_Exception )
+	{
+		h = c->vmppRegister[kReturnRegister];
+		if( h->type == type_int )
+			*pResult = JILGetIntHandle(h)->l;
+		else
+			err = JILExceptionCallGetError(pState, h);
+	}
+	else if( err == JIL_VM_Software_Exception && pState->vmpThrowHandle )
+	{
+		h = pState->vmpThrowHandle;
+		JILAddRef(h);
+		err = JILExceptionCallGetError(pState, h);
+		JILRelease(pState, h);
+	}
+	// pop arguments, leaving the stack frame as it was
+	pState->vmpContext = c;
+	while( c->vmDataStackPointer < pFrame->dstp )
+	{
+		h = JILDataStack(c, c->vmDataStackPointer++);
+		JILRelease(pState, h);
+	}
+	return err;
+}
+
+//------------------------------------------------------------------------------
+// JILNewStackLimit
+//------------------------------------------------------------------------------
+// Computes the new lowest index of a stack that must hold the index 'need'.
+// The stack doubles in size until it reaches 'max'. It only exceeds 'max' if
+// the caller does not check for overflow, see JILGrowStack().
+
+static JILLong JILNewStackLimit(JILLong limit, JILLong max, JILLong need)
+{
+	JILLong size = max - limit;
+	while( max - size > need )
+		size *= 2;
+	if( size > max )
+		size = (need < 0) ? max - need : max;
+	return max - size;
+}
+
+//------------------------------------------------------------------------------
+// JILMoveStack
+//------------------------------------------------------------------------------
+// Allocates a new stack buffer and moves the used part of the old one into it.
+// The used part lies between 'sp' and 'max' and keeps its indices. Element 0
+// of a buffer holds the stack index 'limit'.
+
+static JILByte* JILMoveStack(JILByte* pOld, JILLong elemSize, JILLong limit, JILLong newLimit, JILLong sp, JILLong max)
+{
+	JILByte* pNew = (JILByte*) malloc((max - newLimit) * elemSize);
+	memcpy(pNew + (sp - newLimit) * elemSize, pOld + (sp - limit) * elemSize, (max - sp) * elemSize);
+	free(pOld);
+	return pNew;
+}
+
+//------------------------------------------------------------------------------
+// JILGrowStack
+//------------------------------------------------------------------------------
+
+JILError JILGrowStack(JILState* pState, JILContext* pContext, JILLong numData, JILLong numCalls, JILBool checkOverflow)
+{
+	JILLong need;
+	JILLong limit;
+	JILByte* pMem;
+
+	// data stack
+	need = pContext->vmDataStackPointer - numData;
+	if( need < pContext->vmDataStackLimit )
+	{
+		if( checkOverflow && need < 0 )
+			return JIL_VM_Stack_Overflow;
+		limit = JILNewStackLimit(pContext->vmDataStackLimit, pState->vmDataStackSize, need);
+		pMem = JILMoveStack((JILByte*) pContext->vmppDataStack, sizeof(JILHandle*),
+			pContext->vmDataStackLimit, limit, pContext->vmDataStackPointer, pState->vmDataStackSize);
+		pContext->vmppDataStack = (JILHandle**) pMem;
+		pContext->vmDataStackLimit = limit;
+	}
+	// call stack
+	need = pContext->vmCallStackPointer - numCalls;
+	if( need < pContext->vmCallStackLimit )
+	{
+		if( checkOverflow && need < 0 )
+			return JIL_VM_Stack_Overflow;
+		limit = JILNewStackLimit(pContext->vmCallStackLimit, pState->vmCallStackSize, need);
+		pMem = JILMoveStack((JILByte*) pContext->vmpCallStack, sizeof(JILLong),
+			pContext->vmCallStackLimit, limit, pContext->vmCallStackPointer, pState->vmCallStackSize);
+		pContext->vmpCallStack = (JILLong*) pMem;
+		pContext->vmCallStackLimit = limit;
+	}
+	return JIL_No_Exception;
+}
+
 //------------------------------------------------------------------------------
 // JILAllocContext
 //------------------------------------------------------------------------------
@@ -518,22 +797,32 @@ JILStackFrame* JILPopStackFrame(JILState* pState, JILStackFrame* pStackFrame)
 JILContext* JILAllocContext(JILState* pState, JILLong numArgs, JILLong funcAddr)
 {
 	JILLong i;
+	JILLong size;
 	JILChar* block;
 	JILContext* pContext;
 
-	// allocate memory in one big chunk
-	block = (JILChar*) malloc(
-		sizeof(JILContext) +
-		pState->vmCallStackSize * sizeof(JILLong) +
-		pState->vmDataStackSize * sizeof(JILHandle*)
-	);
-
-	// assign memory portions
-	pContext = (JILContext*) block;
-	block += sizeof(JILContext);
-	pContext->vmpCallStack  = (JILLong*) block;
-	block += pState->vmCallStackSize * sizeof(JILLong);
-	pContext->vmppDataStack = (JILHandle**) block;
+	if( pState->vmpContextPool )
+	{
+		// reuse a context from the pool
+		pContext = pState->vmpContextPool;
+		pState->vmpContextPool = pContext->vmpYieldContext;
+		pState->vmNumContextPool--;
+	}
+	else
+	{
+		// allocate the context and its registers in one chunk
+		block = (JILChar*) malloc( sizeof(JILContext) + kNumRegisters * sizeof(JILHandle*) );
+		pContext = (JILContext*) block;
+		pContext->vmppRegister = (JILHandle**) (block + sizeof(JILContext));
+
+		// allocate initial stacks
+		size = (kContextCallStack < pState->vmCallStackSize) ? kContextCallStack : pState->vmCallStackSize;
+		pContext->vmCallStackLimit = pState->vmCallStackSize - size;
+		pContext->vmpCallStack = (JILLong*) malloc(size * sizeof(JILLong));
+		size = (kContextDataStack < pState->vmDataStackSize) ? kContextDataStack : pState->vmDataStackSize;
+		pContext->vmDataStackLimit = pState->vmDataStackSize - size;
+		pContext->vmppDataStack = (JILHandle**) malloc(size * sizeof(JILHandle*));
+	}
 
 	pContext->vmProgramCounter = funcAddr;
 	pContext->vmpYieldContext = NULL;
@@ -542,10 +831,6 @@ JILContext* JILAllocContext(JILState* pState, JILLong numArgs, JILLong funcAddr)
 	pContext->vmCallStackPointer = pState->vmCallStackSize;
 	pContext->vmDataStackPointer = pState->vmDataStackSize;
 
-	// set register window - registers are just a bank of values on the stack
-	pContext->vmDataStackPointer -= kNumRegisters;
-	pContext->vmppRegister = pContext->vmppDataStack + pContext->vmDataStackPointer;
-
 	// init registers with null-handle
 	pState->vmppHandles[0]->refCount += kNumRegisters;
 	for( i = 0; i < kNumRegisters; i++ )
@@ -563,9 +848,10 @@ JILContext* JILAllocContext(JILState* pState, JILLong numArgs, JILLong funcAddr)
 	{
 		JILHandle** ppSrc;
 		JILHandle** ppDst;
+		JILGrowStack(pState, pContext, numArgs, 0, JILFalse);
 		pContext->vmDataStackPointer -= numArgs;
-		ppSrc = pState->vmpContext->vmppDataStack + pState->vmpContext->vmDataStackPointer;
-		ppDst = pContext->vmppDataStack + pContext->vmDataStackPointer;
+		ppSrc = JILDataStackAt(pState->vmpContext, pState->vmpContext->vmDataStackPointer);
+		ppDst = JILDataStackAt(pContext, pContext->vmDataStackPointer);
 		while( numArgs-- )
 		{
 			JILAddRef( *ppSrc );
@@ -583,17 +869,50 @@ void JILFreeContext(JILState* pState, JILContext* pContext)
 {
 	JILLong i;
 
-	// release all handles still on the stack, this includes our register window on the stack
+	// release all registers and all handles still on the stack
+	for( i = 0; i < kNumRegisters; i++ )
+		JILRelease(pState, pContext->vmppRegister[i]);
 	for( i = pContext->vmDataStackPointer; i < pState->vmDataStackSize; i++ )
 	{
-		JILRelease(pState, pContext->vmppDataStack[i]);
-		pContext->vmppDataStack[i] = NULL;
+		JILRelease(pState, JILDataStack(pContext, i));
+		JILDataStack(pContext, i) = NULL;
+	}
+
+	// keep the context for reuse, unless its stacks have grown
+	if( pState->vmNumContextPool < pState->vmContextPoolCap
+	&&	pState->vmDataStackSize - pContext->vmDataStackLimit <= kContextDataStack
+	&&	pState->vmCallStackSize - pContext->vmCallStackLimit <= kContextCallStack )
+	{
+		pContext->vmpYieldContext = pState->vmpContextPool;
+		pState->vmpContextPool = pContext;
+		pState->vmNumContextPool++;
+		return;
 	}
 
 	// free memory
+	free(pContext->vmppDataStack);
+	free(pContext->vmpCallStack);
 	free(pContext);
 }
 
+//------------------------------------------------------------------------------
+// JILDestroyContextPool
+//------------------------------------------------------------------------------
+
+void JILDestroyContextPool(JILState* pState)
+{
+	JILContext* pContext;
+	while( pState->vmpContextPool )
+	{
+		pContext = pState->vmpContextPool;
+		pState->vmpContextPool = pContext->vmpYieldContext;
+		free(pContext->vmppDataStack);
+		free(pContext->vmpCallStack);
+		free(pContext);
+	}
+	pState->vmNumContextPool = 0;
+}
+
 //------------------------------------------------------------------------------
 // JILMarkContext
 //------------------------------------------------------------------------------
@@ -603,10 +922,17 @@ JILError JILMarkContext(JILState* pState, JILContext* pContext)
 	JILError result = JIL_No_Exception;
 	JILLong i;
 
-	// mark all handles on the stack, including our register window
+	// mark our register window
+	for( i = 0; i < kNumRegisters; i++ )
+	{
+		result = JILMarkHandle(pState, pContext->vmppRegister[i]);
+		if( result )
+			return result;
+	}
+	// mark all handles on the stack
 	for( i = pContext->vmDataStackPointer; i < pState->vmDataStackSize; i++ )
 	{
-		result = JILMarkHandle(pState, pContext->vmppDataStack[i]);
+		result = JILMarkHandle(pState, JILDataStack(pContext, i));
 		if( result )
 			break;
 	}
@@ -648,7 +974,9 @@ static JILLong JILExecuteByteCode(JILState* pState, JILContext* pContext, JILLon
 	if( address < 0 || address >= pState->vmpCodeSegment->usedSize )
 		return JIL_VM_Invalid_Code_Address;
 	// push "return to native" marker onto call stack
-	pContext->vmpCallStack[--pContext->vmCallStackPointer] = kReturnToNative;
+	if( JILGrowStack(pState, pContext, 0, 1, JILTrue) )
+		return JIL_VM_Stack_Overflow;
+	JILCallStack(pContext, --pContext->vmCallStackPointer) = kReturnToNative;
 	// set new program counter
 	pContext->vmProgramCounter = address;
 	// move 'this' into r0
@@ -691,6 +1019,11 @@ static JILLong JILInitNativeType(JILState* pState, JILTypeInfo* pTypeInfo, JILLo
 	// update 'typeProc' member in native object desc
 	pTypeInfo->typeProc = proc;
 
+	// get the table of directly callable functions, if the type lib has one
+	err = JILGetDirectCalls(pState, proc, type);
+	if( err )
+		return err;
+
 	// update 'pState' member in NTLInstance struct
 	pTypeInfo->instance.pState = pState;
 
@@ -702,6 +1035,43 @@ static JILLong JILInitNativeType(JILState* pState, JILTypeInfo* pTypeInfo, JILLo
 	return JIL_No_Exception;
 }
 
+//------------------------------------------------------------------------------
+// JILGetDirectCalls
+//------------------------------------------------------------------------------
+// Asks the type proc for its table of directly callable functions, and stores
+// it in JILState::vmpDirectCalls. The table is kept out of JILTypeInfo, so the
+// layout of the TypeInfo segment saved in chunks does not change. Returns
+// JIL_VM_Allocation_Failed if the table of all types can't be grown.
+
+static JILError JILGetDirectCalls(JILState* pState, JILTypeProc proc, JILLong type)
+{
+	const NTLDirectCall* pCalls = NULL;
+	JILDirectCalls* pEntry;
+	JILDirectCalls* pNew;
+	JILLong num;
+
+	if( type >= pState->vmNumDirectCalls )
+	{
+		num = pState->vmUsedTypeInfoSegSize;
+		pNew = (JILDirectCalls*) realloc(pState->vmpDirectCalls, num * sizeof(JILDirectCalls));
+		if( !pNew )
+			return JIL_VM_Allocation_Failed;
+		pState->vmpDirectCalls = pNew;
+		memset(pState->vmpDirectCalls + pState->vmNumDirectCalls, 0, (num - pState->vmNumDirectCalls) * sizeof(JILDirectCalls));
+		pState->vmNumDirectCalls = num;
+	}
+	pEntry = pState->vmpDirectCalls + type;
+	pEntry->pCalls = NULL;
+	pEntry->count = 0;
+	if( proc(NULL, NTL_GetDirectCalls, 0, NULL, (void**) &pCalls) == JIL_No_Exception && pCalls )
+	{
+		while( pCalls[pEntry->count].signature != NTL_Sig_End )
+			pEntry->count++;
+		pEntry->pCalls = pCalls;
+	}
+	return JIL_No_Exception;
+}
+
 //------------------------------------------------------------------------------
 // JILIsBaseType
 //------------------------------------------------------------------------------
@@ -942,3 +1312,228 @@ use_buf:
 	}
 	return err;
 }
+
+//------------------------------------------------------------------------------
+// JILInitQuickInfo
+//------------------------------------------------------------------------------
+
+JILError JILInitQuickInfo(JILState* ps)
+{
+#if JIL_USE_QUICKENING
+	JILLong newSize = ps->vmpCodeSegment->maxSize;
+	JILLong oldSize = ps->vmQuickInfoSize;
+	JILByte* pOld = ps->vmpQuickInfo;
+	JILByte* pNew;
+
+	if( newSize > oldSize )
+	{
+		// keep the old info if we can't grow it
+		pNew = (JILByte*) malloc(newSize);
+		if( !pNew )
+			return JIL_VM_Allocation_Failed;
+		ps->vmpQuickInfo = pNew;
+		ps->vmQuickInfoSize = newSize;
+		memset(ps->vmpQuickInfo + oldSize, 0, newSize - oldSize);
+		if( pOld )
+		{
+			memcpy(ps->vmpQuickInfo, pOld, oldSize);
+			free(pOld);
+		}
+	}
+#endif
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILResetQuickInfo
+//------------------------------------------------------------------------------
+
+void JILResetQuickInfo(JILState* ps, JILLong address, JILLong size)
+{
+	if( address < ps->vmQuickInfoSize )
+	{
+		if( (address + size) > ps->vmQuickInfoSize )
+			size = ps->vmQuickInfoSize - address;
+		memset(ps->vmpQuickInfo + address, 0, size);
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILQuickenInstruction
+//------------------------------------------------------------------------------
+
+void JILQuickenInstruction(JILState* ps, JILLong address, JILLong type1, JILLong type2)
+{
+	JILByte* pInfo = ps->vmpQuickInfo + address;
+	JILByte info = *pInfo;
+	JILLong last = (info & kQuickFloat) ? type_float : type_int;
+	JILLong opcode;
+
+	if( type1 != type2 || (type1 != type_int && type1 != type_float) )
+	{
+		*pInfo = kQuickNever;
+		return;
+	}
+	if( (info & kQuickCountMask) && type1 != last )
+	{
+		// type has changed, give it another chance, but only once
+		if( info & kQuickChanged )
+		{
+			*pInfo = kQuickNever;
+			return;
+		}
+		info = kQuickChanged;
+	}
+	if( type1 == type_float )
+		info |= kQuickFloat;
+	else
+		info &= ~kQuickFloat;
+	if( (info & kQuickCountMask) < kQuickThreshold )
+	{
+		*pInfo = info + 1;
+		return;
+	}
+	opcode = JILQuickOpcode(ps->vmpCodeSegment->pData[address], type1);
+	if( opcode )
+	{
+		ps->vmpCodeSegment->pData[address] = opcode;
+		*pInfo = (info & kQuickFloat) | kQuickDone;
+	}
+	else
+	{
+		*pInfo = kQuickNever;
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILDequickenInstruction
+//------------------------------------------------------------------------------
+
+void JILDequickenInstruction(JILState* ps, JILLong address)
+{
+	JILLong opcode;
+
+	// only revert instructions we have quickened, not those of the compiler
+	if( address >= ps->vmQuickInfoSize || !(ps->vmpQuickInfo[address] & kQuickDone) )
+		return;
+	opcode = JILGenericOpcode(ps->vmpCodeSegment->pData[address]);
+	if( opcode )
+		ps->vmpCodeSegment->pData[address] = opcode;
+	ps->vmpQuickInfo[address] = kQuickNever;
+	// machine code compiled from the quickened instruction would keep failing its checks
+	JILJitDiscard(ps, address);
+}
+
+//------------------------------------------------------------------------------
+// JILDequickenCode
+//------------------------------------------------------------------------------
+
+void JILDequickenCode(JILState* ps)
+{
+	JILLong i;
+	JILLong opcode;
+	JILLong size = ps->vmpCodeSegment->usedSize;
+
+	if( size > ps->vmQuickInfoSize )
+		size = ps->vmQuickInfoSize;
+	for( i = 0; i < size; i++ )
+	{
+		if( ps->vmpQuickInfo[i] & kQuickDone )
+		{
+			opcode = JILGenericOpcode(ps->vmpCodeSegment->pData[i]);
+			if( opcode )
+				ps->vmpCodeSegment->pData[i] = opcode;
+			ps->vmpQuickInfo[i] = 0;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILInitCallCache
+//------------------------------------------------------------------------------
+
+JILError JILInitCallCache(JILState* ps)
+{
+#if JIL_USE_INLINE_CACHING
+	JILLong i;
+	if( !ps->vmpCallCache )
+	{
+		ps->vmpCallCache = (JILCallSite*) malloc(kCallCacheSize * sizeof(JILCallSite));
+		if( !ps->vmpCallCache )
+			return JIL_VM_Allocation_Failed;
+	}
+	for( i = 0; i < kCallCacheSize; i++ )
+	{
+		ps->vmpCallCache[i].address = -1;
+		ps->vmpCallCache[i].type = type_null;
+		ps->vmpCallCache[i].index = 0;
+		ps->vmpCallCache[i].codeAddr = 0;
+	}
+#endif
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILResetCallCache
+//------------------------------------------------------------------------------
+
+void JILResetCallCache(JILState* ps, JILLong address, JILLong size)
+{
+	JILCallSite* pSite;
+	JILLong i;
+	if( !ps->vmpCallCache )
+		return;
+	if( size > kCallCacheSize )
+	{
+		// the cache exists, so this only clears it
+		JILInitCallCache(ps);
+		return;
+	}
+	for( i = address; i < address + size; i++ )
+	{
+		pSite = ps->vmpCallCache + (i & (kCallCacheSize - 1));
+		if( pSite->address == i )
+			pSite->address = -1;
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILQuickOpcode
+//------------------------------------------------------------------------------
+// Returns the int or float variant of the given generic instruction, or 0 if
+// the instruction cannot be quickened.
+
+static JILLong JILQuickOpcode(JILLong opcode, JILLong type)
+{
+	JILLong i;
+	for( i = 0; i < kQuickMapSize; i++ )
+	{
+		if( opcode >= kQuickMap[i][0] && opcode < kQuickMap[i][0] + kQuickMap[i][2] )
+		{
+			opcode = kQuickMap[i][1] + (opcode - kQuickMap[i][0]);
+			if( type == type_float )
+				opcode += kQuickFloatOffset;
+			return opcode;
+		}
+	}
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+// JILGenericOpcode
+//------------------------------------------------------------------------------
+// Returns the generic variant of the given int or float instruction, or 0 if
+// the instruction has no generic variant.
+
+static JILLong JILGenericOpcode(JILLong opcode)
+{
+	JILLong i;
+	if( opcode >= op_addf_rr && opcode <= op_cslef_sr )
+		opcode -= kQuickFloatOffset;
+	for( i = 0; i < kQuickMapSize; i++ )
+	{
+		if( opcode >= kQuickMap[i][1] && opcode < kQuickMap[i][1] + kQuickMap[i][2] )
+			return kQuickMap[i][0] + (opcode - kQuickMap[i][1]);
+	}
+	return 0;
+}
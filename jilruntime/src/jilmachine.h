@@ -19,6 +19,16 @@
 
 #include "jilsegment.h"
 
+//------------------------------------------------------------------------------
+// JILDataStack / JILDataStackAt / JILCallStack
+//------------------------------------------------------------------------------
+// Access the stacks of a context by stack index. The stack buffers only hold
+// the indices from the stack limit upwards, see JILGrowStack().
+
+#define JILDataStack(C,I)		((C)->vmppDataStack[(I) - (C)->vmDataStackLimit])
+#define JILDataStackAt(C,I)		((C)->vmppDataStack + ((I) - (C)->vmDataStackLimit))
+#define JILCallStack(C,I)		((C)->vmpCallStack[(I) - (C)->vmCallStackLimit])
+
 //------------------------------------------------------------------------------
 // JILInitVM
 //------------------------------------------------------------------------------
@@ -45,6 +55,14 @@ JILError				JILRunInitCode			(JILState* pState);
 
 JILError				JILCallDelegate			(JILState* pState, JILHandle* pDelegate);
 
+//------------------------------------------------------------------------------
+// JILCallDelegateCached
+//------------------------------------------------------------------------------
+// Same as JILCallDelegate(), but uses the inline cache of the calldg
+// instruction at the given code address to skip resolving the function.
+
+JILError				JILCallDelegateCached	(JILState* pState, JILHandle* pDelegate, JILLong address);
+
 //------------------------------------------------------------------------------
 // JILCallCopyConstructor
 //------------------------------------------------------------------------------
@@ -90,6 +108,16 @@ JILStackFrame*			JILPushStackFrame		(JILState*, JILStackFrame*);
 
 JILStackFrame*			JILPopStackFrame		(JILState*, JILStackFrame*);
 
+//------------------------------------------------------------------------------
+// JILCallComparator
+//------------------------------------------------------------------------------
+// Calls a comparator delegate with two arguments and returns the int result in
+// 'pResult'. Unlike JILCallFunction(), this reuses a stack frame the caller has
+// pushed with JILPushStackFrame(), so sorting functions can call it for every
+// comparison without saving and restoring the machine state each time.
+
+JILError				JILCallComparator		(JILState* pState, JILStackFrame* pFrame, JILHandle* pDelegate, JILHandle* pArg1, JILHandle* pArg2, JILLong* pResult);
+
 //------------------------------------------------------------------------------
 // JILAllocContext
 //------------------------------------------------------------------------------
@@ -101,13 +129,33 @@ JILStackFrame*			JILPopStackFrame		(JILState*, JILStackFrame*);
 
 JILContext*				JILAllocContext			(JILState* pState, JILLong numArgs, JILLong funcAddr);
 
+//------------------------------------------------------------------------------
+// JILGrowStack
+//------------------------------------------------------------------------------
+// Makes sure the given context has room for 'numData' more handles on its data
+// stack and 'numCalls' more return addresses on its call stack. Stacks are
+// reallocated to twice their size until they reach their maximum size. Stack
+// indices stay valid, but pointers into the data stack do not!
+// If 'checkOverflow' is true, JIL_VM_Stack_Overflow is returned instead of
+// exceeding the maximum size. Native code pushing onto the stack passes false.
+
+JILError				JILGrowStack			(JILState* pState, JILContext* pContext, JILLong numData, JILLong numCalls, JILBool checkOverflow);
+
 //------------------------------------------------------------------------------
 // JILFreeContext
 //------------------------------------------------------------------------------
-// Free a context.
+// Free a context. Contexts whose stacks have not grown are kept for reuse,
+// up to JILState::vmContextPoolCap.
 
 void					JILFreeContext			(JILState* pState, JILContext* pContext);
 
+//------------------------------------------------------------------------------
+// JILDestroyContextPool
+//------------------------------------------------------------------------------
+// Frees all contexts that JILFreeContext() has kept for reuse.
+
+void					JILDestroyContextPool	(JILState* pState);
+
 //------------------------------------------------------------------------------
 // JILMarkContext
 //------------------------------------------------------------------------------
@@ -176,4 +224,90 @@ JILError				JILCallFactory			(JILState* ps, JILArray* pArr, JILLong funcIndex);
 
 JILError				JILDynamicConvert		(JILState* ps, JILLong dType, JILHandle* sObj, JILHandle** ppOut);
 
+//------------------------------------------------------------------------------
+// quickening info flags
+//------------------------------------------------------------------------------
+// Each word in the code segment has a byte in JILState::vmpQuickInfo, which
+// is used by generic instructions to track the operand types they see.
+
+enum
+{
+	kQuickCountMask	= 0x0F,		//!< number of consecutive executions with the same operand type
+	kQuickFloat		= 1 << 4,	//!< the operand type last seen was float (otherwise int)
+	kQuickChanged	= 1 << 5,	//!< the operand type has changed before
+	kQuickDone		= 1 << 6,	//!< the instruction has been quickened
+	kQuickNever		= 1 << 7	//!< the instruction must not be quickened (anymore)
+};
+
+//------------------------------------------------------------------------------
+// JILInitQuickInfo
+//------------------------------------------------------------------------------
+// Makes sure the quickening info covers the entire code segment. Called by
+// JILInitVM(), after new code has been linked. Does nothing if quickening is
+// disabled by JIL_USE_QUICKENING. Returns JIL_VM_Allocation_Failed if the info
+// can't be grown.
+
+JILError				JILInitQuickInfo		(JILState* ps);
+
+//------------------------------------------------------------------------------
+// JILResetQuickInfo
+//------------------------------------------------------------------------------
+// Clears the quickening info for the given range of code words. Called when
+// code is written into the code segment.
+
+void					JILResetQuickInfo		(JILState* ps, JILLong address, JILLong size);
+
+//------------------------------------------------------------------------------
+// JILQuickenInstruction
+//------------------------------------------------------------------------------
+// Called by a generic instruction after it has successfully executed with
+// the given operand types. Replaces the instruction by the int or float
+// variant once the operand type has been stable for a number of executions.
+
+void					JILQuickenInstruction	(JILState* ps, JILLong address, JILLong type1, JILLong type2);
+
+//------------------------------------------------------------------------------
+// JILDequickenInstruction
+//------------------------------------------------------------------------------
+// Called by an int or float instruction if its operand types don't match.
+// Reverts the instruction to its generic form and prevents it from being
+// quickened again. Does nothing if the instruction has not been quickened.
+
+void					JILDequickenInstruction	(JILState* ps, JILLong address);
+
+//------------------------------------------------------------------------------
+// JILDequickenCode
+//------------------------------------------------------------------------------
+// Reverts all quickened instructions in the code segment to their generic
+// form. Called before the code segment is saved to a binary chunk.
+
+void					JILDequickenCode		(JILState* ps);
+
+//------------------------------------------------------------------------------
+// inline cache size
+//------------------------------------------------------------------------------
+// Number of entries in JILState::vmpCallCache. Must be a power of two.
+
+enum
+{
+	kCallCacheSize	= 1024
+};
+
+//------------------------------------------------------------------------------
+// JILInitCallCache
+//------------------------------------------------------------------------------
+// Allocates the inline cache for call sites. Called by JILInitialize(). Does
+// nothing if inline caching is disabled by JIL_USE_INLINE_CACHING. Returns
+// JIL_VM_Allocation_Failed if the cache can't be allocated.
+
+JILError				JILInitCallCache		(JILState* ps);
+
+//------------------------------------------------------------------------------
+// JILResetCallCache
+//------------------------------------------------------------------------------
+// Invalidates the inline cache entries of all call sites in the given range of
+// code words. Called when code is written into the code segment.
+
+void					JILResetCallCache		(JILState* ps, JILLong address, JILLong size);
+
 #endif	// #ifndef JILMACHINE_H
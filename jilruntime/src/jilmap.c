@@ -0,0 +1,750 @@
+//------------------------------------------------------------------------------
+// File: JILMap.c                                              (c) 2026 jewe.org
+//------------------------------------------------------------------------------
+//
+// DISCLAIMER:
+// -----------
+//	THIS SOFTWARE IS SUBJECT TO THE LICENSE AGREEMENT FOUND IN "jilapi.h" AND
+//	"COPYING". BY USING THIS SOFTWARE YOU IMPLICITLY DECLARE YOUR AGREEMENT TO
+//	THE TERMS OF THIS LICENSE.
+//
+// Description:
+// ------------
+/// @file jilmap.c
+/// An open addressing hash map for the JILRuntime. Keys can be int, float and
+/// string values, which are compared by value, or references to any other
+/// object, which are compared by identity. The map remembers the order in
+/// which keys have been added.
+//------------------------------------------------------------------------------
+
+#include "jilstdinc.h"
+#include "jilmap.h"
+#include "jilhandle.h"
+#include "jilstring.h"
+#include "jilarray.h"
+#include "jillist.h"
+#include "jilapi.h"
+
+//------------------------------------------------------------------------------
+// struct JILMapEntry
+//------------------------------------------------------------------------------
+// Entries are stored in the order their keys have been added. The hash of the
+// key is cached, so probing only compares keys if their hashes are equal.
+
+typedef struct JILMapEntry	JILMapEntry;
+struct JILMapEntry
+{
+	JILHandle*		pKey;					// the key, or NULL if the entry has been removed
+	JILHandle*		pValue;					// the value stored under the key
+	JILUInt32		hash;					// hash of the key
+};
+
+//------------------------------------------------------------------------------
+// struct JILMap
+//------------------------------------------------------------------------------
+// The slots are an open addressing hash table of indexes into the entries.
+// There are always twice as many slots as entries, so the slots are at most
+// half full and probe sequences stay short.
+
+struct JILMap
+{
+	JILState*		pState;
+	JILMapEntry*	pEntries;				// entries in insertion order
+	JILLong*		pSlots;					// index of an entry, or kSlotEmpty / kSlotDeleted
+	JILLong			count;					// number of keys in the map
+	JILLong			numEntries;				// number of entries used, including removed entries
+	JILLong			capacity;				// number of entries allocated, a power of two or 0
+};
+
+//------------------------------------------------------------------------------
+// function index numbers
+//------------------------------------------------------------------------------
+
+enum
+{
+	kCtor,
+	kCctor,
+	kCtorCapacity,
+
+	kGet,
+	kSet,
+	kContains,
+	kRemove,
+	kClear,
+	kReserve,
+	kDeepCopy,
+	kKeys,
+	kValues,
+	kToList,
+	kCount,
+	kCapacity
+};
+
+//------------------------------------------------------------------------------
+// class declaration list
+//------------------------------------------------------------------------------
+
+static const char* kClassDeclaration =
+	TAG("This is JewelScript's built-in hash map class. Unlike the table class, which only accepts string keys, the map accepts int, float and string keys, which are compared by value, and references to any other object, which are compared by identity. Adding, retrieving and removing values by key takes constant time. Functions that return all keys or values of the map return them in the order in which the keys have been added. The map class must be imported before it can be used: <pre>import map;</pre>")
+	"method			map();" TAG("Constructs a new, empty map.")
+	"method			map(const map);" TAG("Copy constructs a new map from the specified one. The new map will be a shallow-copy, meaning values in the map will only be copied by reference.")
+	"explicit		map(const int capacity);" TAG("Constructs a new, empty map with room for the specified number of keys. Use this if the number of keys is known in advance, to avoid growing the map while it is filled. A map can hold at most 67108864 keys, requesting more throws an allocation failure exception.")
+	"method	var		get(const var key);" TAG("Retrieves a value from the map by the specified key. If no value exists in the map under the specified key, null is returned.")
+	"method			set(const var key, var value);" TAG("Stores a value in the map under the specified key. If a value already exists under this key, it is overwritten and the key keeps its position in the map. Storing null removes the key from the map. The key must not be null.")
+	"method	int		contains(const var key);" TAG("Returns true if a value is stored in the map under the specified key.")
+	"method	int		remove(const var key);" TAG("Removes the specified key and its value from the map. Returns true if the key was found.")
+	"method			clear();" TAG("Removes all keys and values from the map. The map keeps its capacity.")
+	"method			reserve(const int capacity);" TAG("Makes sure the map has room for the specified number of keys, so that it does not need to grow while it is filled. Throws an allocation failure exception if more than 67108864 keys are requested.")
+	"method map		deepCopy();" TAG("Returns a deep-copy of this map. Values are copied, as well as keys that are values. Keys that are object references still refer to the same objects, because they are compared by identity.")
+	"method array	keys();" TAG("Returns all keys of this map in a new array, in the order in which they have been added.")
+	"method array	values();" TAG("Returns all values of this map in a new array, in the order in which their keys have been added.")
+	"method list	toList();" TAG("Returns all keys and values of this map in a new list, in the order in which the keys have been added.")
+	"accessor int	count();" TAG("Returns the number of keys currently stored in the map.")
+	"accessor int	capacity();" TAG("Returns the number of keys the map can store before it needs to grow.")
+;
+
+//------------------------------------------------------------------------------
+// some constants
+//------------------------------------------------------------------------------
+
+static const char*		kClassName		=	"map";
+static const char*		kAuthorName		=	"www.jewe.org";
+static const char*		kAuthorString	=	"A hash map class for JewelScript.";
+static const char*		kTimeStamp		=	"10/16/2026";
+
+static const JILLong	kMapMinCapacity = 8;	// number of entries allocated for the first key
+static const JILLong	kMapMaxCapacity = 0x4000000;	// maximum number of keys in a map
+static const JILLong	kSlotEmpty = -1;		// slot that has never been used
+static const JILLong	kSlotDeleted = -2;		// slot whose entry has been removed
+
+//------------------------------------------------------------------------------
+// forward declare static functions
+//------------------------------------------------------------------------------
+
+static JILError MapNew			(NTLInstance* pInst, JILMap** ppObject);
+static JILError MapDelete		(NTLInstance* pInst, JILMap* _this);
+static JILError MapMark			(NTLInstance* pInst, JILMap* _this);
+static JILError MapCallMember	(NTLInstance* pInst, JILLong funcID, JILMap* _this);
+
+static JILBool MapKeyEquals		(JILHandle* pKey1, JILHandle* pKey2);
+static JILUInt32 MapKeyHash		(JILHandle* pKey);
+static JILLong MapFind			(const JILMap* _this, JILHandle* pKey, JILUInt32 hash);
+static void MapInsert			(JILMap* _this, JILHandle* pKey, JILUInt32 hash, JILHandle* pValue);
+static void MapRemove			(JILMap* _this, JILLong slot);
+static void MapResize			(JILMap* _this, JILLong capacity);
+static JILLong MapCapacityFor	(JILLong count);
+
+//------------------------------------------------------------------------------
+// JILMapProc
+//------------------------------------------------------------------------------
+
+JILError JILMapProc(NTLInstance* pInst, JILLong msg, JILLong param, JILUnknown* pDataIn, JILUnknown** ppDataOut)
+{
+	JILError result = JIL_No_Exception;
+	switch( msg )
+	{
+		// runtime messages
+		case NTL_Register:				break;
+		case NTL_Initialize:			break;
+		case NTL_NewObject:				return MapNew(pInst, (JILMap**) ppDataOut);
+		case NTL_CallStatic:			return JIL_ERR_Unsupported_Native_Call;
+		case NTL_CallMember:			return MapCallMember(pInst, param, (JILMap*) pDataIn);
+		case NTL_MarkHandles:			return MapMark(pInst, (JILMap*) pDataIn);
+		case NTL_DestroyObject:			return MapDelete(pInst, (JILMap*) pDataIn);
+		case NTL_Terminate:				break;
+		case NTL_Unregister:			break;
+
+		// class information queries
+		case NTL_GetInterfaceVersion:	return NTLRevisionToLong(JIL_TYPE_INTERFACE_VERSION);
+		case NTL_GetAuthorVersion:		return NTLRevisionToLong(JIL_LIBRARY_VERSION);
+		case NTL_GetClassName:			(*(const char**) ppDataOut) = kClassName; break;
+		case NTL_GetDeclString:			(*(const char**) ppDataOut) = kClassDeclaration; break;
+		case NTL_GetBuildTimeStamp:		(*(const char**) ppDataOut) = kTimeStamp; break;
+		case NTL_GetAuthorName:			(*(const char**) ppDataOut) = kAuthorName; break;
+		case NTL_GetAuthorString:		(*(const char**) ppDataOut) = kAuthorString; break;
+
+		default:						result = JIL_ERR_Unsupported_Native_Call; break;
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// MapNew
+//------------------------------------------------------------------------------
+
+static JILError MapNew(NTLInstance* pInst, JILMap** ppObject)
+{
+	*ppObject = JILMap_New( NTLInstanceGetVM(pInst) );
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// MapDelete
+//------------------------------------------------------------------------------
+
+static JILError MapDelete(NTLInstance* pInst, JILMap* _this)
+{
+	JILMap_Delete( _this );
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// MapMark
+//------------------------------------------------------------------------------
+// Marks the keys and values of all entries. Each of them is referenced once by
+// the map, so the cycle collector can subtract the references correctly.
+
+static JILError MapMark(NTLInstance* pInst, JILMap* _this)
+{
+	JILError err = JIL_No_Exception;
+	JILState* pState = _this->pState;
+	JILMapEntry* pEntry;
+	JILLong i;
+	for( i = 0; i < _this->numEntries; i++ )
+	{
+		pEntry = _this->pEntries + i;
+		if( pEntry->pKey == NULL )
+			continue;
+		err = NTLMarkHandle(pState, pEntry->pKey);
+		if( err )
+			break;
+		err = NTLMarkHandle(pState, pEntry->pValue);
+		if( err )
+			break;
+	}
+	return err;
+}
+
+//------------------------------------------------------------------------------
+// MapCallMember
+//------------------------------------------------------------------------------
+
+static JILError MapCallMember(NTLInstance* pInst, JILLong funcID, JILMap* _this)
+{
+	JILError result = JIL_No_Exception;
+	JILState* ps = NTLInstanceGetVM(pInst);
+	JILHandle* key;
+	JILHandle* val;
+	JILHandle* pH;
+	switch( funcID )
+	{
+		case kCtor:
+			break;
+		case kCctor:
+			pH = NTLGetArgHandle(ps, 0);
+			JILMap_Copy(_this, NTLHandleToObject(ps, NTLInstanceTypeID(pInst), pH));
+			NTLFreeHandle(ps, pH);
+			break;
+		case kCtorCapacity:
+			result = JILMap_Reserve(_this, NTLGetArgInt(ps, 0));
+			break;
+		case kGet:
+			key = NTLGetArgHandle(ps, 0);
+			NTLReturnHandle(ps, JILMap_Get(_this, key));
+			NTLFreeHandle(ps, key);
+			break;
+		case kSet:
+			key = NTLGetArgHandle(ps, 0);
+			val = NTLGetArgHandle(ps, 1);
+			result = JILMap_Set(_this, key, val);
+			NTLFreeHandle(ps, val);
+			NTLFreeHandle(ps, key);
+			break;
+		case kContains:
+			key = NTLGetArgHandle(ps, 0);
+			NTLReturnInt(ps, JILMap_Get(_this, key) != NULL);
+			NTLFreeHandle(ps, key);
+			break;
+		case kRemove:
+			key = NTLGetArgHandle(ps, 0);
+			NTLReturnInt(ps, JILMap_Remove(_this, key));
+			NTLFreeHandle(ps, key);
+			break;
+		case kClear:
+			JILMap_Clear(_this);
+			break;
+		case kReserve:
+			result = JILMap_Reserve(_this, NTLGetArgInt(ps, 0));
+			break;
+		case kDeepCopy:
+			pH = NTLNewHandleForObject(ps, NTLInstanceTypeID(pInst), JILMap_DeepCopy(_this));
+			NTLReturnHandle(ps, pH);
+			NTLFreeHandle(ps, pH);
+			break;
+		case kKeys:
+			pH = NTLNewHandleForObject(ps, type_array, JILMap_Keys(_this));
+			NTLReturnHandle(ps, pH);
+			NTLFreeHandle(ps, pH);
+			break;
+		case kValues:
+			pH = NTLNewHandleForObject(ps, type_array, JILMap_Values(_this));
+			NTLReturnHandle(ps, pH);
+			NTLFreeHandle(ps, pH);
+			break;
+		case kToList:
+			pH = NTLNewHandleForObject(ps, type_list, JILMap_ToList(_this));
+			NTLReturnHandle(ps, pH);
+			NTLFreeHandle(ps, pH);
+			break;
+		case kCount:
+			NTLReturnInt(ps, _this->count);
+			break;
+		case kCapacity:
+			NTLReturnInt(ps, _this->capacity);
+			break;
+		default:
+			result = JIL_ERR_Invalid_Function_Index;
+			break;
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_New
+//------------------------------------------------------------------------------
+// Allocates an empty map, the entries are allocated when the first key is
+// stored.
+
+JILMap* JILMap_New(JILState* pState)
+{
+	JILMap* _this = (JILMap*) pState->vmMalloc(pState, sizeof(JILMap));
+	memset(_this, 0, sizeof(JILMap));
+	_this->pState = pState;
+	return _this;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Delete
+//------------------------------------------------------------------------------
+
+void JILMap_Delete(JILMap* _this)
+{
+	JILState* ps = _this->pState;
+	JILMap_Clear(_this);
+	if( _this->pEntries )
+	{
+		ps->vmFree(ps, _this->pEntries);
+		ps->vmFree(ps, _this->pSlots);
+	}
+	ps->vmFree(ps, _this);
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Copy
+//------------------------------------------------------------------------------
+// Copy-constructs a map. Values are copied by reference, keys are shared with
+// the source map, because they are never modified.
+
+void JILMap_Copy(JILMap* _this, const JILMap* pSrc)
+{
+	JILLong i;
+	JILHandle* pValue;
+	const JILMapEntry* pEntry;
+	JILMap_Reserve(_this, pSrc->count);
+	for( i = 0; i < pSrc->numEntries; i++ )
+	{
+		pEntry = pSrc->pEntries + i;
+		if( pEntry->pKey && MapFind(_this, pEntry->pKey, pEntry->hash) < 0 )
+		{
+			pValue = NTLCopyValueType(_this->pState, pEntry->pValue);
+			NTLReferHandle(_this->pState, pEntry->pKey);
+			MapInsert(_this, pEntry->pKey, pEntry->hash, pValue);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILMap_DeepCopy
+//------------------------------------------------------------------------------
+// Deep-copies this map and returns the new instance. Keys that are object
+// references are not copied, since they are compared by identity.
+
+JILMap* JILMap_DeepCopy(const JILMap* _this)
+{
+	JILLong i;
+	JILHandle* pData;
+	JILMapEntry* pEntry;
+	JILMap* pNew;
+	// copy the references first, copy constructors may modify this map
+	pNew = JILMap_New(_this->pState);
+	JILMap_Copy(pNew, _this);
+	for( i = 0; i < pNew->numEntries; i++ )
+	{
+		pEntry = pNew->pEntries + i;
+		pData = NTLCopyHandle(pNew->pState, pEntry->pValue);
+		NTLFreeHandle(pNew->pState, pEntry->pValue);
+		pEntry->pValue = pData;
+	}
+	return pNew;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Reserve
+//------------------------------------------------------------------------------
+// Makes room for the given number of keys. Returns an error if the number
+// exceeds the maximum capacity of a map.
+
+JILError JILMap_Reserve(JILMap* _this, JILLong capacity)
+{
+	if( capacity > kMapMaxCapacity )
+		return JIL_VM_Allocation_Failed;
+	if( capacity > _this->capacity )
+		MapResize(_this, MapCapacityFor(capacity));
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Capacity
+//------------------------------------------------------------------------------
+
+JILLong JILMap_Capacity(const JILMap* _this)
+{
+	return _this->capacity;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Count
+//------------------------------------------------------------------------------
+
+JILLong JILMap_Count(const JILMap* _this)
+{
+	return _this->count;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Clear
+//------------------------------------------------------------------------------
+// Removes all keys and values, but keeps the allocated entries.
+
+void JILMap_Clear(JILMap* _this)
+{
+	JILLong i;
+	JILMapEntry* pEntry;
+	JILState* ps = _this->pState;
+	for( i = 0; i < _this->numEntries; i++ )
+	{
+		pEntry = _this->pEntries + i;
+		if( pEntry->pKey )
+		{
+			NTLFreeHandle(ps, pEntry->pKey);
+			NTLFreeHandle(ps, pEntry->pValue);
+		}
+	}
+	for( i = 0; i < _this->capacity * 2; i++ )
+		_this->pSlots[i] = kSlotEmpty;
+	_this->count = 0;
+	_this->numEntries = 0;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Get
+//------------------------------------------------------------------------------
+// Returns the value stored under the given key, or NULL.
+
+JILHandle* JILMap_Get(JILMap* _this, JILHandle* pKey)
+{
+	JILLong slot = MapFind(_this, pKey, MapKeyHash(pKey));
+	if( slot < 0 )
+		return NULL;
+	return _this->pEntries[_this->pSlots[slot]].pValue;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Set
+//------------------------------------------------------------------------------
+// Stores a value under the given key. Storing null removes the key. Keys that
+// are values are copied, because a script could modify a key handle it still
+// refers to. Returns an error if the key is null, or if the map is full.
+
+JILError JILMap_Set(JILMap* _this, JILHandle* pKey, JILHandle* pValue)
+{
+	JILLong slot;
+	JILUInt32 hash;
+	JILMapEntry* pEntry;
+	JILState* ps = _this->pState;
+	if( pKey->type == type_null )
+		return JIL_VM_Unsupported_Type;
+	hash = MapKeyHash(pKey);
+	slot = MapFind(_this, pKey, hash);
+	if( slot >= 0 )
+	{
+		pEntry = _this->pEntries + _this->pSlots[slot];
+		if( pValue->type == type_null )
+		{
+			MapRemove(_this, slot);
+		}
+		else
+		{
+			NTLReferHandle(ps, pValue);
+			NTLFreeHandle(ps, pEntry->pValue);
+			pEntry->pValue = pValue;
+		}
+	}
+	else if( pValue->type != type_null )
+	{
+		if( _this->count == kMapMaxCapacity )
+			return JIL_VM_Allocation_Failed;
+		if( pKey->type == type_int || pKey->type == type_float || pKey->type == type_string )
+			pKey = NTLCopyHandle(ps, pKey);
+		else
+			NTLReferHandle(ps, pKey);
+		NTLReferHandle(ps, pValue);
+		MapInsert(_this, pKey, hash, pValue);
+	}
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Remove
+//------------------------------------------------------------------------------
+// Removes a key and its value. Returns true if the key was found.
+
+JILBool JILMap_Remove(JILMap* _this, JILHandle* pKey)
+{
+	JILLong slot = MapFind(_this, pKey, MapKeyHash(pKey));
+	if( slot < 0 )
+		return JILFalse;
+	MapRemove(_this, slot);
+	return JILTrue;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Keys
+//------------------------------------------------------------------------------
+// Returns a new array with the keys of the map, in insertion order.
+
+JILArray* JILMap_Keys(JILMap* _this)
+{
+	JILLong i;
+	JILArray* pArray = JILArray_New(_this->pState);
+	for( i = 0; i < _this->numEntries; i++ )
+	{
+		if( _this->pEntries[i].pKey )
+			JILArray_MoveTo(pArray, pArray->size, _this->pEntries[i].pKey);
+	}
+	return pArray;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_Values
+//------------------------------------------------------------------------------
+// Returns a new array with the values of the map, in insertion order.
+
+JILArray* JILMap_Values(JILMap* _this)
+{
+	JILLong i;
+	JILArray* pArray = JILArray_New(_this->pState);
+	for( i = 0; i < _this->numEntries; i++ )
+	{
+		if( _this->pEntries[i].pKey )
+			JILArray_MoveTo(pArray, pArray->size, _this->pEntries[i].pValue);
+	}
+	return pArray;
+}
+
+//------------------------------------------------------------------------------
+// JILMap_ToList
+//------------------------------------------------------------------------------
+// Returns a new list with the keys and values of the map, in insertion order.
+// Keys that are object references are stored in the list by reference.
+
+JILList* JILMap_ToList(JILMap* _this)
+{
+	JILLong i;
+	JILList* pList = JILList_New(_this->pState);
+	for( i = 0; i < _this->numEntries; i++ )
+	{
+		if( _this->pEntries[i].pKey )
+			JILList_Add(pList, _this->pEntries[i].pKey, _this->pEntries[i].pValue);
+	}
+	return pList;
+}
+
+//------------------------------------------------------------------------------
+// MapKeyEquals
+//------------------------------------------------------------------------------
+// Values are compared by value, any other key by identity.
+
+static JILBool MapKeyEquals(JILHandle* pKey1, JILHandle* pKey2)
+{
+	if( pKey1 == pKey2 )
+		return JILTrue;
+	if( pKey1->type != pKey2->type )
+		return JILFalse;
+	switch( pKey1->type )
+	{
+		case type_int:
+			return JILGetIntHandle(pKey1)->l == JILGetIntHandle(pKey2)->l;
+		case type_float:
+			return JILGetFloatHandle(pKey1)->f == JILGetFloatHandle(pKey2)->f;
+		case type_string:
+			return JILString_Equal(JILGetStringHandle(pKey1)->str, JILGetStringHandle(pKey2)->str);
+	}
+	return JILFalse;
+}
+
+//------------------------------------------------------------------------------
+// MapKeyHash
+//------------------------------------------------------------------------------
+// Computes the hash value of a key. Keys that are equal according to
+// MapKeyEquals() must produce the same hash value.
+
+static JILUInt32 MapKeyHash(JILHandle* pKey)
+{
+	JILUInt32 h = 2166136261u;
+	const JILByte* p;
+	JILFloat f;
+	JILLong i;
+	size_t addr;
+	switch( pKey->type )
+	{
+		case type_int:
+			h = (JILUInt32) JILGetIntHandle(pKey)->l;
+			break;
+		case type_float:
+			f = JILGetFloatHandle(pKey)->f;
+			if( f == 0 )
+				f = 0;	// -0.0 equals 0.0
+			p = (const JILByte*) &f;
+			for( i = 0; i < (JILLong) sizeof(JILFloat); i++ )
+				h = (h ^ p[i]) * 16777619u;
+			break;
+		case type_string:
+			p = (const JILByte*) JILString_String(JILGetStringHandle(pKey)->str);
+			while( *p )
+				h = (h ^ *p++) * 16777619u;
+			break;
+		default:
+			addr = (size_t) pKey;
+			h = (JILUInt32) addr ^ (JILUInt32) (addr >> 16 >> 16);
+			break;
+	}
+	h ^= (JILUInt32) pKey->type;
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+//------------------------------------------------------------------------------
+// MapFind
+//------------------------------------------------------------------------------
+// Returns the slot that refers to the entry with the given key, or -1.
+
+static JILLong MapFind(const JILMap* _this, JILHandle* pKey, JILUInt32 hash)
+{
+	JILLong i, mask, index;
+	const JILMapEntry* pEntry;
+	if( _this->count == 0 )
+		return -1;
+	mask = _this->capacity * 2 - 1;
+	for( i = hash & mask; ; i = (i + 1) & mask )
+	{
+		index = _this->pSlots[i];
+		if( index == kSlotEmpty )
+			return -1;
+		if( index >= 0 )
+		{
+			pEntry = _this->pEntries + index;
+			if( pEntry->hash == hash && MapKeyEquals(pEntry->pKey, pKey) )
+				return i;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// MapInsert
+//------------------------------------------------------------------------------
+// Appends an entry for a key that is not yet in the map. Takes over the
+// references to the key and value. When all entries are used, the map grows,
+// or is compacted if enough entries have been removed.
+
+static void MapInsert(JILMap* _this, JILHandle* pKey, JILUInt32 hash, JILHandle* pValue)
+{
+	JILLong i, mask;
+	JILMapEntry* pEntry;
+	if( _this->numEntries == _this->capacity )
+		MapResize(_this, MapCapacityFor(_this->count + _this->count / 2 + 1));
+	mask = _this->capacity * 2 - 1;
+	for( i = hash & mask; _this->pSlots[i] >= 0; i = (i + 1) & mask )
+		;
+	_this->pSlots[i] = _this->numEntries;
+	pEntry = _this->pEntries + _this->numEntries++;
+	pEntry->pKey = pKey;
+	pEntry->pValue = pValue;
+	pEntry->hash = hash;
+	_this->count++;
+}
+
+//------------------------------------------------------------------------------
+// MapRemove
+//------------------------------------------------------------------------------
+// Removes the entry the given slot refers to and releases its key and value.
+// The entry stays in place, so the order of the other entries is kept.
+
+static void MapRemove(JILMap* _this, JILLong slot)
+{
+	JILState* ps = _this->pState;
+	JILMapEntry* pEntry = _this->pEntries + _this->pSlots[slot];
+	JILHandle* pKey = pEntry->pKey;
+	JILHandle* pValue = pEntry->pValue;
+	pEntry->pKey = NULL;
+	pEntry->pValue = NULL;
+	_this->pSlots[slot] = kSlotDeleted;
+	_this->count--;
+	// release last, freeing a value may call back into this map
+	NTLFreeHandle(ps, pKey);
+	NTLFreeHandle(ps, pValue);
+}
+
+//------------------------------------------------------------------------------
+// MapResize
+//------------------------------------------------------------------------------
+// Moves all entries into new arrays of the given capacity, dropping removed
+// entries. The capacity must be a power of two.
+
+static void MapResize(JILMap* _this, JILLong capacity)
+{
+	JILLong i, j, n, mask;
+	JILMapEntry* pOld = _this->pEntries;
+	JILState* ps = _this->pState;
+	if( _this->pSlots )
+		ps->vmFree(ps, _this->pSlots);
+	_this->pEntries = (JILMapEntry*) ps->vmMalloc(ps, capacity * sizeof(JILMapEntry));
+	_this->pSlots = (JILLong*) ps->vmMalloc(ps, capacity * 2 * sizeof(JILLong));
+	for( i = 0; i < capacity * 2; i++ )
+		_this->pSlots[i] = kSlotEmpty;
+	mask = capacity * 2 - 1;
+	for( i = 0, n = 0; i < _this->numEntries; i++ )
+	{
+		if( pOld[i].pKey )
+		{
+			_this->pEntries[n] = pOld[i];
+			for( j = pOld[i].hash & mask; _this->pSlots[j] != kSlotEmpty; j = (j + 1) & mask )
+				;
+			_this->pSlots[j] = n++;
+		}
+	}
+	if( pOld )
+		ps->vmFree(ps, pOld);
+	_this->numEntries = n;
+	_this->capacity = capacity;
+}
+
+//------------------------------------------------------------------------------
+// MapCapacityFor
+//------------------------------------------------------------------------------
+// Returns the number of entries to allocate for the given number of keys.
+// The result never exceeds the maximum capacity.
+
+static JILLong MapCapacityFor(JILLong count)
+{
+	JILLong capacity = kMapMinCapacity;
+	if( count >= kMapMaxCapacity )
+		return kMapMaxCapacity;
+	while( capacity < count )
+		capacity *= 2;
+	return capacity;
+}
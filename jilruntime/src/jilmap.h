@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+// File: JILMap.h                                              (c) 2026 jewe.org
+//------------------------------------------------------------------------------
+//
+// DISCLAIMER:
+// -----------
+//	THIS SOFTWARE IS SUBJECT TO THE LICENSE AGREEMENT FOUND IN "jilapi.h" AND
+//	"COPYING". BY USING THIS SOFTWARE YOU IMPLICITLY DECLARE YOUR AGREEMENT TO
+//	THE TERMS OF THIS LICENSE.
+//
+// Description:
+// ------------
+/// @file jilmap.h
+/// An open addressing hash map for the JILRuntime. Keys can be int, float and
+/// string values, which are compared by value, or references to any other
+/// object, which are compared by identity. The map remembers the order in
+/// which keys have been added.
+//------------------------------------------------------------------------------
+
+#ifndef JILMAP_H
+#define JILMAP_H
+
+#include "jiltypes.h"
+
+//------------------------------------------------------------------------------
+// JILMap Functions
+//------------------------------------------------------------------------------
+
+BEGIN_JILEXTERN
+
+JILMap*				JILMap_New					(JILState*);
+void				JILMap_Delete				(JILMap*);
+void				JILMap_Copy					(JILMap*, const JILMap*);
+JILMap*				JILMap_DeepCopy				(const JILMap*);
+JILError			JILMap_Reserve				(JILMap*, JILLong);
+JILLong				JILMap_Capacity				(const JILMap*);
+JILLong				JILMap_Count				(const JILMap*);
+void				JILMap_Clear				(JILMap*);
+
+JILHandle*			JILMap_Get					(JILMap*, JILHandle*);
+JILError			JILMap_Set					(JILMap*, JILHandle*, JILHandle*);
+JILBool				JILMap_Remove				(JILMap*, JILHandle*);
+
+JILArray*			JILMap_Keys					(JILMap*);
+JILArray*			JILMap_Values				(JILMap*);
+JILList*			JILMap_ToList				(JILMap*);
+
+//------------------------------------------------------------------------------
+// JILMapProc
+//------------------------------------------------------------------------------
+
+JILError JILMapProc(NTLInstance* pInst, JILLong msg, JILLong param, JILUnknown* pDataIn, JILUnknown** ppDataOut);
+
+END_JILEXTERN
+
+#endif	// JILMAP_H
@@ -44,7 +44,7 @@ const JILLong kLoadResourceChunkSize = 1024 * 64;	// load files in chunks of 64K
 
 JILINLINE JILHandle* get_stack_handle(JILState* pState, JILLong argNum)
 {
-	return pState->vmpContext->vmppDataStack[pState->vmpContext->vmDataStackPointer + argNum];
+	return JILDataStack(pState->vmpContext, pState->vmpContext->vmDataStackPointer + argNum);
 }
 
 //------------------------------------------------------------------------------
@@ -221,13 +221,21 @@ JILUnknown* NTLGetArgObject(JILState* pState, JILLong argNum, JILLong type)
 
 void NTLReturnInt(JILState* pState, JILLong value)
 {
-	JILHandle* pHandle;
+	JILHandle** ppReg = pState->vmpContext->vmppRegister + kReturnRegister;
+	JILHandle* pHandle = *ppReg;
 
+	// reuse the handle in the return register, if no one else references it
+	if( JIL_USE_HANDLE_REUSE && pHandle->refCount == 1 && (pHandle->type == type_int || pHandle->type == type_float) )
+	{
+		pHandle->type = type_int;
+		JILGetIntHandle(pHandle)->l = value;
+		return;
+	}
 	pHandle = JILGetNewHandle( pState );
 	pHandle->type = type_int;
 	JILGetIntHandle(pHandle)->l = value;
-	JILRelease( pState, pState->vmpContext->vmppRegister[kReturnRegister] );
-	pState->vmpContext->vmppRegister[kReturnRegister] = pHandle;
+	JILRelease( pState, *ppReg );
+	*ppReg = pHandle;
 }
 
 //------------------------------------------------------------------------------
@@ -236,15 +244,100 @@ void NTLReturnInt(JILState* pState, JILLong value)
 
 void NTLReturnFloat(JILState* pState, JILFloat value)
 {
-	JILHandle* pHandle;
+	JILHandle** ppReg = pState->vmpContext->vmppRegister + kReturnRegister;
+	JILHandle* pHandle = *ppReg;
 
+	// reuse the handle in the return register, if no one else references it
+	if( JIL_USE_HANDLE_REUSE && pHandle->refCount == 1 && (pHandle->type == type_int || pHandle->type == type_float) )
+	{
+		pHandle->type = type_float;
+		JILGetFloatHandle(pHandle)->f = value;
+		return;
+	}
 	pHandle = JILGetNewHandle( pState );
 	pHandle->type = type_float;
 	JILGetFloatHandle(pHandle)->f = value;
-	JILRelease( pState, pState->vmpContext->vmppRegister[kReturnRegister] );
-	pState->vmpContext->vmppRegister[kReturnRegister] = pHandle;
+	JILRelease( pState, *ppReg );
+	*ppReg = pHandle;
 }
 
+//------------------------------------------------------------------------------
+// CallNTLDirect
+//------------------------------------------------------------------------------
+// The arguments are read directly from the stack handles, since the compiler
+// has already made sure they have the declared types.
+
+typedef JILLong (*NTLProcIV)(void);
+typedef JILLong (*NTLProcII)(JILLong);
+typedef JILLong (*NTLProcIII)(JILLong, JILLong);
+typedef JILFloat (*NTLProcFV)(void);
+typedef JILFloat (*NTLProcFF)(JILFloat);
+typedef JILFloat (*NTLProcFFF)(JILFloat, JILFloat);
+typedef JILFloat (*NTLProcFFFF)(JILFloat, JILFloat, JILFloat);
+typedef JILLong (*NTLMemberIV)(JILUnknown*);
+typedef JILLong (*NTLMemberII)(JILUnknown*, JILLong);
+typedef JILLong (*NTLMemberIII)(JILUnknown*, JILLong, JILLong);
+typedef JILFloat (*NTLMemberFV)(JILUnknown*);
+typedef JILFloat (*NTLMemberFF)(JILUnknown*, JILFloat);
+typedef JILFloat (*NTLMemberFFF)(JILUnknown*, JILFloat, JILFloat);
+typedef JILFloat (*NTLMemberFFFF)(JILUnknown*, JILFloat, JILFloat, JILFloat);
+
+#define ARG_INT(N)		JILGetIntHandle(ppArgs[N])->l
+#define ARG_FLOAT(N)	JILGetFloatHandle(ppArgs[N])->f
+
+void CallNTLDirect(JILState* pState, const NTLDirectCall* pCall, JILUnknown* pObj)
+{
+	JILHandle** ppArgs = JILDataStackAt(pState->vmpContext, pState->vmpContext->vmDataStackPointer);
+	switch( pCall->signature )
+	{
+		case NTL_Sig_Int_Void:
+			NTLReturnInt(pState, ((NTLProcIV) pCall->proc)());
+			break;
+		case NTL_Sig_Int_Int:
+			NTLReturnInt(pState, ((NTLProcII) pCall->proc)(ARG_INT(0)));
+			break;
+		case NTL_Sig_Int_IntInt:
+			NTLReturnInt(pState, ((NTLProcIII) pCall->proc)(ARG_INT(0), ARG_INT(1)));
+			break;
+		case NTL_Sig_Float_Void:
+			NTLReturnFloat(pState, ((NTLProcFV) pCall->proc)());
+			break;
+		case NTL_Sig_Float_Float:
+			NTLReturnFloat(pState, ((NTLProcFF) pCall->proc)(ARG_FLOAT(0)));
+			break;
+		case NTL_Sig_Float_FloatFloat:
+			NTLReturnFloat(pState, ((NTLProcFFF) pCall->proc)(ARG_FLOAT(0), ARG_FLOAT(1)));
+			break;
+		case NTL_Sig_Float_FloatFloatFloat:
+			NTLReturnFloat(pState, ((NTLProcFFFF) pCall->proc)(ARG_FLOAT(0), ARG_FLOAT(1), ARG_FLOAT(2)));
+			break;
+		case NTL_Sig_Int_Void | NTL_Sig_Member:
+			NTLReturnInt(pState, ((NTLMemberIV) pCall->proc)(pObj));
+			break;
+		case NTL_Sig_Int_Int | NTL_Sig_Member:
+			NTLReturnInt(pState, ((NTLMemberII) pCall->proc)(pObj, ARG_INT(0)));
+			break;
+		case NTL_Sig_Int_IntInt | NTL_Sig_Member:
+			NTLReturnInt(pState, ((NTLMemberIII) pCall->proc)(pObj, ARG_INT(0), ARG_INT(1)));
+			break;
+		case NTL_Sig_Float_Void | NTL_Sig_Member:
+			NTLReturnFloat(pState, ((NTLMemberFV) pCall->proc)(pObj));
+			break;
+		case NTL_Sig_Float_Float | NTL_Sig_Member:
+			NTLReturnFloat(pState, ((NTLMemberFF) pCall->proc)(pObj, ARG_FLOAT(0)));
+			break;
+		case NTL_Sig_Float_FloatFloat | NTL_Sig_Member:
+			NTLReturnFloat(pState, ((NTLMemberFFF) pCall->proc)(pObj, ARG_FLOAT(0), ARG_FLOAT(1)));
+			break;
+		case NTL_Sig_Float_FloatFloatFloat | NTL_Sig_Member:
+			NTLReturnFloat(pState, ((NTLMemberFFFF) pCall->proc)(pObj, ARG_FLOAT(0), ARG_FLOAT(1), ARG_FLOAT(2)));
+			break;
+	}
+}
+
+#undef ARG_INT
+#undef ARG_FLOAT
+
 //------------------------------------------------------------------------------
 // NTLReturnString
 //------------------------------------------------------------------------------
@@ -757,12 +850,10 @@ JILHandle* NTLNewObject(JILState* pState, JILLong type)
 	{
 		if( pTypeInfo->family == tf_class )
 		{
-			JILLong size;
 			pNewHandle = JILGetNewHandle(pState);
-			size = pTypeInfo->instanceSize;
 			// allocate object
 			pNewHandle->type = type;
-			JILGetObjectHandle(pNewHandle)->ppHandles = JILAllocObject(pState, size);
+			JILGetObjectHandle(pNewHandle)->ppHandles = JILAllocInstance(pState, pTypeInfo);
 		}
 		else if( pTypeInfo->family == tf_delegate )
 		{
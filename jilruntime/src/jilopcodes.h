@@ -535,6 +535,30 @@ enum
 	// extensions 2015-04-24
 	op_jmp,
 
+	// extensions 2026-10-16
+	op_cseqlb_rr,
+	op_cseqlb_rs,
+	op_cseqlb_sr,
+	op_csnelb_rr,
+	op_csnelb_rs,
+	op_csnelb_sr,
+	op_csgtlb_rr,
+	op_csgtlb_rs,
+	op_csgtlb_sr,
+	op_csgelb_rr,
+	op_csgelb_rs,
+	op_csgelb_sr,
+	op_csltlb_rr,
+	op_csltlb_rs,
+	op_csltlb_sr,
+	op_cslelb_rr,
+	op_cslelb_rs,
+	op_cslelb_sr,
+	op_inclb_r,
+	op_inclb_s,
+	op_pushh,
+	op_tail,
+
 	JILNumOpcodes
 };
 
@@ -0,0 +1,519 @@
+//------------------------------------------------------------------------------
+// File: JILOpDispatch.h                                       (c) 2026 jewe.org
+//------------------------------------------------------------------------------
+//
+// DISCLAIMER:
+// -----------
+//	THIS SOFTWARE IS SUBJECT TO THE LICENSE AGREEMENT FOUND IN "jilapi.h" AND
+//	"COPYING". BY USING THIS SOFTWARE YOU IMPLICITLY DECLARE YOUR AGREEMENT TO
+//	THE TERMS OF THIS LICENSE.
+//
+// Description:
+// ------------
+// The jump table for the threaded dispatch mode of JILExecuteInfinite(). This
+// file is included INSIDE the function body when JIL_USE_THREADED_DISPATCH is
+// enabled. It maps every opcode to the label generated by JIL_CASE for it.
+// JIL_NEXT does not check opcodes, JILInitVM() makes sure that all code only
+// uses valid opcodes before it runs.
+// When adding a new opcode to jilopcodes.h, add it to this table as well!
+//------------------------------------------------------------------------------
+
+	[op_nop] = &&JIL_LABEL(op_nop),
+	[op_alloc] = &&JIL_LABEL(op_alloc),
+	[op_alloca] = &&JIL_LABEL(op_alloca),
+	[op_allocn] = &&JIL_LABEL(op_allocn),
+	[op_bra] = &&JIL_LABEL(op_bra),
+	[op_brk] = &&JIL_LABEL(op_brk),
+	[op_callm] = &&JIL_LABEL(op_callm),
+	[op_calls] = &&JIL_LABEL(op_calls),
+	[op_calln] = &&JIL_LABEL(op_calln),
+	[op_cvf] = &&JIL_LABEL(op_cvf),
+	[op_cvl] = &&JIL_LABEL(op_cvl),
+	[op_popm] = &&JIL_LABEL(op_popm),
+	[op_popr] = &&JIL_LABEL(op_popr),
+	[op_pushm] = &&JIL_LABEL(op_pushm),
+	[op_pushr] = &&JIL_LABEL(op_pushr),
+	[op_ret] = &&JIL_LABEL(op_ret),
+	[op_type] = &&JIL_LABEL(op_type),
+	[op_dec_r] = &&JIL_LABEL(op_dec_r),
+	[op_dec_d] = &&JIL_LABEL(op_dec_d),
+	[op_dec_x] = &&JIL_LABEL(op_dec_x),
+	[op_dec_s] = &&JIL_LABEL(op_dec_s),
+	[op_inc_r] = &&JIL_LABEL(op_inc_r),
+	[op_inc_d] = &&JIL_LABEL(op_inc_d),
+	[op_inc_x] = &&JIL_LABEL(op_inc_x),
+	[op_inc_s] = &&JIL_LABEL(op_inc_s),
+	[op_moveh_r] = &&JIL_LABEL(op_moveh_r),
+	[op_moveh_d] = &&JIL_LABEL(op_moveh_d),
+	[op_moveh_x] = &&JIL_LABEL(op_moveh_x),
+	[op_moveh_s] = &&JIL_LABEL(op_moveh_s),
+	[op_neg_r] = &&JIL_LABEL(op_neg_r),
+	[op_neg_d] = &&JIL_LABEL(op_neg_d),
+	[op_neg_x] = &&JIL_LABEL(op_neg_x),
+	[op_neg_s] = &&JIL_LABEL(op_neg_s),
+	[op_not_r] = &&JIL_LABEL(op_not_r),
+	[op_not_d] = &&JIL_LABEL(op_not_d),
+	[op_not_x] = &&JIL_LABEL(op_not_x),
+	[op_not_s] = &&JIL_LABEL(op_not_s),
+	[op_tsteq_r] = &&JIL_LABEL(op_tsteq_r),
+	[op_tsteq_d] = &&JIL_LABEL(op_tsteq_d),
+	[op_tsteq_x] = &&JIL_LABEL(op_tsteq_x),
+	[op_tsteq_s] = &&JIL_LABEL(op_tsteq_s),
+	[op_tstne_r] = &&JIL_LABEL(op_tstne_r),
+	[op_tstne_d] = &&JIL_LABEL(op_tstne_d),
+	[op_tstne_x] = &&JIL_LABEL(op_tstne_x),
+	[op_tstne_s] = &&JIL_LABEL(op_tstne_s),
+	[op_add_rr] = &&JIL_LABEL(op_add_rr),
+	[op_add_rd] = &&JIL_LABEL(op_add_rd),
+	[op_add_rx] = &&JIL_LABEL(op_add_rx),
+	[op_add_rs] = &&JIL_LABEL(op_add_rs),
+	[op_add_dr] = &&JIL_LABEL(op_add_dr),
+	[op_add_xr] = &&JIL_LABEL(op_add_xr),
+	[op_add_sr] = &&JIL_LABEL(op_add_sr),
+	[op_and_rr] = &&JIL_LABEL(op_and_rr),
+	[op_and_rd] = &&JIL_LABEL(op_and_rd),
+	[op_and_rx] = &&JIL_LABEL(op_and_rx),
+	[op_and_rs] = &&JIL_LABEL(op_and_rs),
+	[op_and_dr] = &&JIL_LABEL(op_and_dr),
+	[op_and_xr] = &&JIL_LABEL(op_and_xr),
+	[op_and_sr] = &&JIL_LABEL(op_and_sr),
+	[op_asl_rr] = &&JIL_LABEL(op_asl_rr),
+	[op_asl_rd] = &&JIL_LABEL(op_asl_rd),
+	[op_asl_rx] = &&JIL_LABEL(op_asl_rx),
+	[op_asl_rs] = &&JIL_LABEL(op_asl_rs),
+	[op_asl_dr] = &&JIL_LABEL(op_asl_dr),
+	[op_asl_xr] = &&JIL_LABEL(op_asl_xr),
+	[op_asl_sr] = &&JIL_LABEL(op_asl_sr),
+	[op_asr_rr] = &&JIL_LABEL(op_asr_rr),
+	[op_asr_rd] = &&JIL_LABEL(op_asr_rd),
+	[op_asr_rx] = &&JIL_LABEL(op_asr_rx),
+	[op_asr_rs] = &&JIL_LABEL(op_asr_rs),
+	[op_asr_dr] = &&JIL_LABEL(op_asr_dr),
+	[op_asr_xr] = &&JIL_LABEL(op_asr_xr),
+	[op_asr_sr] = &&JIL_LABEL(op_asr_sr),
+	[op_div_rr] = &&JIL_LABEL(op_div_rr),
+	[op_div_rd] = &&JIL_LABEL(op_div_rd),
+	[op_div_rx] = &&JIL_LABEL(op_div_rx),
+	[op_div_rs] = &&JIL_LABEL(op_div_rs),
+	[op_div_dr] = &&JIL_LABEL(op_div_dr),
+	[op_div_xr] = &&JIL_LABEL(op_div_xr),
+	[op_div_sr] = &&JIL_LABEL(op_div_sr),
+	[op_lsl_rr] = &&JIL_LABEL(op_lsl_rr),
+	[op_lsl_rd] = &&JIL_LABEL(op_lsl_rd),
+	[op_lsl_rx] = &&JIL_LABEL(op_lsl_rx),
+	[op_lsl_rs] = &&JIL_LABEL(op_lsl_rs),
+	[op_lsl_dr] = &&JIL_LABEL(op_lsl_dr),
+	[op_lsl_xr] = &&JIL_LABEL(op_lsl_xr),
+	[op_lsl_sr] = &&JIL_LABEL(op_lsl_sr),
+	[op_lsr_rr] = &&JIL_LABEL(op_lsr_rr),
+	[op_lsr_rd] = &&JIL_LABEL(op_lsr_rd),
+	[op_lsr_rx] = &&JIL_LABEL(op_lsr_rx),
+	[op_lsr_rs] = &&JIL_LABEL(op_lsr_rs),
+	[op_lsr_dr] = &&JIL_LABEL(op_lsr_dr),
+	[op_lsr_xr] = &&JIL_LABEL(op_lsr_xr),
+	[op_lsr_sr] = &&JIL_LABEL(op_lsr_sr),
+	[op_mod_rr] = &&JIL_LABEL(op_mod_rr),
+	[op_mod_rd] = &&JIL_LABEL(op_mod_rd),
+	[op_mod_rx] = &&JIL_LABEL(op_mod_rx),
+	[op_mod_rs] = &&JIL_LABEL(op_mod_rs),
+	[op_mod_dr] = &&JIL_LABEL(op_mod_dr),
+	[op_mod_xr] = &&JIL_LABEL(op_mod_xr),
+	[op_mod_sr] = &&JIL_LABEL(op_mod_sr),
+	[op_mul_rr] = &&JIL_LABEL(op_mul_rr),
+	[op_mul_rd] = &&JIL_LABEL(op_mul_rd),
+	[op_mul_rx] = &&JIL_LABEL(op_mul_rx),
+	[op_mul_rs] = &&JIL_LABEL(op_mul_rs),
+	[op_mul_dr] = &&JIL_LABEL(op_mul_dr),
+	[op_mul_xr] = &&JIL_LABEL(op_mul_xr),
+	[op_mul_sr] = &&JIL_LABEL(op_mul_sr),
+	[op_or_rr] = &&JIL_LABEL(op_or_rr),
+	[op_or_rd] = &&JIL_LABEL(op_or_rd),
+	[op_or_rx] = &&JIL_LABEL(op_or_rx),
+	[op_or_rs] = &&JIL_LABEL(op_or_rs),
+	[op_or_dr] = &&JIL_LABEL(op_or_dr),
+	[op_or_xr] = &&JIL_LABEL(op_or_xr),
+	[op_or_sr] = &&JIL_LABEL(op_or_sr),
+	[op_sub_rr] = &&JIL_LABEL(op_sub_rr),
+	[op_sub_rd] = &&JIL_LABEL(op_sub_rd),
+	[op_sub_rx] = &&JIL_LABEL(op_sub_rx),
+	[op_sub_rs] = &&JIL_LABEL(op_sub_rs),
+	[op_sub_dr] = &&JIL_LABEL(op_sub_dr),
+	[op_sub_xr] = &&JIL_LABEL(op_sub_xr),
+	[op_sub_sr] = &&JIL_LABEL(op_sub_sr),
+	[op_xor_rr] = &&JIL_LABEL(op_xor_rr),
+	[op_xor_rd] = &&JIL_LABEL(op_xor_rd),
+	[op_xor_rx] = &&JIL_LABEL(op_xor_rx),
+	[op_xor_rs] = &&JIL_LABEL(op_xor_rs),
+	[op_xor_dr] = &&JIL_LABEL(op_xor_dr),
+	[op_xor_xr] = &&JIL_LABEL(op_xor_xr),
+	[op_xor_sr] = &&JIL_LABEL(op_xor_sr),
+	[op_move_rr] = &&JIL_LABEL(op_move_rr),
+	[op_move_rd] = &&JIL_LABEL(op_move_rd),
+	[op_move_rx] = &&JIL_LABEL(op_move_rx),
+	[op_move_rs] = &&JIL_LABEL(op_move_rs),
+	[op_move_dr] = &&JIL_LABEL(op_move_dr),
+	[op_move_dd] = &&JIL_LABEL(op_move_dd),
+	[op_move_dx] = &&JIL_LABEL(op_move_dx),
+	[op_move_ds] = &&JIL_LABEL(op_move_ds),
+	[op_move_xr] = &&JIL_LABEL(op_move_xr),
+	[op_move_xd] = &&JIL_LABEL(op_move_xd),
+	[op_move_xx] = &&JIL_LABEL(op_move_xx),
+	[op_move_xs] = &&JIL_LABEL(op_move_xs),
+	[op_move_sr] = &&JIL_LABEL(op_move_sr),
+	[op_move_sd] = &&JIL_LABEL(op_move_sd),
+	[op_move_sx] = &&JIL_LABEL(op_move_sx),
+	[op_move_ss] = &&JIL_LABEL(op_move_ss),
+	[op_ldz_r] = &&JIL_LABEL(op_ldz_r),
+	[op_copy_rr] = &&JIL_LABEL(op_copy_rr),
+	[op_copy_rd] = &&JIL_LABEL(op_copy_rd),
+	[op_copy_rx] = &&JIL_LABEL(op_copy_rx),
+	[op_copy_rs] = &&JIL_LABEL(op_copy_rs),
+	[op_copy_dr] = &&JIL_LABEL(op_copy_dr),
+	[op_copy_dd] = &&JIL_LABEL(op_copy_dd),
+	[op_copy_dx] = &&JIL_LABEL(op_copy_dx),
+	[op_copy_ds] = &&JIL_LABEL(op_copy_ds),
+	[op_copy_xr] = &&JIL_LABEL(op_copy_xr),
+	[op_copy_xd] = &&JIL_LABEL(op_copy_xd),
+	[op_copy_xx] = &&JIL_LABEL(op_copy_xx),
+	[op_copy_xs] = &&JIL_LABEL(op_copy_xs),
+	[op_copy_sr] = &&JIL_LABEL(op_copy_sr),
+	[op_copy_sd] = &&JIL_LABEL(op_copy_sd),
+	[op_copy_sx] = &&JIL_LABEL(op_copy_sx),
+	[op_copy_ss] = &&JIL_LABEL(op_copy_ss),
+	[op_pop_r] = &&JIL_LABEL(op_pop_r),
+	[op_pop_d] = &&JIL_LABEL(op_pop_d),
+	[op_pop_x] = &&JIL_LABEL(op_pop_x),
+	[op_pop_s] = &&JIL_LABEL(op_pop_s),
+	[op_push_r] = &&JIL_LABEL(op_push_r),
+	[op_push_d] = &&JIL_LABEL(op_push_d),
+	[op_push_x] = &&JIL_LABEL(op_push_x),
+	[op_push_s] = &&JIL_LABEL(op_push_s),
+	[op_copyh_r] = &&JIL_LABEL(op_copyh_r),
+	[op_copyh_d] = &&JIL_LABEL(op_copyh_d),
+	[op_copyh_x] = &&JIL_LABEL(op_copyh_x),
+	[op_copyh_s] = &&JIL_LABEL(op_copyh_s),
+	[op_cseq_rr] = &&JIL_LABEL(op_cseq_rr),
+	[op_cseq_rd] = &&JIL_LABEL(op_cseq_rd),
+	[op_cseq_rx] = &&JIL_LABEL(op_cseq_rx),
+	[op_cseq_rs] = &&JIL_LABEL(op_cseq_rs),
+	[op_cseq_dr] = &&JIL_LABEL(op_cseq_dr),
+	[op_cseq_xr] = &&JIL_LABEL(op_cseq_xr),
+	[op_cseq_sr] = &&JIL_LABEL(op_cseq_sr),
+	[op_csne_rr] = &&JIL_LABEL(op_csne_rr),
+	[op_csne_rd] = &&JIL_LABEL(op_csne_rd),
+	[op_csne_rx] = &&JIL_LABEL(op_csne_rx),
+	[op_csne_rs] = &&JIL_LABEL(op_csne_rs),
+	[op_csne_dr] = &&JIL_LABEL(op_csne_dr),
+	[op_csne_xr] = &&JIL_LABEL(op_csne_xr),
+	[op_csne_sr] = &&JIL_LABEL(op_csne_sr),
+	[op_csgt_rr] = &&JIL_LABEL(op_csgt_rr),
+	[op_csgt_rd] = &&JIL_LABEL(op_csgt_rd),
+	[op_csgt_rx] = &&JIL_LABEL(op_csgt_rx),
+	[op_csgt_rs] = &&JIL_LABEL(op_csgt_rs),
+	[op_csgt_dr] = &&JIL_LABEL(op_csgt_dr),
+	[op_csgt_xr] = &&JIL_LABEL(op_csgt_xr),
+	[op_csgt_sr] = &&JIL_LABEL(op_csgt_sr),
+	[op_csge_rr] = &&JIL_LABEL(op_csge_rr),
+	[op_csge_rd] = &&JIL_LABEL(op_csge_rd),
+	[op_csge_rx] = &&JIL_LABEL(op_csge_rx),
+	[op_csge_rs] = &&JIL_LABEL(op_csge_rs),
+	[op_csge_dr] = &&JIL_LABEL(op_csge_dr),
+	[op_csge_xr] = &&JIL_LABEL(op_csge_xr),
+	[op_csge_sr] = &&JIL_LABEL(op_csge_sr),
+	[op_cslt_rr] = &&JIL_LABEL(op_cslt_rr),
+	[op_cslt_rd] = &&JIL_LABEL(op_cslt_rd),
+	[op_cslt_rx] = &&JIL_LABEL(op_cslt_rx),
+	[op_cslt_rs] = &&JIL_LABEL(op_cslt_rs),
+	[op_cslt_dr] = &&JIL_LABEL(op_cslt_dr),
+	[op_cslt_xr] = &&JIL_LABEL(op_cslt_xr),
+	[op_cslt_sr] = &&JIL_LABEL(op_cslt_sr),
+	[op_csle_rr] = &&JIL_LABEL(op_csle_rr),
+	[op_csle_rd] = &&JIL_LABEL(op_csle_rd),
+	[op_csle_rx] = &&JIL_LABEL(op_csle_rx),
+	[op_csle_rs] = &&JIL_LABEL(op_csle_rs),
+	[op_csle_dr] = &&JIL_LABEL(op_csle_dr),
+	[op_csle_xr] = &&JIL_LABEL(op_csle_xr),
+	[op_csle_sr] = &&JIL_LABEL(op_csle_sr),
+	[op_snul_rr] = &&JIL_LABEL(op_snul_rr),
+	[op_snnul_rr] = &&JIL_LABEL(op_snnul_rr),
+	[op_unot_r] = &&JIL_LABEL(op_unot_r),
+	[op_unot_d] = &&JIL_LABEL(op_unot_d),
+	[op_unot_x] = &&JIL_LABEL(op_unot_x),
+	[op_unot_s] = &&JIL_LABEL(op_unot_s),
+	[op_streq_rr] = &&JIL_LABEL(op_streq_rr),
+	[op_streq_rd] = &&JIL_LABEL(op_streq_rd),
+	[op_streq_rx] = &&JIL_LABEL(op_streq_rx),
+	[op_streq_rs] = &&JIL_LABEL(op_streq_rs),
+	[op_streq_dr] = &&JIL_LABEL(op_streq_dr),
+	[op_streq_xr] = &&JIL_LABEL(op_streq_xr),
+	[op_streq_sr] = &&JIL_LABEL(op_streq_sr),
+	[op_strne_rr] = &&JIL_LABEL(op_strne_rr),
+	[op_strne_rd] = &&JIL_LABEL(op_strne_rd),
+	[op_strne_rx] = &&JIL_LABEL(op_strne_rx),
+	[op_strne_rs] = &&JIL_LABEL(op_strne_rs),
+	[op_strne_dr] = &&JIL_LABEL(op_strne_dr),
+	[op_strne_xr] = &&JIL_LABEL(op_strne_xr),
+	[op_strne_sr] = &&JIL_LABEL(op_strne_sr),
+	[op_stradd_rr] = &&JIL_LABEL(op_stradd_rr),
+	[op_stradd_rd] = &&JIL_LABEL(op_stradd_rd),
+	[op_stradd_rx] = &&JIL_LABEL(op_stradd_rx),
+	[op_stradd_rs] = &&JIL_LABEL(op_stradd_rs),
+	[op_stradd_dr] = &&JIL_LABEL(op_stradd_dr),
+	[op_stradd_xr] = &&JIL_LABEL(op_stradd_xr),
+	[op_stradd_sr] = &&JIL_LABEL(op_stradd_sr),
+	[op_arrcp_rr] = &&JIL_LABEL(op_arrcp_rr),
+	[op_arrcp_rd] = &&JIL_LABEL(op_arrcp_rd),
+	[op_arrcp_rx] = &&JIL_LABEL(op_arrcp_rx),
+	[op_arrcp_rs] = &&JIL_LABEL(op_arrcp_rs),
+	[op_arrcp_dr] = &&JIL_LABEL(op_arrcp_dr),
+	[op_arrcp_xr] = &&JIL_LABEL(op_arrcp_xr),
+	[op_arrcp_sr] = &&JIL_LABEL(op_arrcp_sr),
+	[op_arrmv_rr] = &&JIL_LABEL(op_arrmv_rr),
+	[op_arrmv_rd] = &&JIL_LABEL(op_arrmv_rd),
+	[op_arrmv_rx] = &&JIL_LABEL(op_arrmv_rx),
+	[op_arrmv_rs] = &&JIL_LABEL(op_arrmv_rs),
+	[op_arrmv_dr] = &&JIL_LABEL(op_arrmv_dr),
+	[op_arrmv_xr] = &&JIL_LABEL(op_arrmv_xr),
+	[op_arrmv_sr] = &&JIL_LABEL(op_arrmv_sr),
+	[op_addl_rr] = &&JIL_LABEL(op_addl_rr),
+	[op_addl_rd] = &&JIL_LABEL(op_addl_rd),
+	[op_addl_rx] = &&JIL_LABEL(op_addl_rx),
+	[op_addl_rs] = &&JIL_LABEL(op_addl_rs),
+	[op_addl_dr] = &&JIL_LABEL(op_addl_dr),
+	[op_addl_xr] = &&JIL_LABEL(op_addl_xr),
+	[op_addl_sr] = &&JIL_LABEL(op_addl_sr),
+	[op_subl_rr] = &&JIL_LABEL(op_subl_rr),
+	[op_subl_rd] = &&JIL_LABEL(op_subl_rd),
+	[op_subl_rx] = &&JIL_LABEL(op_subl_rx),
+	[op_subl_rs] = &&JIL_LABEL(op_subl_rs),
+	[op_subl_dr] = &&JIL_LABEL(op_subl_dr),
+	[op_subl_xr] = &&JIL_LABEL(op_subl_xr),
+	[op_subl_sr] = &&JIL_LABEL(op_subl_sr),
+	[op_mull_rr] = &&JIL_LABEL(op_mull_rr),
+	[op_mull_rd] = &&JIL_LABEL(op_mull_rd),
+	[op_mull_rx] = &&JIL_LABEL(op_mull_rx),
+	[op_mull_rs] = &&JIL_LABEL(op_mull_rs),
+	[op_mull_dr] = &&JIL_LABEL(op_mull_dr),
+	[op_mull_xr] = &&JIL_LABEL(op_mull_xr),
+	[op_mull_sr] = &&JIL_LABEL(op_mull_sr),
+	[op_divl_rr] = &&JIL_LABEL(op_divl_rr),
+	[op_divl_rd] = &&JIL_LABEL(op_divl_rd),
+	[op_divl_rx] = &&JIL_LABEL(op_divl_rx),
+	[op_divl_rs] = &&JIL_LABEL(op_divl_rs),
+	[op_divl_dr] = &&JIL_LABEL(op_divl_dr),
+	[op_divl_xr] = &&JIL_LABEL(op_divl_xr),
+	[op_divl_sr] = &&JIL_LABEL(op_divl_sr),
+	[op_modl_rr] = &&JIL_LABEL(op_modl_rr),
+	[op_modl_rd] = &&JIL_LABEL(op_modl_rd),
+	[op_modl_rx] = &&JIL_LABEL(op_modl_rx),
+	[op_modl_rs] = &&JIL_LABEL(op_modl_rs),
+	[op_modl_dr] = &&JIL_LABEL(op_modl_dr),
+	[op_modl_xr] = &&JIL_LABEL(op_modl_xr),
+	[op_modl_sr] = &&JIL_LABEL(op_modl_sr),
+	[op_decl_r] = &&JIL_LABEL(op_decl_r),
+	[op_decl_d] = &&JIL_LABEL(op_decl_d),
+	[op_decl_x] = &&JIL_LABEL(op_decl_x),
+	[op_decl_s] = &&JIL_LABEL(op_decl_s),
+	[op_incl_r] = &&JIL_LABEL(op_incl_r),
+	[op_incl_d] = &&JIL_LABEL(op_incl_d),
+	[op_incl_x] = &&JIL_LABEL(op_incl_x),
+	[op_incl_s] = &&JIL_LABEL(op_incl_s),
+	[op_negl_r] = &&JIL_LABEL(op_negl_r),
+	[op_negl_d] = &&JIL_LABEL(op_negl_d),
+	[op_negl_x] = &&JIL_LABEL(op_negl_x),
+	[op_negl_s] = &&JIL_LABEL(op_negl_s),
+	[op_cseql_rr] = &&JIL_LABEL(op_cseql_rr),
+	[op_cseql_rd] = &&JIL_LABEL(op_cseql_rd),
+	[op_cseql_rx] = &&JIL_LABEL(op_cseql_rx),
+	[op_cseql_rs] = &&JIL_LABEL(op_cseql_rs),
+	[op_cseql_dr] = &&JIL_LABEL(op_cseql_dr),
+	[op_cseql_xr] = &&JIL_LABEL(op_cseql_xr),
+	[op_cseql_sr] = &&JIL_LABEL(op_cseql_sr),
+	[op_csnel_rr] = &&JIL_LABEL(op_csnel_rr),
+	[op_csnel_rd] = &&JIL_LABEL(op_csnel_rd),
+	[op_csnel_rx] = &&JIL_LABEL(op_csnel_rx),
+	[op_csnel_rs] = &&JIL_LABEL(op_csnel_rs),
+	[op_csnel_dr] = &&JIL_LABEL(op_csnel_dr),
+	[op_csnel_xr] = &&JIL_LABEL(op_csnel_xr),
+	[op_csnel_sr] = &&JIL_LABEL(op_csnel_sr),
+	[op_csgtl_rr] = &&JIL_LABEL(op_csgtl_rr),
+	[op_csgtl_rd] = &&JIL_LABEL(op_csgtl_rd),
+	[op_csgtl_rx] = &&JIL_LABEL(op_csgtl_rx),
+	[op_csgtl_rs] = &&JIL_LABEL(op_csgtl_rs),
+	[op_csgtl_dr] = &&JIL_LABEL(op_csgtl_dr),
+	[op_csgtl_xr] = &&JIL_LABEL(op_csgtl_xr),
+	[op_csgtl_sr] = &&JIL_LABEL(op_csgtl_sr),
+	[op_csgel_rr] = &&JIL_LABEL(op_csgel_rr),
+	[op_csgel_rd] = &&JIL_LABEL(op_csgel_rd),
+	[op_csgel_rx] = &&JIL_LABEL(op_csgel_rx),
+	[op_csgel_rs] = &&JIL_LABEL(op_csgel_rs),
+	[op_csgel_dr] = &&JIL_LABEL(op_csgel_dr),
+	[op_csgel_xr] = &&JIL_LABEL(op_csgel_xr),
+	[op_csgel_sr] = &&JIL_LABEL(op_csgel_sr),
+	[op_csltl_rr] = &&JIL_LABEL(op_csltl_rr),
+	[op_csltl_rd] = &&JIL_LABEL(op_csltl_rd),
+	[op_csltl_rx] = &&JIL_LABEL(op_csltl_rx),
+	[op_csltl_rs] = &&JIL_LABEL(op_csltl_rs),
+	[op_csltl_dr] = &&JIL_LABEL(op_csltl_dr),
+	[op_csltl_xr] = &&JIL_LABEL(op_csltl_xr),
+	[op_csltl_sr] = &&JIL_LABEL(op_csltl_sr),
+	[op_cslel_rr] = &&JIL_LABEL(op_cslel_rr),
+	[op_cslel_rd] = &&JIL_LABEL(op_cslel_rd),
+	[op_cslel_rx] = &&JIL_LABEL(op_cslel_rx),
+	[op_cslel_rs] = &&JIL_LABEL(op_cslel_rs),
+	[op_cslel_dr] = &&JIL_LABEL(op_cslel_dr),
+	[op_cslel_xr] = &&JIL_LABEL(op_cslel_xr),
+	[op_cslel_sr] = &&JIL_LABEL(op_cslel_sr),
+	[op_addf_rr] = &&JIL_LABEL(op_addf_rr),
+	[op_addf_rd] = &&JIL_LABEL(op_addf_rd),
+	[op_addf_rx] = &&JIL_LABEL(op_addf_rx),
+	[op_addf_rs] = &&JIL_LABEL(op_addf_rs),
+	[op_addf_dr] = &&JIL_LABEL(op_addf_dr),
+	[op_addf_xr] = &&JIL_LABEL(op_addf_xr),
+	[op_addf_sr] = &&JIL_LABEL(op_addf_sr),
+	[op_subf_rr] = &&JIL_LABEL(op_subf_rr),
+	[op_subf_rd] = &&JIL_LABEL(op_subf_rd),
+	[op_subf_rx] = &&JIL_LABEL(op_subf_rx),
+	[op_subf_rs] = &&JIL_LABEL(op_subf_rs),
+	[op_subf_dr] = &&JIL_LABEL(op_subf_dr),
+	[op_subf_xr] = &&JIL_LABEL(op_subf_xr),
+	[op_subf_sr] = &&JIL_LABEL(op_subf_sr),
+	[op_mulf_rr] = &&JIL_LABEL(op_mulf_rr),
+	[op_mulf_rd] = &&JIL_LABEL(op_mulf_rd),
+	[op_mulf_rx] = &&JIL_LABEL(op_mulf_rx),
+	[op_mulf_rs] = &&JIL_LABEL(op_mulf_rs),
+	[op_mulf_dr] = &&JIL_LABEL(op_mulf_dr),
+	[op_mulf_xr] = &&JIL_LABEL(op_mulf_xr),
+	[op_mulf_sr] = &&JIL_LABEL(op_mulf_sr),
+	[op_divf_rr] = &&JIL_LABEL(op_divf_rr),
+	[op_divf_rd] = &&JIL_LABEL(op_divf_rd),
+	[op_divf_rx] = &&JIL_LABEL(op_divf_rx),
+	[op_divf_rs] = &&JIL_LABEL(op_divf_rs),
+	[op_divf_dr] = &&JIL_LABEL(op_divf_dr),
+	[op_divf_xr] = &&JIL_LABEL(op_divf_xr),
+	[op_divf_sr] = &&JIL_LABEL(op_divf_sr),
+	[op_modf_rr] = &&JIL_LABEL(op_modf_rr),
+	[op_modf_rd] = &&JIL_LABEL(op_modf_rd),
+	[op_modf_rx] = &&JIL_LABEL(op_modf_rx),
+	[op_modf_rs] = &&JIL_LABEL(op_modf_rs),
+	[op_modf_dr] = &&JIL_LABEL(op_modf_dr),
+	[op_modf_xr] = &&JIL_LABEL(op_modf_xr),
+	[op_modf_sr] = &&JIL_LABEL(op_modf_sr),
+	[op_decf_r] = &&JIL_LABEL(op_decf_r),
+	[op_decf_d] = &&JIL_LABEL(op_decf_d),
+	[op_decf_x] = &&JIL_LABEL(op_decf_x),
+	[op_decf_s] = &&JIL_LABEL(op_decf_s),
+	[op_incf_r] = &&JIL_LABEL(op_incf_r),
+	[op_incf_d] = &&JIL_LABEL(op_incf_d),
+	[op_incf_x] = &&JIL_LABEL(op_incf_x),
+	[op_incf_s] = &&JIL_LABEL(op_incf_s),
+	[op_negf_r] = &&JIL_LABEL(op_negf_r),
+	[op_negf_d] = &&JIL_LABEL(op_negf_d),
+	[op_negf_x] = &&JIL_LABEL(op_negf_x),
+	[op_negf_s] = &&JIL_LABEL(op_negf_s),
+	[op_cseqf_rr] = &&JIL_LABEL(op_cseqf_rr),
+	[op_cseqf_rd] = &&JIL_LABEL(op_cseqf_rd),
+	[op_cseqf_rx] = &&JIL_LABEL(op_cseqf_rx),
+	[op_cseqf_rs] = &&JIL_LABEL(op_cseqf_rs),
+	[op_cseqf_dr] = &&JIL_LABEL(op_cseqf_dr),
+	[op_cseqf_xr] = &&JIL_LABEL(op_cseqf_xr),
+	[op_cseqf_sr] = &&JIL_LABEL(op_cseqf_sr),
+	[op_csnef_rr] = &&JIL_LABEL(op_csnef_rr),
+	[op_csnef_rd] = &&JIL_LABEL(op_csnef_rd),
+	[op_csnef_rx] = &&JIL_LABEL(op_csnef_rx),
+	[op_csnef_rs] = &&JIL_LABEL(op_csnef_rs),
+	[op_csnef_dr] = &&JIL_LABEL(op_csnef_dr),
+	[op_csnef_xr] = &&JIL_LABEL(op_csnef_xr),
+	[op_csnef_sr] = &&JIL_LABEL(op_csnef_sr),
+	[op_csgtf_rr] = &&JIL_LABEL(op_csgtf_rr),
+	[op_csgtf_rd] = &&JIL_LABEL(op_csgtf_rd),
+	[op_csgtf_rx] = &&JIL_LABEL(op_csgtf_rx),
+	[op_csgtf_rs] = &&JIL_LABEL(op_csgtf_rs),
+	[op_csgtf_dr] = &&JIL_LABEL(op_csgtf_dr),
+	[op_csgtf_xr] = &&JIL_LABEL(op_csgtf_xr),
+	[op_csgtf_sr] = &&JIL_LABEL(op_csgtf_sr),
+	[op_csgef_rr] = &&JIL_LABEL(op_csgef_rr),
+	[op_csgef_rd] = &&JIL_LABEL(op_csgef_rd),
+	[op_csgef_rx] = &&JIL_LABEL(op_csgef_rx),
+	[op_csgef_rs] = &&JIL_LABEL(op_csgef_rs),
+	[op_csgef_dr] = &&JIL_LABEL(op_csgef_dr),
+	[op_csgef_xr] = &&JIL_LABEL(op_csgef_xr),
+	[op_csgef_sr] = &&JIL_LABEL(op_csgef_sr),
+	[op_csltf_rr] = &&JIL_LABEL(op_csltf_rr),
+	[op_csltf_rd] = &&JIL_LABEL(op_csltf_rd),
+	[op_csltf_rx] = &&JIL_LABEL(op_csltf_rx),
+	[op_csltf_rs] = &&JIL_LABEL(op_csltf_rs),
+	[op_csltf_dr] = &&JIL_LABEL(op_csltf_dr),
+	[op_csltf_xr] = &&JIL_LABEL(op_csltf_xr),
+	[op_csltf_sr] = &&JIL_LABEL(op_csltf_sr),
+	[op_cslef_rr] = &&JIL_LABEL(op_cslef_rr),
+	[op_cslef_rd] = &&JIL_LABEL(op_cslef_rd),
+	[op_cslef_rx] = &&JIL_LABEL(op_cslef_rx),
+	[op_cslef_rs] = &&JIL_LABEL(op_cslef_rs),
+	[op_cslef_dr] = &&JIL_LABEL(op_cslef_dr),
+	[op_cslef_xr] = &&JIL_LABEL(op_cslef_xr),
+	[op_cslef_sr] = &&JIL_LABEL(op_cslef_sr),
+	[op_pop] = &&JIL_LABEL(op_pop),
+	[op_push] = &&JIL_LABEL(op_push),
+	[op_rtchk_r] = &&JIL_LABEL(op_rtchk_r),
+	[op_rtchk_d] = &&JIL_LABEL(op_rtchk_d),
+	[op_rtchk_x] = &&JIL_LABEL(op_rtchk_x),
+	[op_rtchk_s] = &&JIL_LABEL(op_rtchk_s),
+	[op_jsr] = &&JIL_LABEL(op_jsr),
+	[op_newctx] = &&JIL_LABEL(op_newctx),
+	[op_resume_r] = &&JIL_LABEL(op_resume_r),
+	[op_resume_d] = &&JIL_LABEL(op_resume_d),
+	[op_resume_x] = &&JIL_LABEL(op_resume_x),
+	[op_resume_s] = &&JIL_LABEL(op_resume_s),
+	[op_yield] = &&JIL_LABEL(op_yield),
+	[op_wref_rr] = &&JIL_LABEL(op_wref_rr),
+	[op_wref_rd] = &&JIL_LABEL(op_wref_rd),
+	[op_wref_rx] = &&JIL_LABEL(op_wref_rx),
+	[op_wref_rs] = &&JIL_LABEL(op_wref_rs),
+	[op_wref_dr] = &&JIL_LABEL(op_wref_dr),
+	[op_wref_dd] = &&JIL_LABEL(op_wref_dd),
+	[op_wref_dx] = &&JIL_LABEL(op_wref_dx),
+	[op_wref_ds] = &&JIL_LABEL(op_wref_ds),
+	[op_wref_xr] = &&JIL_LABEL(op_wref_xr),
+	[op_wref_xd] = &&JIL_LABEL(op_wref_xd),
+	[op_wref_xx] = &&JIL_LABEL(op_wref_xx),
+	[op_wref_xs] = &&JIL_LABEL(op_wref_xs),
+	[op_wref_sr] = &&JIL_LABEL(op_wref_sr),
+	[op_wref_sd] = &&JIL_LABEL(op_wref_sd),
+	[op_wref_sx] = &&JIL_LABEL(op_wref_sx),
+	[op_wref_ss] = &&JIL_LABEL(op_wref_ss),
+	[op_cmpref_rr] = &&JIL_LABEL(op_cmpref_rr),
+	[op_newdg] = &&JIL_LABEL(op_newdg),
+	[op_newdgm] = &&JIL_LABEL(op_newdgm),
+	[op_calldg_r] = &&JIL_LABEL(op_calldg_r),
+	[op_calldg_d] = &&JIL_LABEL(op_calldg_d),
+	[op_calldg_x] = &&JIL_LABEL(op_calldg_x),
+	[op_calldg_s] = &&JIL_LABEL(op_calldg_s),
+	[op_throw] = &&JIL_LABEL(op_throw),
+	[op_alloci] = &&JIL_LABEL(op_alloci),
+	[op_calli] = &&JIL_LABEL(op_calli),
+	[op_dcvt] = &&JIL_LABEL(op_dcvt),
+	[op_newdgc] = &&JIL_LABEL(op_newdgc),
+	[op_jmp] = &&JIL_LABEL(op_jmp),
+	[op_cseqlb_rr] = &&JIL_LABEL(op_cseqlb_rr),
+	[op_cseqlb_rs] = &&JIL_LABEL(op_cseqlb_rs),
+	[op_cseqlb_sr] = &&JIL_LABEL(op_cseqlb_sr),
+	[op_csnelb_rr] = &&JIL_LABEL(op_csnelb_rr),
+	[op_csnelb_rs] = &&JIL_LABEL(op_csnelb_rs),
+	[op_csnelb_sr] = &&JIL_LABEL(op_csnelb_sr),
+	[op_csgtlb_rr] = &&JIL_LABEL(op_csgtlb_rr),
+	[op_csgtlb_rs] = &&JIL_LABEL(op_csgtlb_rs),
+	[op_csgtlb_sr] = &&JIL_LABEL(op_csgtlb_sr),
+	[op_csgelb_rr] = &&JIL_LABEL(op_csgelb_rr),
+	[op_csgelb_rs] = &&JIL_LABEL(op_csgelb_rs),
+	[op_csgelb_sr] = &&JIL_LABEL(op_csgelb_sr),
+	[op_csltlb_rr] = &&JIL_LABEL(op_csltlb_rr),
+	[op_csltlb_rs] = &&JIL_LABEL(op_csltlb_rs),
+	[op_csltlb_sr] = &&JIL_LABEL(op_csltlb_sr),
+	[op_cslelb_rr] = &&JIL_LABEL(op_cslelb_rr),
+	[op_cslelb_rs] = &&JIL_LABEL(op_cslelb_rs),
+	[op_cslelb_sr] = &&JIL_LABEL(op_cslelb_sr),
+	[op_inclb_r] = &&JIL_LABEL(op_inclb_r),
+	[op_inclb_s] = &&JIL_LABEL(op_inclb_s),
+	[op_pushh] = &&JIL_LABEL(op_pushh),
+	[op_tail] = &&JIL_LABEL(op_tail),
@@ -72,19 +72,86 @@
 //------------------------------------------------------------------------------
 // Load effective address of a handle. Addressing mode 'd(sp)'.
 
-#define JIL_LEA_S(CONTEXT, OUTEA) (OUTEA) = CONTEXT->vmppDataStack + (CONTEXT->vmDataStackPointer + (*pInstruction++));
+#define JIL_LEA_S(CONTEXT, OUTEA) (OUTEA) = JILDataStackAt(CONTEXT, CONTEXT->vmDataStackPointer + (*pInstruction++));
+
+//------------------------------------------------------------------------------
+// JIL_LEA_x_SAVE, JIL_LEA_x_RESTORE
+//------------------------------------------------------------------------------
+// The data stack can be reallocated while script code is called from within an
+// instruction, for example by a copy constructor. Instructions that keep an
+// effective address across such a call save it with JIL_LEA_x_SAVE and
+// restore it afterwards with JIL_LEA_x_RESTORE, where 'x' is the addressing
+// mode. Only the 'd(sp)' mode needs to do anything, registers and members of
+// objects do not move.
+
+#define JIL_LEA_R_SAVE(CONTEXT, EA)
+#define JIL_LEA_R_RESTORE(CONTEXT, EA)
+#define JIL_LEA_D_SAVE(CONTEXT, EA)
+#define JIL_LEA_D_RESTORE(CONTEXT, EA)
+#define JIL_LEA_X_SAVE(CONTEXT, EA)
+#define JIL_LEA_X_RESTORE(CONTEXT, EA)
+#define JIL_LEA_S_SAVE(CONTEXT, EA)		offs = (JILLong) ((EA) - CONTEXT->vmppDataStack) + CONTEXT->vmDataStackLimit;
+#define JIL_LEA_S_RESTORE(CONTEXT, EA)	(EA) = JILDataStackAt(CONTEXT, offs);
 
 //------------------------------------------------------------------------------
 // JIL_STORE_HANDLE
 //------------------------------------------------------------------------------
 // Stores a handle in a variable or register and takes care about the correct
-// reference counting.
+// reference counting. Releasing the old value also executes the write barrier
+// of the incremental garbage collector, see JIL_GC_BARRIER.
 
 #define JIL_STORE_HANDLE(STATE, PPVAR, POBJ) \
 	JILAddRef( POBJ );\
 	JILRelease( STATE, *PPVAR );\
 	*PPVAR = POBJ;
 
+//------------------------------------------------------------------------------
+// JIL_STORE_INT
+//------------------------------------------------------------------------------
+// Stores an int value in a variable or register. If the variable holds the
+// only reference to an int or float handle, the value is written directly into
+// that handle, otherwise a new handle is taken from the handle pool. Since no
+// one else can see the old value, the effect is the same as storing a new
+// handle, but without the handle allocation and reference counting. See
+// JIL_USE_HANDLE_REUSE.
+
+#define JIL_STORE_INT(STATE, PPVAR, VALUE) \
+	pValue = *(PPVAR);\
+	if( JIL_USE_HANDLE_REUSE && pValue->refCount == 1 && (pValue->type == type_int || pValue->type == type_float) )\
+	{\
+		pValue->type = type_int;\
+		JILGetIntHandle(pValue)->l = (VALUE);\
+	}\
+	else\
+	{\
+		pValue = JILGetNewHandle(STATE);\
+		pValue->type = type_int;\
+		JILGetIntHandle(pValue)->l = (VALUE);\
+		JILRelease(STATE, *(PPVAR));\
+		*(PPVAR) = pValue;\
+	}
+
+//------------------------------------------------------------------------------
+// JIL_STORE_FLOAT
+//------------------------------------------------------------------------------
+// Stores a float value in a variable or register, see JIL_STORE_INT.
+
+#define JIL_STORE_FLOAT(STATE, PPVAR, VALUE) \
+	pValue = *(PPVAR);\
+	if( JIL_USE_HANDLE_REUSE && pValue->refCount == 1 && (pValue->type == type_int || pValue->type == type_float) )\
+	{\
+		pValue->type = type_float;\
+		JILGetFloatHandle(pValue)->f = (VALUE);\
+	}\
+	else\
+	{\
+		pValue = JILGetNewHandle(STATE);\
+		pValue->type = type_float;\
+		JILGetFloatHandle(pValue)->f = (VALUE);\
+		JILRelease(STATE, *(PPVAR));\
+		*(PPVAR) = pValue;\
+	}
+
 //------------------------------------------------------------------------------
 // JIL_THROW_IF
 //------------------------------------------------------------------------------
@@ -113,7 +180,7 @@
 // be done as the last thing, if the instruction was successful (no exception
 // thrown!) and the program counter was not set (no branch instruction!).
 
-#define JIL_IEND programCounter += instruction_size; break;
+#define JIL_IEND programCounter += instruction_size; JIL_NEXT
 
 //------------------------------------------------------------------------------
 // JIL_IENDBR
@@ -121,7 +188,154 @@
 // This must be done to correct the instruction read pointer at the end of a
 // branch instruction (but only if it really branches)!
 
-#define JIL_IENDBR pInstruction = pCodeSegment + programCounter; break;
+#define JIL_IENDBR pInstruction = pCodeSegment + programCounter; JIL_NEXT
+
+//------------------------------------------------------------------------------
+// JIL_IPROLOGUE
+//------------------------------------------------------------------------------
+// Executed before every instruction is dispatched: Generates the TRACE
+// exception, if enabled, and increments the instruction counter.
+
+#if defined(_DEBUG) || JIL_TRACE_RELEASE
+#define JIL_IPROLOGUE_TRACE \
+	if( pState->vmTraceFlag )\
+	{\
+		pState->errProgramCounter = pContext->vmProgramCounter = programCounter;\
+		if( (result = JILGenerateException(pState, JIL_VM_Trace_Exception)) )\
+			goto terminate;\
+	}
+#else
+#define JIL_IPROLOGUE_TRACE
+#endif
+
+#if JIL_USE_INSTRUCTION_COUNTER
+#define JIL_IPROLOGUE_COUNT	pState->vmInstructionCounter++;
+#else
+#define JIL_IPROLOGUE_COUNT
+#endif
+
+#if JIL_USE_OPCODE_PROFILING
+#define JIL_IPROLOGUE_PROFILE \
+	if( *pInstruction >= 0 && *pInstruction < JILNumOpcodes ) {\
+		pState->vmpOpcodePairs[lastOpcode * JILNumOpcodes + *pInstruction]++;\
+		lastOpcode = *pInstruction;\
+	}
+#else
+#define JIL_IPROLOGUE_PROFILE
+#endif
+
+#define JIL_IPROLOGUE	JIL_IPROLOGUE_TRACE JIL_IPROLOGUE_COUNT JIL_IPROLOGUE_PROFILE
+
+//------------------------------------------------------------------------------
+// JIL_CASE / JIL_DEFAULT / JIL_NEXT
+//------------------------------------------------------------------------------
+// JIL_CASE begins the procedure of an instruction, JIL_DEFAULT begins the
+// procedure for illegal instructions, JIL_NEXT continues with the next
+// instruction. In the default (switch) dispatch mode, these are case labels
+// and a break statement. In threaded dispatch mode, every instruction
+// procedure jumps directly to the procedure of the next instruction through
+// the jump table defined in jilopdispatch.h. Opcodes are not checked here,
+// JILInitVM() rejects code with invalid opcodes before it runs, so the
+// illegal instruction handler is only reachable in switch mode.
+
+#if JIL_USE_THREADED_DISPATCH
+#define JIL_LABEL(OP)	jil_label_##OP
+#define JIL_CASE(OP)	JIL_LABEL(OP):
+#define JIL_DEFAULT		JIL_LABEL(op_illegal): __attribute__((unused));
+#define JIL_NEXT		JIL_IPROLOGUE pInstruction++; goto *pDispatchTable[pInstruction[-1]];
+#else
+#define JIL_CASE(OP)	case OP:
+#define JIL_DEFAULT		default:
+#define JIL_NEXT		break;
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_QUICKEN
+//------------------------------------------------------------------------------
+// Used by generic arithmetic instructions to report the operand types they
+// have seen, so they can be quickened. See JIL_USE_QUICKENING.
+
+#if JIL_USE_QUICKENING
+#define JIL_QUICKEN(T1,T2) \
+	if( programCounter < pState->vmQuickInfoSize && !(pState->vmpQuickInfo[programCounter] & kQuickNever) )\
+		JILQuickenInstruction(pState, programCounter, T1, T2);
+#else
+#define JIL_QUICKEN(T1,T2)
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_QUICKGUARD
+//------------------------------------------------------------------------------
+// Used by int and float instructions. If the condition is true, the operands
+// don't have the expected type. If the instruction has been quickened, it is
+// reverted to its generic form and executed again. Instructions emitted by the
+// compiler are left alone, their operand types are known to be correct.
+
+#if JIL_USE_QUICKENING
+#define JIL_QUICKGUARD(CONDITION) \
+	if( (CONDITION) && programCounter < pState->vmQuickInfoSize && (pState->vmpQuickInfo[programCounter] & kQuickDone) ) {\
+		JILDequickenInstruction(pState, programCounter);\
+		JIL_IENDBR\
+	}
+#else
+#define JIL_QUICKGUARD(CONDITION)
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_GC_SAFEPOINT
+//------------------------------------------------------------------------------
+// Takes a step of the incremental garbage collector, if a collection is in
+// progress, or collects cycles, if enough candidate roots have been buffered.
+// This is only done at the outermost run level, since native functions
+// calling back into the VM may hold handles in local variables.
+
+#if JIL_USE_INCREMENTAL_GC || JIL_USE_CYCLE_COLLECTOR
+#define JIL_GC_SAFEPOINT \
+	if( (pState->vmGCPhase != kGCIdle || (pState->vmCCTrigger && pState->vmCCRootCount >= pState->vmCCTrigger)) && pState->vmRunLevel == 1 )\
+		JILGCSafePoint(pState);
+#else
+#define JIL_GC_SAFEPOINT
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_JIT_ENTER
+//------------------------------------------------------------------------------
+// Used by calls and backward branches, after the program counter has been set
+// to the target address. These are the safe points of the garbage collectors,
+// see JIL_GC_SAFEPOINT. If code registered by JILRegisterCompiledCode() can be
+// entered at the target address, runs it next. Then, if the function at the
+// target address has been compiled to machine code, runs the machine code and
+// continues wherever it has left off. Otherwise counts the branch, so the
+// function gets compiled once it is hot. See JIL_USE_JIT. Machine code is not
+// entered while the GC is marking, because it stores handles without passing
+// the write barrier.
+
+#define JIL_AOT_ENTER \
+	JIL_GC_SAFEPOINT\
+	if( pState->vmppCompiledCode && pState->vmppCompiledCode[programCounter] && !pState->vmTraceFlag )\
+		programCounter = pState->vmppCompiledCode[programCounter](pState, pContext, programCounter);
+
+#if JIL_USE_JIT
+#define JIL_JIT_ENTER \
+	JIL_AOT_ENTER\
+	if( pState->vmpJit && !pState->vmTraceFlag && pState->vmGCPhase != kGCMark ) {\
+		if( pState->vmpJit->ppEntry[programCounter] || (pState->vmpJit->pCounter[programCounter] >= 0 && JILJitCount(pState, programCounter)) )\
+			programCounter = JILJitRun(pState, pContext, programCounter);\
+	}
+#else
+#define JIL_JIT_ENTER	JIL_AOT_ENTER
+#endif
+
+//------------------------------------------------------------------------------
+// JIL_DIRECT_CALL
+//------------------------------------------------------------------------------
+// Evaluates to the entry of the given function in the table of directly
+// callable functions of the given native type, or NULL if the function must
+// be called through the type proc. See struct NTLDirectCall.
+
+#define JIL_DIRECT_CALL(TYPE, INDEX) \
+	(((TYPE) < pState->vmNumDirectCalls && (INDEX) < pState->vmpDirectCalls[TYPE].count &&\
+	pState->vmpDirectCalls[TYPE].pCalls[INDEX].signature > NTL_Sig_None) ? pState->vmpDirectCalls[TYPE].pCalls + (INDEX) : NULL)
 
 //------------------------------------------------------------------------------
 // JIL_PUSH_CS
@@ -129,15 +343,27 @@
 // Push a return address onto the VM's call stack
 
 #define JIL_PUSH_CS(N) \
-	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(pContext->vmCallStackPointer <= 0, JIL_VM_Stack_Overflow) ) \
-	pContext->vmpCallStack[--pContext->vmCallStackPointer] = N;
+	if( pContext->vmCallStackPointer <= pContext->vmCallStackLimit )\
+		{ JIL_THROW( JILGrowStack(pState, pContext, 0, 1, JILTrue) ) }\
+	JILCallStack(pContext, --pContext->vmCallStackPointer) = N;
+
+//------------------------------------------------------------------------------
+// JIL_RESERVE_DS
+//------------------------------------------------------------------------------
+// Makes room for N more handles on the data stack, growing it if necessary.
+// This must be done before computing effective addresses on the stack, since
+// growing the stack moves it in memory.
+
+#define JIL_RESERVE_DS(N) \
+	if( pContext->vmDataStackPointer - (N) < pContext->vmDataStackLimit )\
+		{ JIL_THROW( JILGrowStack(pState, pContext, (N), 0, JILTrue) ) }
 
 //------------------------------------------------------------------------------
 // JIL_POP_CS
 //------------------------------------------------------------------------------
 // Pop a return address from the VM's call stack
 
-#define JIL_POP_CS(N)	N = pContext->vmpCallStack[pContext->vmCallStackPointer++];
+#define JIL_POP_CS(N)	N = JILCallStack(pContext, pContext->vmCallStackPointer++);
 
 //------------------------------------------------------------------------------
 // JIL_INCDEC
@@ -154,6 +380,7 @@
 		case type_float: JILGetFloatHandle(handle1)->f OP 1.0; break;\
 		default: JIL_THROW(JIL_VM_Unsupported_Type)\
 	}\
+	JIL_QUICKEN(handle1->type, handle1->type)\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -183,6 +410,7 @@
 		case type_float: JILGetFloatHandle(handle1)->f = -JILGetFloatHandle(handle1)->f; break;\
 		default: JIL_THROW(JIL_VM_Unsupported_Type)\
 	}\
+	JIL_QUICKEN(handle1->type, handle1->type)\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -220,6 +448,7 @@
 		case type_float: JILGetFloatHandle(handle2)->f OP JILGetFloatHandle(handle1)->f; break;\
 		default: JIL_THROW(JIL_VM_Unsupported_Type)\
 	}\
+	JIL_QUICKEN(handle1->type, handle2->type)\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -244,6 +473,7 @@
 			JILGetFloatHandle(handle2)->f /= JILGetFloatHandle(handle1)->f; break;\
 		default: JIL_THROW(JIL_VM_Unsupported_Type)\
 	}\
+	JIL_QUICKEN(handle1->type, handle2->type)\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -268,6 +498,7 @@
 			JILGetFloatHandle(handle2)->f = fmod(JILGetFloatHandle(handle2)->f, JILGetFloatHandle(handle1)->f); break;\
 		default: JIL_THROW(JIL_VM_Unsupported_Type)\
 	}\
+	JIL_QUICKEN(handle1->type, handle2->type)\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -311,7 +542,7 @@
 	JIL_IBEGIN( IN )\
 	DO(pContext, operand1)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(pContext->vmDataStackPointer >= pState->vmDataStackSize, JIL_VM_Stack_Overflow) )\
-	handle1 = pContext->vmppDataStack[pContext->vmDataStackPointer++];\
+	handle1 = JILDataStack(pContext, pContext->vmDataStackPointer++);\
 	JIL_STORE_HANDLE(pState, operand1, handle1);\
 	JILRelease(pState, handle1);\
 	JIL_IEND
@@ -323,10 +554,10 @@
 
 #define JIL_PUSHEA(DO,IN) \
 	JIL_IBEGIN( IN )\
+	JIL_RESERVE_DS( 1 )\
 	DO(pContext, operand1)\
-	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(pContext->vmDataStackPointer <= 0, JIL_VM_Stack_Overflow) )\
 	JILAddRef(*operand1);\
-	pContext->vmppDataStack[--pContext->vmDataStackPointer] = *operand1;\
+	JILDataStack(pContext, --pContext->vmDataStackPointer) = *operand1;\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -338,7 +569,9 @@
 	JIL_IBEGIN( IN )\
 	hObj = pDataSegment[JIL_GET_DATA(pState)].index;\
 	DO(pContext, operand1)\
+	DO##_SAVE(pContext, operand1)\
 	JIL_THROW( JILCopyHandle(pState, pState->vmppHandles[hObj], &pNewHandle) )\
+	DO##_RESTORE(pContext, operand1)\
 	JIL_STORE_HANDLE(pState, operand1, pNewHandle);\
 	JILRelease(pState, pNewHandle);\
 	pNewHandle = NULL;\
@@ -351,7 +584,6 @@
 
 #define JIL_CMPS(SO,DO,OP,IN) \
 	JIL_IBEGIN( IN )\
-	pNewHandle = JILGetNewHandle(pState);\
 	SO(pContext, operand1)\
 	DO(pContext, operand2)\
 	JIL_LEA_R(pContext, operand3)\
@@ -364,11 +596,8 @@
 		case type_float: offs = (JILGetFloatHandle(handle2)->f OP JILGetFloatHandle(handle1)->f); break;\
 		default: JIL_THROW(JIL_VM_Unsupported_Type)\
 	}\
-	pNewHandle->type = type_int;\
-	JILGetIntHandle(pNewHandle)->l = offs;\
-	JIL_STORE_HANDLE(pState, operand3, pNewHandle);\
-	JILRelease(pState, pNewHandle);\
-	pNewHandle = NULL;\
+	JIL_QUICKEN(handle1->type, handle2->type)\
+	JIL_STORE_INT(pState, operand3, offs);\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -378,15 +607,10 @@
 
 #define JIL_SNUL(SO,IN) \
 	JIL_IBEGIN( IN )\
-	pNewHandle = JILGetNewHandle(pState);\
 	SO(pContext, operand1)\
 	JIL_LEA_R(pContext, operand2)\
 	handle1 = *operand1;\
-	pNewHandle->type = type_int;\
-	JILGetIntHandle(pNewHandle)->l = (handle1->type == type_null);\
-	JIL_STORE_HANDLE(pState, operand2, pNewHandle);\
-	JILRelease(pState, pNewHandle);\
-	pNewHandle = NULL;\
+	JIL_STORE_INT(pState, operand2, (handle1->type == type_null));\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -396,15 +620,10 @@
 
 #define JIL_SNNUL(SO,IN) \
 	JIL_IBEGIN( IN )\
-	pNewHandle = JILGetNewHandle(pState);\
 	SO(pContext, operand1)\
 	JIL_LEA_R(pContext, operand2)\
 	handle1 = *operand1;\
-	pNewHandle->type = type_int;\
-	JILGetIntHandle(pNewHandle)->l = (handle1->type != type_null);\
-	JIL_STORE_HANDLE(pState, operand2, pNewHandle);\
-	JILRelease(pState, pNewHandle);\
-	pNewHandle = NULL;\
+	JIL_STORE_INT(pState, operand2, (handle1->type != type_null));\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -443,22 +662,20 @@
 	DO(pContext, operand2)\
 	switch((*operand1)->type) {\
 		case type_int:\
-			pNewHandle = JILGetNewHandle(pState);\
-			pNewHandle->type = type_int;\
-			JILGetIntHandle(pNewHandle)->l = JILGetIntHandle(*operand1)->l;\
+			JIL_STORE_INT(pState, operand2, JILGetIntHandle(*operand1)->l);\
 			break;\
 		case type_float:\
-			pNewHandle = JILGetNewHandle(pState);\
-			pNewHandle->type = type_float;\
-			JILGetFloatHandle(pNewHandle)->f = JILGetFloatHandle(*operand1)->f;\
+			JIL_STORE_FLOAT(pState, operand2, JILGetFloatHandle(*operand1)->f);\
 			break;\
 		default:\
+			DO##_SAVE(pContext, operand2)\
 			JIL_THROW( JILCopyHandle(pState, *operand1, &pNewHandle) )\
+			DO##_RESTORE(pContext, operand2)\
+			JIL_STORE_HANDLE(pState, operand2, pNewHandle);\
+			JILRelease(pState, pNewHandle);\
+			pNewHandle = NULL;\
 			break;\
 		}\
-	JIL_STORE_HANDLE(pState, operand2, pNewHandle);\
-	JILRelease(pState, pNewHandle);\
-	pNewHandle = NULL;\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -468,7 +685,6 @@
 
 #define JIL_CMPSTR(SO,DO,OP,IN) \
 	JIL_IBEGIN( IN )\
-	pNewHandle = JILGetNewHandle(pState);\
 	SO(pContext, operand1)\
 	DO(pContext, operand2)\
 	JIL_LEA_R(pContext, operand3)\
@@ -476,11 +692,7 @@
 	handle2 = *operand2;\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != type_string, JIL_VM_Unsupported_Type) )\
-	pNewHandle->type = type_int;\
-	JILGetIntHandle(pNewHandle)->l = OP(JILGetStringHandle(handle2)->str, JILGetStringHandle(handle1)->str);\
-	JIL_STORE_HANDLE(pState, operand3, pNewHandle);\
-	JILRelease(pState, pNewHandle);\
-	pNewHandle = NULL;\
+	JIL_STORE_INT(pState, operand3, OP(JILGetStringHandle(handle2)->str, JILGetStringHandle(handle1)->str));\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -524,6 +736,7 @@
 	DO(pContext, operand2)\
 	handle1 = *operand1;\
 	handle2 = *operand2;\
+	JIL_QUICKGUARD(handle1->type != type_int || handle2->type != type_int)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_int, JIL_VM_Unsupported_Type) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
 	JILGetIntHandle(handle2)->l OP JILGetIntHandle(handle1)->l;\
@@ -540,6 +753,7 @@
 	DO(pContext, operand2)\
 	handle1 = *operand1;\
 	handle2 = *operand2;\
+	JIL_QUICKGUARD(handle1->type != type_int || handle2->type != type_int)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_int, JIL_VM_Unsupported_Type) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
 	JIL_THROW_IF(!JILGetIntHandle(handle1)->l, JIL_VM_Division_By_Zero)\
@@ -555,10 +769,27 @@
 	JIL_IBEGIN( IN )\
 	DO(pContext, operand1)\
 	handle1 = *operand1;\
+	JIL_QUICKGUARD(handle1->type != type_int)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != type_int, JIL_VM_Unsupported_Type) )\
 	JILGetIntHandle(handle1)->l OP 1;\
 	JIL_IEND
 
+//------------------------------------------------------------------------------
+// JIL_INCDECLB
+//------------------------------------------------------------------------------
+// "template" macro for long inc / dec instructions followed by a branch
+
+#define	JIL_INCDECLB(DO,OP,IN) \
+	JIL_IBEGIN( IN )\
+	DO(pContext, operand1)\
+	offs = JIL_GET_DATA(pState);\
+	handle1 = *operand1;\
+	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != type_int, JIL_VM_Unsupported_Type) )\
+	JILGetIntHandle(handle1)->l OP 1;\
+	programCounter += offs;\
+	if( offs < 0 ) { JIL_JIT_ENTER }\
+	JIL_IENDBR
+
 //------------------------------------------------------------------------------
 // JIL_NEGL
 //------------------------------------------------------------------------------
@@ -568,6 +799,7 @@
 	JIL_IBEGIN( IN )\
 	DO(pContext, operand1)\
 	handle1 = *operand1;\
+	JIL_QUICKGUARD(handle1->type != type_int)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != type_int, JIL_VM_Unsupported_Type) )\
 	JILGetIntHandle(handle1)->l = -JILGetIntHandle(handle1)->l;\
 	JIL_IEND
@@ -579,19 +811,39 @@
 
 #define JIL_CMPSL(SO,DO,OP,IN) \
 	JIL_IBEGIN( IN )\
-	pNewHandle = JILGetNewHandle(pState);\
 	SO(pContext, operand1)\
 	DO(pContext, operand2)\
 	JIL_LEA_R(pContext, operand3)\
 	handle1 = *operand1;\
 	handle2 = *operand2;\
+	JIL_QUICKGUARD(handle1->type != type_int || handle2->type != type_int)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_int, JIL_VM_Unsupported_Type) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
-	pNewHandle->type = type_int;\
-	JILGetIntHandle(pNewHandle)->l = (JILGetIntHandle(handle2)->l OP JILGetIntHandle(handle1)->l);\
-	JIL_STORE_HANDLE(pState, operand3, pNewHandle);\
-	JILRelease(pState, pNewHandle);\
-	pNewHandle = NULL;\
+	JIL_STORE_INT(pState, operand3, (JILGetIntHandle(handle2)->l OP JILGetIntHandle(handle1)->l));\
+	JIL_IEND
+
+//------------------------------------------------------------------------------
+// JIL_CMPSLB
+//------------------------------------------------------------------------------
+// "template" macro for long compare-and-set instructions followed by a tsteq
+// on the result register
+
+#define JIL_CMPSLB(SO,DO,OP,IN) \
+	JIL_IBEGIN( IN )\
+	SO(pContext, operand1)\
+	DO(pContext, operand2)\
+	JIL_LEA_R(pContext, operand3)\
+	offs = JIL_GET_DATA(pState);\
+	handle1 = *operand1;\
+	handle2 = *operand2;\
+	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_int, JIL_VM_Unsupported_Type) )\
+	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
+	i = (JILGetIntHandle(handle2)->l OP JILGetIntHandle(handle1)->l);\
+	JIL_STORE_INT(pState, operand3, i);\
+	if( i == 0 ) {\
+		programCounter += offs;\
+		JIL_IENDBR\
+	}\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -605,6 +857,7 @@
 	DO(pContext, operand2)\
 	handle1 = *operand1;\
 	handle2 = *operand2;\
+	JIL_QUICKGUARD(handle1->type != type_float || handle2->type != type_float)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_float, JIL_VM_Unsupported_Type) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
 	JILGetFloatHandle(handle2)->f OP JILGetFloatHandle(handle1)->f;\
@@ -621,6 +874,7 @@
 	DO(pContext, operand2)\
 	handle1 = *operand1;\
 	handle2 = *operand2;\
+	JIL_QUICKGUARD(handle1->type != type_float || handle2->type != type_float)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_float, JIL_VM_Unsupported_Type) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
 	JIL_THROW_IF(!JILGetFloatHandle(handle1)->f, JIL_VM_Division_By_Zero)\
@@ -638,6 +892,7 @@
 	DO(pContext, operand2)\
 	handle1 = *operand1;\
 	handle2 = *operand2;\
+	JIL_QUICKGUARD(handle1->type != type_float || handle2->type != type_float)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_float, JIL_VM_Unsupported_Type) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
 	JIL_THROW_IF(!JILGetFloatHandle(handle1)->f, JIL_VM_Division_By_Zero)\
@@ -653,6 +908,7 @@
 	JIL_IBEGIN( IN )\
 	DO(pContext, operand1)\
 	handle1 = *operand1;\
+	JIL_QUICKGUARD(handle1->type != type_float)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != type_float, JIL_VM_Unsupported_Type) )\
 	JILGetFloatHandle(handle1)->f OP 1.0;\
 	JIL_IEND
@@ -666,6 +922,7 @@
 	JIL_IBEGIN( IN )\
 	DO(pContext, operand1)\
 	handle1 = *operand1;\
+	JIL_QUICKGUARD(handle1->type != type_float)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != type_float, JIL_VM_Unsupported_Type) )\
 	JILGetFloatHandle(handle1)->f = -JILGetFloatHandle(handle1)->f;\
 	JIL_IEND
@@ -677,19 +934,15 @@
 
 #define JIL_CMPSF(SO,DO,OP,IN) \
 	JIL_IBEGIN( IN )\
-	pNewHandle = JILGetNewHandle(pState);\
 	SO(pContext, operand1)\
 	DO(pContext, operand2)\
 	JIL_LEA_R(pContext, operand3)\
 	handle1 = *operand1;\
 	handle2 = *operand2;\
+	JIL_QUICKGUARD(handle1->type != type_float || handle2->type != type_float)\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle2->type != type_float, JIL_VM_Unsupported_Type) )\
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(handle1->type != handle2->type, JIL_VM_Type_Mismatch) )\
-	pNewHandle->type = type_int;\
-	JILGetIntHandle(pNewHandle)->l = (JILGetFloatHandle(handle2)->f OP JILGetFloatHandle(handle1)->f);\
-	JIL_STORE_HANDLE(pState, operand3, pNewHandle);\
-	JILRelease(pState, pNewHandle);\
-	pNewHandle = NULL;\
+	JIL_STORE_INT(pState, operand3, (JILGetFloatHandle(handle2)->f OP JILGetFloatHandle(handle1)->f));\
 	JIL_IEND
 
 //------------------------------------------------------------------------------
@@ -746,6 +999,12 @@
 // "template" macro for all call delegate instructions. This instruction can
 // in certain cases modify register R0, so R0 should be saved to the stack!
 
+#if JIL_USE_INLINE_CACHING
+#define JIL_CALL_DELEGATE(D)	JILCallDelegateCached(pState, D, programCounter)
+#else
+#define JIL_CALL_DELEGATE(D)	JILCallDelegate(pState, D)
+#endif
+
 #define JIL_CALLDG(DO,IN) \
 	JIL_IBEGIN( IN )\
 	DO(pContext, operand1)\
@@ -755,7 +1014,7 @@
 	JIL_INSERT_DEBUG_CODE( JIL_THROW_IF(typeInfo->family != tf_delegate, JIL_VM_Unsupported_Type) );\
 	pState->errProgramCounter = pContext->vmProgramCounter = programCounter;\
 	JIL_PUSH_CS(programCounter + instruction_size)\
-	result = JILCallDelegate(pState, handle1);\
+	result = JIL_CALL_DELEGATE(handle1);\
 	JIL_POP_CS(i)\
 	JIL_THROW( result )\
 	JIL_IEND
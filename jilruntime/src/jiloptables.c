@@ -537,5 +537,29 @@ const JILInstrInfo g_InstructionInfo[JILNumOpcodes] =
 	op_newdgc,      5, 4,   ot_type,    ot_number,  ot_number,  ot_ear,     "newdgc",
 
 	// extensions 2015-04-24
-	op_jmp,         2, 1,   ot_number,  ot_none,    ot_none,    ot_none,    "jmp"
+	op_jmp,         2, 1,   ot_number,  ot_none,    ot_none,    ot_none,    "jmp",
+
+	// extensions 2026-10-16
+	op_cseqlb_rr,   5, 4,   ot_ear,     ot_ear,     ot_ear,     ot_label,   "cseql.b",
+	op_cseqlb_rs,   5, 4,   ot_ear,     ot_eas,     ot_ear,     ot_label,   "cseql.b",
+	op_cseqlb_sr,   5, 4,   ot_eas,     ot_ear,     ot_ear,     ot_label,   "cseql.b",
+	op_csnelb_rr,   5, 4,   ot_ear,     ot_ear,     ot_ear,     ot_label,   "csnel.b",
+	op_csnelb_rs,   5, 4,   ot_ear,     ot_eas,     ot_ear,     ot_label,   "csnel.b",
+	op_csnelb_sr,   5, 4,   ot_eas,     ot_ear,     ot_ear,     ot_label,   "csnel.b",
+	op_csgtlb_rr,   5, 4,   ot_ear,     ot_ear,     ot_ear,     ot_label,   "csgtl.b",
+	op_csgtlb_rs,   5, 4,   ot_ear,     ot_eas,     ot_ear,     ot_label,   "csgtl.b",
+	op_csgtlb_sr,   5, 4,   ot_eas,     ot_ear,     ot_ear,     ot_label,   "csgtl.b",
+	op_csgelb_rr,   5, 4,   ot_ear,     ot_ear,     ot_ear,     ot_label,   "csgel.b",
+	op_csgelb_rs,   5, 4,   ot_ear,     ot_eas,     ot_ear,     ot_label,   "csgel.b",
+	op_csgelb_sr,   5, 4,   ot_eas,     ot_ear,     ot_ear,     ot_label,   "csgel.b",
+	op_csltlb_rr,   5, 4,   ot_ear,     ot_ear,     ot_ear,     ot_label,   "csltl.b",
+	op_csltlb_rs,   5, 4,   ot_ear,     ot_eas,     ot_ear,     ot_label,   "csltl.b",
+	op_csltlb_sr,   5, 4,   ot_eas,     ot_ear,     ot_ear,     ot_label,   "csltl.b",
+	op_cslelb_rr,   5, 4,   ot_ear,     ot_ear,     ot_ear,     ot_label,   "cslel.b",
+	op_cslelb_rs,   5, 4,   ot_ear,     ot_eas,     ot_ear,     ot_label,   "cslel.b",
+	op_cslelb_sr,   5, 4,   ot_eas,     ot_ear,     ot_ear,     ot_label,   "cslel.b",
+	op_inclb_r,     3, 2,   ot_ear,     ot_label,   ot_none,    ot_none,    "incl.b",
+	op_inclb_s,     3, 2,   ot_eas,     ot_label,   ot_none,    ot_none,    "incl.b",
+	op_pushh,       2, 1,   ot_handle,  ot_none,    ot_none,    ot_none,    "pushh",
+	op_tail,        3, 2,   ot_number,  ot_number,  ot_none,    ot_none,    "tail"
 };
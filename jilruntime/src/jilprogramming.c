@@ -28,6 +28,8 @@
 #include "jiltypeinfo.h"
 #include "jilcallntl.h"
 #include "jilallocators.h"
+#include "jiljit.h"
+#include "jilaot.h"
 
 //------------------------------------------------------------------------------
 // constants
@@ -272,6 +274,8 @@ JILError JILCreateType(JILState* pState, const JILChar* pName, JILTypeFamily fam
 
 	// allocate a new TypeInfo entry
 	*pType = JILNewTypeInfo(pState, pName, &pTypeInfo);
+	if( *pType > JIL_MAX_HANDLE_TYPE )
+		return JIL_ERR_Generic_Error;
 
 	// set type information
 	pTypeInfo->base = 0;
@@ -310,6 +314,8 @@ JILError JILSetClassInstanceSize(JILState* pState, JILLong type, JILLong instanc
 	if( pTypeInfo->family != tf_class || pTypeInfo->isNative )
 		return JIL_ERR_Illegal_Argument;
 
+	// pooled instances have the old size
+	JILFlushInstancePool(pState, type);
 	// update type info
 	pTypeInfo->instanceSize = instanceSize;
 	return JIL_No_Exception;
@@ -436,6 +442,10 @@ JILError JILSetMemory(JILState* pState, JILLong address, const JILLong* pData, J
 	if( (address + size) > pCodeSegment->usedSize )
 		pCodeSegment->usedSize = address + size;
 	memcpy( pCodeSegment->pData + address, pData, size * sizeof(JILLong) );
+	JILResetQuickInfo( pState, address, size );
+	JILResetCallCache( pState, address, size );
+	JILResetJit( pState, address, size );
+	JILResetCompiledCode( pState );
 
 	return result;
 }
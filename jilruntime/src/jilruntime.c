@@ -36,8 +36,13 @@
 #include "jilfixmem.h"
 #include "jillist.h"
 #include "jiltable.h"
+#include "jilmap.h"
 #include "jilprogramming.h"
+#include "jiljit.h"
+#include "jilaot.h"
 #include "jilallocators.h"
+#include "jilopcodes.h"
+#include "jilcodelist.h"
 
 //------------------------------------------------------------------------------
 // other constants or variables
@@ -46,6 +51,10 @@
 static const JILLong kCStrAllocGrain		= 256;		// cstr segment
 static const JILLong kHandleAllocGrain		= 1024;		// handles
 static const JILLong kTypeAllocGrain		= 16;		// native types
+static const JILLong kGCStepWork			= 4096;		// handles per incremental GC step
+static const JILLong kCCThreshold			= 10000;	// candidate roots that trigger the cycle collector
+static const JILLong kInstancePoolCap		= 256;		// recycled instances per script class
+static const JILLong kContextPoolCap		= 256;		// recycled contexts (cofunction instances)
 
 //------------------------------------------------------------------------------
 // extern references
@@ -107,10 +116,13 @@ JILState* JILInitialize(JILLong stackSize, const JILChar* options)
 	pState->vmFree = DefaultFreeProc;
 	pState->vmFileInput = DefaultFileInputProc;
 
-	JIL_INSERT_DEBUG_CODE(
-		pState->vmpStats   = (JILMemStats*) malloc(sizeof(JILMemStats));
-		memset(pState->vmpStats, 0, sizeof(JILMemStats));
-	)
+	pState->vmpStats = (JILMemStats*) malloc(sizeof(JILMemStats));
+	memset(pState->vmpStats, 0, sizeof(JILMemStats));
+
+	#if JIL_USE_OPCODE_PROFILING
+		pState->vmpOpcodePairs = (JILUInt64*) malloc(JILNumOpcodes * JILNumOpcodes * sizeof(JILUInt64));
+		memset(pState->vmpOpcodePairs, 0, JILNumOpcodes * JILNumOpcodes * sizeof(JILUInt64));
+	#endif
 
 	// build flags
 	#if defined(_DEBUG) || JIL_TRACE_RELEASE
@@ -164,6 +176,9 @@ JILState* JILInitialize(JILLong stackSize, const JILChar* options)
 	if( err )
 		goto exit;
 	err = JILRegisterNativeType( pState, JILTableProc );
+	if( err )
+		goto exit;
+	err = JILRegisterNativeType( pState, JILMapProc );
 	if( err )
 		goto exit;
 	err = JILRegisterNativeType( pState, JILRuntimeProc );
@@ -207,19 +222,17 @@ JILError JILTerminate(JILState* pState)
 	// clear GC event list
 	JILClearGCEventList(pState);
 
+	// output and free opcode pair profile
+	if( pState->vmpOpcodePairs )
+	{
+		JILListOpcodePairs(pState, 32);
+		free( pState->vmpOpcodePairs );
+		pState->vmpOpcodePairs = NULL;
+	}
+
 	// free any fixed memory manager in use
-	Delete_FixMem(pState->vmFixMem16);
-	pState->vmFixMem16 = NULL;
-	Delete_FixMem(pState->vmFixMem32);
-	pState->vmFixMem32 = NULL;
-	Delete_FixMem(pState->vmFixMem64);
-	pState->vmFixMem64 = NULL;
-	Delete_FixMem(pState->vmFixMem128);
-	pState->vmFixMem128 = NULL;
-	Delete_FixMem(pState->vmFixMem256);
-	pState->vmFixMem256 = NULL;
-	Delete_FixMem(pState->vmFixMem512);
-	pState->vmFixMem512 = NULL;
+	Delete_FixMem(pState->vmFixMem);
+	pState->vmFixMem = NULL;
 
 	// check for runtime memory leaks
 	JIL_INSERT_DEBUG_CODE(
@@ -239,8 +252,8 @@ JILError JILTerminate(JILState* pState)
 			pState->errHandlesLeaked,
 			pState->vmpStats->bytesUsed, pState->vmpStats->maxBytesUsed,
 			pState->vmpStats->numBuckets, pState->vmpStats->bucketBytes);
-		free( pState->vmpStats );
 	)
+	free( pState->vmpStats );
 	// free our state object
 	free( pState );
 	return err;
@@ -328,8 +341,9 @@ JILHandle* JILCallFunction(JILState* pState, JILHandle* pFunc, JILLong numArgs,
 	JILPushStackFrame(pState, &stackFrame);
 
 	// reserve space on stack
+	JILGrowStack(pState, pState->vmpContext, numArgs, 0, JILFalse);
 	pState->vmpContext->vmDataStackPointer -= numArgs;
-	sp = pState->vmpContext->vmppDataStack + pState->vmpContext->vmDataStackPointer;
+	sp = JILDataStackAt(pState->vmpContext, pState->vmpContext->vmDataStackPointer);
 	// push arguments onto stack
 	va_start( marker, numArgs );	// Initialize variable arguments
 	for( i = 0; i < numArgs; i++ )
@@ -516,15 +530,16 @@ JILError JILUseFixedMemory(JILState* pState, JILLong max16, JILLong max32, JILLo
 	// Are we set up already?
 	if( pState->vmInitialized )
 		return JIL_ERR_Runtime_Locked;
-	if( pState->vmFixMem16 )
+	if( pState->vmFixMem )
 		return JIL_ERR_Runtime_Locked;
 
-	pState->vmFixMem16  = New_FixMem( 16, max16, 512, pState->vmpStats);
-	pState->vmFixMem32  = New_FixMem( 32, max32, 256, pState->vmpStats);
-	pState->vmFixMem64  = New_FixMem( 64, max64, 128, pState->vmpStats);
-	pState->vmFixMem128 = New_FixMem(128, max128, 64, pState->vmpStats);
-	pState->vmFixMem256 = New_FixMem(256, max256, 32, pState->vmpStats);
-	pState->vmFixMem512 = New_FixMem(512, max512, 16, pState->vmpStats);
+	pState->vmFixMem = New_FixMem(pState->vmpStats);
+	FixMem_SetMaxBlocks(pState->vmFixMem,   0,  16, max16);
+	FixMem_SetMaxBlocks(pState->vmFixMem,  16,  32, max32);
+	FixMem_SetMaxBlocks(pState->vmFixMem,  32,  64, max64);
+	FixMem_SetMaxBlocks(pState->vmFixMem,  64, 128, max128);
+	FixMem_SetMaxBlocks(pState->vmFixMem, 128, 256, max256);
+	FixMem_SetMaxBlocks(pState->vmFixMem, 256, 512, max512);
 
 	pState->vmMalloc = FixedMallocProc;
 	pState->vmFree = FixedFreeProc;
@@ -559,6 +574,15 @@ void JILMfree(JILState* pState, JILUnknown* ptr)
 	pState->vmFree(pState, ptr);
 }
 
+//------------------------------------------------------------------------------
+// JILGetMemStats
+//------------------------------------------------------------------------------
+
+const JILMemStats* JILGetMemStats(JILState* pState)
+{
+	return pState->vmpStats;
+}
+
 //------------------------------------------------------------------------------
 // JILSetBlocked
 //------------------------------------------------------------------------------
@@ -600,6 +624,16 @@ JILError JILInitializeRuntime(JILState* pState, const JILChar* options, JILBool
 	// construct runtime handles
 	err = JILInitHandles( pState, kHandleAllocGrain );
 	if( err ) return err;
+	pState->vmGCStepWork = kGCStepWork;
+	pState->vmCCThreshold = kCCThreshold;
+	pState->vmCCTrigger = kCCThreshold;
+	pState->vmInstancePoolCap = kInstancePoolCap;
+	pState->vmContextPoolCap = kContextPoolCap;
+	JILGCSetLimits(pState);
+
+	// construct call site caches, JILTerminateRuntime() has freed them
+	err = JILInitCallCache(pState);
+	if( err ) return err;
 
 	// construct segments
 	if( initSegments )
@@ -672,6 +706,25 @@ JILError JILTerminateRuntime(JILState* pState)
 	}
 	free( pState->vmpCodeSegment );
 	pState->vmpCodeSegment = NULL;
+	if( pState->vmpQuickInfo )
+	{
+		free( pState->vmpQuickInfo );
+		pState->vmpQuickInfo = NULL;
+		pState->vmQuickInfoSize = 0;
+	}
+	if( pState->vmpDirectCalls )
+	{
+		free( pState->vmpDirectCalls );
+		pState->vmpDirectCalls = NULL;
+		pState->vmNumDirectCalls = 0;
+	}
+	if( pState->vmpCallCache )
+	{
+		free( pState->vmpCallCache );
+		pState->vmpCallCache = NULL;
+	}
+	JILDestroyJit( pState );
+	JILResetCompiledCode( pState );
 	free( pState->vmpDataSegment );
 	pState->vmpDataSegment = NULL;
 	free( pState->vmpFuncSegment );
@@ -724,6 +777,48 @@ JILError JILHandleRuntimeOptions(JILState* pState, const JILChar* pName, const J
 		else
 			return JCL_WARN_Invalid_Option_Value;
 	}
+	else if( strcmp(pName, "gc-growth") == 0 )
+	{
+		JILFloat fValue = atof(pValue);
+		if( fValue != 0.0 && fValue <= 1.0 )
+			return JCL_WARN_Invalid_Option_Value;
+		JILSetGCGrowth(pState, fValue);
+	}
+	else if( strcmp(pName, "gc-budget-ms") == 0 )
+	{
+		JILFloat fValue = atof(pValue);
+		if( fValue < 0.0 )
+			return JCL_WARN_Invalid_Option_Value;
+		pState->vmGCStepTime = fValue / 1000.0;
+	}
+	else if( strcmp(pName, "lazy-free") == 0 )
+	{
+		if( nValue < 0 )
+			return JCL_WARN_Invalid_Option_Value;
+		JILSetLazyFree(pState, nValue);
+	}
+	else if( strcmp(pName, "instance-pool") == 0 )
+	{
+		if( nValue < 0 )
+			return JCL_WARN_Invalid_Option_Value;
+		JILSetInstancePool(pState, nValue);
+	}
+	else if( strcmp(pName, "jit") == 0 )
+	{
+		if( strcmp(pValue, "on") == 0 )
+		{
+			pState->vmJitDisabled = JILFalse;
+			if( pState->vmInitialized )
+				err = JILInitJit(pState);
+		}
+		else if( strcmp(pValue, "off") == 0 )
+		{
+			pState->vmJitDisabled = JILTrue;
+			JILDestroyJit(pState);
+		}
+		else
+			return JCL_WARN_Invalid_Option_Value;
+	}
 	else if( strcmp(pName, "document") == 0 )
 	{
 		if( strcmp(pValue, "user") == 0 || strcmp(pValue, "default") == 0 )
@@ -877,6 +972,70 @@ JILFloat JILGetTimeLastGC(JILState* pState)
 	return pState->vmTimeLastGC;
 }
 
+//------------------------------------------------------------------------------
+// JILSetGCBudget
+//------------------------------------------------------------------------------
+
+void JILSetGCBudget(JILState* pState, JILLong numHandles, JILFloat seconds)
+{
+	pState->vmGCStepWork = (numHandles > 0) ? numHandles : 0;
+	pState->vmGCStepTime = (seconds > 0.0) ? seconds : 0.0;
+}
+
+//------------------------------------------------------------------------------
+// JILSetGCGrowth
+//------------------------------------------------------------------------------
+
+void JILSetGCGrowth(JILState* pState, JILFloat growth)
+{
+	pState->vmGCGrowth = (growth > 1.0) ? growth : 0.0;
+	JILGCSetLimits(pState);
+}
+
+//------------------------------------------------------------------------------
+// JILGetGCPauseTime
+//------------------------------------------------------------------------------
+
+JILFloat JILGetGCPauseTime(JILState* pState)
+{
+	return pState->vmGCLastPause;
+}
+
+//------------------------------------------------------------------------------
+// JILSetLazyFree
+//------------------------------------------------------------------------------
+
+void JILSetLazyFree(JILState* pState, JILLong batchSize)
+{
+	pState->vmLazyFree = (batchSize > 0) ? batchSize : 0;
+	if( !pState->vmLazyFree )
+		JILDestroyPending(pState, 0);
+}
+
+//------------------------------------------------------------------------------
+// JILFreePendingObjects
+//------------------------------------------------------------------------------
+
+JILLong JILFreePendingObjects(JILState* pState, JILLong maxObjects)
+{
+	return JILDestroyPending(pState, (maxObjects > 0) ? maxObjects : 0);
+}
+
+//------------------------------------------------------------------------------
+// JILSetInstancePool
+//------------------------------------------------------------------------------
+
+void JILSetInstancePool(JILState* pState, JILLong maxInstances)
+{
+	JILLong type;
+	pState->vmInstancePoolCap = (maxInstances > 0) ? maxInstances : 0;
+	for( type = 0; type < pState->vmNumInstancePools; type++ )
+	{
+		if( pState->vmpInstancePools[type].count > pState->vmInstancePoolCap )
+			JILFlushInstancePool(pState, type);
+	}
+}
+
 //------------------------------------------------------------------------------
 // JILGetImplementors
 //------------------------------------------------------------------------------
@@ -932,7 +1091,7 @@ static void JILClearGCEventList(JILState* pState)
 
 static JILUnknown* DefaultMallocProc(JILState* pState, JILLong numBytes)
 {
-	JIL_INSERT_DEBUG_CODE( pState->vmpStats->numAlloc++; )
+	pState->vmpStats->numAlloc++;
 
 	return malloc(numBytes);
 }
@@ -943,7 +1102,7 @@ static JILUnknown* DefaultMallocProc(JILState* pState, JILLong numBytes)
 
 static void DefaultFreeProc(JILState* pState, JILUnknown* pBuffer)
 {
-	JIL_INSERT_DEBUG_CODE( pState->vmpStats->numFree++; )
+	pState->vmpStats->numFree++;
 
 	free(pBuffer);
 }
@@ -960,20 +1119,13 @@ static JILUnknown* FixedMallocProc(JILState* pState, JILLong numBytes)
 		return NULL;
 	else if( numBytes == 0 )
 		return pState; // This is intentional! If anyone writes into a zero byte buffer, they are bound to notice!
-	else if( numBytes <= 16 )
-		pResult = FixMem_Alloc(pState->vmFixMem16);
-	else if( numBytes <= 32 )
-		pResult = FixMem_Alloc(pState->vmFixMem32);
-	else if( numBytes <= 64 )
-		pResult = FixMem_Alloc(pState->vmFixMem64);
-	else if( numBytes <= 128 )
-		pResult = FixMem_Alloc(pState->vmFixMem128);
-	else if( numBytes <= 256 )
-		pResult = FixMem_Alloc(pState->vmFixMem256);
-	else if( numBytes <= 512 )
-		pResult = FixMem_Alloc(pState->vmFixMem512);
-	else
-		pResult = FixMem_AllocLargeBlock(numBytes, pState->vmpStats);
+
+	pResult = FixMem_Alloc(pState->vmFixMem, numBytes);
+	if( pResult )
+	{
+		pState->vmHeapBytes += FixMem_GetBlockLength(pResult);
+		JIL_GC_CHECK_LIMIT(pState, pState->vmHeapBytes, pState->vmGCByteLimit)
+	}
 
 	JIL_INSERT_DEBUG_CODE(
 		if( pResult == NULL )
@@ -994,20 +1146,8 @@ static void FixedFreeProc(JILState* pState, JILUnknown* pBuffer)
 	if( pBuffer == NULL || pBuffer == pState )
 		return;
 	numBytes = FixMem_GetBlockLength(pBuffer);
-	if( numBytes <= 16 )
-		FixMem_Free(pState->vmFixMem16, pBuffer);
-	else if( numBytes <= 32 )
-		FixMem_Free(pState->vmFixMem32, pBuffer);
-	else if( numBytes <= 64 )
-		FixMem_Free(pState->vmFixMem64, pBuffer);
-	else if( numBytes <= 128 )
-		FixMem_Free(pState->vmFixMem128, pBuffer);
-	else if( numBytes <= 256 )
-		FixMem_Free(pState->vmFixMem256, pBuffer);
-	else if( numBytes <= 512 )
-		FixMem_Free(pState->vmFixMem512, pBuffer);
-	else
-		FixMem_FreeLargeBlock(pBuffer, pState->vmpStats);
+	pState->vmHeapBytes -= numBytes;
+	FixMem_Free(pState->vmFixMem, pBuffer);
 }
 
 //------------------------------------------------------------------------------
@@ -11,7 +11,7 @@
 // Description:
 // ------------
 /// @file jiltable.c
-/// A very simple and straightforward Hash Table for the JILRuntime.
+/// An open addressing Hash Table with string keys for the JILRuntime.
 /// The table also supports a "native mode", storing native void* pointers
 /// instead of JILHandle pointers. The native mode table is used by the runtime
 /// internally.
@@ -26,15 +26,25 @@
 #include "jilapi.h"
 
 //------------------------------------------------------------------------------
-// struct JILTableNode
+// struct JILTableEntry
 //------------------------------------------------------------------------------
-// An entry in the JILTable is constructed out of several nodes.
+// A slot in the open addressing hash table. The hash of the key is cached in
+// the slot, so probing only compares keys if their hashes are equal. Keys that
+// fit into the slot are stored inline, longer keys are allocated separately.
 
-typedef struct JILTableNode	JILTableNode;
-struct JILTableNode
+#define kTableInlineKey		16
+
+typedef struct JILTableEntry	JILTableEntry;
+struct JILTableEntry
 {
-	JILUnknown*		pData;
-	JILTableNode*	p[16];
+	JILUInt32		hash;					// hash of the key, or kSlotEmpty / kSlotDeleted
+	JILLong			length;					// length of the key in bytes
+	JILUnknown*		pData;					// the value stored under the key
+	union
+	{
+		JILChar*	ptr;					// keys of kTableInlineKey or more bytes
+		JILChar		buf[kTableInlineKey];	// shorter keys, including the terminator
+	} key;
 };
 
 typedef enum
@@ -44,19 +54,27 @@ typedef enum
 	kTableModeNativeManaged					// the table contains native pointers and manages their lifetime (objects are stored and destroyed when no longer needed)
 } JILTableMode;
 
-typedef enum
-{
-	copy_shallow,
-	copy_deep
-} JILTableCopyMode;
-
 struct JILTable
 {
 	JILTableDestructor		pDestructor;
 	JILState*				pState;
-	struct JILTableNode*	pNode;
+	JILTableEntry*			pEntries;		// array of slots, the number of slots is a power of two
+	JILTableEntry**			ppOrder;		// slots sorted by key, built when needed, or NULL
 	JILTableMode			mode;			// native mode is used internally by the runtime, see NTLTypeNameToTypeID()
-	JILLong					count;
+	JILLong					count;			// number of values in the table
+	JILLong					used;			// number of slots that are not empty, including deleted slots
+	JILLong					capacity;		// number of slots
+	JILLong					orderLength;	// number of slots in ppOrder, including removed keys
+	JILLong					orderVersion;	// incremented whenever positions in ppOrder change
+};
+
+struct JILTableCursor
+{
+	JILTable*				pTable;
+	JILChar*				pKey;			// copy of the current key, or NULL if the cursor is invalid
+	JILLong					length;			// length of the current key
+	JILLong					pos;			// position of the current key in ppOrder
+	JILLong					version;		// the table's orderVersion when pos was taken
 };
 
 typedef struct JILTableMergeData
@@ -72,15 +90,17 @@ typedef struct JILTableMergeData
 } JILTableMergeData;
 
 static JILError JILTable_Merge(JILTableMergeData* pData);
-static void DestroyNodeRecursive(JILTable*, JILTableNode*);
-static void CopyNodeRecursive(JILState*, const JILTableNode*, JILTableNode**, JILTableCopyMode);
-static void CopyNodeStructure(JILState*, const JILTableNode*, JILTableNode**);
-static JILError EnumerateNodeRecursive(JILState*, const JILTableNode*, JILHandle*, JILHandle*);
-static JILError MarkNodeRecursive(JILState*, const JILTableNode*);
-static JILLong FreeEmptyNodeRecursive(JILTable*, JILTableNode*);
-static JILError AddToArrayRecursive(const JILTableNode*, JILArray*);
-static JILError AddToListRecursive(const JILTableNode*, JILString*, JILLong, JILList*);
-static JILError MergeNodeRecursive(const JILTableNode*, JILTableMergeData*, JILString*, JILLong);
+static JILUInt32 TableHash(const JILChar*, JILLong*);
+static JILTableEntry* TableFind(const JILTable*, const JILChar*, JILUInt32, JILLong);
+static void TableInsert(JILTable*, const JILChar*, JILUInt32, JILLong, JILUnknown*);
+static void TableRemove(JILTable*, JILTableEntry*);
+static void TableResize(JILTable*, JILLong);
+static void TableFreeData(JILTable*, JILUnknown*);
+static JILTableEntry** TableGetOrder(JILTable*);
+static void TableDropOrder(JILTable*);
+static JILLong TableLowerBound(const JILTable*, const JILChar*, JILLong);
+static void CursorSeek(JILTableCursor*, JILLong, JILLong);
+static JILBool CursorSync(JILTableCursor*);
 
 //------------------------------------------------------------------------------
 // function index numbers
@@ -102,7 +122,9 @@ enum
 	kToArray,
 	kToList,
 	kCount,
-	kMerge
+	kMerge,
+	kKeysWithPrefix,
+	kIterate
 };
 
 //------------------------------------------------------------------------------
@@ -110,7 +132,7 @@ enum
 //------------------------------------------------------------------------------
 
 static const char* kClassDeclaration =
-	TAG("This is JewelScript's built-in hash table class. Adding and removing data by hash key to the table is very quick. However, hash tables are very costly in terms of memory usage.")
+	TAG("This is JewelScript's built-in hash table class. Adding and removing data by hash key to the table is very quick. Functions that traverse the whole table visit the values in the order of their keys.")
 	"delegate		enumerator(var element, var args);" TAG("Delegate type for the table::enumerate() and array::enumerate() methods.")
 	"delegate		merger(const string key, const table t1, const table t2, table result);" TAG("Delegate type for the table::merge() function.")
 	"method			table();" TAG("Constructs a new, empty hashtable.")
@@ -120,13 +142,15 @@ static const char* kClassDeclaration =
 	"method	var		get(const string key);" TAG("Retrieves a value from the table by the specified key. If no value exists in the table under the specified key, null is returned.")
 	"method			set(const string key, var value);" TAG("Stores a value in the table under the specified key. If a value already exists under this key, it is overwritten. To clear a value in the table, you can just set it to null.")
 	"method table	deepCopy();" TAG("Returns a deep-copy of this table. WARNING: All table data will be copied! This is a highly recursive operation. If the table contains script objects that have copy-constructors, this method can be very time consuming. It should only be called in cases where a shallow copy would not suffice.")
-	"method			enumerate(enumerator fn);" TAG("Calls the specified enumerator delegate for every value in this table. This is a highly recursive operation that can be very time consuming with large tables.")
-	"method			enumerate(enumerator fn, var args);" TAG("Calls the specified enumerator delegate for every value in this table. This is a highly recursive operation that can be very time consuming with large tables.")
-	"method int		cleanup();" TAG("Frees all empty nodes in this table, releasing unneeded resources. This only affects internal infrastructure, all table data will remain intact. When storing and clearing large amounts of values in the table, calling this can improve memory footprint and performance of all other recursive table methods.")
-	"method array	toArray();" TAG("Moves all values from this table into a new array. This is a highly recursive operation that can be very time consuming with complex tables.")
-	"method list	toList();" TAG("Moves all keys and values from this table into a new list. This is a highly recursive operation that can be very time consuming with complex tables.")
+	"method			enumerate(enumerator fn);" TAG("Calls the specified enumerator delegate for every value in this table, in the order of their keys.")
+	"method			enumerate(enumerator fn, var args);" TAG("Calls the specified enumerator delegate for every value in this table, in the order of their keys.")
+	"method int		cleanup();" TAG("Shrinks the internal storage of this table to fit the number of values it contains, releasing unneeded resources. All table data will remain intact. Calling this after clearing large amounts of values from the table can improve its memory footprint.")
+	"method array	toArray();" TAG("Moves all values from this table into a new array, in the order of their keys.")
+	"method list	toList();" TAG("Moves all keys and values from this table into a new list, in the order of their keys.")
 	"accessor int	count();" TAG("Returns the number of values currently stored in the table.")
-	"function table merge(const table t1, const table t2, merger fn);" TAG("Merges the given tables according to the specified delegate and returns a new table. The function works as follows: First a reference table is created that contains all keys from both tables, but not their values. Then the reference table is iterated recursively. For every key in the reference table, the table::merger delegate is called. The current key, both source tables and a result table are passed to the delegate. The delegate defines how values from either or both source tables are stored in the result table.")
+	"function table merge(const table t1, const table t2, merger fn);" TAG("Merges the given tables according to the specified delegate and returns a new table. The function works as follows: First a reference table is created that contains all keys from both tables, but not their values. Then the reference table is iterated in the order of its keys. For every key in the reference table, the table::merger delegate is called. The current key, both source tables and a result table are passed to the delegate. The delegate defines how values from either or both source tables are stored in the result table.")
+	"method string[] keysWithPrefix(const string prefix);" TAG("Returns the keys in this table that start with the specified prefix, in sorted order. Only the matching keys are visited, so this is fast even for large tables.")
+	"function iterator iterate(table t);" TAG("Returns an iterator that visits the keys and values of the specified table in the order of their keys, without copying them: <pre>for( iterator it = table::iterate(myTable); it.valid; it.next() )\\n{\\n    println(it.key + \\\" = \\\" + it.value);\\n}</pre> The table may be modified during iteration. The iterator continues with the next key in order, whether its current key was removed or not.")
 ;
 
 //------------------------------------------------------------------------------
@@ -138,7 +162,10 @@ static const char*		kAuthorName		=	"www.jewe.org";
 static const char*		kAuthorString	=	"A hashtable class for JewelScript.";
 static const char*		kTimeStamp		=	"02/15/2007";
 
-static const int		kMaxKeyBufferLength = 256;
+static const JILLong		kTableMinCapacity = 8;	// number of slots allocated for the first value
+static const JILUInt32	kSlotEmpty = 0;			// hash of a slot that has never been used
+static const JILUInt32	kSlotDeleted = 1;		// hash of a slot whose key has been removed
+static const JILUInt32	kSlotFirstHash = 2;		// lowest hash of a slot that contains a key
 
 //------------------------------------------------------------------------------
 // forward declare static functions
@@ -149,6 +176,17 @@ static JILError TableDelete		(NTLInstance* pInst, JILTable* _this);
 static JILError TableMark		(NTLInstance* pInst, JILTable* _this);
 static JILError TableCallStatic	(NTLInstance* pInst, JILLong funcID);
 static JILError TableCallMember	(NTLInstance* pInst, JILLong funcID, JILTable* _this);
+static JILLong TableCapacityFor	(JILLong count);
+
+//------------------------------------------------------------------------------
+// EntryKey
+//------------------------------------------------------------------------------
+// Returns the key stored in a slot.
+
+JILINLINE const JILChar* EntryKey(const JILTableEntry* e)
+{
+	return (e->length >= kTableInlineKey) ? e->key.ptr : e->key.buf;
+}
 
 //------------------------------------------------------------------------------
 // JILTableProc
@@ -210,12 +248,20 @@ static JILError TableDelete(NTLInstance* pInst, JILTable* _this)
 
 static JILError TableMark(NTLInstance* pInst, JILTable* _this)
 {
+	JILError err = JIL_No_Exception;
+	JILLong i;
 	if( _this->mode != kTableModeManaged )
 		return JIL_ERR_Unsupported_Native_Call;
-	// we use the GC event to clean up the table
-	FreeEmptyNodeRecursive(_this, _this->pNode);
-	// now mark all items
-	return MarkNodeRecursive(_this->pState, _this->pNode);
+	for( i = 0; i < _this->capacity; i++ )
+	{
+		if( _this->pEntries[i].hash > kSlotDeleted )
+		{
+			JILError e = NTLMarkHandle(_this->pState, _this->pEntries[i].pData);
+			if( e )
+				err = e;
+		}
+	}
+	return err;
 }
 
 //------------------------------------------------------------------------------
@@ -248,6 +294,15 @@ static JILError TableCallStatic(NTLInstance* pInst, JILLong funcID)
 			ps->vmFree(ps, pData);
 			break;
 		}
+		case kIterate:
+		{
+			JILHandle* hTable = NTLGetArgHandle(ps, 0);
+			JILHandle* hIter = JILIterator_NewForTable(ps, hTable);
+			NTLReturnHandle(ps, hIter);
+			NTLFreeHandle(ps, hIter);
+			NTLFreeHandle(ps, hTable);
+			break;
+		}
 		default:
 			result = JIL_ERR_Invalid_Function_Index;
 			break;
@@ -343,6 +398,16 @@ static JILError TableCallMember(NTLInstance* pInst, JILLong funcID, JILTable* _t
 		case kCount:
 			NTLReturnInt(ps, _this->count);
 			break;
+		case kKeysWithPrefix:
+		{
+			JILHandle* pH;
+			JILArray* pArray = JILArray_New(ps);
+			JILTable_KeysWithPrefix(_this, NTLGetArgString(ps, 0), pArray);
+			pH = NTLNewHandleForObject(ps, type_array, pArray);
+			NTLReturnHandle(ps, pH);
+			NTLFreeHandle(ps, pH);
+			break;
+		}
 		default:
 			result = JIL_ERR_Invalid_Function_Index;
 			break;
@@ -361,21 +426,38 @@ static void JILTable_DefaultDestructor(JILUnknown* pItem)
 }
 
 //------------------------------------------------------------------------------
-// JILTable_NewManaged
+// JILTable_New
 //------------------------------------------------------------------------------
-// Create a new managed table.
+// Allocates an empty table, the slots are allocated when the first value is
+// stored.
 
-JILTable* JILTable_NewManaged(JILState* pVM)
+static JILTable* JILTable_New(JILState* pVM, JILTableMode mode, JILTableDestructor pDestructor)
 {
 	JILTable* _this = (JILTable*) pVM->vmMalloc(pVM, sizeof(JILTable));
-	_this->pDestructor = NULL; // destructor callback not used in managed mode
+	_this->pDestructor = pDestructor;
 	_this->pState = pVM;
-	_this->pNode = NULL;
-	_this->mode = kTableModeManaged;
+	_this->pEntries = NULL;
+	_this->ppOrder = NULL;
+	_this->mode = mode;
 	_this->count = 0;
+	_this->used = 0;
+	_this->capacity = 0;
+	_this->orderLength = 0;
+	_this->orderVersion = 0;
 	return _this;
 }
 
+//------------------------------------------------------------------------------
+// JILTable_NewManaged
+//------------------------------------------------------------------------------
+// Create a new managed table.
+
+JILTable* JILTable_NewManaged(JILState* pVM)
+{
+	// destructor callback not used in managed mode
+	return JILTable_New(pVM, kTableModeManaged, NULL);
+}
+
 //------------------------------------------------------------------------------
 // JILTable_NewNativeUnmanaged
 //------------------------------------------------------------------------------
@@ -383,13 +465,7 @@ JILTable* JILTable_NewManaged(JILState* pVM)
 
 JILTable* JILTable_NewNativeUnmanaged(JILState* pVM)
 {
-	JILTable* _this = (JILTable*) pVM->vmMalloc(pVM, sizeof(JILTable));
-	_this->pDestructor = NULL;
-	_this->pState = pVM;
-	_this->pNode = NULL;
-	_this->mode = kTableModeNativeUnmanaged;
-	_this->count = 0;
-	return _this;
+	return JILTable_New(pVM, kTableModeNativeUnmanaged, NULL);
 }
 
 //------------------------------------------------------------------------------
@@ -399,13 +475,7 @@ JILTable* JILTable_NewNativeUnmanaged(JILState* pVM)
 
 JILTable* JILTable_NewNativeManaged(JILState* pVM, JILTableDestructor pDestructor)
 {
-	JILTable* _this = (JILTable*) pVM->vmMalloc(pVM, sizeof(JILTable));
-	_this->pDestructor = (pDestructor == NULL) ? JILTable_DefaultDestructor : pDestructor;
-	_this->pState = pVM;
-	_this->pNode = NULL;
-	_this->mode = kTableModeNativeManaged;
-	_this->count = 0;
-	return _this;
+	return JILTable_New(pVM, kTableModeNativeManaged, (pDestructor == NULL) ? JILTable_DefaultDestructor : pDestructor);
 }
 
 //------------------------------------------------------------------------------
@@ -415,8 +485,23 @@ JILTable* JILTable_NewNativeManaged(JILState* pVM, JILTableDestructor pDestructo
 
 void JILTable_Delete(JILTable* _this)
 {
-	DestroyNodeRecursive( _this, _this->pNode );
-	_this->pState->vmFree(_this->pState, _this);
+	JILLong i;
+	JILTableEntry* e;
+	JILState* ps = _this->pState;
+	TableDropOrder(_this);
+	for( i = 0; i < _this->capacity; i++ )
+	{
+		e = _this->pEntries + i;
+		if( e->hash > kSlotDeleted )
+		{
+			TableFreeData(_this, e->pData);
+			if( e->length >= kTableInlineKey )
+				ps->vmFree(ps, e->key.ptr);
+		}
+	}
+	if( _this->pEntries )
+		ps->vmFree(ps, _this->pEntries);
+	ps->vmFree(ps, _this);
 }
 
 //------------------------------------------------------------------------------
@@ -426,10 +511,22 @@ void JILTable_Delete(JILTable* _this)
 
 void JILTable_Copy(JILTable* _this, const JILTable* pSrc)
 {
+	JILLong i;
+	JILHandle* pData;
+	const JILTableEntry* e;
 	if( pSrc->mode != kTableModeManaged )
 		return;
 	_this->mode = pSrc->mode;
-	CopyNodeRecursive(_this->pState, pSrc->pNode, &(_this->pNode), JILFalse);
+	for( i = 0; i < pSrc->capacity; i++ )
+	{
+		e = pSrc->pEntries + i;
+		if( e->hash > kSlotDeleted )
+		{
+			pData = NTLCopyValueType(_this->pState, e->pData);
+			JILTable_SetItem(_this, EntryKey(e), pData);
+			NTLFreeHandle(_this->pState, pData);
+		}
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -439,11 +536,25 @@ void JILTable_Copy(JILTable* _this, const JILTable* pSrc)
 
 JILTable* JILTable_DeepCopy(const JILTable* _this)
 {
+	JILLong i;
+	JILHandle* pData;
 	JILTable* pNew;
+	JILTableEntry* e;
 	if( _this->mode != kTableModeManaged )
 		return NULL;
+	// copy the references first, copy constructors may modify this table
 	pNew = JILTable_NewManaged(_this->pState);
-	CopyNodeRecursive(pNew->pState, _this->pNode, &(pNew->pNode), JILTrue);
+	JILTable_Copy(pNew, _this);
+	for( i = 0; i < pNew->capacity; i++ )
+	{
+		e = pNew->pEntries + i;
+		if( e->hash > kSlotDeleted )
+		{
+			pData = NTLCopyHandle(pNew->pState, e->pData);
+			NTLFreeHandle(pNew->pState, e->pData);
+			e->pData = pData;
+		}
+	}
 	return pNew;
 }
 
@@ -520,28 +631,58 @@ JILError JILTable_FromList(JILTable* _this, const JILList* pList)
 //------------------------------------------------------------------------------
 // JILTable_Enumerate
 //------------------------------------------------------------------------------
-// Call a delegate for every element in the table. This does NOT work in native mode.
+// Call a delegate for every element in the table, in the order of the keys.
+// The delegate may modify the table, so the values are collected first.
+// This does NOT work in native mode.
 
 JILError JILTable_Enumerate(JILTable* _this, JILHandle* pDel, JILHandle* pArgs)
 {
+	JILError err = JIL_No_Exception;
+	JILLong i, n;
+	JILHandle** ppValues;
+	JILTableEntry** ppOrder;
+	JILState* ps = _this->pState;
 	if( _this->mode != kTableModeManaged )
 		return JIL_ERR_Unsupported_Native_Call;
-	return EnumerateNodeRecursive(_this->pState, _this->pNode, pDel, pArgs);
+	ppOrder = TableGetOrder(_this);
+	if( ppOrder == NULL )
+		return err;
+	ppValues = (JILHandle**) ps->vmMalloc(ps, _this->count * sizeof(JILHandle*));
+	for( i = 0, n = 0; i < _this->orderLength; i++ )
+	{
+		if( ppOrder[i]->hash > kSlotDeleted )
+		{
+			ppValues[n] = ppOrder[i]->pData;
+			NTLReferHandle(ps, ppValues[n++]);
+		}
+	}
+	for( i = 0; i < n && !err; i++ )
+	{
+		JILHandle* pResult = JILCallFunction(ps, pDel, 2, kArgHandle, ppValues[i], kArgHandle, pArgs);
+		err = NTLHandleToError(ps, pResult);
+		NTLFreeHandle(ps, pResult);
+	}
+	for( i = 0; i < n; i++ )
+		NTLFreeHandle(ps, ppValues[i]);
+	ps->vmFree(ps, ppValues);
+	return err;
 }
 
 //------------------------------------------------------------------------------
 // JILTable_Cleanup
 //------------------------------------------------------------------------------
-// Free all empty nodes in the table to consolidate resources.
+// Rebuilds the table without deleted slots and shrinks it to fit the number of
+// values. Returns true if the table was empty and all slots have been freed.
 
 JILLong JILTable_Cleanup(JILTable* _this)
 {
-	JILLong isFree = FreeEmptyNodeRecursive(_this, _this->pNode);
-	if( isFree )
+	if( _this->count == 0 )
 	{
-		_this->pNode = NULL;
+		TableResize(_this, 0);
+		return JILTrue;
 	}
-	return isFree;
+	TableResize(_this, TableCapacityFor(_this->count));
+	return JILFalse;
 }
 
 //------------------------------------------------------------------------------
@@ -550,9 +691,17 @@ JILLong JILTable_Cleanup(JILTable* _this)
 
 JILError JILTable_ToArray(JILTable* _this, JILArray* pArray)
 {
+	JILLong i;
+	JILTableEntry** ppOrder;
 	if (_this->mode != kTableModeManaged)
 		return JIL_ERR_Unsupported_Native_Call;
-	return AddToArrayRecursive(_this->pNode, pArray);
+	ppOrder = TableGetOrder(_this);
+	for( i = 0; i < _this->orderLength; i++ )
+	{
+		if( ppOrder[i]->hash > kSlotDeleted )
+			JILArray_ArrMove(pArray, ppOrder[i]->pData);
+	}
+	return JIL_No_Exception;
 }
 
 //------------------------------------------------------------------------------
@@ -561,33 +710,105 @@ JILError JILTable_ToArray(JILTable* _this, JILArray* pArray)
 
 JILError JILTable_ToList(JILTable* _this, JILList* pList)
 {
-	JILError err;
+	JILLong i;
 	JILString* pKey;
+	JILHandle* hKey;
+	JILTableEntry** ppOrder;
+	JILState* ps = _this->pState;
 	if (_this->mode != kTableModeManaged)
 		return JIL_ERR_Unsupported_Native_Call;
-	pKey = JILString_New(_this->pState);
-	JILString_SetSize(pKey, kMaxKeyBufferLength);
-	err = AddToListRecursive(_this->pNode, pKey, 0, pList);
-	JILString_Delete(pKey);
-	return err;
+	ppOrder = TableGetOrder(_this);
+	for( i = 0; i < _this->orderLength; i++ )
+	{
+		if( ppOrder[i]->hash <= kSlotDeleted )
+			continue;
+		pKey = JILString_New(ps);
+		JILString_Assign(pKey, EntryKey(ppOrder[i]));
+		hKey = NTLNewHandleForObject(ps, type_string, pKey);
+		JILList_Add(pList, hKey, ppOrder[i]->pData);
+		NTLFreeHandle(ps, hKey);
+	}
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILTable_KeysWithPrefix
+//------------------------------------------------------------------------------
+// Adds all keys starting with the given prefix to the array, in key order.
+// Finds the first matching key by binary search, so only the matching keys
+// are visited once the order of the keys is known.
+
+void JILTable_KeysWithPrefix(JILTable* _this, const JILChar* pPrefix, JILArray* pArray)
+{
+	JILLong i, length;
+	JILString* pKey;
+	JILHandle* hKey;
+	JILTableEntry** ppOrder;
+	JILTableEntry* e;
+	JILState* ps = _this->pState;
+	ppOrder = TableGetOrder(_this);
+	length = (JILLong) strlen(pPrefix);
+	for( i = TableLowerBound(_this, pPrefix, length); i < _this->orderLength; i++ )
+	{
+		e = ppOrder[i];
+		if( e->length < length || memcmp(EntryKey(e), pPrefix, length) != 0 )
+			break;
+		if( e->hash <= kSlotDeleted )
+			continue;
+		pKey = JILString_New(ps);
+		JILString_Assign(pKey, EntryKey(e));
+		hKey = NTLNewHandleForObject(ps, type_string, pKey);
+		JILArray_ArrMove(pArray, hKey);
+		NTLFreeHandle(ps, hKey);
+	}
 }
 
 //------------------------------------------------------------------------------
 // JILTable_Merge
 //------------------------------------------------------------------------------
+// Builds a reference table with the keys of both tables and calls the merger
+// delegate for each key. The delegate may modify both tables, so the keys
+// are taken from the reference table.
 
 static JILError JILTable_Merge(JILTableMergeData* pData)
 {
 	JILError err = JIL_No_Exception;
-	JILString* pKey;
+	JILLong i, t;
+	JILString* pKeyStr;
+	JILHandle* hKey;
+	JILHandle* hException;
 	JILTable* pReference;
-	pReference = JILTable_NewNativeUnmanaged(pData->pState);
-	CopyNodeStructure(pData->pState, pData->pTableL->pNode, &pReference->pNode);
-	CopyNodeStructure(pData->pState, pData->pTableR->pNode, &pReference->pNode);
-	pKey = JILString_New(pData->pState);
-	JILString_SetSize(pKey, kMaxKeyBufferLength);
-	err = MergeNodeRecursive(pReference->pNode, pData, pKey, 0);
-	JILString_Delete(pKey);
+	JILTable* pSrc[2];
+	JILTableEntry** ppOrder;
+	JILTableEntry* e;
+	JILState* ps = pData->pState;
+	pReference = JILTable_NewNativeUnmanaged(ps);
+	pSrc[0] = pData->pTableL;
+	pSrc[1] = pData->pTableR;
+	for( t = 0; t < 2; t++ )
+	{
+		for( i = 0; i < pSrc[t]->capacity; i++ )
+		{
+			e = pSrc[t]->pEntries + i;
+			if( e->hash > kSlotDeleted && !TableFind(pReference, EntryKey(e), e->hash, e->length) )
+				TableInsert(pReference, EntryKey(e), e->hash, e->length, pReference);
+		}
+	}
+	ppOrder = TableGetOrder(pReference);
+	for( i = 0; i < pReference->orderLength && !err; i++ )
+	{
+		pKeyStr = JILString_New(ps);
+		JILString_Assign(pKeyStr, EntryKey(ppOrder[i]));
+		hKey = NTLNewHandleForObject(ps, type_string, pKeyStr);
+		hException = JILCallFunction(ps, pData->hDelegate, 4,
+			kArgHandle, hKey,
+			kArgHandle, pData->hTableL,
+			kArgHandle, pData->hTableR,
+			kArgHandle, pData->hResult);
+		err = NTLHandleToError(ps, hException);
+		NTLFreeHandle(ps, hException);
+		NTLFreeHandle(ps, hKey);
+	}
 	JILTable_Delete(pReference);
 	return err;
 }
@@ -602,26 +823,12 @@ JILUnknown* JILTable_GetItem(JILTable* _this, const JILChar* pKey)
 	JILUnknown* pResult = NULL;
 	if( pKey && *pKey )
 	{
-		JILLong c;
-		JILTableNode* pNode;
-
-		if( _this->pNode == NULL )
-			goto done;
-		pNode = _this->pNode;
-		while( (c = (unsigned char) *pKey++) )
-		{
-			pNode = pNode->p[c >> 4];
-			if( !pNode )
-				goto done;
-			pNode = pNode->p[c & 15];
-			if( !pNode )
-				goto done;
-		}
-		if( !pNode->pData )
-			goto done;
-		pResult = pNode->pData;
+		JILLong length;
+		JILUInt32 hash = TableHash(pKey, &length);
+		JILTableEntry* e = TableFind(_this, pKey, hash, length);
+		if( e )
+			pResult = e->pData;
 	}
-done:
 	if( !pResult && _this->mode == kTableModeManaged )
 		pResult = JILGetNullHandle(_this->pState);
 	return pResult;
@@ -630,380 +837,535 @@ done:
 //------------------------------------------------------------------------------
 // JILTable_SetItem
 //------------------------------------------------------------------------------
-// Put an item into the table.
+// Put an item into the table. Storing NULL, or null in managed mode, removes
+// the key from the table.
 
 void JILTable_SetItem(JILTable* _this, const JILChar* pKey, JILUnknown* pData)
 {
 	if( pKey && *pKey )
 	{
-		JILLong c;
-		JILTableNode* pNode;
-		JILTableNode** ppNode;
-		JILUnknown* data0;
-		JILState* pVM = _this->pState;
-
-		if( _this->pNode == NULL )
-		{
-			// if we don't have a root node yet, allocate it now
-			_this->pNode = (JILTableNode*) pVM->vmMalloc(pVM, sizeof(JILTableNode));
-			memset(_this->pNode, 0, sizeof(JILTableNode));
-		}
-		pNode = _this->pNode;
-		while( (c = (unsigned char) *pKey++) )
-		{
-			ppNode = pNode->p + (c >> 4);
-			if( *ppNode == NULL )
-			{
-				*ppNode = (JILTableNode*) pVM->vmMalloc(pVM, sizeof(JILTableNode));
-				memset(*ppNode, 0, sizeof(JILTableNode));
-			}
-			ppNode = (*ppNode)->p + (c & 15);
-			if( *ppNode == NULL )
-			{
-				*ppNode = (JILTableNode*) pVM->vmMalloc(pVM, sizeof(JILTableNode));
-				memset(*ppNode, 0, sizeof(JILTableNode));
-			}
-			pNode = *ppNode;
-		}
-		data0 = pNode->pData;
+		JILLong length;
+		JILUInt32 hash = TableHash(pKey, &length);
+		JILTableEntry* e = TableFind(_this, pKey, hash, length);
 		if( _this->mode == kTableModeManaged )
 		{
-			if( NTLHandleToTypeID(pVM, (JILHandle*)pData) == type_null )
+			if( NTLHandleToTypeID(_this->pState, (JILHandle*)pData) == type_null )
 				pData = NULL;
 			else
-				NTLReferHandle(pVM, (JILHandle*)pData);
-			if( pNode->pData )
-				NTLFreeHandle(pVM, ((JILHandle*)pNode->pData));
-			pNode->pData = pData;
+				NTLReferHandle(_this->pState, (JILHandle*)pData);
 		}
-		else if( _this->mode == kTableModeNativeManaged )
+		if( e )
 		{
-			if( pNode->pData )
-				_this->pDestructor(pNode->pData);
-			pNode->pData = pData;
+			JILUnknown* data0 = e->pData;
+			if( pData )
+				e->pData = pData;
+			else
+				TableRemove(_this, e);
+			TableFreeData(_this, data0);
 		}
-		else if( _this->mode == kTableModeNativeUnmanaged )
+		else if( pData )
 		{
-			pNode->pData = pData;
+			TableInsert(_this, pKey, hash, length, pData);
 		}
-		// statistics...
-		if( data0 == NULL && pData != NULL )
-			_this->count++;
-		else if( data0 != NULL && pData == NULL )
-			_this->count--;
 	}
 }
 
 //------------------------------------------------------------------------------
-// DestroyNodeRecursive
+// TableCapacityFor
+//------------------------------------------------------------------------------
+// Returns the number of slots for a table with the given number of values.
+// The table is at most half full after resizing.
+
+static JILLong TableCapacityFor(JILLong count)
+{
+	JILLong capacity = kTableMinCapacity;
+	while( capacity < count * 2 )
+		capacity *= 2;
+	return capacity;
+}
+
+//------------------------------------------------------------------------------
+// TableHash
+//------------------------------------------------------------------------------
+// Calculates the hash of a key and returns its length in 'pLength'. Hashes
+// below kSlotFirstHash are reserved to mark free slots.
+
+static JILUInt32 TableHash(const JILChar* pKey, JILLong* pLength)
+{
+	JILUInt32 h = 2166136261u;
+	const JILByte* p = (const JILByte*) pKey;
+	while( *p )
+		h = (h ^ *p++) * 16777619u;
+	*pLength = (JILLong) (p - (const JILByte*) pKey);
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	if( h < kSlotFirstHash )
+		h += kSlotFirstHash;
+	return h;
+}
+
+//------------------------------------------------------------------------------
+// TableFind
 //------------------------------------------------------------------------------
-// Helper function to destroy the table.
+// Returns the slot that contains the given key, or NULL.
 
-static void DestroyNodeRecursive(JILTable* pTable, JILTableNode* pNode)
+static JILTableEntry* TableFind(const JILTable* _this, const JILChar* pKey, JILUInt32 hash, JILLong length)
 {
-	if( pNode )
+	JILLong i, mask;
+	JILTableEntry* e;
+	if( _this->count == 0 )
+		return NULL;
+	mask = _this->capacity - 1;
+	for( i = hash & mask; ; i = (i + 1) & mask )
 	{
-		JILLong i;
-		for( i = 0; i < 16; i++ )
-		{
-			if( pNode->p[i] )
-			{
-				JILLong j;
-				JILTableNode* pNode2 = pNode->p[i];
-				for( j = 0; j < 16; j++ )
-				{
-					if( pNode2->p[j] )
-					{
-						DestroyNodeRecursive(pTable, pNode2->p[j]);
-					}
-				}
-				pTable->pState->vmFree(pTable->pState, pNode2);
-			}
-		}
-		if( pNode->pData )
-		{
-			if( pTable->mode == kTableModeManaged )
-			{
-				NTLFreeHandle(pTable->pState, pNode->pData);
-			}
-			else if( pTable->mode == kTableModeNativeManaged )
-			{
-				pTable->pDestructor(pNode->pData);
-			}
-		}
-		pTable->pState->vmFree(pTable->pState, pNode);
+		e = _this->pEntries + i;
+		if( e->hash == kSlotEmpty )
+			return NULL;
+		if( e->hash == hash && e->length == length && memcmp(EntryKey(e), pKey, length) == 0 )
+			return e;
 	}
 }
 
 //------------------------------------------------------------------------------
-// CopyNodeRecursive
+// TableInsert
 //------------------------------------------------------------------------------
-// Helper function to copy the table. Does NOT work in native mode.
+// Stores a key that is not yet in the table. The table grows when more than
+// three quarters of the slots are used.
 
-static void CopyNodeRecursive(JILState* pVM, const JILTableNode* pSrc, JILTableNode** ppDest, JILTableCopyMode mode)
+static void TableInsert(JILTable* _this, const JILChar* pKey, JILUInt32 hash, JILLong length, JILUnknown* pData)
 {
-	if( pSrc )
+	JILLong i, mask;
+	JILTableEntry* e;
+	JILState* ps = _this->pState;
+	TableDropOrder(_this);
+	if( (_this->used + 1) * 4 > _this->capacity * 3 )
+		TableResize(_this, TableCapacityFor(_this->count + 1));
+	mask = _this->capacity - 1;
+	for( i = hash & mask; ; i = (i + 1) & mask )
 	{
-		JILLong i;
-		JILTableNode* pNode;
-		pNode = (JILTableNode*) pVM->vmMalloc(pVM, sizeof(JILTableNode));
-		memset(pNode, 0, sizeof(JILTableNode));
-		*ppDest = pNode;
-		for( i = 0; i < 16; i++ )
-			CopyNodeRecursive(pVM, pSrc->p[i], &(pNode->p[i]), mode);
-		if( pSrc->pData )
-		{
-			if( mode == copy_deep )
-				pNode->pData = NTLCopyHandle(pVM, pSrc->pData);
-			else
-				pNode->pData = NTLCopyValueType(pVM, pSrc->pData);
-		}
+		e = _this->pEntries + i;
+		if( e->hash <= kSlotDeleted )
+			break;
+	}
+	if( e->hash == kSlotEmpty )
+		_this->used++;
+	e->hash = hash;
+	e->length = length;
+	e->pData = pData;
+	if( length >= kTableInlineKey )
+	{
+		e->key.ptr = (JILChar*) ps->vmMalloc(ps, length + 1);
+		memcpy(e->key.ptr, pKey, length + 1);
+	}
+	else
+	{
+		memcpy(e->key.buf, pKey, length + 1);
 	}
+	_this->count++;
 }
 
 //------------------------------------------------------------------------------
-// CopyNodeStructure
+// TableRemove
 //------------------------------------------------------------------------------
-// Recursively copies the table structure, but not the table data. This is meant
-// for unmanaged native tables only!
+// Removes a key from the table. Does not free the value stored in the slot.
+// The slot is marked deleted, unless the next slot is empty, in which case no
+// probe sequence can run across it. If the slot is in the order of the keys,
+// it stays there and keeps its key, so the order remains valid.
 
-static void CopyNodeStructure(JILState* pVM, const JILTableNode* pSrc, JILTableNode** ppDest)
+static void TableRemove(JILTable* _this, JILTableEntry* e)
 {
-	if( pSrc )
+	JILState* ps = _this->pState;
+	JILLong next = ((JILLong) (e - _this->pEntries) + 1) & (_this->capacity - 1);
+	if( e->length >= kTableInlineKey && _this->ppOrder == NULL )
+		ps->vmFree(ps, e->key.ptr);
+	if( _this->pEntries[next].hash == kSlotEmpty )
 	{
-		JILLong i;
-		JILTableNode* pNode = *ppDest;
-		if( pNode == NULL )
-		{
-			pNode = (JILTableNode*) pVM->vmMalloc(pVM, sizeof(JILTableNode));
-			memset(pNode, 0, sizeof(JILTableNode));
-			*ppDest = pNode;
-		}
-		for( i = 0; i < 16; i++ )
-			CopyNodeStructure(pVM, pSrc->p[i], &(pNode->p[i]));
-		if( pSrc->pData )
-			pNode->pData = pNode;
+		e->hash = kSlotEmpty;
+		_this->used--;
+	}
+	else
+	{
+		e->hash = kSlotDeleted;
 	}
+	e->pData = NULL;
+	_this->count--;
 }
 
 //------------------------------------------------------------------------------
-// EnumerateNodeRecursive
+// TableResize
 //------------------------------------------------------------------------------
-// Calls a delegate for every item in this table. Obviously does not work in native mode.
+// Moves all values into a new array of slots, dropping deleted slots. The
+// capacity must be a power of two, or 0 if the table is empty.
 
-static JILError EnumerateNodeRecursive(JILState* pVM, const JILTableNode* pNode, JILHandle* pDelegate, JILHandle* pArgs)
+static void TableResize(JILTable* _this, JILLong capacity)
 {
-	JILError err = JIL_No_Exception;
-	JILLong i, j;
-	const JILTableNode* pNode2;
-	if( pNode )
+	JILLong i, j, mask;
+	JILTableEntry* pOld = _this->pEntries;
+	JILTableEntry* e;
+	JILState* ps = _this->pState;
+	TableDropOrder(_this);
+	_this->pEntries = NULL;
+	if( capacity )
 	{
-		if( pNode->pData )
-		{
-			JILHandle* pResult = JILCallFunction(pVM, pDelegate, 2, kArgHandle, pNode->pData, kArgHandle, pArgs);
-			err = NTLHandleToError(pVM, pResult);
-			NTLFreeHandle(pVM, pResult);
-			if( err )
-				goto exit;
-		}
-		for( i = 0; i < 16; i++ )
+		_this->pEntries = (JILTableEntry*) ps->vmMalloc(ps, capacity * sizeof(JILTableEntry));
+		memset(_this->pEntries, 0, capacity * sizeof(JILTableEntry));
+	}
+	mask = capacity - 1;
+	for( i = 0; i < _this->capacity; i++ )
+	{
+		e = pOld + i;
+		if( e->hash > kSlotDeleted )
 		{
-			if( pNode->p[i] )
-			{
-				pNode2 = pNode->p[i];
-				for( j = 0; j < 16; j++ )
-				{
-					if( pNode2->p[j] )
-					{
-						err = EnumerateNodeRecursive(pVM, pNode2->p[j], pDelegate, pArgs);
-						if( err )
-							goto exit;
-					}
-				}
-			}
+			for( j = e->hash & mask; _this->pEntries[j].hash != kSlotEmpty; j = (j + 1) & mask )
+				;
+			_this->pEntries[j] = *e;
 		}
 	}
-exit:
-	return err;
+	if( pOld )
+		ps->vmFree(ps, pOld);
+	_this->capacity = capacity;
+	_this->used = _this->count;
 }
 
 //------------------------------------------------------------------------------
-// MarkNodeRecursive
+// TableFreeData
 //------------------------------------------------------------------------------
-// Marks all handles in this table. Obviously does not work in native mode.
+// Releases a value removed from the table, depending on the table mode.
 
-static JILError MarkNodeRecursive(JILState* pVM, const JILTableNode* pSrc)
+static void TableFreeData(JILTable* _this, JILUnknown* pData)
 {
-	JILError err = JIL_No_Exception;
-	if( pSrc )
+	if( pData )
 	{
-		JILLong i;
-		for( i = 0; i < 16; i++ )
-		{
-			JILError e = MarkNodeRecursive(pVM, pSrc->p[i]);
-			if( e )
-				err = e;
-		}
-		if( pSrc->pData )
-		{
-			JILError e = NTLMarkHandle(pVM, pSrc->pData);
-			if( e )
-				err = e;
-		}
+		if( _this->mode == kTableModeManaged )
+			NTLFreeHandle(_this->pState, (JILHandle*) pData);
+		else if( _this->mode == kTableModeNativeManaged )
+			_this->pDestructor(pData);
 	}
-	return err;
 }
 
 //------------------------------------------------------------------------------
-// FreeEmptyNodeRecursive
+// TableCompareKeys
+//------------------------------------------------------------------------------
+// Compare callback for JILSort(), orders slots by their keys like strcmp().
+
+static JILError TableCompareKeys(JILUnknown* pUser, JILUnknown* pItem1, JILUnknown* pItem2, JILLong* pResult)
+{
+	const JILTableEntry* e1 = (const JILTableEntry*) pItem1;
+	const JILTableEntry* e2 = (const JILTableEntry*) pItem2;
+	*pResult = memcmp(EntryKey(e1), EntryKey(e2), JILMIN(e1->length, e2->length) + 1);
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// TableCompareKey
+//------------------------------------------------------------------------------
+// Compares the key of a slot to the given key like strcmp().
+
+JILINLINE JILLong TableCompareKey(const JILTableEntry* e, const JILChar* pKey, JILLong length)
+{
+	return memcmp(EntryKey(e), pKey, JILMIN(e->length, length) + 1);
+}
+
+//------------------------------------------------------------------------------
+// TableGetOrder
 //------------------------------------------------------------------------------
-// Helper function to free empty table nodes.
+// Returns the slots sorted by key, or NULL if the table is empty. Traversing
+// the table in key order keeps the results of toArray(), toList() and the
+// enumeration functions independent of the hash function. The order is kept
+// until a key is added. Removed keys stay in the order, callers must skip
+// slots that are not live. When more than half of the slots in the order
+// have been removed, they are dropped from it.
 
-static JILLong FreeEmptyNodeRecursive(JILTable* pTable, JILTableNode* pNode)
+static JILTableEntry** TableGetOrder(JILTable* _this)
 {
-	JILLong nodeIsFree = JILFalse;
-	if( pNode )
+	JILLong i, n;
+	JILTableEntry* e;
+	JILState* ps = _this->pState;
+	if( _this->ppOrder && (_this->orderLength - _this->count) * 2 > _this->orderLength )
 	{
-		JILLong i;
-		JILLong freeSub = 0;
-		for( i = 0; i < 16; i++ )
+		for( i = 0, n = 0; i < _this->orderLength; i++ )
+		{
+			e = _this->ppOrder[i];
+			if( e->hash > kSlotDeleted )
+				_this->ppOrder[n++] = e;
+			else if( e->length >= kTableInlineKey )
+				ps->vmFree(ps, e->key.ptr);
+		}
+		_this->orderLength = n;
+		_this->orderVersion++;
+		if( n == 0 )
 		{
-			if( FreeEmptyNodeRecursive(pTable, pNode->p[i]) )
-			{
-				pNode->p[i] = NULL;
-				freeSub++;
-			}
+			ps->vmFree(ps, _this->ppOrder);
+			_this->ppOrder = NULL;
 		}
-		if( freeSub == 16 && pNode->pData == NULL )
+	}
+	if( _this->ppOrder == NULL && _this->count )
+	{
+		_this->ppOrder = (JILTableEntry**) ps->vmMalloc(ps, _this->count * sizeof(JILTableEntry*));
+		for( i = 0, n = 0; i < _this->capacity; i++ )
 		{
-			pTable->pState->vmFree(pTable->pState, pNode);
-			nodeIsFree = JILTrue;
+			if( _this->pEntries[i].hash > kSlotDeleted )
+				_this->ppOrder[n++] = _this->pEntries + i;
 		}
+		JILSort((JILUnknown**) _this->ppOrder, n, TableCompareKeys, NULL);
+		_this->orderLength = n;
 	}
-	return nodeIsFree;
+	return _this->ppOrder;
 }
 
 //------------------------------------------------------------------------------
-// AddToArrayRecursive
+// TableDropOrder
 //------------------------------------------------------------------------------
-// Helper function to add all table items to an array.
+// Frees the order of the keys, and the keys of removed slots still in it.
+// Must be called before slots are reused or moved.
 
-static JILError AddToArrayRecursive(const JILTableNode* pSrc, JILArray* pArray)
+static void TableDropOrder(JILTable* _this)
 {
-	JILError err = JIL_No_Exception;
 	JILLong i;
-	if( pSrc )
+	JILTableEntry* e;
+	JILState* ps = _this->pState;
+	if( _this->ppOrder )
 	{
-		for( i = 0; i < 16; i++ )
+		for( i = 0; i < _this->orderLength; i++ )
 		{
-			err = AddToArrayRecursive(pSrc->p[i], pArray);
-			if( err )
-				return err;
-		}
-		if( pSrc->pData )
-		{
-			JILArray_ArrMove(pArray, pSrc->pData);
+			e = _this->ppOrder[i];
+			if( e->hash <= kSlotDeleted && e->length >= kTableInlineKey )
+				ps->vmFree(ps, e->key.ptr);
 		}
+		ps->vmFree(ps, _this->ppOrder);
+		_this->ppOrder = NULL;
+		_this->orderLength = 0;
+		_this->orderVersion++;
 	}
-	return err;
 }
 
 //------------------------------------------------------------------------------
-// AddToListRecursive
+// TableLowerBound
 //------------------------------------------------------------------------------
-// Helper function to add all table items to a list.
+// Returns the position of the first slot in the order whose key is not less
+// than the given key. TableGetOrder() must have been called.
 
-static JILError AddToListRecursive(const JILTableNode* pNode, JILString* pKey, JILLong pos, JILList* pList)
+static JILLong TableLowerBound(const JILTable* _this, const JILChar* pKey, JILLong length)
 {
-	JILError err = JIL_No_Exception;
-	JILLong i, j;
-	const JILTableNode* pNode2;
-	JILHandle* hNewKey;
-	JILString* pKeyStr;
-	JILState* ps = pList->pState;
-	if( pNode )
+	JILLong lo = 0;
+	JILLong hi = _this->orderLength;
+	while( lo < hi )
 	{
-		if( pNode->pData )
-		{
-			pKey->string[pos] = 0;
-			pKey->length = pos;
-			pKeyStr = JILString_Copy(pKey);
-			hNewKey = NTLNewHandleForObject(ps, type_string, pKeyStr);
-			JILList_Add(pList, hNewKey, pNode->pData);
-			NTLFreeHandle(ps, hNewKey);
-		}
-		for( i = 0; i < 16; i++ )
-		{
-			if( pNode->p[i] )
-			{
-				pNode2 = pNode->p[i];
-				for( j = 0; j < 16; j++ )
-				{
-					if( pNode2->p[j] )
-					{
-						pKey->string[pos] = (i << 4 | j);
-						err = AddToListRecursive(pNode2->p[j], pKey, pos + 1, pList);
-						if( err )
-							goto exit;
-					}
-				}
-			}
-		}
+		JILLong mid = (lo + hi) / 2;
+		if( TableCompareKey(_this->ppOrder[mid], pKey, length) < 0 )
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
-exit:
-	return err;
+	return lo;
 }
 
 //------------------------------------------------------------------------------
-// MergeNodeRecursive
+// JILTable_NewCursor
 //------------------------------------------------------------------------------
+// Creates a cursor that visits the keys of a table in sorted order, starting
+// with the first key. Cursors do not copy the table. The table may be
+// modified while cursors exist, but must outlive them.
 
-static JILError MergeNodeRecursive(const JILTableNode* pNode, JILTableMergeData* pData, JILString* pKey, JILLong pos)
+JILTableCursor* JILTable_NewCursor(JILTable* pTable)
 {
-	JILError err = JIL_No_Exception;
-	JILLong i, j;
-	const JILTableNode* pNode2;
-	JILHandle* hNewKey;
-	JILHandle* hException;
-	JILString* pKeyStr;
-	JILState* ps = pData->pState;
-	if( pNode )
+	JILState* ps = pTable->pState;
+	JILTableCursor* _this = (JILTableCursor*) ps->vmMalloc(ps, sizeof(JILTableCursor));
+	memset(_this, 0, sizeof(JILTableCursor));
+	_this->pTable = pTable;
+	JILTable_CursorFirst(_this);
+	return _this;
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CopyCursor
+//------------------------------------------------------------------------------
+
+JILTableCursor* JILTable_CopyCursor(const JILTableCursor* pSrc)
+{
+	JILState* ps = pSrc->pTable->pState;
+	JILTableCursor* _this = (JILTableCursor*) ps->vmMalloc(ps, sizeof(JILTableCursor));
+	*_this = *pSrc;
+	if( pSrc->pKey )
 	{
-		if( pNode->pData )
-		{
-			pKey->string[pos] = 0;
-			pKey->length = pos;
-			pKeyStr = JILString_Copy(pKey);
-			hNewKey = NTLNewHandleForObject(ps, type_string, pKeyStr);
-			hException = JILCallFunction(ps, pData->hDelegate, 4,
-				kArgHandle, hNewKey,
-				kArgHandle, pData->hTableL,
-				kArgHandle, pData->hTableR,
-				kArgHandle, pData->hResult);
-			err = NTLHandleToError(ps, hException);
-			NTLFreeHandle(ps, hException);
-			NTLFreeHandle(ps, hNewKey);
-			if( err )
-				goto exit;
-		}
-		for( i = 0; i < 16; i++ )
+		_this->pKey = (JILChar*) ps->vmMalloc(ps, pSrc->length + 1);
+		memcpy(_this->pKey, pSrc->pKey, pSrc->length + 1);
+	}
+	return _this;
+}
+
+//------------------------------------------------------------------------------
+// JILTable_DeleteCursor
+//------------------------------------------------------------------------------
+
+void JILTable_DeleteCursor(JILTableCursor* _this)
+{
+	JILState* ps = _this->pTable->pState;
+	if( _this->pKey )
+		ps->vmFree(ps, _this->pKey);
+	ps->vmFree(ps, _this);
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CursorKey
+//------------------------------------------------------------------------------
+// Returns the key the cursor is on, or NULL if the cursor is invalid. The key
+// may have been removed from the table since the cursor moved to it.
+
+const JILChar* JILTable_CursorKey(const JILTableCursor* _this)
+{
+	return _this->pKey;
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CursorFirst
+//------------------------------------------------------------------------------
+
+void JILTable_CursorFirst(JILTableCursor* _this)
+{
+	TableGetOrder(_this->pTable);
+	CursorSeek(_this, 0, 1);
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CursorLast
+//------------------------------------------------------------------------------
+
+void JILTable_CursorLast(JILTableCursor* _this)
+{
+	TableGetOrder(_this->pTable);
+	CursorSeek(_this, _this->pTable->orderLength - 1, -1);
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CursorNext
+//------------------------------------------------------------------------------
+// Moves the cursor to the next key in the table. If keys have been added
+// since the cursor moved, the next key is looked up by binary search.
+
+void JILTable_CursorNext(JILTableCursor* _this)
+{
+	if( _this->pKey )
+	{
+		JILLong pos;
+		if( !CursorSync(_this) )
+			pos = TableLowerBound(_this->pTable, _this->pKey, _this->length) - 1;
+		else
+			pos = _this->pos;
+		CursorSeek(_this, pos + 1, 1);
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CursorPrev
+//------------------------------------------------------------------------------
+
+void JILTable_CursorPrev(JILTableCursor* _this)
+{
+	if( _this->pKey )
+	{
+		JILLong pos;
+		if( !CursorSync(_this) )
+			pos = TableLowerBound(_this->pTable, _this->pKey, _this->length);
+		else
+			pos = _this->pos;
+		CursorSeek(_this, pos - 1, -1);
+	}
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CursorIsFirst
+//------------------------------------------------------------------------------
+// Returns true if the cursor is on the first key of the table.
+
+JILBool JILTable_CursorIsFirst(JILTableCursor* _this)
+{
+	JILLong i;
+	if( !_this->pKey || !CursorSync(_this) )
+		return JILFalse;
+	if( _this->pTable->ppOrder[_this->pos]->hash <= kSlotDeleted )
+		return JILFalse;
+	for( i = _this->pos - 1; i >= 0; i-- )
+	{
+		if( _this->pTable->ppOrder[i]->hash > kSlotDeleted )
+			return JILFalse;
+	}
+	return JILTrue;
+}
+
+//------------------------------------------------------------------------------
+// JILTable_CursorIsLast
+//------------------------------------------------------------------------------
+// Returns true if the cursor is on the last key of the table.
+
+JILBool JILTable_CursorIsLast(JILTableCursor* _this)
+{
+	JILLong i;
+	if( !_this->pKey || !CursorSync(_this) )
+		return JILFalse;
+	if( _this->pTable->ppOrder[_this->pos]->hash <= kSlotDeleted )
+		return JILFalse;
+	for( i = _this->pos + 1; i < _this->pTable->orderLength; i++ )
+	{
+		if( _this->pTable->ppOrder[i]->hash > kSlotDeleted )
+			return JILFalse;
+	}
+	return JILTrue;
+}
+
+//------------------------------------------------------------------------------
+// CursorSync
+//------------------------------------------------------------------------------
+// Makes sure the order of the table is built and the cursor's position refers
+// to it. Returns false if the cursor's key is no longer in the order, in which
+// case the position is not updated.
+
+static JILBool CursorSync(JILTableCursor* _this)
+{
+	JILLong pos;
+	JILTable* pTable = _this->pTable;
+	TableGetOrder(pTable);
+	if( _this->version == pTable->orderVersion )
+		return JILTrue;
+	pos = TableLowerBound(pTable, _this->pKey, _this->length);
+	if( pos == pTable->orderLength || TableCompareKey(pTable->ppOrder[pos], _this->pKey, _this->length) != 0 )
+		return JILFalse;
+	_this->pos = pos;
+	_this->version = pTable->orderVersion;
+	return JILTrue;
+}
+
+//------------------------------------------------------------------------------
+// CursorSeek
+//------------------------------------------------------------------------------
+// Moves the cursor to the first live slot at or after the given position in
+// the order, searching in the given direction. The cursor becomes invalid if
+// there is none.
+
+static void CursorSeek(JILTableCursor* _this, JILLong pos, JILLong dir)
+{
+	JILTableEntry* e;
+	JILTable* pTable = _this->pTable;
+	JILState* ps = pTable->pState;
+	if( _this->pKey )
+	{
+		ps->vmFree(ps, _this->pKey);
+		_this->pKey = NULL;
+	}
+	for( ; pos >= 0 && pos < pTable->orderLength; pos += dir )
+	{
+		e = pTable->ppOrder[pos];
+		if( e->hash > kSlotDeleted )
 		{
-			if( pNode->p[i] )
-			{
-				pNode2 = pNode->p[i];
-				for( j = 0; j < 16; j++ )
-				{
-					if( pNode2->p[j] )
-					{
-						pKey->string[pos] = (i << 4 | j);
-						err = MergeNodeRecursive(pNode2->p[j], pData, pKey, pos + 1);
-						if( err )
-							goto exit;
-					}
-				}
-			}
+			_this->length = e->length;
+			_this->pKey = (JILChar*) ps->vmMalloc(ps, e->length + 1);
+			memcpy(_this->pKey, EntryKey(e), e->length + 1);
+			_this->pos = pos;
+			_this->version = pTable->orderVersion;
+			break;
 		}
 	}
-exit:
-	return err;
 }
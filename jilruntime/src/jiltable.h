@@ -11,7 +11,7 @@
 // Description:
 // ------------
 /// @file jiltable.h
-/// A very simple and straightforward Hash Table for the JILRuntime.
+/// An open addressing Hash Table with string keys for the JILRuntime.
 /// The table also supports a "native mode", storing native void* pointers
 /// instead of JILHandle pointers. The native mode table is used by the runtime
 /// internally.
@@ -49,6 +49,25 @@ JILLong				JILTable_Cleanup			(JILTable*);
 
 JILUnknown*			JILTable_GetItem			(JILTable*, const JILChar*);
 void				JILTable_SetItem			(JILTable*, const JILChar*, JILUnknown*);
+void				JILTable_KeysWithPrefix		(JILTable*, const JILChar*, JILArray*);
+
+//------------------------------------------------------------------------------
+// JILTableCursor Functions
+//------------------------------------------------------------------------------
+/// A cursor visits the keys of a table in sorted order without copying them.
+/// The table may be modified while cursors exist. A cursor continues with
+/// the next key in order, even if its current key has been removed.
+
+JILTableCursor*		JILTable_NewCursor			(JILTable*);
+JILTableCursor*		JILTable_CopyCursor			(const JILTableCursor*);
+void				JILTable_DeleteCursor		(JILTableCursor*);
+const JILChar*		JILTable_CursorKey			(const JILTableCursor*);
+void				JILTable_CursorFirst		(JILTableCursor*);
+void				JILTable_CursorLast			(JILTableCursor*);
+void				JILTable_CursorNext			(JILTableCursor*);
+void				JILTable_CursorPrev			(JILTableCursor*);
+JILBool				JILTable_CursorIsFirst		(JILTableCursor*);
+JILBool				JILTable_CursorIsLast		(JILTableCursor*);
 
 //------------------------------------------------------------------------------
 // JILTableProc
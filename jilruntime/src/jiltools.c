@@ -21,6 +21,12 @@
 #include "jiltools.h"
 #include "jclstring.h"
 
+//------------------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------------------
+
+static const JILLong kSortInsertionMax = 16;	// runs up to this length are sorted by insertion
+
 //------------------------------------------------------------------------------
 // JILMessageLog
 //------------------------------------------------------------------------------
@@ -106,3 +112,99 @@ void JILStrncpy(JILChar* pDest, JILLong destSize, const JILChar* pSrc, JILLong l
 		pDest[length] = 0;
 	}
 }
+
+//------------------------------------------------------------------------------
+// JILSortInsertion
+//------------------------------------------------------------------------------
+// Sorts a short run of items by binary insertion. Equal items are inserted
+// behind each other, so the order of equal items is preserved.
+
+static JILError JILSortInsertion(JILUnknown** a, JILLong lo, JILLong hi, JILSortCompareProc proc, JILUnknown* pUser)
+{
+	JILError err;
+	JILLong i, l, r, m, res;
+	JILUnknown* x;
+	for( i = lo + 1; i < hi; i++ )
+	{
+		x = a[i];
+		l = lo;
+		r = i;
+		while( l < r )
+		{
+			m = l + (r - l) / 2;
+			err = proc(pUser, x, a[m], &res);
+			if( err )
+				return err;
+			if( res < 0 )
+				r = m;
+			else
+				l = m + 1;
+		}
+		if( l < i )
+		{
+			memmove(a + l + 1, a + l, (i - l) * sizeof(JILUnknown*));
+			a[l] = x;
+		}
+	}
+	return JIL_No_Exception;
+}
+
+//------------------------------------------------------------------------------
+// JILSortMerge
+//------------------------------------------------------------------------------
+// Recursively sorts both halves of a run and merges them. Only the left half
+// is copied to the temp buffer.
+
+static JILError JILSortMerge(JILUnknown** a, JILUnknown** tmp, JILLong lo, JILLong hi, JILSortCompareProc proc, JILUnknown* pUser)
+{
+	JILError err;
+	JILLong mid, i, j, k, n, res;
+	if( hi - lo <= kSortInsertionMax )
+		return JILSortInsertion(a, lo, hi, proc, pUser);
+	mid = lo + (hi - lo) / 2;
+	err = JILSortMerge(a, tmp, lo, mid, proc, pUser);
+	if( err )
+		return err;
+	err = JILSortMerge(a, tmp, mid, hi, proc, pUser);
+	if( err )
+		return err;
+	// already in order?
+	err = proc(pUser, a[mid - 1], a[mid], &res);
+	if( err || res <= 0 )
+		return err;
+	n = mid - lo;
+	memcpy(tmp, a + lo, n * sizeof(JILUnknown*));
+	i = 0;
+	j = mid;
+	k = lo;
+	while( i < n && j < hi )
+	{
+		err = proc(pUser, a[j], tmp[i], &res);
+		if( err )
+			break;
+		if( res < 0 )
+			a[k++] = a[j++];
+		else
+			a[k++] = tmp[i++];
+	}
+	// remaining items of the left half, also restores the run on error
+	while( i < n )
+		a[k++] = tmp[i++];
+	return err;
+}
+
+//------------------------------------------------------------------------------
+// JILSort
+//------------------------------------------------------------------------------
+
+JILError JILSort(JILUnknown** ppItems, JILLong count, JILSortCompareProc proc, JILUnknown* pUser)
+{
+	JILError err;
+	JILUnknown** tmp;
+	if( count <= kSortInsertionMax )
+		return JILSortInsertion(ppItems, 0, count, proc, pUser);
+	tmp = (JILUnknown**) malloc((count / 2 + 1) * sizeof(JILUnknown*));
+	err = JILSortMerge(ppItems, tmp, 0, count, proc, pUser);
+	free(tmp);
+	return err;
+}
@@ -109,6 +109,26 @@ JILEXTERN void	JILStrcpy			(JILChar* pDest, JILLong destSize, const JILChar* pSr
 
 JILEXTERN void	JILStrncpy			(JILChar* pDest, JILLong destSize, const JILChar* pSrc, JILLong length);
 
+//------------------------------------------------------------------------------
+// JILSortCompareProc
+//------------------------------------------------------------------------------
+/// Compare callback for JILSort(). Stores a value less than 0 in 'pResult' if
+/// item1 belongs in front of item2, a value greater than 0 if it belongs behind
+/// item2, and 0 if both are equal. Any error returned aborts the sort.
+
+typedef JILError (*JILSortCompareProc) (JILUnknown* pUser, JILUnknown* pItem1, JILUnknown* pItem2, JILLong* pResult);
+
+//------------------------------------------------------------------------------
+// JILSort
+//------------------------------------------------------------------------------
+/// Sorts an array of pointers using a stable merge sort, which takes
+/// O(n log n) comparisons. Short runs are sorted by binary insertion, and
+/// merging two runs is skipped if they are already in order, so sorted input
+/// only takes n - 1 comparisons. If the compare callback returns an error,
+/// the sort is aborted, but the array still contains all of its items.
+
+JILEXTERN JILError	JILSort			(JILUnknown** ppItems, JILLong count, JILSortCompareProc proc, JILUnknown* pUser);
+
 //------------------------------------------------------------------------------
 // JILRevisionToLong
 //------------------------------------------------------------------------------
@@ -168,8 +168,8 @@ JILError JILRegisterNativeType(JILState* pState, JILTypeProc proc)
 	{
 		// get the interface version used by the lib
 		vers = CallNTLGetInterfaceVersion(proc);
-		// we could filter out no longer supported versions here, but for now we accept all valid version numbers
-		if( !vers || vers > JILRevisionToLong(JIL_TYPE_INTERFACE_VERSION) )
+		// filter out versions we don't support
+		if( vers < JILRevisionToLong(JIL_TYPE_INTERFACE_MIN_VERSION) || vers > JILRevisionToLong(JIL_TYPE_INTERFACE_VERSION) )
 			goto exit;
 		// get class name
 		err = CallNTLGetClassName(proc, &pClassName);
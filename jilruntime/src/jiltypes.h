@@ -79,7 +79,10 @@ typedef enum
 {
 	HF_NEWBUCKET	= 1 << 0,	//!< handle address is address of a "bucket"
 	HF_PERSIST		= 1 << 1,	//!< do NOT destroy encapsulated object
-	HF_MARKED		= 1 << 2	//!< handle is marked in response to garbage collection MARK command
+	HF_MARKED		= 1 << 2,	//!< handle is marked in response to garbage collection MARK command
+	HF_CCBUFFERED	= 1 << 3,	//!< handle is in the candidate buffer of the cycle collector
+	HF_CCGREY		= 1 << 4,	//!< handle is being trial-deleted by the cycle collector
+	HF_CCWHITE		= 1 << 5	//!< handle has been found to be garbage by the cycle collector
 
 } JILHandleFlags;
 
@@ -118,6 +121,8 @@ typedef struct JILArray				JILArray;
 typedef struct JILList				JILList;
 typedef struct JILListItem			JILListItem;
 typedef struct JILIterator			JILIterator;
+typedef struct JILTableCursor		JILTableCursor;
+typedef struct JILMap				JILMap;
 typedef struct JILArrayList			JILArrayList;
 typedef struct JILFuncInfo			JILFuncInfo;
 typedef struct JILDataHandle		JILDataHandle;
@@ -149,17 +154,23 @@ typedef union
 /// is allowing to determine the actual type of data, as well as keeping track
 /// of the number of references to that data, in order to automatically free
 /// the memory used by the data when it is no longer used.
+/// <p>A handle is 16 bytes, so four of them fit into a cache line. The type
+/// and flags share a 32-bit word, which limits the number of types to 65536.
+/// The index of a handle is not stored in it, but in the bucket it has been
+/// allocated from, see JILFindHandleIndex().</p>
 /// @see opaque structs in JILHandle.h
 
 struct JILHandle
 {
-	JILLong			type;				//!< The type of the value this handle encapsulates, see struct JILTypeInfo
-	JILLong			flags;				//!< Flags, see enum JILHandleFlags
+	JILUInt16		type;				//!< The type of the value this handle encapsulates, see struct JILTypeInfo
+	JILUInt16		flags;				//!< Flags, see enum JILHandleFlags
 	JILLong			refCount;			//!< Number of references to the value
-	JILLong			reserved;			//!< Reserved to ensure 8-byte alignment for 64-bit float
 	JILHandleData	data[1];			//!< The handle's value, handle type dependent, see opaque structs in jilhandle.h
 };
 
+/// The highest type identifier a JILHandle can store.
+#define JIL_MAX_HANDLE_TYPE		0xFFFF
+
 //------------------------------------------------------------------------------
 // struct NTLInstance
 //------------------------------------------------------------------------------
@@ -378,32 +389,6 @@ struct JILDataHandle
 	JILHandleData		data[1];	//!< The handle data, type dependant
 };
 
-//------------------------------------------------------------------------------
-// struct JILMemStats
-//------------------------------------------------------------------------------
-/// This is a small object that is passed to the Fixed Memory management
-/// functions to keep track of number of allocs, number of bytes allocated, and
-/// so on. The statistics is only generated in DEBUG builds, and only when
-/// Fixed Memory Management is enabled. FixMem allocates memory in bigger blocks,
-/// called buckets. It never frees buckets, but keeps them around for fast reuse
-/// of free memory. This value should give a rough picture how much memory
-/// the runtime really has used. Note that FixMem only is used when memory is
-/// allocated during run-time, not when the compiler or other parts of the
-/// library allocate it. The built-in native type libraries use FixMem too.
-/// But of course it is up to the implementor, whether or not a specific
-/// type library uses FixMem or just new / malloc.
-/// @see JILUseFixedMemory ()
-
-struct JILMemStats
-{
-	JILLong				numAlloc;		//!< The total number of memory allocations
-	JILLong				numFree;		//!< Total number of memory frees
-	JILLong				bytesUsed;		//!< Currently allocated number of bytes
-	JILLong				maxBytesUsed;	//!< Maximum number of allocated bytes at any time
-	JILLong				numBuckets;		//!< Total number of buckets used
-	JILLong				bucketBytes;	//!< Total number of bytes allocated for buckets
-};
-
 //------------------------------------------------------------------------------
 // struct JILClosure
 //------------------------------------------------------------------------------
@@ -412,8 +397,8 @@ struct JILMemStats
 
 struct JILClosure
 {
-	JILLong				stackSize;		//!< size of the parent function's stack
-	JILHandle**			ppStack;		//!< snapshot of the parent function's stack
+	JILLong				stackSize;		//!< number of captured variables of the parent function
+	JILHandle**			ppStack;		//!< the captured variables, pushed onto the stack when the closure is called
 };
 
 //------------------------------------------------------------------------------